@@ -0,0 +1,92 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocations.h"
+
+namespace
+{
+
+std::atomic<std::size_t> bytes{ 0 };
+std::atomic<std::size_t> count{ 0 };
+
+void
+record (std::size_t size) noexcept
+{
+  bytes.fetch_add (size, std::memory_order_relaxed);
+  count.fetch_add (1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+namespace patrick::bench
+{
+
+[[nodiscard]] std::size_t
+allocated_bytes () noexcept
+{
+  return bytes.load (std::memory_order_relaxed);
+}
+
+[[nodiscard]] std::size_t
+allocation_count () noexcept
+{
+  return count.load (std::memory_order_relaxed);
+}
+
+} // namespace patrick::bench
+
+#if defined(__GLIBC__)
+
+extern "C"
+{
+  void *__libc_malloc (std::size_t);
+  void *__libc_calloc (std::size_t, std::size_t);
+  void *__libc_realloc (void *, std::size_t);
+
+  void *
+  malloc (std::size_t size)
+  {
+    record (size);
+    return __libc_malloc (size);
+  }
+
+  void *
+  calloc (std::size_t num, std::size_t size)
+  {
+    record (num * size);
+    return __libc_calloc (num, size);
+  }
+
+  void *
+  realloc (void *ptr, std::size_t size)
+  {
+    record (size);
+    return __libc_realloc (ptr, size);
+  }
+}
+
+#else
+
+void *
+operator new (std::size_t size)
+{
+  record (size);
+  if (void *ptr = std::malloc (size == 0 ? 1 : size))
+    return ptr;
+  throw std::bad_alloc{};
+}
+
+void
+operator delete (void *ptr) noexcept
+{
+  std::free (ptr);
+}
+
+void
+operator delete (void *ptr, std::size_t) noexcept
+{
+  std::free (ptr);
+}
+
+#endif
@@ -0,0 +1,27 @@
+/// \file
+
+#ifndef PATRICK_BENCH_ALLOCATIONS_H_INCLUDED
+#define PATRICK_BENCH_ALLOCATIONS_H_INCLUDED
+
+#include <cstddef>
+
+namespace patrick::bench
+{
+
+///
+/// \brief The number of bytes which the process has allocated so far.
+/// \details With glibc, \c malloc, \c calloc and \c realloc are interposed,
+/// so that the buffers of Eigen are counted along with everything that
+/// <tt>operator new</tt> allocates. Elsewhere, only the global
+/// <tt>operator new</tt> is replaced.
+///
+[[nodiscard]] std::size_t allocated_bytes () noexcept;
+
+///
+/// \brief The number of allocations which the process has made so far.
+///
+[[nodiscard]] std::size_t allocation_count () noexcept;
+
+} // namespace patrick::bench
+
+#endif // PATRICK_BENCH_ALLOCATIONS_H_INCLUDED
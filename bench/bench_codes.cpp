@@ -0,0 +1,305 @@
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <fmt/core.h>
+
+#include <patrick/core.h>
+
+#include "allocations.h"
+
+using namespace patrick;
+
+namespace
+{
+
+///
+/// \brief A code whose operations are measured.
+///
+struct preset
+{
+  std::string name;
+  std::function<linearcode ()> make;
+};
+
+///
+/// \brief A generic code with a generator \f$(I|A)\f$ for a random
+/// \f$A\f$, which is the same on every run.
+///
+linearcode
+random_code (std::size_t n, std::size_t k)
+{
+  std::mt19937_64 gen{ n * 1000 + k };
+  Eigen::MatrixXi generator = Eigen::MatrixXi::Zero (k, n);
+  for (std::size_t i = 0; i < k; ++i)
+    {
+      generator (i, i) = 1;
+      for (std::size_t j = k; j < n; ++j)
+        generator (i, j) = gen () & 1;
+    }
+  return linearcode::from_generator (generator);
+}
+
+std::vector<preset>
+presets ()
+{
+  std::vector<preset> result{
+    { "hamming(3)", [] { return linearcode::hamming (3); } },
+    { "hamming(4)", [] { return linearcode::hamming (4); } },
+    { "bch(4,2)", [] { return linearcode::bch (4, 2); } },
+    { "golay24", [] { return linearcode::golay24 (); } },
+  };
+  for (std::size_t n = 8; n <= 24; n += 4)
+    result.push_back ({ fmt::format ("random({},{})", n, n / 2),
+                        [n] { return random_code (n, n / 2); } });
+  return result;
+}
+
+///
+/// \return Whether the tables of \a code may be built in a few seconds.
+/// Both searches of the coset leaders scan all \f$2^n\f$ words for every
+/// one of the \f$2^{n - k}\f$ cosets.
+///
+bool
+has_tables (const linearcode &code)
+{
+  const auto &properties = code.properties ();
+  return 2 * properties.word_size - properties.basis_size <= 26;
+}
+
+///
+/// \brief Random words of a given size, which the measured operations
+/// cycle through.
+///
+template <typename Tag>
+std::vector<details::word<Tag> >
+random_words (std::size_t size, std::size_t count = 256)
+{
+  std::mt19937_64 gen{ size };
+  std::vector<details::word<Tag> > words;
+  for (std::size_t i = 0; i < count; ++i)
+    {
+      Eigen::RowVectorXi vec (size);
+      for (std::size_t j = 0; j < size; ++j)
+        vec (j) = gen () & 1;
+      words.emplace_back (std::move (vec));
+    }
+  return words;
+}
+
+///
+/// \brief Codewords of \a code with at most as many errors as it corrects,
+/// so that every decoder succeeds on them.
+///
+std::vector<codeword>
+correctable_words (const linearcode &code, std::size_t count = 256)
+{
+  const auto &properties = code.properties ();
+  std::mt19937_64 gen{ properties.word_size };
+  std::vector<codeword> words;
+  for (const auto &iword : random_words<details::infoword_tag> (
+           properties.basis_size, count))
+    {
+      auto cword = code.encode (iword);
+      for (std::size_t e = 0; e < properties.max_errors_correct; ++e)
+        cword.vec (gen () % properties.word_size) ^= 1;
+      words.push_back (std::move (cword));
+    }
+  return words;
+}
+
+///
+/// \brief Reports the throughput and the allocations of every operation.
+///
+void
+report (benchmark::State &state, std::size_t bytes, std::size_t allocations,
+        std::size_t words_per_iteration = 1)
+{
+  state.SetItemsProcessed (state.iterations () * words_per_iteration);
+  state.counters["bytes_per_op"] = benchmark::Counter (
+      double (bytes), benchmark::Counter::kAvgIterations);
+  state.counters["allocs_per_op"] = benchmark::Counter (
+      double (allocations), benchmark::Counter::kAvgIterations);
+}
+
+///
+/// \brief Measures \a op on the words of \a words in turn.
+///
+template <typename Word, typename Operation>
+void
+measure (benchmark::State &state, const std::vector<Word> &words,
+         Operation op)
+{
+  const std::size_t bytes = bench::allocated_bytes ();
+  const std::size_t allocations = bench::allocation_count ();
+  std::size_t i = 0;
+  for (auto _ : state)
+    {
+      benchmark::DoNotOptimize (op (words[i]));
+      i = (i + 1) % words.size ();
+    }
+  report (state, bench::allocated_bytes () - bytes,
+          bench::allocation_count () - allocations);
+}
+
+///
+/// \brief Measures building a table of a new code on every iteration.
+///
+template <typename Build>
+void
+measure_build (benchmark::State &state, const preset &p, Build build)
+{
+  std::size_t bytes = 0;
+  std::size_t allocations = 0;
+  for (auto _ : state)
+    {
+      state.PauseTiming ();
+      const auto code = p.make ();
+      const std::size_t bytes_before = bench::allocated_bytes ();
+      const std::size_t allocations_before = bench::allocation_count ();
+      state.ResumeTiming ();
+
+      build (code);
+
+      state.PauseTiming ();
+      bytes += bench::allocated_bytes () - bytes_before;
+      allocations += bench::allocation_count () - allocations_before;
+      state.ResumeTiming ();
+    }
+  report (state, bytes, allocations);
+}
+
+///
+/// Benchmarks
+///
+
+void
+bench_encode (benchmark::State &state, const preset &p)
+{
+  const auto code = p.make ();
+  measure (state,
+           random_words<details::infoword_tag> (code.properties ().basis_size),
+           [&code] (const infoword &iword) { return code.encode (iword); });
+}
+
+void
+bench_syndrome_of (benchmark::State &state, const preset &p)
+{
+  const auto code = p.make ();
+  measure (state,
+           random_words<details::codeword_tag> (code.properties ().word_size),
+           [&code] (const codeword &cword) {
+             return code.syndrome_of (cword);
+           });
+}
+
+void
+bench_contains (benchmark::State &state, const preset &p)
+{
+  const auto code = p.make ();
+  measure (state,
+           random_words<details::codeword_tag> (code.properties ().word_size),
+           [&code] (const codeword &cword) { return code.contains (cword); });
+}
+
+template <linearcode::decoding_strategy Strategy>
+void
+bench_decode (benchmark::State &state, const preset &p)
+{
+  linearcode code = p.make ();
+  const auto words = correctable_words (code);
+  // The tables are built before the measurement.
+  (void)code.decode<Strategy> (words.front ());
+  measure (state, words, [&code] (const codeword &cword) {
+    return code.decode<Strategy> (cword);
+  });
+}
+
+void
+bench_decode_batch (benchmark::State &state, const preset &p)
+{
+  auto code = p.make ();
+  const std::size_t count = 256;
+  const std::size_t stride
+      = details::bitmatrix::blocks_for (code.properties ().word_size);
+  std::vector<std::uint64_t> received (count * stride);
+  std::vector<std::uint64_t> decoded (
+      count * details::bitmatrix::blocks_for (code.properties ().basis_size));
+  const auto words = correctable_words (code, count);
+  for (std::size_t w = 0; w < count; ++w)
+    details::pack (words[w], received.data () + w * stride);
+  (void)code.decode_batch (received, decoded, 1);
+
+  const std::size_t bytes = bench::allocated_bytes ();
+  const std::size_t allocations = bench::allocation_count ();
+  for (auto _ : state)
+    {
+      benchmark::DoNotOptimize (code.decode_batch (received, decoded, count));
+      benchmark::ClobberMemory ();
+    }
+  report (state, bench::allocated_bytes () - bytes,
+          bench::allocation_count () - allocations, count);
+}
+
+void
+bench_build_slepian_table (benchmark::State &state, const preset &p)
+{
+  measure_build (state, p, [] (const linearcode &code) {
+    benchmark::DoNotOptimize (code.slepian_table ());
+  });
+}
+
+void
+bench_build_syndrome_table (benchmark::State &state, const preset &p)
+{
+  measure_build (state, p, [] (const linearcode &code) {
+    benchmark::DoNotOptimize (code.syndrome_table ());
+  });
+}
+
+} // namespace
+
+int
+main (int argc, char **argv)
+{
+  using enum linearcode::decoding_strategy;
+  using bench_type = void (*) (benchmark::State &, const preset &);
+  const std::pair<std::string_view, bench_type> everywhere[]{
+    { "encode", bench_encode },
+    { "syndrome_of", bench_syndrome_of },
+    { "contains", bench_contains },
+  };
+  const std::pair<std::string_view, bench_type> with_tables[]{
+    { "decode<SlepyanTable>", bench_decode<SlepyanTable> },
+    { "decode<Syndromes>", bench_decode<Syndromes> },
+    { "decode_batch", bench_decode_batch },
+    { "build_slepian_table", bench_build_slepian_table },
+    { "build_syndrome_table", bench_build_syndrome_table },
+  };
+
+  for (const auto &p : presets ())
+    {
+      const auto code = p.make ();
+      const std::string suffix
+          = fmt::format ("{}[{},{}]", p.name, code.properties ().word_size,
+                         code.properties ().basis_size);
+      for (const auto &[op, bench] : everywhere)
+        benchmark::RegisterBenchmark (
+            fmt::format ("{}/{}", op, suffix).c_str (), bench, p);
+      if (!has_tables (code))
+        continue;
+      for (const auto &[op, bench] : with_tables)
+        benchmark::RegisterBenchmark (
+            fmt::format ("{}/{}", op, suffix).c_str (), bench, p);
+    }
+
+  benchmark::Initialize (&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments (argc, argv))
+    return 1;
+  benchmark::RunSpecifiedBenchmarks ();
+  benchmark::Shutdown ();
+  return 0;
+}
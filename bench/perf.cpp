@@ -0,0 +1,529 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include <fmt/core.h>
+#include <fmt/os.h>
+
+#include <patrick/core.h>
+#include <patrick/simulation.h>
+
+using namespace patrick;
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+///
+/// \brief The measurements of a single scenario. They are written as a row
+/// of the CSV report and an object of the JSON one.
+///
+struct result
+{
+  std::string name;
+  std::string code;
+  std::size_t word_size{ 0 };
+  std::size_t basis_size{ 0 };
+  std::string strategy;
+  std::size_t batch_size{ 1 };
+  std::size_t threads{ 1 };
+
+  ///
+  /// \brief Decoded words (or simulated frames) per second.
+  ///
+  double throughput{ 0 };
+
+  ///
+  /// \brief The percentiles of the time of a single call - of a word, a
+  /// batch or a whole simulation.
+  ///
+  double p50_ns{ 0 };
+  double p99_ns{ 0 };
+
+  ///
+  /// \brief The peak resident set of the process once the scenario is done.
+  /// It never decreases, so it is the most that any scenario so far needed.
+  ///
+  std::size_t peak_rss_kib{ 0 };
+
+  ///
+  /// \brief \ref linearcode::cache_bytes once the scenario is done.
+  ///
+  std::size_t table_bytes{ 0 };
+
+  ///
+  /// \brief The throughput relative to the one of the same simulation on a
+  /// single thread.
+  ///
+  double speedup{ 1 };
+};
+
+struct options_type
+{
+  bool quick{ false };
+  std::string json_path;
+  std::string csv_path;
+  std::string baseline_path;
+  double threshold{ 0.1 };
+};
+
+struct preset
+{
+  std::string_view name;
+  linearcode (*make) ();
+};
+
+///
+/// \brief The codes the scenarios run on. The generic ones have the
+/// generators of their families, but are decoded like any code without
+/// structure - with the tables, which must be affordable.
+///
+constexpr preset presets[]{
+  { "hamming(4)", [] { return linearcode::hamming (4); } },
+  { "bch(4,2)", [] { return linearcode::bch (4, 2); } },
+  { "bch(5,2)", [] { return linearcode::bch (5, 2); } },
+  { "golay24", [] { return linearcode::golay24 (); } },
+  { "reed_muller(1,5)", [] { return linearcode::reed_muller (1, 5); } },
+  { "generic(hamming(4))",
+    [] {
+      return linearcode::from_generator (
+          linearcode::hamming (4).generator_matrix ());
+    } },
+  { "generic(bch(4,2))",
+    [] {
+      return linearcode::from_generator (
+          linearcode::bch (4, 2).generator_matrix ());
+    } },
+};
+
+constexpr std::size_t batch_sizes[]{ 1, 64, 1024 };
+
+///
+/// \return Whether the syndrome table of \a code is small enough to be
+/// held, which is what \ref linearcode::decode_batch asks of its packed
+/// table too.
+///
+bool
+has_syndrome_table (const linearcode &code)
+{
+  const auto &properties = code.properties ();
+  return properties.word_size - properties.basis_size
+         <= linearcode::max_packed_table_redundancy;
+}
+
+[[nodiscard]] std::size_t
+peak_rss_kib () noexcept
+{
+#if defined(__unix__) || defined(__APPLE__)
+  rusage usage{};
+  if (getrusage (RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+[[nodiscard]] double
+percentile (std::vector<double> &samples, double fraction)
+{
+  if (samples.empty ())
+    return 0;
+  const auto nth = samples.begin ()
+                   + std::size_t (fraction * (samples.size () - 1) + 0.5);
+  std::nth_element (samples.begin (), nth, samples.end ());
+  return *nth;
+}
+
+///
+/// \brief Codewords of \a code with at most as many errors as it corrects,
+/// so that every decoder succeeds on them.
+///
+std::vector<codeword>
+correctable_words (const linearcode &code, std::size_t count)
+{
+  const auto &properties = code.properties ();
+  std::mt19937_64 gen{ properties.word_size };
+  std::vector<codeword> words;
+  words.reserve (count);
+  for (std::size_t i = 0; i < count; ++i)
+    {
+      Eigen::RowVectorXi vec (properties.basis_size);
+      for (std::size_t j = 0; j < properties.basis_size; ++j)
+        vec (j) = gen () & 1;
+      auto cword = code.encode (infoword{ std::move (vec) });
+      for (std::size_t e = 0; e < properties.max_errors_correct; ++e)
+        cword.vec (gen () % properties.word_size) ^= 1;
+      words.push_back (std::move (cword));
+    }
+  return words;
+}
+
+result
+describe (const preset &p, const linearcode &code, std::string name,
+          std::string strategy)
+{
+  return { .name = std::move (name),
+           .code = std::string{ p.name },
+           .word_size = code.properties ().word_size,
+           .basis_size = code.properties ().basis_size,
+           .strategy = std::move (strategy) };
+}
+
+///
+/// \brief Times the decoding of every word on its own.
+///
+template <linearcode::decoding_strategy Strategy>
+result
+run_decode (const preset &p, std::string_view strategy,
+            const options_type &options)
+{
+  linearcode code = p.make ();
+  auto r = describe (p, code, fmt::format ("decode/{}/{}", strategy, p.name),
+                     std::string{ strategy });
+  const std::size_t count = options.quick ? 2000 : 20000;
+  const auto words = correctable_words (code, 256);
+  // The tables are built before the measurement.
+  (void)code.decode<Strategy> (words.front ());
+
+  std::vector<double> samples;
+  samples.reserve (count);
+  double total = 0;
+  for (std::size_t i = 0; i < count; ++i)
+    {
+      const auto start = clock_type::now ();
+      const auto decoded = code.decode<Strategy> (words[i % words.size ()]);
+      const std::chrono::duration<double, std::nano> elapsed
+          = clock_type::now () - start;
+      samples.push_back (elapsed.count ());
+      total += elapsed.count ();
+      (void)decoded;
+    }
+  r.throughput = count / (total * 1e-9);
+  r.p50_ns = percentile (samples, 0.5);
+  r.p99_ns = percentile (samples, 0.99);
+  r.peak_rss_kib = peak_rss_kib ();
+  r.table_bytes = code.cache_bytes ();
+  return r;
+}
+
+result
+run_decode_batch (const preset &p, std::size_t batch_size,
+                  const options_type &options)
+{
+  linearcode code = p.make ();
+  auto r = describe (p, code,
+                     fmt::format ("decode_batch/{}/{}", p.name, batch_size),
+                     "batch");
+  r.batch_size = batch_size;
+
+  const std::size_t stride
+      = details::bitmatrix::blocks_for (code.properties ().word_size);
+  std::vector<std::uint64_t> received (batch_size * stride);
+  std::vector<std::uint64_t> decoded (
+      batch_size
+      * details::bitmatrix::blocks_for (code.properties ().basis_size));
+  const auto words = correctable_words (code, batch_size);
+  for (std::size_t w = 0; w < batch_size; ++w)
+    details::pack (words[w], received.data () + w * stride);
+  (void)code.decode_batch (received, decoded, 1);
+
+  const std::size_t num_words = options.quick ? 20000 : 200000;
+  const std::size_t count = std::max<std::size_t> (num_words / batch_size, 20);
+  std::vector<double> samples;
+  samples.reserve (count);
+  double total = 0;
+  for (std::size_t i = 0; i < count; ++i)
+    {
+      const auto start = clock_type::now ();
+      (void)code.decode_batch (received, decoded, batch_size);
+      const std::chrono::duration<double, std::nano> elapsed
+          = clock_type::now () - start;
+      samples.push_back (elapsed.count ());
+      total += elapsed.count ();
+    }
+  r.throughput = count * batch_size / (total * 1e-9);
+  r.p50_ns = percentile (samples, 0.5);
+  r.p99_ns = percentile (samples, 0.99);
+  r.peak_rss_kib = peak_rss_kib ();
+  r.table_bytes = code.cache_bytes ();
+  return r;
+}
+
+result
+run_simulation (const preset &p, std::size_t threads,
+                const options_type &options)
+{
+  const simulation_options sim_options{
+    .max_frames = options.quick ? 20'000u : 200'000u,
+    .target_frame_errors = 0,
+    .num_threads = threads,
+    .seed = 1,
+  };
+  simulation sim{ p.make (), sim_options };
+  auto r = describe (p, sim.code (),
+                     fmt::format ("simulation/{}/{}", p.name, threads),
+                     "simulation");
+  r.batch_size = sim_options.batch_size;
+  r.threads = threads;
+
+  const std::size_t repetitions = options.quick ? 3 : 5;
+  std::vector<double> samples;
+  for (std::size_t i = 0; i < repetitions; ++i)
+    {
+      const auto start = clock_type::now ();
+      (void)sim.run (0.01);
+      const std::chrono::duration<double, std::nano> elapsed
+          = clock_type::now () - start;
+      samples.push_back (elapsed.count ());
+    }
+  r.p50_ns = percentile (samples, 0.5);
+  r.p99_ns = percentile (samples, 0.99);
+  r.throughput = sim_options.max_frames / (r.p50_ns * 1e-9);
+  r.peak_rss_kib = peak_rss_kib ();
+  r.table_bytes = sim.code ().cache_bytes ();
+  return r;
+}
+
+///
+/// \brief Runs the whole scenario matrix, printing every result as soon as
+/// it is known.
+///
+std::vector<result>
+run_all (const options_type &options)
+{
+  using enum linearcode::decoding_strategy;
+  std::vector<result> results;
+  const auto add = [&results] (result r) {
+    fmt::print ("{:<36} {:>14.0f} words/s  p50 {:>12.0f} ns  p99 {:>12.0f} "
+                "ns  rss {:>8} KiB  tables {:>10} B\n",
+                r.name, r.throughput, r.p50_ns, r.p99_ns, r.peak_rss_kib,
+                r.table_bytes);
+    std::fflush (stdout);
+    results.push_back (std::move (r));
+  };
+
+  for (const auto &p : presets)
+    {
+      // A generic code is decoded with the Slepian table by default, which
+      // is only affordable where the syndrome table is.
+      const auto code = p.make ();
+      if (code.family ().kind != linearcode::code_family::Generic)
+        add (run_decode<Auto> (p, "auto", options));
+      if (has_syndrome_table (code))
+        add (run_decode<Syndromes> (p, "syndromes", options));
+      for (const std::size_t batch_size : batch_sizes)
+        add (run_decode_batch (p, batch_size, options));
+    }
+
+  std::vector<std::size_t> thread_counts{ 1, 2, 4 };
+  const std::size_t hardware = std::thread::hardware_concurrency ();
+  if (hardware > 4)
+    thread_counts.push_back (hardware);
+  for (const auto &name : { "generic(hamming(4))", "golay24" })
+    {
+      const auto &p = *std::find_if (
+          std::begin (presets), std::end (presets),
+          [name] (const preset &q) { return q.name == name; });
+      double single = 0;
+      for (const std::size_t threads : thread_counts)
+        {
+          auto r = run_simulation (p, threads, options);
+          if (threads == 1)
+            single = r.throughput;
+          r.speedup = r.throughput / single;
+          add (std::move (r));
+        }
+    }
+  return results;
+}
+
+void
+write_csv (const std::string &path, const std::vector<result> &results)
+{
+  auto out = fmt::output_file (path);
+  out.print ("name,code,n,k,strategy,batch_size,threads,throughput,p50_ns,"
+             "p99_ns,peak_rss_kib,table_bytes,speedup\n");
+  for (const auto &r : results)
+    out.print ("\"{}\",\"{}\",{},{},{},{},{},{:.1f},{:.1f},{:.1f},{},{},"
+               "{:.3f}\n",
+               r.name, r.code, r.word_size, r.basis_size, r.strategy,
+               r.batch_size, r.threads, r.throughput, r.p50_ns, r.p99_ns,
+               r.peak_rss_kib, r.table_bytes, r.speedup);
+}
+
+void
+write_json (const std::string &path, const std::vector<result> &results)
+{
+  auto out = fmt::output_file (path);
+  out.print ("{{\n  \"results\": [");
+  for (std::size_t i = 0; i < results.size (); ++i)
+    {
+      const auto &r = results[i];
+      out.print ("{}\n    {{ \"name\": \"{}\", \"code\": \"{}\", \"n\": {}, "
+                 "\"k\": {}, \"strategy\": \"{}\", \"batch_size\": {}, "
+                 "\"threads\": {}, \"throughput\": {:.1f}, \"p50_ns\": "
+                 "{:.1f}, \"p99_ns\": {:.1f}, \"peak_rss_kib\": {}, "
+                 "\"table_bytes\": {}, \"speedup\": {:.3f} }}",
+                 i == 0 ? "" : ",", r.name, r.code, r.word_size,
+                 r.basis_size, r.strategy, r.batch_size, r.threads,
+                 r.throughput, r.p50_ns, r.p99_ns, r.peak_rss_kib,
+                 r.table_bytes, r.speedup);
+    }
+  out.print ("\n  ]\n}}\n");
+}
+
+///
+/// \brief Reads a report written by \ref write_csv, by the names of its
+/// scenarios.
+///
+std::map<std::string, result>
+read_csv (const std::string &path)
+{
+  std::ifstream in{ path };
+  if (!in)
+    throw std::runtime_error{ fmt::format (
+        "patrick: Cannot read the baseline '{}'.", path) };
+
+  std::map<std::string, result> baseline;
+  std::string line;
+  std::getline (in, line);
+  while (std::getline (in, line))
+    {
+      // The names are quoted, since the ones of the codes have commas.
+      std::vector<std::string> fields (1);
+      bool quoted = false;
+      for (const char c : line)
+        if (c == '"')
+          quoted = !quoted;
+        else if (c == ',' && !quoted)
+          fields.emplace_back ();
+        else
+          fields.back () += c;
+      if (fields.size () < 13)
+        continue;
+      result r;
+      r.name = fields[0];
+      r.throughput = std::stod (fields[7]);
+      r.p50_ns = std::stod (fields[8]);
+      r.p99_ns = std::stod (fields[9]);
+      r.peak_rss_kib = std::stoull (fields[10]);
+      r.table_bytes = std::stoull (fields[11]);
+      baseline.emplace (r.name, std::move (r));
+    }
+  return baseline;
+}
+
+///
+/// \brief Compares the results with a baseline. A scenario regresses if
+/// its throughput drops, or its median time or its tables grow, by more
+/// than \a threshold of the baseline. The tail and the resident set are
+/// too noisy to be judged, so they are only reported.
+/// \return The number of regressions.
+///
+std::size_t
+compare (const std::vector<result> &results,
+         const std::map<std::string, result> &baseline, double threshold)
+{
+  std::size_t regressions = 0;
+  const auto check = [&] (const result &r, std::string_view metric,
+                          double before, double after, bool lower_is_worse) {
+    if (before <= 0)
+      return;
+    const double change = (after - before) / before;
+    if (lower_is_worse ? change < -threshold : change > threshold)
+      {
+        fmt::print ("REGRESSION {}: {} {:.1f} -> {:.1f} ({:+.1f}%)\n", r.name,
+                    metric, before, after, 100 * change);
+        ++regressions;
+      }
+  };
+
+  for (const auto &r : results)
+    {
+      const auto it = baseline.find (r.name);
+      if (it == baseline.end ())
+        {
+          fmt::print ("new scenario {}\n", r.name);
+          continue;
+        }
+      const auto &base = it->second;
+      check (r, "throughput", base.throughput, r.throughput, true);
+      check (r, "p50_ns", base.p50_ns, r.p50_ns, false);
+      check (r, "table_bytes", base.table_bytes, r.table_bytes, false);
+    }
+  fmt::print ("{} regressions past {:.0f}% against {} baseline scenarios\n",
+              regressions, 100 * threshold, baseline.size ());
+  return regressions;
+}
+
+void
+usage (const char *program)
+{
+  fmt::print (stderr,
+              "usage: {} [--quick] [--json FILE] [--csv FILE] "
+              "[--baseline FILE] [--threshold FRACTION]\n"
+              "The baseline is a report written with --csv. The exit status "
+              "is 1 if a scenario\nregressed past the threshold (0.1 by "
+              "default).\n",
+              program);
+}
+
+} // namespace
+
+int
+main (int argc, char **argv)
+{
+  options_type options;
+  for (int i = 1; i < argc; ++i)
+    {
+      const std::string_view arg{ argv[i] };
+      const bool has_value = i + 1 < argc;
+      if (arg == "--quick")
+        options.quick = true;
+      else if (arg == "--json" && has_value)
+        options.json_path = argv[++i];
+      else if (arg == "--csv" && has_value)
+        options.csv_path = argv[++i];
+      else if (arg == "--baseline" && has_value)
+        options.baseline_path = argv[++i];
+      else if (arg == "--threshold" && has_value)
+        options.threshold = std::stod (argv[++i]);
+      else
+        {
+          usage (argv[0]);
+          return 2;
+        }
+    }
+
+  // Read the baseline first, so that a wrong path fails fast.
+  std::map<std::string, result> baseline;
+  if (!options.baseline_path.empty ())
+    baseline = read_csv (options.baseline_path);
+
+  const auto results = run_all (options);
+  if (!options.csv_path.empty ())
+    write_csv (options.csv_path, results);
+  if (!options.json_path.empty ())
+    write_json (options.json_path, results);
+  if (!options.baseline_path.empty ()
+      && compare (results, baseline, options.threshold) > 0)
+    return 1;
+  return 0;
+}
@@ -15,6 +15,7 @@ conan_cmake_configure(
         gtest/1.13.0
         eigen/3.4.0
         fmt/10.0.0
+        benchmark/1.8.0
     OPTIONS gtest:shared=False
     GENERATORS cmake_find_package)
 
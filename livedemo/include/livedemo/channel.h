@@ -4,7 +4,10 @@
 #define LIVEDEMO_CHANNEL_H_INCLUDED
 
 #include <optional>
+#include <random>
 
+#include <patrick/batch.h>
+#include <patrick/channel.h>
 #include <patrick/core.h>
 
 namespace livedemo
@@ -44,11 +47,61 @@ public:
   virtual double crossover_probability () const noexcept = 0;
 };
 
+///
+/// \brief Base class of the channels whose noise corrupts packed bits in
+/// place. It implements \ref channel::transfer and a batch transfer on top
+/// of the noise of \a Derived, which it reaches with no virtual calls.
+/// \tparam Derived Has a `noise ()` member, which returns a \ref
+/// patrick::packed_channel.
+///
+template <typename Derived> class packed_noise_channel : public channel
+{
+public:
+  [[nodiscard]] std::optional<patrick::linearcode::decoding_result>
+  transfer (const infoword_type &sent, patrick::linearcode &code) override
+  {
+    try
+      {
+        auto &noise = derived ().noise ();
+        return code.decode (noise.transmit (code.encode (sent)));
+      }
+    catch (const patrick::linearcode_exception &le)
+      {
+        return std::nullopt;
+      }
+  }
+
+  ///
+  /// \brief Sends a batch of packed infowords and decodes them.
+  /// \see patrick::transfer_batch
+  ///
+  std::size_t
+  transfer_batch (patrick::linearcode &code,
+                  std::span<const std::uint64_t> infowords,
+                  std::span<std::uint64_t> decoded, std::size_t count)
+  {
+    return patrick::transfer_batch (code, derived ().noise (), infowords,
+                                    decoded, count, m_workspace);
+  }
+
+private:
+  Derived &
+  derived () noexcept
+  {
+    return static_cast<Derived &> (*this);
+  }
+
+  patrick::batch_workspace m_workspace;
+};
+
 ///
 /// \brief Binary symmetric channel mock.
 ///
-class binary_symm_channel final : public channel
+class binary_symm_channel final
+    : public packed_noise_channel<binary_symm_channel>
 {
+  friend packed_noise_channel<binary_symm_channel>;
+
 public:
   ///
   /// Helpers
@@ -62,7 +115,54 @@ public:
   ///
   /// Special member functions
   ///
-  explicit binary_symm_channel (double p = 0.3) : m_crossover_probability{ p }
+  explicit binary_symm_channel (double p = 0.3,
+                                std::uint64_t seed = std::random_device{}())
+      : m_capacity{ evaluate_capacity (p) }, m_noise{ p, seed }
+  {
+  }
+
+private:
+  patrick::binary_symmetric_channel &
+  noise () noexcept
+  {
+    return m_noise;
+  }
+
+public:
+  ///
+  /// Properties
+  ///
+
+  [[nodiscard]] double
+  capacity () const noexcept
+  {
+    return m_capacity;
+  }
+
+  [[nodiscard]] double
+  crossover_probability () const noexcept override
+  {
+    return m_noise.crossover_probability ();
+  }
+
+private:
+  double m_capacity{ 0 };
+  patrick::binary_symmetric_channel m_noise;
+};
+
+///
+/// \brief AWGN channel with BPSK modulation, whose words are decoded from
+/// the soft ratios of their bits.
+///
+class awgn_channel final : public channel
+{
+public:
+  ///
+  /// Special member functions
+  ///
+  explicit awgn_channel (double noise_deviation = 0.5,
+                         std::uint64_t seed = std::random_device{}())
+      : m_noise{ noise_deviation, seed }
   {
   }
 
@@ -76,9 +176,8 @@ public:
   {
     try
       {
-        codeword_type encoded = code.encode (sent);
-        with_noise (encoded);
-        return code.decode (encoded);
+        const auto llrs = m_noise.transmit (code.encode (sent));
+        return code.decode_soft (llrs);
       }
     catch (const patrick::linearcode_exception &le)
       {
@@ -86,10 +185,49 @@ public:
       }
   }
 
+public:
+  ///
+  /// Properties
+  ///
+
+  ///
+  /// \brief The probability that the hard decision of a bit is wrong.
+  ///
+  [[nodiscard]] double
+  crossover_probability () const noexcept override
+  {
+    const double sigma = m_noise.noise_deviation ();
+    return 0.5 * std::erfc (1 / (sigma * std::sqrt (2.0)));
+  }
+
+private:
+  patrick::awgn_channel m_noise;
+};
+
+///
+/// \brief Gilbert-Elliott channel, whose errors come in bursts.
+///
+class burst_channel final : public packed_noise_channel<burst_channel>
+{
+  friend packed_noise_channel<burst_channel>;
+
+public:
+  ///
+  /// Special member functions
+  ///
+  explicit burst_channel (
+      patrick::gilbert_elliott_channel::parameters_type parameters
+      = { .good_to_bad = 0.01, .bad_to_good = 0.1, .bad_error = 0.5 },
+      std::uint64_t seed = std::random_device{}())
+      : m_noise{ parameters, seed }
+  {
+  }
+
 private:
-  void
-  with_noise (codeword_type &)
+  patrick::gilbert_elliott_channel &
+  noise () noexcept
   {
+    return m_noise;
   }
 
 public:
@@ -98,20 +236,66 @@ public:
   ///
 
   [[nodiscard]] double
-  capacity () const noexcept
+  crossover_probability () const noexcept override
   {
-    return m_capacity;
+    return m_noise.crossover_probability ();
   }
 
+private:
+  patrick::gilbert_elliott_channel m_noise;
+};
+
+///
+/// \brief Binary erasure channel, whose words are decoded from the bits
+/// which are not erased.
+///
+class erasure_channel final : public channel
+{
+public:
+  ///
+  /// Special member functions
+  ///
+  explicit erasure_channel (double erasure_probability = 0.1,
+                            std::uint64_t seed = std::random_device{}())
+      : m_noise{ erasure_probability, seed }
+  {
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  [[nodiscard]] std::optional<patrick::linearcode::decoding_result>
+  transfer (const infoword_type &sent, patrick::linearcode &code) override
+  {
+    try
+      {
+        const auto [word, erasures] = m_noise.transmit (code.encode (sent));
+        return code.decode_erasures (word, erasures);
+      }
+    catch (const patrick::linearcode_exception &le)
+      {
+        return std::nullopt;
+      }
+  }
+
+public:
+  ///
+  /// Properties
+  ///
+
+  ///
+  /// \brief The erased bits are received as 0, so half of them are wrong.
+  ///
   [[nodiscard]] double
   crossover_probability () const noexcept override
   {
-    return m_crossover_probability;
+    return m_noise.erasure_probability () / 2;
   }
 
 private:
-  double m_capacity;
-  double m_crossover_probability;
+  patrick::binary_erasure_channel m_noise;
 };
 
 ///
@@ -134,6 +134,7 @@ bool transfer_through_channel (command_line &);
 
 bool unload_code (command_line &);
 bool load_code (command_line &);
+bool load_family (command_line &);
 bool encode (command_line &);
 bool decode (command_line &);
 
@@ -143,6 +144,8 @@ bool show_codewords (command_line &);
 bool show_generator (command_line &);
 bool show_parity (command_line &);
 
+bool trace (command_line &);
+
 bool exit (command_line &);
 bool help (command_line &);
 
@@ -1,12 +1,16 @@
+#include <cmath>
+
 #include <livedemo/channel.h>
 
 namespace livedemo
 {
 
 double
-binary_symm_channel::binary_entropy_function (double)
+binary_symm_channel::binary_entropy_function (double p)
 {
-  return 0.;
+  if (p <= 0 || p >= 1)
+    return 0.;
+  return -p * std::log2 (p) - (1 - p) * std::log2 (1 - p);
 }
 
 double
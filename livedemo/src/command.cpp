@@ -5,6 +5,7 @@
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 #include <patrick/core.h>
+#include <patrick/trace.h>
 
 #include <livedemo/command.h>
 
@@ -84,6 +85,43 @@ load_code (command_line &l)
   return false;
 }
 
+bool
+load_family (command_line &l)
+{
+  std::string family;
+  l.in () >> family;
+  try
+    {
+      if (family == "hamming")
+        {
+          std::size_t r;
+          l.in () >> r;
+          l.set_code (linearcode::hamming (r));
+        }
+      else if (family == "bch")
+        {
+          std::size_t m, t;
+          l.in () >> m >> t;
+          l.set_code (linearcode::bch (m, t));
+        }
+      else if (family == "golay24")
+        l.set_code (linearcode::golay24 ());
+      else if (family == "reed_muller")
+        {
+          std::size_t r, m;
+          l.in () >> r >> m;
+          l.set_code (linearcode::reed_muller (r, m));
+        }
+      else
+        l.out () << "Error: Trying to load unknown code family.\n";
+    }
+  catch (const linearcode_exception &le)
+    {
+      l.out () << fmt::format ("Error: {}\n", le.what ());
+    }
+  return false;
+}
+
 bool
 unload_code (command_line &l)
 {
@@ -201,6 +239,12 @@ set_channel (command_line &l)
     {
       l.set_channel (binary_symm_channel{});
     }
+  else if (channel_name == "awgn")
+    l.set_channel (awgn_channel{});
+  else if (channel_name == "burst")
+    l.set_channel (burst_channel{});
+  else if (channel_name == "erasure")
+    l.set_channel (erasure_channel{});
   else if (channel_name == "lossless")
     l.set_channel (lossless_channel{});
   else
@@ -238,6 +282,29 @@ exit (command_line &)
   return true;
 }
 
+bool
+trace (command_line &l)
+{
+  std::string path;
+  l.in () >> path;
+  if (path == "off")
+    {
+      set_trace_sink (nullptr);
+      l.out () << "Success: Tracing is off.\n";
+      return false;
+    }
+  try
+    {
+      set_trace_sink (std::make_shared<chrome_trace_sink> (path));
+      l.out () << fmt::format ("Success: Tracing to '{}'.\n", path);
+    }
+  catch (const trace_exception &te)
+    {
+      l.out () << fmt::format ("Error: {}\n", te.what ());
+    }
+  return false;
+}
+
 bool
 help (command_line &l)
 {
@@ -247,10 +314,12 @@ help (command_line &l)
   l.out () << "  props\n";
   l.out () << "  slepian_table\n";
   l.out () << "  load_code\n";
+  l.out () << "  load_family\n";
   l.out () << "  encode\n";
   l.out () << "  decode\n";
   l.out () << "  set_channel\n";
   l.out () << "  transfer_through_channel\n";
+  l.out () << "  trace <file>|off\n";
   return false;
 }
 
@@ -15,6 +15,7 @@ main ()
   cmdline.add_cmd ("set_channel", commands::set_channel);
   cmdline.add_cmd ("transfer", commands::transfer_through_channel);
   cmdline.add_cmd ("load", commands::load_code);
+  cmdline.add_cmd ("load_family", commands::load_family);
   cmdline.add_cmd ("unload", commands::unload_code);
   cmdline.add_cmd ("encode", commands::encode);
   cmdline.add_cmd ("decode", commands::decode);
@@ -23,6 +24,7 @@ main ()
   cmdline.add_cmd ("show_codewords", commands::show_codewords);
   cmdline.add_cmd ("show_generator", commands::show_generator);
   cmdline.add_cmd ("show_parity", commands::show_parity);
+  cmdline.add_cmd ("trace", commands::trace);
   cmdline.add_cmd ("exit", commands::exit);
   cmdline.add_cmd ("help", commands::help);
 
@@ -0,0 +1,77 @@
+/// \file
+
+#ifndef PATRICK_BATCH_H_INCLUDED
+#define PATRICK_BATCH_H_INCLUDED
+
+#include <concepts>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include <patrick/core.h>
+
+namespace patrick
+{
+
+///
+/// \brief A channel which corrupts packed bits in place, such as \ref
+/// binary_symmetric_channel and \ref gilbert_elliott_channel.
+///
+template <typename Channel>
+concept packed_channel
+    = requires (Channel &channel, std::span<std::uint64_t> bits,
+                std::size_t num_bits) { channel.corrupt (bits, num_bits); };
+
+///
+/// \class batch_workspace
+/// \brief The buffers of \ref transfer_batch. They keep their capacity from
+/// one batch to the next, so a workspace which is reused stops allocating
+/// once it has seen the largest batch.
+/// \details The buffers are allocated from the resource the workspace is
+/// created with, so that every thread may give its workspace an arena of
+/// its own.
+///
+struct batch_workspace
+{
+  explicit batch_workspace (std::pmr::memory_resource *resource
+                            = std::pmr::get_default_resource ())
+      : codewords{ resource }
+  {
+  }
+
+  std::pmr::vector<details::bitmatrix::block_type> codewords;
+};
+
+///
+/// \brief Encodes \a count packed infowords, sends their codewords through
+/// \a channel one after the other and decodes them, with \ref
+/// linearcode::encode_batch and \ref linearcode::decode_batch.
+/// \details The channel is a template parameter, so its noise is injected
+/// in the loop with no virtual calls.
+/// \return The number of words on which the decoder failed.
+///
+template <packed_channel Channel>
+std::size_t
+transfer_batch (linearcode &code, Channel &channel,
+                std::span<const details::bitmatrix::block_type> infowords,
+                std::span<details::bitmatrix::block_type> decoded,
+                std::size_t count, batch_workspace &workspace,
+                std::span<std::uint8_t> failures = {})
+{
+  const std::size_t n = code.properties ().word_size;
+  const std::size_t stride = details::bitmatrix::blocks_for (n);
+  workspace.codewords.resize (count * stride);
+  const std::span<details::bitmatrix::block_type> codewords{
+    workspace.codewords
+  };
+
+  code.encode_batch (infowords, codewords, count);
+  for (std::size_t w = 0; w < count; ++w)
+    channel.corrupt (codewords.subspan (w * stride, stride), n);
+  return code.decode_batch (codewords, decoded, count, failures);
+}
+
+} // namespace patrick
+
+#endif // PATRICK_BATCH_H_INCLUDED
@@ -0,0 +1,75 @@
+/// \file
+
+#ifndef PATRICK_BCH_H_INCLUDED
+#define PATRICK_BCH_H_INCLUDED
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <patrick/gf2m.h>
+#include <patrick/word.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+///
+/// \return The generator polynomial of the narrow-sense BCH code of length
+/// \f$2^{m} - 1\f$ which corrects \a t errors - the least common multiple
+/// of the minimal polynomials of \f$\alpha, \ldots, \alpha^{2t}\f$. Its
+/// coefficients are given from the constant term.
+///
+[[nodiscard]] std::vector<std::uint8_t>
+bch_generator_polynomial (const galois_field &field, std::size_t t);
+
+///
+/// \brief Evaluates the received polynomial \f$r(x)\f$ at
+/// \f$\alpha, \alpha^{2}, \ldots, \alpha^{2t}\f$.
+/// \details Only the odd syndromes are evaluated. The even ones follow from
+/// \f$S_{2j} = S_{j}^{2}\f$, which holds because \f$r(x)\f$ has binary
+/// coefficients.
+/// \return \f$S_{1}, \ldots, S_{2t}\f$.
+///
+[[nodiscard]] std::vector<galois_field::element_type>
+bch_syndromes (const galois_field &field, const codeword &received,
+               std::size_t t);
+
+///
+/// \brief Finds the error locator polynomial \f$\Lambda(x)\f$ - the shortest
+/// linear feedback shift register which generates the syndromes.
+/// \return The coefficients of \f$\Lambda(x)\f$, starting from the constant
+/// term, which is 1. Its degree is the number of errors, if they are
+/// correctable.
+///
+[[nodiscard]] std::vector<galois_field::element_type>
+berlekamp_massey (const galois_field &field,
+                  std::span<const galois_field::element_type> syndromes);
+
+///
+/// \brief Finds the positions \f$i < n\f$ for which
+/// \f$\Lambda(\alpha^{-i}) = 0\f$. Those are the positions of the errors.
+/// \details All positions are evaluated for one term of \f$\Lambda\f$ at a
+/// time, stepping the exponent of the term incrementally. On CPUs with AVX2,
+/// 8 positions are evaluated at once with gathers from the antilog table.
+///
+[[nodiscard]] std::vector<std::size_t>
+chien_search (const galois_field &field,
+              std::span<const galois_field::element_type> locator,
+              std::size_t n);
+
+///
+/// \brief The portable implementation of \ref chien_search.
+///
+[[nodiscard]] std::vector<std::size_t>
+chien_search_scalar (const galois_field &field,
+                     std::span<const galois_field::element_type> locator,
+                     std::size_t n);
+
+} // namespace details
+
+} // namespace patrick
+
+#endif // PATRICK_BCH_H_INCLUDED
@@ -0,0 +1,278 @@
+/// \file
+
+#ifndef PATRICK_BITMATRIX_H_INCLUDED
+#define PATRICK_BITMATRIX_H_INCLUDED
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <patrick/word.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+///
+/// \class bitmatrix
+/// \brief Dense matrix over \f$F_{2}\f$ whose rows are packed into 64-bit
+/// blocks.
+/// \details Column \f$j\f$ of a row lives in bit \f$j \bmod 64\f$ of block
+/// \f$\lfloor j / 64 \rfloor\f$. Every row occupies the same number of blocks
+/// (the \a stride) and the unused high bits of the last block are kept zero,
+/// so that whole rows can be XOR-ed, compared and hashed block by block.
+///
+class bitmatrix
+{
+public:
+  using block_type = std::uint64_t;
+  static constexpr std::size_t block_bits = 64;
+
+  ///
+  /// Constructors
+  ///
+
+  bitmatrix () = default;
+
+  ///
+  /// \brief Creates the zero matrix with the given dimensions.
+  ///
+  bitmatrix (std::size_t t_rows, std::size_t t_cols)
+      : m_rows{ t_rows }, m_cols{ t_cols }, m_stride{ blocks_for (t_cols) },
+        m_blocks (t_rows * blocks_for (t_cols), 0)
+  {
+  }
+
+  ///
+  /// \brief Packs an Eigen matrix. Every entry is taken mod 2.
+  ///
+  [[nodiscard]] static bitmatrix from_eigen (const Eigen::MatrixXi &m);
+
+  [[nodiscard]] static bitmatrix identity (std::size_t n);
+
+  [[nodiscard]] Eigen::MatrixXi to_eigen () const;
+
+  [[nodiscard]] static constexpr std::size_t
+  blocks_for (std::size_t num_bits) noexcept
+  {
+    return (num_bits + block_bits - 1) / block_bits;
+  }
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] std::size_t
+  rows () const noexcept
+  {
+    return m_rows;
+  }
+
+  [[nodiscard]] std::size_t
+  cols () const noexcept
+  {
+    return m_cols;
+  }
+
+  ///
+  /// \brief Number of blocks occupied by a single row.
+  ///
+  [[nodiscard]] std::size_t
+  stride () const noexcept
+  {
+    return m_stride;
+  }
+
+  [[nodiscard]] bool
+  get (std::size_t r, std::size_t c) const noexcept
+  {
+    return (row (r)[c / block_bits] >> (c % block_bits)) & 1u;
+  }
+
+  [[nodiscard]] block_type *
+  row (std::size_t r) noexcept
+  {
+    return m_blocks.data () + r * m_stride;
+  }
+
+  [[nodiscard]] const block_type *
+  row (std::size_t r) const noexcept
+  {
+    return m_blocks.data () + r * m_stride;
+  }
+
+  [[nodiscard]] bool
+  is_zero () const noexcept
+  {
+    return std::ranges::all_of (m_blocks,
+                                [] (const block_type b) { return b == 0; });
+  }
+
+  [[nodiscard]] bool operator== (const bitmatrix &) const noexcept = default;
+
+public:
+  ///
+  /// Operations
+  ///
+
+  void
+  set (std::size_t r, std::size_t c, bool value) noexcept
+  {
+    const block_type mask = block_type{ 1 } << (c % block_bits);
+    if (value)
+      row (r)[c / block_bits] |= mask;
+    else
+      row (r)[c / block_bits] &= ~mask;
+  }
+
+  void
+  flip (std::size_t r, std::size_t c) noexcept
+  {
+    row (r)[c / block_bits] ^= block_type{ 1 } << (c % block_bits);
+  }
+
+  ///
+  /// \brief Row \a dst becomes the sum of rows \a dst and \a src.
+  ///
+  void
+  xor_row (std::size_t dst, std::size_t src) noexcept
+  {
+    block_type *d = row (dst);
+    const block_type *s = row (src);
+    for (std::size_t b = 0; b < m_stride; ++b)
+      d[b] ^= s[b];
+  }
+
+  void swap_rows (std::size_t a, std::size_t b) noexcept;
+
+  ///
+  /// \brief Keeps only the first \a t_rows rows, or appends zero rows.
+  ///
+  void
+  resize_rows (std::size_t t_rows)
+  {
+    m_rows = t_rows;
+    m_blocks.resize (t_rows * m_stride, 0);
+  }
+
+  ///
+  /// \brief Creates a matrix out of the given columns, in the given order.
+  ///
+  [[nodiscard]] bitmatrix
+  select_columns (std::span<const std::size_t> columns) const;
+
+  ///
+  /// \brief Transposes the matrix tile by tile, using a 64x64 in-register
+  /// bit transpose for every tile.
+  ///
+  [[nodiscard]] bitmatrix transpose () const;
+
+private:
+  std::size_t m_rows{ 0 };
+  std::size_t m_cols{ 0 };
+  std::size_t m_stride{ 0 };
+  std::vector<block_type> m_blocks;
+};
+
+///
+/// \brief Hashes a packed row of bits block by block.
+///
+struct packed_row_hash
+{
+  [[nodiscard]] std::size_t
+  operator() (const std::vector<bitmatrix::block_type> &blocks) const noexcept
+  {
+    std::size_t seed = blocks.size ();
+    for (const bitmatrix::block_type b : blocks)
+      seed ^= std::hash<bitmatrix::block_type>{}(b) + 0x9e3779b97f4a7c15ull
+              + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+};
+
+///
+/// \brief Transposes a 64x64 bit matrix in place. Element \f$(i, j)\f$ is
+/// bit \f$j\f$ of \a tile[i].
+/// \details With AVX2, the stages which swap blocks of at least 4 rows are
+/// done on 4 rows at a time.
+///
+void transpose64 (bitmatrix::block_type *tile) noexcept;
+
+///
+/// \brief The portable implementation of \ref transpose64.
+///
+void transpose64_scalar (bitmatrix::block_type *tile) noexcept;
+
+///
+/// \brief Reduces \a m to reduced row echelon form over \f$F_{2}\f$.
+/// \details The reduction is done in the style of the _Method of Four
+/// Russians_ (M4RI): pivots are found in groups of up to 8 columns, a table
+/// with every combination of the group's pivot rows is built, and each of the
+/// remaining rows is then cleared on all of the group's columns with a single
+/// lookup and one row XOR.
+/// \return The pivot columns in increasing order. Their count is the rank of
+/// \a m. The first rank rows of \a m are the nonzero rows of the result.
+///
+std::vector<std::size_t> reduce_to_echelon_form (bitmatrix &m);
+
+///
+/// \brief Builds a basis of the orthogonal complement of the row space of
+/// \a m.
+/// \param columns A column order in which \a m is systematic, that is \a m
+/// is the identity matrix at columns `columns[0..m.rows ())`.
+/// \return A matrix with `m.cols () - m.rows ()` rows, which is the identity
+/// matrix at columns `columns[m.rows ()..m.cols ())`. If \a m is a generator
+/// matrix, the result is a parity matrix of the same code and vice versa.
+///
+[[nodiscard]] bitmatrix
+orthogonal_complement (const bitmatrix &m,
+                       std::span<const std::size_t> columns);
+
+///
+/// \brief Counts the vectors of each weight in the row space of \a basis.
+/// \details All \f$2^{k}\f$ combinations of the \f$k\f$ rows are visited in
+/// Gray code order, so every next vector costs a single row XOR.
+/// \return The weight distribution \f$A_{0}, \ldots, A_{n}\f$.
+///
+[[nodiscard]] std::vector<std::uint64_t>
+weight_distribution (const bitmatrix &basis);
+
+///
+/// \brief Packs the bits of \a w into \a out, which must have room for
+/// \ref bitmatrix::blocks_for `(w.vec.cols ())` blocks.
+///
+template <typename Tag>
+void
+pack (const word<Tag> &w, bitmatrix::block_type *out) noexcept
+{
+  const std::size_t num_bits = w.vec.cols ();
+  std::fill_n (out, bitmatrix::blocks_for (num_bits), 0);
+  for (std::size_t i = 0; i < num_bits; ++i)
+    out[i / bitmatrix::block_bits] |= bitmatrix::block_type (w.vec (i) & 1)
+                                      << (i % bitmatrix::block_bits);
+}
+
+template <typename Tag>
+[[nodiscard]] word<Tag>
+unpack (const bitmatrix::block_type *in, std::size_t num_bits)
+{
+  Eigen::RowVectorXi vec (num_bits);
+  for (std::size_t i = 0; i < num_bits; ++i)
+    vec (i) = (in[i / bitmatrix::block_bits] >> (i % bitmatrix::block_bits))
+              & 1u;
+  return word<Tag>{ std::move (vec) };
+}
+
+} // namespace details
+
+} // namespace patrick
+
+#endif // PATRICK_BITMATRIX_H_INCLUDED
@@ -0,0 +1,191 @@
+/// \file
+
+#ifndef PATRICK_CACHE_H_INCLUDED
+#define PATRICK_CACHE_H_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include <patrick/stats.h>
+
+namespace patrick
+{
+
+class linearcode;
+
+///
+/// \brief The bytes which the rebuildable tables of all codes hold, next
+/// to the budget they are held to.
+///
+struct cache_usage
+{
+  ///
+  /// \brief See \ref set_cache_budget. 0 if there is none.
+  ///
+  std::size_t budget{ 0 };
+  std::size_t bytes{ 0 };
+
+  ///
+  /// \brief The tables which are built and not evicted.
+  ///
+  std::size_t tables{ 0 };
+  std::uint64_t evictions{ 0 };
+};
+
+///
+/// \brief Limits the bytes which the rebuildable tables of all codes hold
+/// at once - their codewords, Slepian tables, syndrome tables (packed or
+/// not) and erasure solutions. A budget of 0, which is the default, lifts
+/// the limit.
+/// \details Once a new table takes the total past the budget, the tables of
+/// the codes which were used least recently are evicted, the largest first,
+/// until it is within the budget again. The tables of the code which built
+/// the new one and of codes which are being used on another thread are
+/// kept, so the total may stay past the budget for a while.
+///
+/// An evicted table is built again once it is needed, by a single thread
+/// if several share the code, unless it would not fit in the budget on its
+/// own. Then the code decodes with a strategy which needs less memory
+/// instead: the Slepian table gives way to the syndrome table, and the
+/// syndrome tables to a search of the error patterns by increasing weight,
+/// which finds the same coset leaders.
+/// \note With a budget, the references which \ref linearcode::codewords,
+/// \ref linearcode::slepian_table and \ref linearcode::syndrome_table
+/// return are only valid until the table is evicted. Set the budget before
+/// codes are shared between threads.
+///
+void set_cache_budget (std::size_t bytes);
+
+[[nodiscard]] cache_usage current_cache_usage ();
+
+namespace details
+{
+
+///
+/// \brief See \ref set_cache_budget. Codes check this before anything else,
+/// so that keeping track of their use costs a single relaxed load while
+/// there is no budget.
+///
+extern std::atomic<std::size_t> cache_budget;
+
+///
+/// \brief Ticks once a table is built. Codes remember the tick they were
+/// last used at, which orders them from the least recently used.
+///
+extern std::atomic<std::uint64_t> cache_clock;
+
+///
+/// \return Whether a table of \a bytes fits in the budget on its own.
+///
+[[nodiscard]] inline bool
+cache_affords (std::size_t bytes) noexcept
+{
+  const std::size_t budget = cache_budget.load (std::memory_order_relaxed);
+  return budget == 0 || bytes <= budget;
+}
+
+class cache_registry;
+
+///
+/// \brief The bytes of the tables of a code as the registry accounts for
+/// them. Every code holds one, which tells the registry about the tables it
+/// builds and drops.
+///
+class cache_slot
+{
+public:
+  explicit cache_slot (linearcode &owner) noexcept : m_owner{ &owner } {}
+
+  ///
+  /// \brief Accounts for the tables as dropped.
+  ///
+  ~cache_slot ();
+
+  cache_slot (const cache_slot &) = delete;
+  cache_slot &operator= (const cache_slot &) = delete;
+
+  ///
+  /// \brief Accounts for \a bytes more in \a table, and evicts the tables of
+  /// other codes if that takes the total past the budget.
+  ///
+  void add (lazy_table table, std::size_t bytes);
+
+  ///
+  /// \brief Accounts for \a table as dropped by its code.
+  ///
+  void drop (lazy_table table) noexcept;
+
+  ///
+  /// \brief Takes over the tables of \a other, which were moved to the code
+  /// of this slot.
+  ///
+  void take_over (cache_slot &other) noexcept;
+
+private:
+  friend class cache_registry;
+  friend class cache_use;
+
+  linearcode *m_owner;
+
+  ///
+  /// \brief The \ref cache_use scopes which are open on the code, and
+  /// whether the registry is evicting from it. Each side sets its own flag
+  /// before it checks the other one, so they never overlap.
+  ///
+  std::atomic<std::uint32_t> m_users{ 0 };
+  std::atomic<bool> m_evicting{ false };
+  std::atomic<std::uint64_t> m_last_use{ 0 };
+
+  ///
+  /// \brief Guarded by the mutex of the registry.
+  ///
+  std::array<std::size_t, linearcode_stats::num_tables> m_bytes{};
+};
+
+///
+/// \brief Keeps the tables of a code from being evicted while it is being
+/// used, and marks it as the most recently used one.
+///
+class cache_use
+{
+public:
+  explicit cache_use (cache_slot &slot) noexcept
+  {
+    if (cache_budget.load (std::memory_order_relaxed) == 0) [[likely]]
+      return;
+    m_slot = &slot;
+    while (true)
+      {
+        slot.m_users.fetch_add (1);
+        if (!slot.m_evicting.load ())
+          break;
+        slot.m_users.fetch_sub (1);
+        while (slot.m_evicting.load ())
+          std::this_thread::yield ();
+      }
+    const std::uint64_t now = cache_clock.load (std::memory_order_relaxed);
+    if (slot.m_last_use.load (std::memory_order_relaxed) != now)
+      slot.m_last_use.store (now, std::memory_order_relaxed);
+  }
+
+  ~cache_use ()
+  {
+    if (m_slot)
+      m_slot->m_users.fetch_sub (1);
+  }
+
+  cache_use (const cache_use &) = delete;
+  cache_use &operator= (const cache_use &) = delete;
+
+private:
+  cache_slot *m_slot{ nullptr };
+};
+
+} // namespace details
+
+} // namespace patrick
+
+#endif // PATRICK_CACHE_H_INCLUDED
@@ -0,0 +1,659 @@
+/// \file
+
+#ifndef PATRICK_CHANNEL_H_INCLUDED
+#define PATRICK_CHANNEL_H_INCLUDED
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <patrick/word.h>
+
+namespace patrick
+{
+
+///
+/// \class channel_exception
+/// \brief Indicates an exceptional behaviour during an operation of a
+/// channel model.
+///
+class channel_exception : public std::runtime_error
+{
+public:
+  explicit channel_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+namespace details
+{
+
+///
+/// \class xoshiro256pp
+/// \brief The xoshiro256++ generator of Blackman and Vigna - a fast 64-bit
+/// generator with a period of \f$2^{256} - 1\f$. It satisfies
+/// _UniformRandomBitGenerator_.
+///
+class xoshiro256pp
+{
+public:
+  using result_type = std::uint64_t;
+
+  ///
+  /// \brief Expands \a seed into the state with SplitMix64, as recommended
+  /// by the authors, so that similar seeds give unrelated streams.
+  ///
+  explicit constexpr xoshiro256pp (std::uint64_t seed) noexcept
+  {
+    for (auto &s : m_state)
+      {
+        seed += 0x9e3779b97f4a7c15ull;
+        std::uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        s = z ^ (z >> 31);
+      }
+  }
+
+  [[nodiscard]] static constexpr result_type
+  min () noexcept
+  {
+    return 0;
+  }
+
+  [[nodiscard]] static constexpr result_type
+  max () noexcept
+  {
+    return std::numeric_limits<result_type>::max ();
+  }
+
+  constexpr result_type
+  operator() () noexcept
+  {
+    const std::uint64_t result
+        = std::rotl (m_state[0] + m_state[3], 23) + m_state[0];
+    const std::uint64_t t = m_state[1] << 17;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = std::rotl (m_state[3], 45);
+    return result;
+  }
+
+  ///
+  /// \return A uniform double in \f$(0, 1]\f$, out of the high 53 bits of
+  /// the next output.
+  ///
+  constexpr double
+  uniform () noexcept
+  {
+    return double ((operator() () >> 11) + 1) * 0x1.0p-53;
+  }
+
+private:
+  std::uint64_t m_state[4]{};
+};
+
+///
+/// \class philox4x32
+/// \brief The counter-based Philox4x32-10 generator of Salmon et al. Block
+/// \f$i\f$ of a stream is a function of the key, the stream and \f$i\f$
+/// alone, so any part of any stream can be generated independently, in any
+/// order and on any thread. It satisfies _UniformRandomBitGenerator_.
+///
+class philox4x32
+{
+public:
+  using result_type = std::uint64_t;
+  using block_type = std::array<std::uint32_t, 4>;
+
+  constexpr philox4x32 (std::uint64_t key, std::uint64_t stream) noexcept
+      : m_key{ key }, m_stream{ stream }
+  {
+  }
+
+  ///
+  /// \brief Encrypts \a counter with \a key by 10 rounds of Philox.
+  ///
+  [[nodiscard]] static constexpr block_type
+  encrypt (block_type counter, std::array<std::uint32_t, 2> key) noexcept
+  {
+    for (std::size_t round = 0; round < 10; ++round)
+      {
+        const std::uint64_t p0 = std::uint64_t{ 0xd2511f53 } * counter[0];
+        const std::uint64_t p1 = std::uint64_t{ 0xcd9e8d57 } * counter[2];
+        counter = { std::uint32_t (p1 >> 32) ^ counter[1] ^ key[0],
+                    std::uint32_t (p1),
+                    std::uint32_t (p0 >> 32) ^ counter[3] ^ key[1],
+                    std::uint32_t (p0) };
+        key[0] += 0x9e3779b9;
+        key[1] += 0xbb67ae85;
+      }
+    return counter;
+  }
+
+  [[nodiscard]] static constexpr result_type
+  min () noexcept
+  {
+    return 0;
+  }
+
+  [[nodiscard]] static constexpr result_type
+  max () noexcept
+  {
+    return std::numeric_limits<result_type>::max ();
+  }
+
+  constexpr result_type
+  operator() () noexcept
+  {
+    if (m_used == 2)
+      {
+        m_block = encrypt ({ std::uint32_t (m_index),
+                             std::uint32_t (m_index >> 32),
+                             std::uint32_t (m_stream),
+                             std::uint32_t (m_stream >> 32) },
+                           { std::uint32_t (m_key),
+                             std::uint32_t (m_key >> 32) });
+        ++m_index;
+        m_used = 0;
+      }
+    const std::size_t i = 2 * m_used++;
+    return std::uint64_t{ m_block[i] } | std::uint64_t{ m_block[i + 1] } << 32;
+  }
+
+  ///
+  /// \return A uniform double in \f$(0, 1]\f$.
+  ///
+  constexpr double
+  uniform () noexcept
+  {
+    return double ((operator() () >> 11) + 1) * 0x1.0p-53;
+  }
+
+private:
+  std::uint64_t m_key{ 0 };
+  std::uint64_t m_stream{ 0 };
+  std::uint64_t m_index{ 0 };
+  block_type m_block{};
+  std::size_t m_used{ 2 };
+};
+
+///
+/// \return The number of bits before the next flip of a binary symmetric
+/// channel, for a uniform \a u in \f$(0, 1]\f$ and \a scale
+/// \f$1 / \log (1 - p)\f$.
+///
+[[nodiscard]] inline std::uint64_t
+geometric_gap (double u, double scale) noexcept
+{
+  const double gap = std::floor (std::log (u) * scale);
+  return gap < 0x1.0p63 ? static_cast<std::uint64_t> (gap)
+                        : std::numeric_limits<std::uint64_t>::max ();
+}
+
+///
+/// \class geometric_skipper
+/// \brief Finds the positions of a stream of bits at which an event of
+/// probability \f$p\f$ happens, by drawing the geometric gaps between them
+/// with \ref geometric_gap. The bits between events cost nothing.
+/// \details The gap to the next event carries over, so the events only
+/// depend on the seed and the position in the whole stream.
+///
+class geometric_skipper
+{
+public:
+  geometric_skipper (double probability, std::uint64_t seed) noexcept
+      : m_gen{ seed }
+  {
+    set_probability (probability);
+  }
+
+  [[nodiscard]] double
+  probability () const noexcept
+  {
+    return m_probability;
+  }
+
+  ///
+  /// \brief Changes the probability of the events from the current position
+  /// on. Since the gaps are memoryless, the next one is simply drawn again.
+  ///
+  void
+  set_probability (double probability) noexcept
+  {
+    m_probability = probability;
+    // With p = 1 the scale is -0, so that every gap is 0.
+    m_scale = 1 / std::log1p (-probability);
+    m_gap = next_gap ();
+  }
+
+  ///
+  /// \brief Advances the stream to just past the next event among its next
+  /// \a num_bits, or past all of them if there is none.
+  /// \return The offset of the event, or \a num_bits if there is none.
+  ///
+  std::uint64_t
+  next (std::uint64_t num_bits) noexcept
+  {
+    if (m_gap >= num_bits)
+      {
+        m_gap -= num_bits;
+        return num_bits;
+      }
+    const std::uint64_t offset = m_gap;
+    m_gap = next_gap ();
+    return offset;
+  }
+
+  ///
+  /// \brief Calls \a visit with the offset of every event among the next
+  /// \a num_bits of the stream.
+  ///
+  template <typename Visitor>
+  void
+  for_each (std::uint64_t num_bits, Visitor &&visit)
+  {
+    for (std::uint64_t position = 0;
+         (position += next (num_bits - position)) < num_bits; ++position)
+      visit (position);
+  }
+
+  void
+  reseed (std::uint64_t seed) noexcept
+  {
+    m_gen = xoshiro256pp{ seed };
+    m_gap = next_gap ();
+  }
+
+private:
+  [[nodiscard]] std::uint64_t
+  next_gap () noexcept
+  {
+    // Also keeps the gaps of invalid probabilities, which the channels
+    // reject after constructing their skippers, well-defined.
+    if (!(m_probability > 0))
+      return std::numeric_limits<std::uint64_t>::max ();
+    return geometric_gap (m_gen.uniform (), m_scale);
+  }
+
+private:
+  double m_probability{ 0 };
+
+  ///
+  /// \brief \f$1 / \log (1 - p)\f$.
+  ///
+  double m_scale{ 0 };
+
+  xoshiro256pp m_gen;
+  std::uint64_t m_gap{ 0 };
+};
+
+///
+/// \class gaussian_generator
+/// \brief Draws standard normal floats by the Box-Muller transform, a block
+/// of \ref block_size at a time.
+/// \details The uniforms come from 4 interleaved xoshiro256++ generators,
+/// so that AVX2 runs them in a single register, and the logarithm, sine and
+/// cosine are polynomial approximations accurate to a few ulp. With AVX2, a
+/// block takes a handful of vector instructions. The portable kernel does
+/// the same operations in the same order.
+///
+class gaussian_generator
+{
+public:
+  static constexpr std::size_t block_size = 16;
+
+  ///
+  /// \brief The state of the 4 generators - word \f$w\f$ of generator
+  /// \f$l\f$ is at \f$4 w + l\f$.
+  ///
+  using state_type = std::array<std::uint64_t, 16>;
+
+  explicit gaussian_generator (std::uint64_t seed) noexcept;
+
+  ///
+  /// \brief Fills \a out with the next normals of the stream.
+  ///
+  void fill (std::span<float> out) noexcept;
+
+private:
+  state_type m_state{};
+
+  ///
+  /// \brief The rest of the last block, which was only used in part.
+  ///
+  std::array<float, block_size> m_spare{};
+  std::size_t m_spare_used{ block_size };
+};
+
+///
+/// \brief Writes \a num_blocks blocks of normals to \a out and advances
+/// \a state past them.
+///
+void gaussian_blocks (gaussian_generator::state_type &state, float *out,
+                      std::size_t num_blocks) noexcept;
+
+///
+/// \brief The portable implementation of \ref gaussian_blocks.
+///
+void gaussian_blocks_scalar (gaussian_generator::state_type &state,
+                             float *out, std::size_t num_blocks) noexcept;
+
+} // namespace details
+
+///
+/// \class binary_symmetric_channel
+/// \brief The binary symmetric channel, which flips every bit independently
+/// with the crossover probability \f$p\f$.
+/// \details Instead of drawing a number for every bit, the channel draws
+/// the gaps between flipped bits with \ref details::geometric_skipper. They
+/// are geometric:
+/// \f$\lfloor \log U / \log (1 - p) \rfloor\f$ for a uniform \f$U\f$. So a
+/// stream of \f$N\f$ bits costs about \f$p N\f$ draws, and the bits between
+/// flips are not touched at all.
+///
+/// The gap to the next flip carries over from one call to the next, so the
+/// flips only depend on the seed and the position in the whole stream - not
+/// on how it is split into calls.
+///
+class binary_symmetric_channel final
+{
+public:
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \throws \ref channel_exception unless \f$0 \leq p \leq 1\f$.
+  ///
+  binary_symmetric_channel (double crossover_probability,
+                            std::uint64_t seed);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] double
+  crossover_probability () const noexcept
+  {
+    return m_flips.probability ();
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Flips the bits of the next \a num_bits of the stream, which are
+  /// packed like the rows of \ref details::bitmatrix, in place.
+  ///
+  void corrupt (std::span<std::uint64_t> bits, std::size_t num_bits) noexcept;
+
+  ///
+  /// \return \a cword as it is received.
+  ///
+  [[nodiscard]] codeword transmit (const codeword &cword);
+
+  ///
+  /// \brief Restarts the stream with another seed.
+  ///
+  void reseed (std::uint64_t seed) noexcept;
+
+private:
+  details::geometric_skipper m_flips;
+};
+
+///
+/// \class awgn_channel
+/// \brief The additive white Gaussian noise channel with BPSK modulation:
+/// bit \f$b\f$ is sent as \f$x = 1 - 2 b\f$ and received as \f$y = x + n\f$
+/// for a normal \f$n\f$ with deviation \f$\sigma\f$.
+/// \details The channel gives the log-likelihood ratios
+/// \f$\log \frac{P(0 | y)}{P(1 | y)} = 2 y / \sigma^2\f$ of the received
+/// bits, which is what the soft decoders take. The normals come from \ref
+/// details::gaussian_generator and are written straight into the buffer of
+/// the ratios. Like with \ref binary_symmetric_channel, the noise only
+/// depends on the seed and the position in the whole stream.
+///
+class awgn_channel final
+{
+public:
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \throws \ref channel_exception unless \f$\sigma\f$ is positive and
+  /// finite.
+  ///
+  awgn_channel (double noise_deviation, std::uint64_t seed);
+
+  ///
+  /// \brief The channel at signal to noise ratio \f$E_b / N_0\f$ for a code
+  /// of rate \f$R\f$, that is \f$\sigma^2 = 1 / (2 R E_b / N_0)\f$.
+  /// \throws \ref channel_exception unless \f$0 < R \leq 1\f$.
+  ///
+  [[nodiscard]] static awgn_channel from_ebn0 (double ebn0_db, double rate,
+                                               std::uint64_t seed);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] double
+  noise_deviation () const noexcept
+  {
+    return m_noise_deviation;
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Sends the next \a num_bits of the stream, which are packed like
+  /// the rows of \ref details::bitmatrix, and writes the ratios of the
+  /// received bits to the first \a num_bits entries of \a llrs.
+  ///
+  void transmit (std::span<const std::uint64_t> bits, std::size_t num_bits,
+                 std::span<float> llrs) noexcept;
+
+  ///
+  /// \return The ratios of the bits of \a cword as they are received.
+  ///
+  [[nodiscard]] std::vector<float> transmit (const codeword &cword);
+
+  ///
+  /// \brief Restarts the stream with another seed.
+  ///
+  void reseed (std::uint64_t seed) noexcept;
+
+private:
+  double m_noise_deviation{ 1 };
+  details::gaussian_generator m_gen;
+};
+
+///
+/// \class gilbert_elliott_channel
+/// \brief The Gilbert-Elliott channel, which is a binary symmetric channel
+/// whose crossover probability depends on the state of a two-state Markov
+/// chain. After every bit, the chain moves from the good state to the bad
+/// one or back with the given probabilities.
+/// \details Both the transitions and the flips within a state are skip
+/// sampled with \ref details::geometric_skipper, so long runs in a state
+/// cost a single draw. The first state is drawn from the stationary
+/// distribution of the chain. Both the state and the gaps carry over from
+/// one call to the next.
+///
+class gilbert_elliott_channel final
+{
+public:
+  struct parameters_type
+  {
+    double good_to_bad{ 0 };
+    double bad_to_good{ 1 };
+
+    ///
+    /// \brief The crossover probabilities in either state.
+    ///
+    double good_error{ 0 };
+    double bad_error{ 0.5 };
+  };
+
+public:
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \throws \ref channel_exception unless the probabilities are within
+  /// \f$[0, 1]\f$ and the chain may leave the bad state.
+  ///
+  gilbert_elliott_channel (parameters_type parameters, std::uint64_t seed);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] const parameters_type &
+  parameters () const noexcept
+  {
+    return m_parameters;
+  }
+
+  [[nodiscard]] bool
+  is_bad () const noexcept
+  {
+    return m_bad;
+  }
+
+  ///
+  /// \return The probability that a bit is flipped in the long run.
+  ///
+  [[nodiscard]] double
+  crossover_probability () const noexcept
+  {
+    const double bad
+        = m_parameters.good_to_bad
+          / (m_parameters.good_to_bad + m_parameters.bad_to_good);
+    return (1 - bad) * m_parameters.good_error + bad * m_parameters.bad_error;
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Flips the bits of the next \a num_bits of the stream, which are
+  /// packed like the rows of \ref details::bitmatrix, in place.
+  ///
+  void corrupt (std::span<std::uint64_t> bits, std::size_t num_bits) noexcept;
+
+  ///
+  /// \return \a cword as it is received.
+  ///
+  [[nodiscard]] codeword transmit (const codeword &cword);
+
+  ///
+  /// \brief Restarts the stream with another seed.
+  ///
+  void reseed (std::uint64_t seed) noexcept;
+
+private:
+  parameters_type m_parameters;
+  bool m_bad{ false };
+  details::geometric_skipper m_transitions;
+  details::geometric_skipper m_flips;
+};
+
+///
+/// \class binary_erasure_channel
+/// \brief The binary erasure channel, which erases every bit independently
+/// with the erasure probability \f$\epsilon\f$.
+/// \details The channel gives the received word along with a mask of the
+/// erased positions, and the erased bits of the word are cleared. The
+/// erasures are skip sampled like the flips of \ref
+/// binary_symmetric_channel, and the gap carries over between calls.
+///
+class binary_erasure_channel final
+{
+public:
+  ///
+  /// \brief A received word and the positions of its erased bits.
+  ///
+  struct received_type
+  {
+    codeword word;
+    codeword erasures;
+  };
+
+public:
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \throws \ref channel_exception unless \f$0 \leq \epsilon \leq 1\f$.
+  ///
+  binary_erasure_channel (double erasure_probability, std::uint64_t seed);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] double
+  erasure_probability () const noexcept
+  {
+    return m_erasures.probability ();
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Erases bits of the next \a num_bits of the stream, which are
+  /// packed like the rows of \ref details::bitmatrix, in place.
+  /// \param erasures The mask of the erased bits is written here, packed in
+  /// the same way.
+  ///
+  void erase (std::span<std::uint64_t> bits,
+              std::span<std::uint64_t> erasures,
+              std::size_t num_bits) noexcept;
+
+  ///
+  /// \return \a cword as it is received.
+  ///
+  [[nodiscard]] received_type transmit (const codeword &cword);
+
+  ///
+  /// \brief Restarts the stream with another seed.
+  ///
+  void reseed (std::uint64_t seed) noexcept;
+
+private:
+  details::geometric_skipper m_erasures;
+};
+
+} // namespace patrick
+
+#endif // PATRICK_CHANNEL_H_INCLUDED
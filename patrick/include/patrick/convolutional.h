@@ -0,0 +1,405 @@
+/// \file
+
+#ifndef PATRICK_CONVOLUTIONAL_H_INCLUDED
+#define PATRICK_CONVOLUTIONAL_H_INCLUDED
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <fmt/core.h>
+
+namespace patrick
+{
+
+///
+/// \class convolutional_code_exception
+/// \brief Indicates an exceptional behaviour during an operation of a
+/// \ref convolutional_code or a \ref viterbi_decoder instance.
+///
+class convolutional_code_exception : public std::runtime_error
+{
+public:
+  explicit convolutional_code_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+namespace details
+{
+
+///
+/// \class trellis
+/// \brief The trellis of a rate \f$1/n\f$ convolutional encoder with
+/// constraint length \f$K\f$ and its add-compare-select step.
+/// \details The state is formed by the last \f$K - 1\f$ input bits, the most
+/// recent one being the highest. Feeding bit \f$b\f$ to state \f$s\f$ fills
+/// the register \f$2^{K - 1} b + s\f$, whose parities with the generator
+/// polynomials are the outputs, and moves to state
+/// \f$\lfloor (2^{K - 1} b + s) / 2 \rfloor\f$.
+/// Hence states \f$2u\f$ and \f$2u + 1\f$ are the only predecessors of
+/// \f$u\f$ and \f$u + 2^{K - 2}\f$.
+///
+/// Received symbols are signed, positive ones standing for 0. The cost of a
+/// branch is the sum of the symbols whose bits it outputs as 1 minus the sum
+/// of the others, shifted by \f$n\f$ \ref max_symbol so that it is never
+/// negative.
+///
+class trellis
+{
+public:
+  using metric_type = std::int16_t;
+  using decision_type = std::uint16_t;
+
+  static constexpr std::size_t decision_bits = 16;
+
+  ///
+  /// \brief The bound of the magnitude of received symbols. It keeps the
+  /// spread of the path metrics of the largest trellis below \f$2^{13}\f$.
+  ///
+  static constexpr metric_type max_symbol = 63;
+
+  trellis () = default;
+
+  trellis (std::size_t constraint_length,
+           std::span<const std::uint32_t> polynomials);
+
+  [[nodiscard]] std::size_t
+  constraint_length () const noexcept
+  {
+    return m_constraint_length;
+  }
+
+  [[nodiscard]] std::size_t
+  num_outputs () const noexcept
+  {
+    return m_num_outputs;
+  }
+
+  [[nodiscard]] std::size_t
+  num_states () const noexcept
+  {
+    return std::size_t{ 1 } << (m_constraint_length - 1);
+  }
+
+  ///
+  /// \brief The number of \ref decision_type words of a step.
+  ///
+  [[nodiscard]] std::size_t
+  decision_words () const noexcept
+  {
+    return (num_states () + decision_bits - 1) / decision_bits;
+  }
+
+  ///
+  /// \return The output bits of the branch from \a state with \a input,
+  /// bit \f$i\f$ being that of polynomial \f$i\f$.
+  ///
+  [[nodiscard]] std::uint32_t
+  output_of (std::size_t state, std::size_t input) const noexcept
+  {
+    return m_outputs[2 * state + input];
+  }
+
+  ///
+  /// \brief Extends the paths by one step.
+  /// \param symbols The \f$n\f$ received symbols of the step.
+  /// \param metrics The path metrics of the states before the step.
+  /// \param next The path metrics of the states after the step.
+  /// \param decisions Bit \f$t\f$ is set iff the survivor of state \f$t\f$
+  /// comes from the odd one of its predecessors.
+  ///
+  void add_compare_select (std::span<const metric_type> symbols,
+                           std::span<const metric_type> metrics,
+                           std::span<metric_type> next,
+                           std::span<decision_type> decisions) const noexcept;
+
+  ///
+  /// \brief The portable implementation of \ref add_compare_select.
+  ///
+  void add_compare_select_scalar (
+      std::span<const metric_type> symbols,
+      std::span<const metric_type> metrics, std::span<metric_type> next,
+      std::span<decision_type> decisions) const noexcept;
+
+private:
+  std::size_t m_constraint_length{ 0 };
+  std::size_t m_num_outputs{ 0 };
+
+  ///
+  /// \brief See \ref output_of.
+  ///
+  std::vector<std::uint32_t> m_outputs;
+
+  ///
+  /// \brief For every 16 states \f$u\f$, every input and both parities of
+  /// the predecessor, and every output - 16 lanes which are 0 if the branch
+  /// outputs 1 and -1 otherwise. The vectorized step negates symbols with
+  /// them.
+  ///
+  std::vector<metric_type> m_lane_masks;
+};
+
+} // namespace details
+
+///
+/// \class convolutional_code
+/// \brief Represents a binary convolutional code of rate \f$1/n\f$ and
+/// constraint length \f$K \leq 9\f$, optionally punctured.
+/// \details Generator polynomials are given in the usual (octal) notation -
+/// bit \f$K - 1\f$ taps the current input and bit 0 the oldest one. For
+/// example, the code of rate 1/2 with \f$K = 7\f$ used by CCSDS has the
+/// polynomials 0171 and 0133.
+///
+/// The encoder starts from the zero state. A terminated block is followed by
+/// \f$K - 1\f$ zero bits which bring it back there.
+///
+/// A puncturing pattern is a matrix with \f$n\f$ rows whose columns are
+/// repeated over time - output \f$i\f$ of step \f$j\f$ is transmitted iff
+/// the entry at row \f$i\f$ and column \f$j\f$ modulo the period is 1.
+///
+class convolutional_code final
+{
+public:
+  ///
+  /// Related types
+  ///
+
+  using bit_type = std::uint8_t;
+
+  static constexpr std::size_t max_constraint_length = 9;
+  static constexpr std::size_t max_outputs = 8;
+
+  struct properties_type
+  {
+    std::size_t constraint_length{ 0 };
+    std::size_t num_outputs{ 0 };
+    std::size_t num_states{ 0 };
+    /// The number of steps after which puncturing repeats.
+    std::size_t puncturing_period{ 1 };
+    /// The number of bits transmitted per period.
+    std::size_t num_transmitted{ 0 };
+  };
+
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \param puncturing The puncturing pattern. It is not punctured if empty.
+  /// \throws \ref convolutional_code_exception unless \f$2 \leq K \leq 9\f$,
+  /// there are between 2 and 8 nonzero polynomials of degree less than
+  /// \f$K\f$, some of which taps the current input, and every column of the
+  /// puncturing pattern has a 1.
+  ///
+  convolutional_code (std::size_t constraint_length,
+                      std::vector<std::uint32_t> polynomials,
+                      const Eigen::MatrixXi &puncturing = {});
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] const properties_type &
+  properties () const &noexcept
+  {
+    return m_properties;
+  }
+
+  [[nodiscard]] const std::vector<std::uint32_t> &
+  polynomials () const &noexcept
+  {
+    return m_polynomials;
+  }
+
+  ///
+  /// \return The ratio of the input bits to the transmitted ones.
+  ///
+  [[nodiscard]] double
+  rate () const noexcept
+  {
+    return static_cast<double> (m_properties.puncturing_period)
+           / static_cast<double> (m_properties.num_transmitted);
+  }
+
+  [[nodiscard]] const details::trellis &
+  trellis () const &noexcept
+  {
+    return m_trellis;
+  }
+
+  ///
+  /// \return Whether the output with index \a slot modulo \f$n\f$ of step
+  /// \a slot divided by \f$n\f$ is transmitted, for \a slot less than
+  /// \f$n\f$ times the period.
+  ///
+  [[nodiscard]] bool
+  is_transmitted (std::size_t slot) const noexcept
+  {
+    return m_transmitted[slot];
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Encodes \a message, whose entries are 0 or 1.
+  /// \param terminate Whether to append the \f$K - 1\f$ zero bits.
+  /// \return The transmitted bits.
+  ///
+  [[nodiscard]] std::vector<bit_type>
+  encode (std::span<const bit_type> message, bool terminate = true) const;
+
+  ///
+  /// \brief Decodes a whole block of hard decisions with \ref
+  /// viterbi_decoder.
+  /// \param terminated Whether the block was encoded with its tail, which is
+  /// then dropped from the result.
+  ///
+  [[nodiscard]] std::vector<bit_type>
+  decode (std::span<const bit_type> received, bool terminated = true) const;
+
+  ///
+  /// \brief Decodes a whole block of soft decisions with \ref
+  /// viterbi_decoder.
+  /// \param llrs The log-likelihood ratios \f$\log \frac{P(0)}{P(1)}\f$ of
+  /// the transmitted bits.
+  ///
+  [[nodiscard]] std::vector<bit_type>
+  decode_soft (std::span<const float> llrs, bool terminated = true) const;
+
+private:
+  properties_type m_properties;
+  std::vector<std::uint32_t> m_polynomials;
+  details::trellis m_trellis;
+
+  ///
+  /// \brief See \ref is_transmitted.
+  ///
+  std::vector<bool> m_transmitted;
+};
+
+///
+/// \class viterbi_decoder
+/// \brief Decodes a continuous stream of a \ref convolutional_code with the
+/// Viterbi algorithm.
+/// \details The decisions of the last steps are kept in a ring of
+/// \f$2D\f$ steps, where \f$D\f$ is the traceback depth. Once it fills, the
+/// survivor of the best state is traced back and the bits of its oldest
+/// \f$D\f$ steps are emitted. They are final, because the survivors have
+/// merged by then with high probability.
+///
+/// Received values are quantized to at most \ref
+/// details::trellis::max_symbol in magnitude. Punctured bits are treated as
+/// erasures.
+///
+class viterbi_decoder final
+{
+public:
+  using bit_type = convolutional_code::bit_type;
+
+  ///
+  /// \param traceback_depth \f$D\f$. If 0, it is \f$5K\f$ for codes which
+  /// are not punctured and \f$10K\f$ for ones which are.
+  /// \param llr_scale The factor applied to log-likelihood ratios before
+  /// they are rounded.
+  /// \throws \ref convolutional_code_exception if \f$0 < D < K\f$.
+  ///
+  explicit viterbi_decoder (const convolutional_code &code,
+                            std::size_t traceback_depth = 0,
+                            float llr_scale = 8.0f);
+
+  [[nodiscard]] std::size_t
+  traceback_depth () const noexcept
+  {
+    return m_depth;
+  }
+
+  ///
+  /// \brief Consumes the next log-likelihood ratios of the stream.
+  /// \param decoded The bits which become final are appended to it.
+  ///
+  void push (std::span<const float> llrs, std::vector<bit_type> &decoded);
+
+  ///
+  /// \brief Consumes the next hard decisions of the stream.
+  ///
+  void push_hard (std::span<const bit_type> received,
+                  std::vector<bit_type> &decoded);
+
+  ///
+  /// \brief Ends the stream by emitting all bits which are not yet final.
+  /// \param terminated Whether the stream ends with the \f$K - 1\f$ zero
+  /// bits, which are not emitted then.
+  /// \post The decoder is ready for a new stream.
+  ///
+  void finish (bool terminated, std::vector<bit_type> &decoded);
+
+  ///
+  /// \brief Starts a new stream.
+  ///
+  void reset ();
+
+private:
+  using metric_type = details::trellis::metric_type;
+  using decision_type = details::trellis::decision_type;
+
+  void push_symbol (metric_type symbol, std::vector<bit_type> &decoded);
+
+  ///
+  /// \brief Skips the punctured bits up to the next transmitted one and
+  /// runs the steps which this completes.
+  ///
+  void advance (std::vector<bit_type> &decoded);
+
+  void step (std::vector<bit_type> &decoded);
+
+  ///
+  /// \brief Traces the survivor of \a state back over the stored steps and
+  /// emits the bits of the \a count oldest ones, which are then dropped.
+  ///
+  void trace_back (std::size_t state, std::size_t count,
+                   std::vector<bit_type> &decoded);
+
+private:
+  convolutional_code m_code;
+  std::size_t m_depth{ 0 };
+  float m_llr_scale{ 1.0f };
+
+  std::vector<metric_type> m_metrics;
+  std::vector<metric_type> m_next_metrics;
+
+  ///
+  /// \brief The symbols of the current step and whether any was received.
+  ///
+  std::vector<metric_type> m_symbols;
+  bool m_has_symbols{ false };
+
+  ///
+  /// \brief The position of the next bit within the puncturing period.
+  ///
+  std::size_t m_slot{ 0 };
+
+  ///
+  /// \brief The decisions of \ref m_stored steps, starting with the oldest
+  /// one at step \ref m_oldest of the ring.
+  ///
+  std::vector<decision_type> m_decisions;
+  std::size_t m_oldest{ 0 };
+  std::size_t m_stored{ 0 };
+
+  ///
+  /// \brief The number of bits emitted for the current stream.
+  ///
+  std::size_t m_emitted{ 0 };
+};
+
+} // namespace patrick
+
+#endif // PATRICK_CONVOLUTIONAL_H_INCLUDED
@@ -3,8 +3,14 @@
 #ifndef PATRICK_CORE_H_INCLUDED
 #define PATRICK_CORE_H_INCLUDED
 
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -13,6 +19,10 @@
 #include <Eigen/Dense>
 #include <fmt/core.h>
 
+#include <patrick/bitmatrix.h>
+#include <patrick/cache.h>
+#include <patrick/gf2m.h>
+#include <patrick/stats.h>
 #include <patrick/word.h>
 
 namespace patrick
@@ -58,12 +68,50 @@ public:
     std::size_t max_errors_correct{ 0 };
   };
 
+  ///
+  /// \brief Known code families. Codes of a family are built
+  /// algorithmically and may be decoded with a decoder that makes use of
+  /// their structure.
+  ///
+  enum class code_family
+  {
+    Generic,
+    Hamming,
+    BCH,
+    Golay,
+    ReedMuller
+  };
+
+  ///
+  /// \brief The family of a code and the parameters it was built with.
+  ///
+  struct family_type
+  {
+    code_family kind{ code_family::Generic };
+    /// Hamming: the number of parity bits \f$r\f$. BCH and Reed-Muller: the
+    /// number of variables \f$m\f$.
+    std::size_t m{ 0 };
+    /// Reed-Muller: the order \f$r\f$.
+    std::size_t r{ 0 };
+    /// BCH: the number of errors \f$t\f$ that the code is designed for.
+    std::size_t t{ 0 };
+  };
+
+  ///
+  /// \brief The containers of the tables are allocated from the resource
+  /// which \ref set_table_resource sets. The words in them keep their
+  /// storage on the heap.
+  ///
+  using codewords_type = std::pmr::vector<codeword>;
+
   struct coset
   {
     codeword leader;
-    std::vector<codeword> columns;
+    codewords_type columns;
   };
 
+  using slepian_table_type = std::pmr::vector<coset>;
+
   ///
   /// \brief Represents a result from the decoding strategy used.
   ///
@@ -73,17 +121,53 @@ public:
     codeword error;
   };
 
-  using syndrome_table_type = std::unordered_map<syndrome, codeword>;
+  using syndrome_table_type = std::pmr::unordered_map<syndrome, codeword>;
+
+  ///
+  /// \brief The solutions of the erasure patterns which \ref decode_erasures
+  /// has met, by their packed masks.
+  ///
+  using erasure_solutions_type
+      = std::unordered_map<std::vector<details::bitmatrix::block_type>,
+                           details::bitmatrix, details::packed_row_hash>;
+
+  ///
+  /// \brief The most erasure patterns whose solutions are kept. Once there
+  /// are as many, the solutions are dropped and found again as needed.
+  ///
+  static constexpr std::size_t max_erasure_solutions = 4096;
+
+  ///
+  /// \brief The largest redundancy \f$n - k\f$ of a generic code which \ref
+  /// decode_batch decodes with a packed table of the coset leaders.
+  ///
+  static constexpr std::size_t max_packed_table_redundancy = 20;
+
+  ///
+  /// \brief The largest dimension of a code (or its dual) whose codewords
+  /// may be enumerated in order to evaluate its properties.
+  ///
+  static constexpr std::size_t max_enumerated_dimension = 32;
+
+  ///
+  /// \brief The most bits of the generator of a code of a family, which is
+  /// stored dense - 32 MiB. Longer Hamming and BCH codes are left to \ref
+  /// cyclic_code, which keeps its generator implicit.
+  ///
+  static constexpr std::size_t max_family_generator_bits
+      = std::size_t{ 1 } << 28;
 
   ///
   /// Constructors
   ///
 
   ///
-  /// \param parity_equations Set of pairs that give the redundency positions
-  /// in terms of the information positions.
+  /// \param parity_equations A parity matrix - every row is an equation
+  /// which the positions of a codeword have to satisfy. The rows do not need
+  /// to be linearly independent.
   /// \return Constructed
   /// \ref linearcode instance which is described by the provided equations.
+  /// That is the null space of \a parity_equations over \f$F_{2}\f$.
   ///
   [[nodiscard]] [[maybe_unused]] static linearcode
   from_parity_equations (const Eigen::MatrixXi &parity_equations);
@@ -93,6 +177,11 @@ public:
   /// vectors of a linear subspace.
   /// \return Constructed \ref linearcode instance which is described by
   /// the provided generator.
+  /// \details The generator does not need to be in standard form. It is
+  /// reduced over \f$F_{2}\f$ and the columns holding its pivots become the
+  /// information positions of the code (see \ref permutation).
+  /// \throws \ref linearcode_exception if the rows of the generator are not
+  /// linearly independent.
   ///
   [[nodiscard]] static linearcode
   from_generator (const Eigen::MatrixXi &generator_matrix);
@@ -101,19 +190,129 @@ public:
   /// \param dual A linear code
   /// \return Constructed \ref linearcode instance which is dual to the
   /// provided code.
+  /// \note The parity matrix of \a code is already systematic, so it is used
+  /// as the generator of the dual as it is.
   ///
   [[nodiscard]] static linearcode from_dual (const linearcode &code);
 
+  ///
+  /// Code families
+  ///
+
+  ///
+  /// \brief The binary Hamming \f$[2^{r} - 1, 2^{r} - r - 1, 3]\f$ code.
+  /// \details Column \f$j\f$ of its parity matrix is the binary
+  /// representation of \f$j + 1\f$, so the syndrome of a single error is the
+  /// position of the error.
+  /// \throws \ref linearcode_exception if \f$r < 2\f$, or if the generator
+  /// takes more than \ref max_family_generator_bits, which holds for
+  /// \f$r > 14\f$.
+  ///
+  [[nodiscard]] static linearcode hamming (std::size_t r);
+
+  ///
+  /// \brief The primitive narrow-sense binary BCH code of length
+  /// \f$2^{m} - 1\f$ which corrects \a t errors.
+  /// \details Codeword position \f$i\f$ holds the coefficient of \f$x^{i}\f$
+  /// and the generator polynomial is the least common multiple of the
+  /// minimal polynomials of \f$\alpha, \ldots, \alpha^{2t}\f$ over
+  /// \f$GF(2^{m})\f$.
+  /// \note The minimum distance in the properties of the code is its
+  /// designed distance \f$2t + 1\f$, which is a lower bound of the actual
+  /// one.
+  /// \throws \ref linearcode_exception if there is no such code, or if its
+  /// generator takes more than \ref max_family_generator_bits.
+  ///
+  [[nodiscard]] static linearcode bch (std::size_t m, std::size_t t);
+
+  ///
+  /// \brief The extended binary Golay \f$[24, 12, 8]\f$ code with generator
+  /// \f$(I|B)\f$.
+  ///
+  [[nodiscard]] static linearcode golay24 ();
+
+  ///
+  /// \brief The Reed-Muller code \f$RM(r, m)\f$ of length \f$2^{m}\f$.
+  /// \details The rows of its generator are the monomials of degree at most
+  /// \a r in \f$m\f$ variables. Position \f$p\f$ holds the value of the
+  /// monomial at the point whose \f$i\f$-th coordinate is bit \f$i\f$ of
+  /// \f$p\f$.
+  /// \throws \ref linearcode_exception if there is no such code, or if its
+  /// generator takes more than \ref max_family_generator_bits.
+  ///
+  [[nodiscard]] static linearcode reed_muller (std::size_t r, std::size_t m);
+
 private:
+  ///
+  /// \brief Reduces \a generator and creates the code it generates.
+  /// \see from_generator
+  ///
+  [[nodiscard]] static linearcode from_packed_generator (
+      details::bitmatrix generator, family_type family,
+      std::optional<std::size_t> known_min_distance);
+
+  ///
+  /// \brief Creates the code which is the null space of \a parity.
+  /// \see from_parity_equations
+  ///
+  [[nodiscard]] static linearcode from_packed_parity_equations (
+      details::bitmatrix parity, family_type family,
+      std::optional<std::size_t> known_min_distance);
+
+  ///
+  /// \brief Creates the code of \a family with the parameters in it.
+  /// \throws \ref linearcode_exception if \a family is \ref
+  /// code_family::Generic.
+  ///
+  [[nodiscard]] static linearcode from_family (const family_type &family);
+
   ///
   /// \brief This constructor should remain private, since the
   /// internal representation of the linear code is a \a secret :D. Anyways,
   /// both the parity equations and the generator are actually matrices, so for
   /// API clarity I think that the most suitable way for creating instances is
-  /// my using the named ctors \a from_*(). \param generator_matrix The linear
-  /// code represented by a generator matrix.
+  /// my using the named ctors \a from_*().
+  /// \param generator The generator matrix in systematic form.
+  /// \param permutation The column order which brings \a generator into
+  /// standard form.
+  /// \param family The family which the code is part of.
+  /// \param known_min_distance The minimum distance, if it is known from the
+  /// construction of the code. Otherwise it is evaluated.
+  ///
+  linearcode (details::bitmatrix generator,
+              std::vector<std::size_t> permutation, family_type family,
+              std::optional<std::size_t> known_min_distance);
+
+  ///
+  /// \brief Copies \a other, which \a use keeps from being evicted from
+  /// meanwhile.
   ///
-  explicit linearcode (const Eigen::MatrixXi &generator_matrix);
+  linearcode (const linearcode &other, const details::cache_use &use);
+
+  ///
+  /// \brief Moves \a other, which \a use keeps from being evicted from
+  /// meanwhile.
+  ///
+  linearcode (linearcode &&other, const details::cache_use &use);
+
+public:
+  ///
+  /// \brief The tables of the copy are accounted for in the cache budget
+  /// (see \ref set_cache_budget) along with the ones of \a other.
+  ///
+  linearcode (const linearcode &other)
+      : linearcode{ other, details::cache_use{ other.m_cache } }
+  {
+  }
+
+  ///
+  /// \brief The tables of \a other are accounted for as the ones of the new
+  /// code, and \a other is left without any.
+  ///
+  linearcode (linearcode &&other)
+      : linearcode{ std::move (other), details::cache_use{ other.m_cache } }
+  {
+  }
 
 public:
   ///
@@ -132,59 +331,254 @@ public:
   const Eigen::MatrixXi &
   parity_matrix () const
   {
-    if (!m_lazy_parity_matrix.has_value ())
-      prepare_parity_matrix ();
+    ensure_built (lazy_table::ParityMatrix);
     // We either had it before or we just evaluated the parity matrix.
     assert (m_lazy_parity_matrix);
     return *m_lazy_parity_matrix;
   }
 
   ///
-  /// \brief Calculates the parity matrix for this code.
+  /// \brief The generator matrix of this code in systematic form - it
+  /// contains the identity matrix at the information positions.
+  /// \note It is equal to the one the code was created from, if that one was
+  /// already in standard form.
   ///
   const Eigen::MatrixXi &
   generator_matrix () const
   {
-    return m_generator;
+    if (!m_generator_matrix_built.load (std::memory_order_acquire))
+      [[unlikely]] prepare_generator_matrix ();
+    return *m_lazy_generator_matrix;
   }
 
-  const std::optional<std::vector<codeword> > &
-  codewords () const noexcept
+  [[nodiscard]] const family_type &
+  family () const noexcept
   {
-    if (!m_lazy_codewords.has_value ())
-      prepare_codewords ();
+    return m_family;
+  }
+
+  ///
+  /// \brief The column order which brings the generator into standard form
+  /// \f$(I|A)\f$.
+  /// \details Column \f$j\f$ of the standard form is column
+  /// `permutation ()[j]` of the code. Therefore, the first \f$k\f$ entries are
+  /// the information positions - the ones at which an encoded word contains
+  /// its infoword. Codewords, syndromes and the parity matrix are always
+  /// given in the original column order.
+  ///
+  const std::vector<std::size_t> &
+  permutation () const noexcept
+  {
+    return m_permutation;
+  }
+
+  const std::optional<codewords_type> &
+  codewords () const
+  {
+    ensure_built (lazy_table::Codewords);
     // We either had it before or we just evaluated it.
     assert (m_lazy_codewords);
     return m_lazy_codewords;
   }
 
-  const std::optional<std::vector<coset> > &
-  slepian_table () const noexcept
+  const std::optional<slepian_table_type> &
+  slepian_table () const
   {
-    if (!m_lazy_slepian_table.has_value ())
-      prepare_slepian_table ();
+    ensure_built (lazy_table::SlepianTable);
     // We either had it before or we just evaluated it.
     assert (m_lazy_slepian_table);
     return m_lazy_slepian_table;
   }
 
   const std::optional<syndrome_table_type> &
-  syndrome_table () const noexcept
+  syndrome_table () const
   {
-    if (!m_lazy_syndrome_table.has_value ())
-      prepare_syndrome_table ();
+    ensure_built (lazy_table::SyndromeTable);
     // We either had it before or we just evaluated it.
     assert (m_lazy_syndrome_table);
     return m_lazy_syndrome_table;
   }
 
+  const erasure_solutions_type &
+  erasure_solutions () const noexcept
+  {
+    return m_erasure_solutions;
+  }
+
+  ///
+  /// \brief The resource which the tables are allocated from. See \ref
+  /// set_table_resource.
+  ///
+  [[nodiscard]] std::pmr::memory_resource *
+  table_resource () const noexcept
+  {
+    return m_table_resource;
+  }
+
+  ///
+  /// \brief An estimate of the bytes held by the matrices and the tables
+  /// which are built on demand, including the storage of their words.
+  ///
+  [[nodiscard]] std::size_t cache_bytes () const noexcept;
+
+  ///
+  /// \brief What the code has done so far. It is all 0 unless the library
+  /// is built with \c PATRICK_ENABLE_STATS.
+  ///
+  [[nodiscard]] linearcode_stats
+  stats () const noexcept
+  {
+    return m_stats.snapshot ();
+  }
+
+  void
+  reset_stats () noexcept
+  {
+    m_stats.reset ();
+  }
+
 private:
+  const details::bitmatrix &
+  packed_parity_matrix () const
+  {
+    ensure_built (lazy_table::ParityMatrix);
+    assert (m_lazy_packed_parity_matrix);
+    return *m_lazy_packed_parity_matrix;
+  }
+
   ///
-  /// \param generator_matrix Representation of the linear code that is being
-  /// inspected.
+  /// \brief The coset leaders packed one after the other, so that the
+  /// leader of syndrome \f$s\f$ starts at block `s * blocks_for (n)`. Bit
+  /// \f$i\f$ of \f$s\f$ is the one of row \f$i\f$ of the parity matrix.
+  ///
+  const std::pmr::vector<details::bitmatrix::block_type> &
+  packed_syndrome_table () const
+  {
+    ensure_built (lazy_table::PackedSyndromeTable);
+    assert (m_lazy_packed_syndrome_table);
+    return *m_lazy_packed_syndrome_table;
+  }
+
+  ///
+  /// \return Whether \a table is built. Once this is true, the table may be
+  /// read without a lock until it is evicted.
+  ///
+  [[nodiscard]] bool
+  is_built (lazy_table table) const noexcept
+  {
+    return m_built[std::size_t (table)].load (std::memory_order_acquire);
+  }
+
+  ///
+  /// \brief Builds \a table unless it is built. Threads which share the
+  /// code build it once, since the first one to take \ref m_build_mutex
+  /// builds it and the others wait for it.
+  ///
+  void
+  ensure_built (lazy_table table) const
+  {
+    if (!is_built (table)) [[unlikely]]
+      build (table);
+  }
+
+  ///
+  /// \brief The slow path of \ref ensure_built.
+  ///
+  void build (lazy_table table) const;
+
+  ///
+  /// \brief Marks the tables which are there as built and the others as
+  /// not, once they were copied or moved in.
+  ///
+  void mark_present_built () noexcept;
+
+  ///
+  /// \brief Marks \a table, which was filled in directly, as built.
+  ///
+  void
+  mark_built (lazy_table table) const noexcept
+  {
+    m_built[std::size_t (table)].store (true, std::memory_order_release);
+  }
+
+  ///
+  /// \return The bytes held by \a table, as \ref cache_bytes estimates them.
+  ///
+  [[nodiscard]] std::size_t table_bytes (lazy_table table) const noexcept;
+
+  ///
+  /// \return Whether \a table would fit in the cache budget if it were built
+  /// along with the tables it is built from.
+  ///
+  [[nodiscard]] bool affords (lazy_table table) const noexcept;
+
+  ///
+  /// \brief Accounts for \a table, which was just built, in the cache budget.
+  ///
+  void
+  account_for (lazy_table table) const
+  {
+    m_cache.add (table, table_bytes (table));
+  }
+
+  ///
+  /// \brief Drops \a table to keep within the cache budget.
+  /// \note Called by the cache registry, which accounts for it.
+  ///
+  void evict (lazy_table table) noexcept;
+
+  ///
+  /// \brief Extracts the information positions of a codeword.
+  ///
+  [[nodiscard]] infoword information_of (const codeword &cword) const;
+
+  ///
+  /// \brief Extracts the information positions of a packed codeword into a
+  /// packed infoword.
+  ///
+  void information_of (const details::bitmatrix::block_type *cword,
+                       details::bitmatrix::block_type *iword) const noexcept;
+
+  ///
+  /// \brief Evaluates the properties of the code that is being inspected.
+  /// \details Unless it is already known, the minimum distance is read off
+  /// the weight distribution of either the code or its dual, whichever is of
+  /// smaller dimension. In the latter case the MacWilliams identity gives the
+  /// distribution of the code. Neither of them stores any codewords.
+  /// \param known_min_distance The minimum distance if it is already known.
   /// \note This is called in the ctor of \ref linearcode.
   ///
-  void evaluate_properties_of ();
+  void evaluate_properties_of (std::optional<std::size_t> known_min_distance);
+
+  ///
+  /// \brief Like \ref encode, but not counted in \ref stats.
+  ///
+  [[nodiscard]] codeword encode_uncounted (const infoword &iword) const;
+
+  ///
+  /// \brief Runs \a decode and counts its word in \ref stats under \a
+  /// decoder - a strategy, \ref details::soft_decoder or \ref
+  /// details::erasure_decoder. A decoder which throws has failed on it.
+  ///
+  template <typename Decode>
+  [[nodiscard]] decoding_result
+  counted (std::size_t decoder, Decode &&decode)
+  {
+    if constexpr (!details::stats_enabled)
+      return decode ();
+    else
+      try
+        {
+          auto result = decode ();
+          m_stats.count_decode (decoder, result.error.weight ());
+          return result;
+        }
+      catch (const linearcode_exception &)
+        {
+          m_stats.count_uncorrectable (decoder);
+          throw;
+        }
+  }
 
 private:
   ///
@@ -201,14 +595,108 @@ private:
   ///
   [[nodiscard]] decoding_result decode_with_syndromes (const codeword &cword);
 
+  ///
+  /// \brief Searches the error patterns by increasing weight for one with
+  /// the syndrome of \a cword. It finds the leader which the syndrome table
+  /// holds for the coset, so it decodes like \ref decode_with_syndromes
+  /// does, but needs no tables. It is what the table decoders give way to
+  /// when their tables do not fit in the cache budget.
+  /// \note Words in the cosets of heavy leaders take up to
+  /// \f$\sum_{w \leq n - k} \binom{n}{w}\f$ steps.
+  ///
+  [[nodiscard]] decoding_result decode_by_search (const codeword &cword) const;
+
+  ///
+  /// \brief Decodes using the structure of the family of the code, if there
+  /// is a decoder for it. Otherwise falls back to \ref decode_with_slepian.
+  ///
+  [[nodiscard]] decoding_result decode_with_structure (const codeword &cword);
+
+  ///
+  /// \brief Corrects a single error, whose position is given by the syndrome
+  /// with respect to the parity matrix of \ref hamming.
+  ///
+  [[nodiscard]] decoding_result decode_hamming (const codeword &cword) const;
+
+  ///
+  /// \brief Corrects up to 3 errors of the extended Golay code by comparing
+  /// the weights of its two syndromes with respect to \f$(I|B)\f$ and
+  /// \f$(B|I)\f$.
+  ///
+  [[nodiscard]] decoding_result decode_golay (const codeword &cword) const;
+
+  ///
+  /// \brief Corrects up to \f$t\f$ errors of a \ref bch code
+  /// algebraically. The error locator polynomial is found from the syndromes
+  /// by Berlekamp-Massey and its roots by a Chien search.
+  /// \throws \ref linearcode_exception if the code is not a BCH code, or if
+  /// more than \f$t\f$ errors are detected.
+  ///
+  [[nodiscard]] decoding_result
+  decode_with_chien (const codeword &cword) const;
+
+  ///
+  /// \brief Decodes a first-order \ref reed_muller code to the nearest
+  /// codeword. The correlations of the word with all codewords are the
+  /// Walsh-Hadamard transform of its \f$\pm 1\f$ form.
+  ///
+  [[nodiscard]] decoding_result
+  decode_with_hadamard (const codeword &cword) const;
+
+  ///
+  /// \brief Decodes a \ref reed_muller code of any order by Reed's majority
+  /// logic, which corrects up to \f$2^{m - r - 1} - 1\f$ errors.
+  /// \throws \ref linearcode_exception if the votes for a coefficient are
+  /// tied.
+  ///
+  [[nodiscard]] decoding_result
+  decode_with_majority (const codeword &cword) const;
+
+  ///
+  /// \throws \ref linearcode_exception if the code is not a Reed-Muller code
+  /// of order at most \a max_order.
+  ///
+  void ensure_reed_muller (std::size_t max_order) const;
+
+  ///
+  /// \brief Makes this code, which is \a mother shortened to the positions
+  /// \a kept, part of the family of \a mother, so that it keeps its
+  /// structure decoders.
+  ///
+  void shortened_from (const linearcode &mother,
+                       const std::vector<std::size_t> &kept);
+
+  ///
+  /// \brief Decodes a shortened code with \a decoder of the code of its
+  /// family. The positions it is shortened at are zeros of the word which
+  /// that one decodes.
+  /// \throws \ref linearcode_exception if the decoder does, or if it
+  /// corrects one of those positions, so that the decoded word is not a
+  /// codeword of this code.
+  ///
+  [[nodiscard]] decoding_result decode_shortened (
+      const codeword &cword,
+      decoding_result (linearcode::*decoder) (const codeword &) const) const;
+
+  ///
+  /// \throws \ref linearcode_exception if \a cword is not of the size of the
+  /// codewords of this code.
+  ///
+  void ensure_word_size (const codeword &cword) const;
+
   ///
   /// \brief Exhausts all valid codewords and stores them in \ref
   /// m_lazy_codewords.
-  /// \note May get called by `evaluate_properties_of()` and
-  /// `prepare_slepian_table()`.
+  /// \note May get called by `prepare_slepian_table()`.
   ///
   void prepare_codewords () const;
 
+  ///
+  /// \brief Unpacks the generator into \ref m_lazy_generator_matrix, once
+  /// for all threads which share the code.
+  ///
+  void prepare_generator_matrix () const;
+
   ///
   /// \brief Creates the parity matrix of the linear code.
   /// \note Called when trying to access the \ref parity_matrix member and it
@@ -226,6 +714,25 @@ private:
 
   void prepare_syndrome_table () const;
 
+  ///
+  /// \brief Packs the syndrome table, which it builds if needed, into \ref
+  /// m_lazy_packed_syndrome_table.
+  ///
+  void prepare_packed_syndrome_table () const;
+
+  ///
+  /// \brief Finds the solution of an erasure pattern, unless it is cached.
+  /// \param mask The packed mask of the erased positions.
+  /// \param positions The erased positions in increasing order.
+  /// \return The matrix \f$T\f$ for which \f$T H_E\f$ is the identity
+  /// matrix over the zero matrix, where \f$H_E\f$ is made of the columns of
+  /// the parity matrix at the positions.
+  /// \throws \ref linearcode_exception if the columns are dependent.
+  ///
+  const details::bitmatrix &
+  erasure_solution (std::vector<details::bitmatrix::block_type> mask,
+                    std::span<const std::size_t> positions);
+
 public:
   ///
   /// Operations
@@ -237,6 +744,22 @@ public:
     m_properties.special_name = t_special_name;
   }
 
+  ///
+  /// \brief Allocates the tables which are built from now on from \a
+  /// resource - for example a monotonic arena or a resource backed by huge
+  /// pages. The tables which are already built keep theirs. Copies of the
+  /// code and the codes derived from it by \ref shorten and \ref puncture
+  /// use it as well. It is the default resource of the time the code was
+  /// created unless this is called.
+  /// \note \a resource must outlive the tables allocated from it. Set it
+  /// before the code is shared between threads, unless it is thread-safe.
+  ///
+  void
+  set_table_resource (std::pmr::memory_resource *resource) noexcept
+  {
+    m_table_resource = resource;
+  }
+
   ///
   /// \brief Check whether a given codeword is in the code. That is equivalent,
   /// to the fact that the vector is in the vector subspace that is this code.
@@ -254,12 +777,77 @@ public:
   ///
   [[nodiscard]] codeword encode (const infoword &) const;
 
+  ///
+  /// \brief Shortens the code at \a positions - the result is made of the
+  /// codewords which are zero there, with those positions removed.
+  /// \details If all positions are information positions, the generator and
+  /// parity matrix of the result are read off the ones of this code, and so
+  /// are its codewords and its syndrome table, if this code has built them.
+  /// The coset leaders which avoid the positions stay leaders, so only the
+  /// cosets whose leaders do not are searched again. Otherwise the result is
+  /// built from the parity matrix with the positions removed.
+  ///
+  /// The result stays in the family of this code, and its structure
+  /// decoders decode it as a word of the code of the family with zeros at
+  /// the positions. They fail if they correct one of those.
+  /// \note The minimum distance in the properties of the result is the one
+  /// of this code, which is a lower bound of the actual one.
+  /// \throws \ref linearcode_exception if a position is out of range or
+  /// repeated, or if only the null vector is left.
+  ///
+  [[nodiscard]] linearcode
+  shorten (std::span<const std::size_t> positions) const;
+
+  ///
+  /// \brief Punctures the code at \a positions - the result is made of the
+  /// codewords with those positions removed.
+  /// \details If all positions are redundancy positions, the dimension is
+  /// kept and the generator and parity matrix of the result are read off
+  /// the ones of this code, and so are its codewords and its syndrome table,
+  /// if this code has built them. The leader of a syndrome of the result is
+  /// the lightest of the leaders of the syndromes which it is a part of,
+  /// with the positions removed. Otherwise the result is built from the
+  /// generator with the positions removed.
+  ///
+  /// The result is a \ref code_family::Generic code, since the decoders of
+  /// the families cannot tell the values at the positions. So it is decoded
+  /// with the tables, which are only affordable for a short code - or, with
+  /// \ref decoding_strategy::Syndromes and \ref decode_batch, for a small
+  /// redundancy.
+  /// \note If fewer than \f$d\f$ positions are removed, the minimum distance
+  /// in the properties of the result is \f$d\f$ less their number, which is
+  /// a lower bound of the actual one.
+  /// \throws \ref linearcode_exception if a position is out of range or
+  /// repeated, or if the dimension would drop.
+  ///
+  [[nodiscard]] linearcode
+  puncture (std::span<const std::size_t> positions) const;
+
+  ///
+  /// \note The table strategies give way to ones which need less memory if
+  /// their tables do not fit in the cache budget (see \ref
+  /// set_cache_budget).
+  ///
   enum class decoding_strategy
   {
     SlepyanTable,
-    Syndromes
+    Syndromes,
+    /// Berlekamp-Massey and a Chien search. Only for BCH codes, but needs
+    /// no tables, so it works for any length.
+    ChienSearch,
+    /// Maximum likelihood decoding with the fast Hadamard transform. Only
+    /// for Reed-Muller codes of first order.
+    FastHadamard,
+    /// Reed's majority logic. Only for Reed-Muller codes.
+    MajorityLogic,
+    /// Uses the structure of the code family if there is a decoder for it,
+    /// and the Slepian table otherwise.
+    Auto
   };
 
+  static_assert (std::size_t (decoding_strategy::Auto) + 1
+                 == linearcode_stats::num_strategies);
+
   ///
   /// \brief Tries to decode a code word into its corresponding
   /// information word. The algorithm is based on maximum likelihood decoding.
@@ -271,35 +859,118 @@ public:
   /// \return Either the decoded \ref
   /// infoword, or an empty value.
   ///
-  template <enum decoding_strategy Strategy = decoding_strategy::SlepyanTable>
+  template <enum decoding_strategy Strategy = decoding_strategy::Auto>
   [[nodiscard]] decoding_result
   decode (const codeword &cword)
   {
     // Safety: This invariant is established during instantiation.
-    assert (!m_generator.isZero ());
-
-    using enum decoding_strategy;
-    if constexpr (Strategy == SlepyanTable)
-      return decode_with_slepian (cword);
-    if constexpr (Strategy == Syndromes)
-      return decode_with_syndromes (cword);
-
-    /// There are only two valid values for an enumerator of \ref
-    /// decoding_strategy. If this line is reached (and the if statements
-    /// actually exhaust all values), then \ref decode has been called
-    /// in a semantically correct way such as
-    /// `decode<static_cast<[...]>(42)>([...]);`
-    throw linearcode_exception{ fmt::format (
-        "Invalid decoding strategy '{}' used with linear code.",
-        static_cast<std::uint8_t> (Strategy)) };
+    assert (!m_packed_generator.is_zero ());
+
+    const details::cache_use use{ m_cache };
+    return counted (std::size_t (Strategy), [&] () -> decoding_result {
+      using enum decoding_strategy;
+      if constexpr (Strategy == SlepyanTable)
+        return decode_with_slepian (cword);
+      if constexpr (Strategy == Syndromes)
+        return decode_with_syndromes (cword);
+      if constexpr (Strategy == ChienSearch)
+        return decode_with_chien (cword);
+      if constexpr (Strategy == FastHadamard)
+        return decode_with_hadamard (cword);
+      if constexpr (Strategy == MajorityLogic)
+        return decode_with_majority (cword);
+      if constexpr (Strategy == Auto)
+        return decode_with_structure (cword);
+
+      /// There are only six valid values for an enumerator of \ref
+      /// decoding_strategy. If this line is reached (and the if statements
+      /// actually exhaust all values), then \ref decode has been called
+      /// in a semantically correct way such as
+      /// `decode<static_cast<[...]>(42)>([...]);`
+      throw linearcode_exception{ fmt::format (
+          "Invalid decoding strategy '{}' used with linear code.",
+          static_cast<std::uint8_t> (Strategy)) };
+    });
   }
 
+  ///
+  /// \brief Decodes a word received through a soft channel.
+  /// \param llrs The log-likelihood ratios \f$\log \frac{P(0)}{P(1)}\f$ of
+  /// the received bits.
+  /// \details First-order Reed-Muller codes which are not shortened are
+  /// decoded to the most likely codeword given the ratios. Every other code
+  /// decodes the hard decisions as \ref decoding_strategy::Auto does.
+  /// \return The decoded information word and the difference between the
+  /// hard decisions and the decoded codeword.
+  ///
+  [[nodiscard]] decoding_result decode_soft (std::span<const float> llrs);
+
+  ///
+  /// \brief Recovers the erased bits of a word received through an erasure
+  /// channel, which are the unknowns of the parity equations restricted to
+  /// the erased columns.
+  /// \details The equations of an erasure pattern are solved once by
+  /// Gaussian elimination on the packed parity matrix, and the solution is
+  /// kept in \ref erasure_solutions. Then the erased bits of every word are
+  /// dot products of the rows of the solution with its syndrome. No tables
+  /// are needed, so this works for codes of any size, and any pattern of at
+  /// most \f$d - 1\f$ erasures is recovered.
+  /// \param cword The received word. Its erased bits are ignored.
+  /// \param erasures The mask of the erased positions.
+  /// \return The decoded information word and the difference between \a
+  /// cword and the decoded codeword, which is within the erased positions.
+  /// \throws \ref linearcode_exception if the erased bits cannot be told
+  /// apart, or if the bits which are not erased are not part of a codeword.
+  ///
+  [[nodiscard]] decoding_result decode_erasures (const codeword &cword,
+                                                 const codeword &erasures);
+
+  ///
+  /// \brief Encodes \a count infowords at once.
+  /// \param infowords The packed infowords, one after the other, each in
+  /// \ref details::bitmatrix::blocks_for `(k)` blocks.
+  /// \param codewords The packed codewords are written here in the same
+  /// way, each in `blocks_for (n)` blocks.
+  ///
+  void encode_batch (
+      std::span<const details::bitmatrix::block_type> infowords,
+      std::span<details::bitmatrix::block_type> codewords,
+      std::size_t count) const noexcept;
+
+  ///
+  /// \brief Decodes \a count received words at once.
+  /// \details A generic code with a redundancy of at most \ref
+  /// max_packed_table_redundancy looks up the error of a word in \ref
+  /// packed_syndrome_table, which is built once. So it decodes like \ref
+  /// decoding_strategy::Syndromes does, but with no allocations. Every other
+  /// code, and one whose packed table does not fit in the cache budget,
+  /// decodes word by word like \ref decoding_strategy::Syndromes does if it
+  /// is generic and \ref decoding_strategy::Auto does otherwise.
+  /// \param received The packed words, laid out like the codewords of \ref
+  /// encode_batch.
+  /// \param infowords The packed infowords are written here, laid out like
+  /// the ones of \ref encode_batch. The infoword of a word on which the
+  /// decoder fails is read off its information positions.
+  /// \param failures Unless empty, entry \f$i\f$ is set to whether the
+  /// decoder failed on word \f$i\f$.
+  /// \return The number of words on which the decoder failed.
+  ///
+  std::size_t
+  decode_batch (std::span<const details::bitmatrix::block_type> received,
+                std::span<details::bitmatrix::block_type> infowords,
+                std::size_t count, std::span<std::uint8_t> failures = {});
+
 private:
   ///
   /// \brief The internal representation of a linear code is based
   /// on a generator matrix.
   ///
-  const Eigen::MatrixXi m_generator;
+  const details::bitmatrix m_packed_generator;
+
+  ///
+  /// \brief See \ref permutation.
+  ///
+  const std::vector<std::size_t> m_permutation;
 
   ///
   /// \brief The basic properties of the linear code that is
@@ -307,16 +978,81 @@ private:
   ///
   properties_type m_properties;
 
+  family_type m_family;
+
+  ///
+  /// \brief The code of \ref m_family which this one is shortened from,
+  /// and the positions of it which are kept, in order. Copies of a code
+  /// share it. See \ref decode_shortened.
+  ///
+  std::shared_ptr<const linearcode> m_family_code;
+  std::vector<std::size_t> m_family_positions;
+
+  ///
+  /// \brief See \ref set_table_resource.
+  ///
+  std::pmr::memory_resource *m_table_resource{
+    std::pmr::get_default_resource ()
+  };
+
   // TODO: Make these lazy_loaded<T, LoadFunc, Args ...>
 
   ///
   /// \brief All codewords that are part of the linear code. They are stored is
   /// sorted order, relative to their order.
   ///
-  mutable std::optional<std::vector<codeword> > m_lazy_codewords;
+  mutable std::optional<codewords_type> m_lazy_codewords;
+  mutable std::optional<Eigen::MatrixXi> m_lazy_generator_matrix;
   mutable std::optional<Eigen::MatrixXi> m_lazy_parity_matrix;
-  mutable std::optional<std::vector<coset> > m_lazy_slepian_table;
+  mutable std::optional<details::bitmatrix> m_lazy_packed_parity_matrix;
+  mutable std::optional<slepian_table_type> m_lazy_slepian_table;
   mutable std::optional<syndrome_table_type> m_lazy_syndrome_table;
+  mutable std::optional<std::pmr::vector<details::bitmatrix::block_type> >
+      m_lazy_packed_syndrome_table;
+
+  ///
+  /// \brief Whether \ref m_lazy_generator_matrix is built. It is never
+  /// evicted, so it is not one of the tables of \ref m_built.
+  ///
+  mutable std::atomic<bool> m_generator_matrix_built{ false };
+
+  ///
+  /// \brief The field of the roots of a \ref bch code, which its decoder
+  /// needs. It is built along with the code, so that threads only read it.
+  ///
+  std::optional<details::galois_field> m_field;
+
+  ///
+  /// \brief Which of the tables above are built. See \ref ensure_built.
+  /// An evicted table is marked as not built before it is dropped.
+  ///
+  mutable std::array<std::atomic<bool>, linearcode_stats::num_tables>
+      m_built{};
+
+  ///
+  /// \brief Held while a table is built. It is recursive, since building a
+  /// table may need another one - the Slepian table needs the codewords,
+  /// for example.
+  ///
+  mutable std::recursive_mutex m_build_mutex;
+
+  ///
+  /// \brief See \ref erasure_solutions.
+  ///
+  erasure_solutions_type m_erasure_solutions;
+
+  ///
+  /// \brief See \ref stats.
+  ///
+  [[no_unique_address]] mutable details::stats_counters m_stats;
+
+  ///
+  /// \brief The tables of the code in the cache budget. It is the last
+  /// member, so that it leaves the budget before the tables are destroyed.
+  ///
+  mutable details::cache_slot m_cache{ *this };
+
+  friend class details::cache_registry;
 };
 
 } // namespace patrick
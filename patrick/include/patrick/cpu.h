@@ -0,0 +1,35 @@
+/// \file
+
+#ifndef PATRICK_CPU_H_INCLUDED
+#define PATRICK_CPU_H_INCLUDED
+
+namespace patrick
+{
+
+namespace details
+{
+
+///
+/// \brief Instruction set extensions which the vectorized kernels may use.
+/// \details The kernels are compiled for their extension regardless of the
+/// flags of the build, and the one to run is selected at runtime based on
+/// these. Every kernel has a portable fallback.
+///
+struct cpu_features
+{
+  bool ssse3{ false };
+  bool avx2{ false };
+  bool pclmul{ false };
+};
+
+///
+/// \brief The features of the CPU that the process runs on. They are
+/// detected on the first call.
+///
+[[nodiscard]] const cpu_features &cpu () noexcept;
+
+} // namespace details
+
+} // namespace patrick
+
+#endif // PATRICK_CPU_H_INCLUDED
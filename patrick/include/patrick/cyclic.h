@@ -0,0 +1,225 @@
+/// \file
+
+#ifndef PATRICK_CYCLIC_H_INCLUDED
+#define PATRICK_CYCLIC_H_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <patrick/word.h>
+
+namespace patrick
+{
+
+///
+/// \class cyclic_code_exception
+/// \brief Indicates an exceptional behaviour during an operation of a
+/// \ref cyclic_code instance.
+///
+class cyclic_code_exception : public std::runtime_error
+{
+public:
+  explicit cyclic_code_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+namespace details
+{
+
+///
+/// \brief The values which \ref polynomial_divisor precomputes for its
+/// divisor \f$g(x)\f$ of degree \f$r\f$.
+///
+struct reduction_constants
+{
+  std::size_t degree{ 0 };
+  /// The packed coefficients of \f$g\f$.
+  std::vector<std::uint64_t> divisor;
+  /// \f$\mu = \lfloor x^{r + 64} / g \rfloor\f$ without its leading
+  /// coefficient, which is that of \f$x^{64}\f$.
+  std::uint64_t barrett{ 0 };
+  /// \f$x^{e} \bmod g\f$ for \f$e = 128, 192, 512, 576\f$, used for
+  /// folding when \f$r \leq 64\f$.
+  std::array<std::uint64_t, 4> folding{};
+};
+
+///
+/// \class polynomial_divisor
+/// \brief Computes remainders modulo a fixed polynomial \f$g(x)\f$ over
+/// \f$F_{2}\f$ of degree \f$r\f$, 64 coefficients at a time.
+/// \details Polynomials are packed like the rows of \ref bitmatrix - the
+/// coefficient of \f$x^{i}\f$ is bit \f$i \bmod 64\f$ of digit
+/// \f$\lfloor i / 64 \rfloor\f$.
+///
+/// The dividend is consumed from its highest digit. Appending a digit \f$d\f$
+/// to a remainder \f$s\f$ gives \f$s x^{64} + d\f$, whose quotient by
+/// \f$g\f$ is found by Barrett reduction from its top 64 coefficients \f$t\f$
+/// as \f$\lfloor t \mu / x^{64} \rfloor\f$. Both products are carry-less.
+///
+/// If \f$r \leq 64\f$, long dividends are first folded 64 bytes at a time
+/// into 4 independent 128-bit lanes, by multiplying them with
+/// \f$x^{512} \bmod g\f$ and \f$x^{576} \bmod g\f$.
+///
+/// Carry-less products use `pclmulqdq` on CPUs which have it.
+///
+class polynomial_divisor
+{
+public:
+  using digit_type = std::uint64_t;
+  static constexpr std::size_t digit_bits = 64;
+
+  ///
+  /// \param divisor The packed coefficients of \f$g(x)\f$ of degree at least
+  /// 1.
+  ///
+  explicit polynomial_divisor (std::span<const digit_type> divisor);
+
+  [[nodiscard]] std::size_t
+  degree () const noexcept
+  {
+    return m_constants.degree;
+  }
+
+  ///
+  /// \brief The number of digits of a remainder.
+  ///
+  [[nodiscard]] std::size_t
+  remainder_digits () const noexcept
+  {
+    return (m_constants.degree + digit_bits - 1) / digit_bits;
+  }
+
+  ///
+  /// \brief Writes the remainder of \a dividend to \a remainder.
+  /// \pre \a remainder has \ref remainder_digits digits.
+  ///
+  void remainder (std::span<const digit_type> dividend,
+                  std::span<digit_type> remainder) const noexcept;
+
+  ///
+  /// \brief The portable implementation of \ref remainder.
+  ///
+  void remainder_portable (std::span<const digit_type> dividend,
+                           std::span<digit_type> remainder) const noexcept;
+
+private:
+  reduction_constants m_constants;
+};
+
+} // namespace details
+
+///
+/// \class cyclic_code
+/// \brief Represents a binary cyclic \f$[n, k]\f$ code given by its
+/// generator polynomial \f$g(x)\f$ of degree \f$n - k\f$.
+/// \details Codeword position \f$i\f$ holds the coefficient of \f$x^{i}\f$.
+/// Encoding is systematic - the message occupies the positions from
+/// \f$n - k\f$ up, and the positions below hold the remainder of
+/// \f$m(x) x^{n - k}\f$ modulo \f$g(x)\f$. No matrix is stored, so the code
+/// may be arbitrarily long.
+///
+/// If \f$g(x)\f$ does not divide \f$x^{n} - 1\f$, this is a shortened cyclic
+/// code, as used by CRCs.
+///
+class cyclic_code final
+{
+public:
+  ///
+  /// Related types
+  ///
+
+  using digit_type = details::polynomial_divisor::digit_type;
+
+  struct properties_type
+  {
+    std::size_t word_size{ 0 };
+    std::size_t basis_size{ 0 };
+  };
+
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \param n The length of the codewords.
+  /// \param generator The packed coefficients of \f$g(x)\f$.
+  /// \throws \ref cyclic_code_exception unless \f$1 \leq \deg g < n\f$.
+  ///
+  cyclic_code (std::size_t n, std::span<const digit_type> generator);
+
+  ///
+  /// \brief The cyclic form of the Hamming code of length \f$2^{r} - 1\f$,
+  /// generated by a primitive polynomial of degree \a r.
+  ///
+  [[nodiscard]] static cyclic_code hamming (std::size_t r);
+
+  ///
+  /// \brief The narrow-sense binary BCH code of length \f$2^{m} - 1\f$ which
+  /// corrects \a t errors. It is the same code as \ref linearcode::bch.
+  ///
+  [[nodiscard]] static cyclic_code bch (std::size_t m, std::size_t t);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] const properties_type &
+  properties () const &noexcept
+  {
+    return m_properties;
+  }
+
+  ///
+  /// \return Whether \f$g(x)\f$ divides \f$x^{n} - 1\f$, that is whether
+  /// every cyclic shift of a codeword is a codeword.
+  ///
+  [[nodiscard]] bool is_cyclic () const;
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Encodes a packed message of \f$k\f$ bits into a packed codeword
+  /// of \f$n\f$ bits.
+  ///
+  void encode (std::span<const digit_type> message,
+               std::span<digit_type> cword) const;
+
+  [[nodiscard]] codeword encode (const infoword &iword) const;
+
+  ///
+  /// \brief Writes the remainder of the packed \a cword modulo \f$g(x)\f$,
+  /// which is zero for codewords.
+  ///
+  void syndrome_of (std::span<const digit_type> cword,
+                    std::span<digit_type> syndrome) const;
+
+  ///
+  /// \return The remainder of \a cword modulo \f$g(x)\f$ - position \f$i\f$
+  /// holds the coefficient of \f$x^{i}\f$.
+  ///
+  [[nodiscard]] syndrome syndrome_of (const codeword &cword) const;
+
+  [[nodiscard]] bool contains (const codeword &cword) const;
+
+private:
+  void ensure_digits (std::size_t digits, std::size_t bits) const;
+
+private:
+  details::polynomial_divisor m_divisor;
+  properties_type m_properties;
+};
+
+} // namespace patrick
+
+#endif // PATRICK_CYCLIC_H_INCLUDED
@@ -0,0 +1,197 @@
+/// \file
+
+#ifndef PATRICK_GF2M_H_INCLUDED
+#define PATRICK_GF2M_H_INCLUDED
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+class galois_field_exception : public std::runtime_error
+{
+public:
+  explicit galois_field_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("galois_field_exception: {}", msg) }
+  {
+  }
+};
+
+///
+/// \class galois_field
+/// \brief Arithmetic in the finite field \f$GF(2^{m})\f$.
+/// \details Elements are polynomials over \f$F_{2}\f$ of degree less than
+/// \f$m\f$, stored as bit masks. Every nonzero element is a power of the
+/// primitive element \f$\alpha\f$, so multiplication is done by adding
+/// logarithms. The antilog table is stored twice over, so that the sum of two
+/// logarithms never needs to be reduced.
+///
+class galois_field
+{
+public:
+  using element_type = std::uint32_t;
+
+  static constexpr std::size_t min_degree = 2;
+  static constexpr std::size_t max_degree = 16;
+
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \brief Creates the field using a default primitive polynomial of
+  /// degree \a m.
+  ///
+  explicit galois_field (std::size_t m)
+      : galois_field (m, default_primitive_polynomial (m))
+  {
+  }
+
+  ///
+  /// \param primitive_polynomial Bit mask of a primitive polynomial of
+  /// degree \a m, including the \f$x^{m}\f$ term.
+  /// \throws \ref galois_field_exception if the polynomial is not primitive.
+  ///
+  galois_field (std::size_t m, std::uint32_t primitive_polynomial);
+
+  [[nodiscard]] static std::uint32_t
+  default_primitive_polynomial (std::size_t m);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] std::size_t
+  degree () const noexcept
+  {
+    return m_degree;
+  }
+
+  ///
+  /// \brief The order of the multiplicative group - \f$2^{m} - 1\f$.
+  ///
+  [[nodiscard]] std::size_t
+  order () const noexcept
+  {
+    return m_order;
+  }
+
+  [[nodiscard]] std::uint32_t
+  primitive_polynomial () const noexcept
+  {
+    return m_polynomial;
+  }
+
+public:
+  ///
+  /// Arithmetics
+  ///
+
+  ///
+  /// \return \f$\alpha^{i}\f$.
+  ///
+  [[nodiscard]] element_type
+  exp (std::size_t i) const noexcept
+  {
+    return m_antilog[i % m_order];
+  }
+
+  ///
+  /// \return \f$\log_{\alpha} a\f$ for \f$a \neq 0\f$.
+  ///
+  [[nodiscard]] std::size_t
+  log (element_type a) const noexcept
+  {
+    assert (a != 0);
+    return m_log[a];
+  }
+
+  [[nodiscard]] static element_type
+  add (element_type a, element_type b) noexcept
+  {
+    return a ^ b;
+  }
+
+  [[nodiscard]] element_type
+  mul (element_type a, element_type b) const noexcept
+  {
+    if (a == 0 || b == 0)
+      return 0;
+    return m_antilog[m_log[a] + m_log[b]];
+  }
+
+  [[nodiscard]] element_type
+  inv (element_type a) const noexcept
+  {
+    assert (a != 0);
+    return m_antilog[m_order - m_log[a]];
+  }
+
+  [[nodiscard]] element_type
+  div (element_type a, element_type b) const noexcept
+  {
+    assert (b != 0);
+    if (a == 0)
+      return 0;
+    return m_antilog[m_log[a] + m_order - m_log[b]];
+  }
+
+  [[nodiscard]] element_type
+  pow (element_type a, std::size_t e) const noexcept
+  {
+    if (a == 0)
+      return e == 0;
+    return exp ((m_log[a] * (e % m_order)) % m_order);
+  }
+
+  ///
+  /// \brief Evaluates a polynomial at \a x by Horner's rule.
+  /// \param poly The coefficients, starting from the constant term.
+  ///
+  [[nodiscard]] element_type
+  evaluate (std::span<const element_type> poly, element_type x) const noexcept
+  {
+    element_type result = 0;
+    for (auto it = poly.rbegin (); it != poly.rend (); ++it)
+      result = add (mul (result, x), *it);
+    return result;
+  }
+
+  ///
+  /// \brief The table of \f$\alpha^{i}\f$ for \f$0 \leq i < 2(2^{m} - 1)\f$.
+  ///
+  [[nodiscard]] std::span<const element_type>
+  antilog_table () const noexcept
+  {
+    return m_antilog;
+  }
+
+  ///
+  /// \return The minimal polynomial of \f$\alpha^{i}\f$ over \f$F_{2}\f$ as a
+  /// bit mask. Its roots are the elements of the cyclotomic coset of \a i.
+  ///
+  [[nodiscard]] std::uint32_t minimal_polynomial (std::size_t i) const;
+
+private:
+  std::size_t m_degree;
+  std::size_t m_order;
+  std::uint32_t m_polynomial;
+  std::vector<element_type> m_antilog;
+  std::vector<std::uint32_t> m_log;
+};
+
+} // namespace details
+
+} // namespace patrick
+
+#endif // PATRICK_GF2M_H_INCLUDED
@@ -0,0 +1,241 @@
+/// \file
+
+#ifndef PATRICK_INTERLEAVER_H_INCLUDED
+#define PATRICK_INTERLEAVER_H_INCLUDED
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <patrick/bitmatrix.h>
+#include <patrick/word.h>
+
+namespace patrick
+{
+
+///
+/// \class interleaver_exception
+/// \brief Indicates an exceptional behaviour during an operation of an
+/// interleaver.
+///
+class interleaver_exception : public std::runtime_error
+{
+public:
+  explicit interleaver_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+namespace details
+{
+
+///
+/// \brief Transposes the \a rows by \a cols bit matrix which is stored row
+/// after row in the packed stream \a in, and writes the result the same way
+/// to \a out.
+/// \details Bits are packed like the rows of \ref bitmatrix, but the rows of
+/// the matrix follow each other with no padding. The matrix is transposed
+/// in 64x64 tiles with \ref transpose64, which are gathered from and
+/// scattered to the streams 64 bits at a time.
+///
+void transpose_stream (std::span<const std::uint64_t> in,
+                       std::span<std::uint64_t> out, std::size_t rows,
+                       std::size_t cols) noexcept;
+
+} // namespace details
+
+///
+/// \class block_interleaver
+/// \brief Writes bits row by row into a matrix and reads them column by
+/// column.
+/// \details With a row per codeword, a burst of up to `rows ()` consecutive
+/// errors of the interleaved stream corrupts every codeword at most once.
+///
+class block_interleaver final
+{
+public:
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \throws \ref interleaver_exception if either dimension is 0.
+  ///
+  block_interleaver (std::size_t rows, std::size_t cols);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] std::size_t
+  rows () const noexcept
+  {
+    return m_rows;
+  }
+
+  [[nodiscard]] std::size_t
+  cols () const noexcept
+  {
+    return m_cols;
+  }
+
+  ///
+  /// \return The number of bits of a block.
+  ///
+  [[nodiscard]] std::size_t
+  size () const noexcept
+  {
+    return m_rows * m_cols;
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Interleaves a block of packed bits.
+  /// \param in, out Packed blocks of `size ()` bits each.
+  /// \throws \ref interleaver_exception if either is too short.
+  ///
+  void interleave (std::span<const std::uint64_t> in,
+                   std::span<std::uint64_t> out) const;
+
+  ///
+  /// \brief Undoes \ref interleave.
+  ///
+  void deinterleave (std::span<const std::uint64_t> in,
+                     std::span<std::uint64_t> out) const;
+
+  ///
+  /// \brief Interleaves the concatenation of \a cwords, which must have
+  /// `size ()` bits in total.
+  ///
+  [[nodiscard]] codeword interleave (std::span<const codeword> cwords) const;
+
+  ///
+  /// \brief Undoes \ref interleave and splits the result into codewords of
+  /// `cols ()` bits.
+  ///
+  [[nodiscard]] std::vector<codeword>
+  deinterleave (const codeword &stream) const;
+
+private:
+  std::size_t m_rows{ 0 };
+  std::size_t m_cols{ 0 };
+};
+
+///
+/// \class convolutional_interleaver
+/// \brief A streaming interleaver which deals consecutive bits to \f$B\f$
+/// branches in turn. Branch \f$i\f$ delays its bits by \f$i M\f$ of its
+/// own bits.
+/// \details The matching deinterleaver delays branch \f$i\f$ by
+/// \f$(B - 1 - i) M\f$, so that every bit comes out of the pair
+/// \f$B (B - 1) M\f$ bits late. A burst of up to \f$B M\f$ errors is spread
+/// so that consecutive errors are at least \f$B\f$ bits apart. The delay
+/// lines start out zero.
+///
+/// The stream is processed as a matrix with a column per branch. It is
+/// transposed with \ref details::transpose_stream so that every branch is a
+/// contiguous run of bits, which is shifted through its delay line a word
+/// at a time and transposed back.
+///
+class convolutional_interleaver final
+{
+public:
+  ///
+  /// Related types
+  ///
+
+  enum class direction_type : std::uint8_t
+  {
+    Interleave,
+    Deinterleave
+  };
+
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \param branches The number of branches \f$B\f$.
+  /// \param delay The increment \f$M\f$ of the delay between branches.
+  /// \throws \ref interleaver_exception if \f$B = 0\f$.
+  ///
+  convolutional_interleaver (std::size_t branches, std::size_t delay,
+                             direction_type direction
+                             = direction_type::Interleave);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] std::size_t
+  branches () const noexcept
+  {
+    return m_delays.size ();
+  }
+
+  ///
+  /// \return The delay of a bit through an interleaver and a deinterleaver.
+  ///
+  [[nodiscard]] std::size_t
+  latency () const noexcept
+  {
+    return branches () * (branches () - 1) * m_delay;
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Passes \a num_bits packed bits through the branches.
+  /// \details The stream must be fed in pieces whose sizes are multiples
+  /// of `branches ()`, so that every piece starts at branch 0.
+  /// \throws \ref interleaver_exception if it is not, or if \a in or \a out
+  /// is too short.
+  ///
+  void push (std::span<const std::uint64_t> in, std::span<std::uint64_t> out,
+             std::size_t num_bits);
+
+  [[nodiscard]] codeword push (const codeword &stream);
+
+  ///
+  /// \brief Zeroes the delay lines.
+  ///
+  void reset () noexcept;
+
+private:
+  std::size_t m_delay{ 0 };
+
+  ///
+  /// \brief The delay of each branch in bits of the branch.
+  ///
+  std::vector<std::size_t> m_delays;
+
+  ///
+  /// \brief The packed contents of the delay line of each branch, oldest
+  /// first.
+  ///
+  std::vector<std::vector<std::uint64_t> > m_lines;
+
+  ///
+  /// \brief The stream with a row per branch, and the branches after the
+  /// delay.
+  ///
+  std::vector<std::uint64_t> m_branches_in;
+  std::vector<std::uint64_t> m_branches_out;
+};
+
+} // namespace patrick
+
+#endif // PATRICK_INTERLEAVER_H_INCLUDED
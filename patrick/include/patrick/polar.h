@@ -0,0 +1,234 @@
+/// \file
+
+#ifndef PATRICK_POLAR_H_INCLUDED
+#define PATRICK_POLAR_H_INCLUDED
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <patrick/core.h>
+#include <patrick/cyclic.h>
+
+namespace patrick
+{
+
+///
+/// \class polar_code_exception
+/// \brief Indicates an exceptional behaviour during an operation of a
+/// \ref polar_code instance.
+///
+class polar_code_exception : public std::runtime_error
+{
+public:
+  explicit polar_code_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+namespace details
+{
+
+///
+/// \brief Multiplies the packed row vector \a bits of length \f$2^{m}\f$ by
+/// \f$F^{\otimes m}\f$, where \f$F = \begin{pmatrix} 1 & 0 \\ 1 & 1
+/// \end{pmatrix}\f$, in place. The transform is its own inverse.
+/// \details Bits are packed like the rows of \ref bitmatrix. The butterflies
+/// of the stages within a digit are done with shifts and masks, the others
+/// by whole digits.
+///
+void polar_transform (std::span<std::uint64_t> bits, std::size_t m) noexcept;
+
+class list_decoder;
+
+} // namespace details
+
+///
+/// \class polar_code
+/// \brief Represents a polar code of length \f$n = 2^{m}\f$ whose codewords
+/// are \f$u F^{\otimes m}\f$, where \f$u\f$ is zero at the frozen positions.
+/// \details The information set is made of the most reliable bit channels
+/// for an AWGN channel with BPSK at a design SNR, as estimated by one of
+/// \ref construction_type.
+///
+/// Optionally, the information bits are followed by a CRC of them, so that
+/// list decoding may pick the most likely path which satisfies it. The
+/// information set then also holds the CRC bits - the \f$k\f$ information
+/// bits go to its lowest positions and the CRC to the highest ones.
+///
+class polar_code final
+{
+public:
+  ///
+  /// Related types
+  ///
+
+  using decoding_result = linearcode::decoding_result;
+
+  ///
+  /// \brief How the reliabilities of the bit channels are estimated.
+  ///
+  enum class construction_type : std::uint8_t
+  {
+    /// Tracks upper bounds of the Bhattacharyya parameters, which are exact
+    /// for an erasure channel.
+    Bhattacharyya,
+    /// Tracks the means of the log-likelihood ratios, assuming they are
+    /// Gaussian.
+    GaussianApproximation
+  };
+
+  struct properties_type
+  {
+    std::size_t word_size{ 0 };
+    std::size_t basis_size{ 0 };
+    std::size_t crc_size{ 0 };
+  };
+
+  static constexpr std::size_t max_log_size = 20;
+
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \param m The logarithm of the length.
+  /// \param k The number of information bits.
+  /// \param design_snr The design \f$E_{s}/N_{0}\f$ in dB.
+  /// \param crc The packed generator polynomial of the CRC, including its
+  /// leading term, or 0 for none.
+  /// \throws \ref polar_code_exception unless \f$1 \leq m \leq 20\f$ and
+  /// \f$1 \leq k\f$ and there is room for \f$k\f$ bits and the CRC.
+  ///
+  polar_code (std::size_t m, std::size_t k,
+              construction_type construction
+              = construction_type::GaussianApproximation,
+              double design_snr = 0.0, std::uint64_t crc = 0);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] const properties_type &
+  properties () const &noexcept
+  {
+    return m_properties;
+  }
+
+  ///
+  /// \return Whether each position of \f$u\f$ is frozen.
+  ///
+  [[nodiscard]] const std::vector<bool> &
+  frozen () const &noexcept
+  {
+    return m_frozen;
+  }
+
+  ///
+  /// \return The positions of \f$u\f$ which are not frozen, in increasing
+  /// order.
+  ///
+  [[nodiscard]] const std::vector<std::size_t> &
+  information_set () const &noexcept
+  {
+    return m_information_set;
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  [[nodiscard]] codeword encode (const infoword &iword) const;
+
+  ///
+  /// \brief Decodes hard decisions, as \ref decode_soft does with
+  /// log-likelihood ratios of \f$\pm 1\f$.
+  ///
+  [[nodiscard]] decoding_result decode (const codeword &cword,
+                                        std::size_t list_size = 1) const;
+
+  ///
+  /// \brief Decodes a word received through a soft channel.
+  /// \param llrs The log-likelihood ratios \f$\log \frac{P(0)}{P(1)}\f$ of
+  /// the received bits.
+  /// \param list_size The number of paths kept by successive cancellation
+  /// list decoding. If it is 1, the fast simplified successive cancellation
+  /// decoder is used, which decodes whole subcodes which are rate 0, rate 1,
+  /// repetition or single parity check codes at once.
+  /// \details List decoding skips rate 0 subcodes as well. The memory of the
+  /// paths is shared until they diverge - a path which is split only points
+  /// to the buffers of its parent, and a buffer is copied the first time
+  /// one of its sharers writes to it.
+  /// \return The decoded information word and the difference between the
+  /// hard decisions and the decoded codeword.
+  /// \throws \ref polar_code_exception if there is a CRC and no surviving
+  /// path satisfies it.
+  ///
+  [[nodiscard]] decoding_result
+  decode_soft (std::span<const float> llrs, std::size_t list_size = 1) const;
+
+private:
+  ///
+  /// \brief The kinds of subcodes which the fast decoder recognizes.
+  ///
+  enum class node_type : std::uint8_t
+  {
+    RateZero,
+    RateOne,
+    Repetition,
+    SingleParityCheck,
+    Other
+  };
+
+  ///
+  /// \return Node \f$j\f$ of depth \f$d\f$, which covers the positions of
+  /// \f$u\f$ from \f$j 2^{m - d}\f$ on, is at \f$2^{d} + j\f$.
+  ///
+  [[nodiscard]] node_type
+  type_of (std::size_t depth, std::size_t index) const noexcept
+  {
+    return m_node_types[(std::size_t{ 1 } << depth) + index];
+  }
+
+  ///
+  /// \brief Decodes the subcode of a node from the log-likelihood ratios
+  /// \a alpha of its bits and writes its codeword to \a beta.
+  ///
+  void decode_fast (std::size_t depth, std::size_t index,
+                    std::span<const float> alpha, std::span<std::uint8_t> beta,
+                    std::vector<float> &scratch) const;
+
+  ///
+  /// \brief Extracts the information bits from \a cword, one bit per
+  /// byte.
+  /// \return Nothing if they do not satisfy the CRC.
+  ///
+  [[nodiscard]] std::optional<infoword>
+  information_of (std::span<const std::uint8_t> cword) const;
+
+  friend class details::list_decoder;
+
+private:
+  properties_type m_properties;
+  std::size_t m_log_size{ 0 };
+  std::vector<bool> m_frozen;
+  std::vector<std::size_t> m_information_set;
+
+  ///
+  /// \brief See \ref type_of.
+  ///
+  std::vector<node_type> m_node_types;
+
+  std::optional<cyclic_code> m_crc;
+};
+
+} // namespace patrick
+
+#endif // PATRICK_POLAR_H_INCLUDED
@@ -0,0 +1,185 @@
+/// \file
+
+#ifndef PATRICK_PRODUCT_H_INCLUDED
+#define PATRICK_PRODUCT_H_INCLUDED
+
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <fmt/core.h>
+
+#include <patrick/core.h>
+
+namespace patrick
+{
+
+///
+/// \class product_code_exception
+/// \brief Indicates an exceptional behaviour during an operation of a
+/// \ref product_code instance.
+///
+class product_code_exception : public std::runtime_error
+{
+public:
+  explicit product_code_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+///
+/// \class product_code
+/// \brief Represents the product of a row code \f$[n_{1}, k_{1}, d_{1}]\f$
+/// and a column code \f$[n_{2}, k_{2}, d_{2}]\f$ - the
+/// \f$[n_{1} n_{2}, k_{1} k_{2}, d_{1} d_{2}]\f$ code of the
+/// \f$n_{2} \times n_{1}\f$ matrices whose rows and columns are codewords
+/// of the respective codes.
+/// \details Matrices are stored row by row in words, so that position
+/// \f$i n_{1} + j\f$ is at row \f$i\f$ and column \f$j\f$. Information words
+/// are \f$k_{2} \times k_{1}\f$ matrices.
+///
+/// A burst of errors along a row is spread over the columns, so a column
+/// code which corrects \f$t_{2}\f$ errors corrects any \f$t_{2}\f$ corrupted
+/// rows.
+///
+/// Decoding alternates passes over all rows and all columns. The lines of a
+/// pass are independent, so they are split between threads. Each line is
+/// decoded by its component code - with \ref
+/// linearcode::decoding_strategy::Auto if it is from a known family and with
+/// \ref linearcode::decoding_strategy::Syndromes otherwise. The tables of the
+/// component codes are built when the product code is created. If a cache
+/// budget evicts them, the first thread to need one builds it again while
+/// the others wait (see \ref set_cache_budget).
+///
+class product_code final
+{
+public:
+  ///
+  /// Related types
+  ///
+
+  using decoding_result = linearcode::decoding_result;
+
+  struct properties_type
+  {
+    std::size_t word_size{ 0 };
+    std::size_t basis_size{ 0 };
+    std::size_t min_distance{ 0 };
+  };
+
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \param num_threads The number of threads which decode the lines of a
+  /// pass. If 0, it is the number of hardware threads.
+  ///
+  product_code (linearcode row_code, linearcode column_code,
+                std::size_t num_threads = 0);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] const properties_type &
+  properties () const &noexcept
+  {
+    return m_properties;
+  }
+
+  [[nodiscard]] const linearcode &
+  row_code () const &noexcept
+  {
+    return m_row_code;
+  }
+
+  [[nodiscard]] const linearcode &
+  column_code () const &noexcept
+  {
+    return m_column_code;
+  }
+
+  [[nodiscard]] bool contains (const codeword &cword) const;
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Encodes the rows of \a iword and then all columns.
+  ///
+  [[nodiscard]] codeword encode (const infoword &iword) const;
+
+  ///
+  /// \brief Decodes hard decisions by alternating row and column passes,
+  /// until a pass changes nothing.
+  /// \details A line whose component decoder fails is left as it is.
+  /// \throws \ref product_code_exception if the word is not a codeword after
+  /// \a max_iterations pairs of passes.
+  ///
+  [[nodiscard]] decoding_result decode (const codeword &cword,
+                                        std::size_t max_iterations = 8);
+
+  ///
+  /// \brief Decodes a word received through a soft channel by turbo
+  /// product decoding.
+  /// \param llrs The log-likelihood ratios \f$\log \frac{P(0)}{P(1)}\f$ of
+  /// the received bits.
+  /// \param chase_positions The number of least reliable positions of a line
+  /// which the Chase decoder flips in all combinations.
+  /// \details Each line is decoded by the Chase-Pyndiah algorithm - the
+  /// component decoder is run on its hard decisions with every combination
+  /// of flips, and the most likely of the candidates is the decision. The
+  /// reliability of a bit is the difference between the metric of the
+  /// decision and of the best candidate which disagrees with it. The
+  /// extrinsic part of it is passed to the next pass, scaled by a factor
+  /// which grows with the iterations. The final decisions are cleaned up
+  /// with at most 8 pairs of hard passes, like \ref decode does. With no \a
+  /// iterations, these start from the hard decisions of \a llrs.
+  /// \return The decoded information word and the difference between the
+  /// hard decisions and the decoded codeword.
+  /// \throws \ref product_code_exception if the decisions are not a codeword
+  /// in the end.
+  ///
+  [[nodiscard]] decoding_result
+  decode_soft (std::span<const float> llrs, std::size_t iterations = 4,
+               std::size_t chase_positions = 4);
+
+private:
+  using bit_matrix
+      = Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  using soft_matrix
+      = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  ///
+  /// \brief Decodes every row and then every column of \a bits once.
+  /// \return Whether any bit changed.
+  ///
+  bool hard_iteration (bit_matrix &bits);
+
+  ///
+  /// \brief Replaces \a extrinsic with the extrinsic information of every
+  /// row, or every column if \a columns, of \a input.
+  ///
+  void soft_pass (const soft_matrix &input, soft_matrix &extrinsic,
+                  bit_matrix &decisions, bool columns, float fallback,
+                  std::size_t chase_positions);
+
+  [[nodiscard]] decoding_result result_of (const bit_matrix &bits,
+                                           const codeword &received) const;
+
+private:
+  linearcode m_row_code;
+  linearcode m_column_code;
+  std::size_t m_num_threads{ 1 };
+  properties_type m_properties;
+};
+
+} // namespace patrick
+
+#endif // PATRICK_PRODUCT_H_INCLUDED
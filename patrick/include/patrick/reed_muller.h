@@ -0,0 +1,36 @@
+/// \file
+
+#ifndef PATRICK_REED_MULLER_H_INCLUDED
+#define PATRICK_REED_MULLER_H_INCLUDED
+
+#include <cstdint>
+#include <span>
+
+namespace patrick
+{
+
+namespace details
+{
+
+///
+/// \brief Replaces \a values by their Walsh-Hadamard transform
+/// \f$F(a) = \sum_{p} (-1)^{\langle a, p \rangle} v_{p}\f$, in place.
+/// \details The transform is done in \f$\log_{2} n\f$ stages of butterflies.
+/// On CPUs with AVX2 every stage whose butterflies span a whole vector is
+/// vectorized. Instantiated for `std::int16_t`, `std::int32_t` and `float`.
+/// \pre The size of \a values is a power of 2. The magnitudes of the
+/// results have to fit into \a T.
+///
+template <typename T> void fast_hadamard_transform (std::span<T> values);
+
+///
+/// \brief The portable implementation of \ref fast_hadamard_transform.
+///
+template <typename T>
+void fast_hadamard_transform_scalar (std::span<T> values);
+
+} // namespace details
+
+} // namespace patrick
+
+#endif // PATRICK_REED_MULLER_H_INCLUDED
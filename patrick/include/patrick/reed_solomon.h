@@ -0,0 +1,262 @@
+/// \file
+
+#ifndef PATRICK_REED_SOLOMON_H_INCLUDED
+#define PATRICK_REED_SOLOMON_H_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <patrick/gf2m.h>
+
+namespace patrick
+{
+
+///
+/// \class reed_solomon_exception
+/// \brief Indicates an exceptional behaviour during an operation of a
+/// \ref reed_solomon instance.
+///
+class reed_solomon_exception : public std::runtime_error
+{
+public:
+  explicit reed_solomon_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+namespace details
+{
+
+///
+/// \class region_multiplier
+/// \brief Multiplies whole byte regions by a constant of \f$GF(2^{8})\f$.
+/// \details The product of the constant with a byte is the sum of its
+/// products with the low and the high nibble of the byte. Both are looked
+/// up in 16 entry tables, which fit into a vector register, so that
+/// `pshufb` does 16 (SSSE3) or 32 (AVX2) lookups at once.
+///
+class region_multiplier
+{
+public:
+  using symbol_type = std::uint8_t;
+
+  region_multiplier () = default;
+
+  region_multiplier (const galois_field &field, symbol_type constant);
+
+  [[nodiscard]] symbol_type
+  constant () const noexcept
+  {
+    return m_constant;
+  }
+
+  ///
+  /// \brief Adds the product of the constant and \a src to \a dst.
+  /// \pre Both regions are of the same size.
+  ///
+  void multiply_add (std::span<const symbol_type> src,
+                     std::span<symbol_type> dst) const noexcept;
+
+  ///
+  /// \brief The portable implementation of \ref multiply_add.
+  ///
+  void multiply_add_scalar (std::span<const symbol_type> src,
+                            std::span<symbol_type> dst) const noexcept;
+
+private:
+  symbol_type m_constant{ 0 };
+  alignas (16) std::array<symbol_type, 16> m_low{};
+  alignas (16) std::array<symbol_type, 16> m_high{};
+};
+
+} // namespace details
+
+///
+/// \class reed_solomon
+/// \brief Represents a (possibly shortened) Reed-Solomon \f$[n, k, n - k +
+/// 1]\f$ code over \f$GF(2^{8})\f$.
+/// \details Codewords are systematic - the \f$k\f$ message symbols are
+/// followed by \f$n - k\f$ parity symbols. Symbol \f$i\f$ is the coefficient
+/// of \f$x^{n - 1 - i}\f$ and the generator polynomial is
+/// \f$g(x) = \prod_{j = 0}^{n - k - 1} (x - \alpha^{j})\f$.
+///
+/// Besides single codewords, the code encodes and repairs shards - \f$k\f$
+/// data regions of equal size with \f$n - k\f$ parity regions, where byte
+/// \f$b\f$ of all shards is a codeword.
+///
+class reed_solomon final
+{
+public:
+  ///
+  /// Related types
+  ///
+
+  using symbol_type = std::uint8_t;
+
+  static constexpr std::size_t max_word_size = 255;
+
+  struct properties_type
+  {
+    std::size_t word_size{ 0 };
+    std::size_t basis_size{ 0 };
+    std::size_t min_distance{ 0 };
+    std::size_t max_errors_correct{ 0 };
+  };
+
+  ///
+  /// \brief Represents a result from decoding.
+  ///
+  struct decoding_result
+  {
+    std::vector<symbol_type> message;
+    /// The error which was removed from the received word, symbol by symbol.
+    std::vector<symbol_type> error;
+  };
+
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \throws \ref reed_solomon_exception unless \f$0 < k < n \leq 255\f$.
+  ///
+  reed_solomon (std::size_t n, std::size_t k);
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] const properties_type &
+  properties () const &noexcept
+  {
+    return m_properties;
+  }
+
+  ///
+  /// \return The coefficients of the generator polynomial, starting from the
+  /// constant term.
+  ///
+  [[nodiscard]] const std::vector<symbol_type> &
+  generator_polynomial () const &noexcept
+  {
+    return m_generator;
+  }
+
+  ///
+  /// \brief The field the code is over.
+  ///
+  [[nodiscard]] const details::galois_field &
+  field () const &noexcept
+  {
+    return m_field;
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Encodes \f$k\f$ message symbols.
+  /// \return The codeword of \f$n\f$ symbols.
+  ///
+  [[nodiscard]] std::vector<symbol_type>
+  encode (std::span<const symbol_type> message) const;
+
+  ///
+  /// \brief Writes the \f$n - k\f$ parity symbols of \a message to
+  /// \a parity.
+  ///
+  void encode (std::span<const symbol_type> message,
+               std::span<symbol_type> parity) const;
+
+  ///
+  /// \brief Calculates \f$S_{j} = r(\alpha^{j})\f$ for
+  /// \f$0 \leq j < n - k\f$. All of them are zero for codewords.
+  ///
+  [[nodiscard]] std::vector<symbol_type>
+  syndrome_of (std::span<const symbol_type> received) const;
+
+  ///
+  /// \brief Corrects \f$e\f$ errors and \f$f\f$ erasures as long as
+  /// \f$2e + f \leq n - k\f$.
+  /// \param erasures The positions whose symbols are known to be unreliable.
+  /// \throws \ref reed_solomon_exception if the word cannot be corrected.
+  ///
+  [[nodiscard]] decoding_result
+  decode (std::span<const symbol_type> received,
+          std::span<const std::size_t> erasures = {}) const;
+
+  ///
+  /// \brief Calculates the parity shards of \a data.
+  /// \param data \f$k\f$ shards of equal size.
+  /// \param parity \f$n - k\f$ shards of the same size.
+  ///
+  void encode_shards (std::span<const std::span<const symbol_type> > data,
+                      std::span<const std::span<symbol_type> > parity) const;
+
+  ///
+  /// \brief Restores the contents of the missing shards from the others.
+  /// \param shards All \f$n\f$ shards - the data ones and then the parity
+  /// ones.
+  /// \param missing The indices of the shards which are lost. Their
+  /// contents are overwritten.
+  /// \throws \ref reed_solomon_exception if more than \f$n - k\f$ shards are
+  /// missing.
+  ///
+  void reconstruct_shards (std::span<const std::span<symbol_type> > shards,
+                           std::span<const std::size_t> missing) const;
+
+private:
+  ///
+  /// \brief Finds the errata locator polynomial, starting from the locator
+  /// of the erasures.
+  ///
+  [[nodiscard]] std::vector<details::galois_field::element_type>
+  errata_locator (std::span<const symbol_type> syndromes,
+                  std::span<const std::size_t> erasures) const;
+
+  ///
+  /// \brief Adds the products of the shards with \a rows to \a outputs.
+  /// \details Byte ranges are processed in blocks which fit in the L1 cache,
+  /// so that each block of the outputs is read and written once per input.
+  ///
+  void
+  combine_shards (std::span<const std::span<const symbol_type> > inputs,
+                  std::span<const details::region_multiplier> rows,
+                  std::span<const std::span<symbol_type> > outputs) const;
+
+private:
+  details::galois_field m_field{ 8 };
+  properties_type m_properties;
+
+  ///
+  /// \brief See \ref generator_polynomial.
+  ///
+  std::vector<symbol_type> m_generator;
+
+  ///
+  /// \brief The products of every symbol with the coefficients of the
+  /// generator polynomial, from the highest to the lowest one below the
+  /// leading term. They drive the division in \ref encode.
+  ///
+  std::vector<std::array<symbol_type, 256> > m_generator_products;
+
+  ///
+  /// \brief Row \f$j\f$ holds the multipliers of the message symbols in
+  /// parity symbol \f$j\f$, that is the coefficients of
+  /// \f$x^{n - 1 - i} \bmod g(x)\f$.
+  ///
+  std::vector<details::region_multiplier> m_parity_rows;
+};
+
+} // namespace patrick
+
+#endif // PATRICK_REED_SOLOMON_H_INCLUDED
@@ -0,0 +1,218 @@
+/// \file
+
+#ifndef PATRICK_SIMULATION_H_INCLUDED
+#define PATRICK_SIMULATION_H_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <patrick/core.h>
+
+namespace patrick
+{
+
+///
+/// \class simulation_exception
+/// \brief Indicates an exceptional behaviour during a simulation.
+///
+class simulation_exception : public std::runtime_error
+{
+public:
+  explicit simulation_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+///
+/// \brief When and how a \ref simulation runs.
+///
+struct simulation_options
+{
+  ///
+  /// \brief The most frames sent for a single point.
+  ///
+  std::size_t max_frames{ 1'000'000 };
+
+  ///
+  /// \brief Stop once this many frames are in error. 0 turns it off.
+  ///
+  std::size_t target_frame_errors{ 100 };
+
+  ///
+  /// \brief Stop once the 95% confidence interval of the frame error rate
+  /// is narrower than this fraction of it on either side. 0 turns it off.
+  ///
+  double relative_precision{ 0 };
+
+  ///
+  /// \brief The number of frames whose results are committed together.
+  /// Frames are given to threads a batch at a time, and the stopping rules
+  /// are checked after every batch.
+  ///
+  std::size_t batch_size{ 256 };
+
+  ///
+  /// \brief The number of threads. If 0, it is the number of hardware
+  /// threads.
+  ///
+  std::size_t num_threads{ 0 };
+
+  std::uint64_t seed{ 0 };
+};
+
+///
+/// \brief The results of a \ref simulation at a single crossover
+/// probability.
+///
+struct simulation_point
+{
+  double crossover_probability{ 0 };
+  std::size_t frames{ 0 };
+  std::size_t frame_errors{ 0 };
+  std::size_t bit_errors{ 0 };
+
+  ///
+  /// \brief The number of information bits sent.
+  ///
+  std::size_t bits{ 0 };
+
+  [[nodiscard]] double
+  frame_error_rate () const noexcept
+  {
+    return frames == 0 ? 0 : double (frame_errors) / frames;
+  }
+
+  [[nodiscard]] double
+  bit_error_rate () const noexcept
+  {
+    return bits == 0 ? 0 : double (bit_errors) / bits;
+  }
+
+  ///
+  /// \return The Wilson score interval of the frame error rate at
+  /// confidence 95%.
+  ///
+  [[nodiscard]] std::pair<double, double>
+  frame_error_interval () const noexcept
+  {
+    if (frames == 0)
+      return { 0, 1 };
+    constexpr double z = 1.959963984540054;
+    const double n = frames;
+    const double p = frame_error_rate ();
+    const double center = (p + z * z / (2 * n)) / (1 + z * z / n);
+    const double half_width = z / (1 + z * z / n)
+                              * std::sqrt (p * (1 - p) / n
+                                           + z * z / (4 * n * n));
+    return { center - half_width, center + half_width };
+  }
+
+  bool operator== (const simulation_point &) const noexcept = default;
+};
+
+///
+/// \class simulation
+/// \brief Estimates the bit and frame error rates of a code over binary
+/// symmetric channels by Monte Carlo simulation.
+/// \details Every frame carries a random information word, which is
+/// encoded and corrupted by geometric skip sampling. The frames of a batch
+/// are decoded together with \ref linearcode::decode_batch, so that a frame
+/// allocates nothing. The buffers of a batch are carved out of a scratch
+/// buffer of the thread which runs it, so the threads do not contend for
+/// the heap either. A frame whose decoder fails is in error.
+///
+/// The random numbers of frame \f$i\f$ come from stream \f$i\f$ of a
+/// \ref details::philox4x32 generator, which is keyed by the seed and the
+/// point. Batches of frames are handed out to threads, but their results are
+/// committed in order and the stopping rules are only checked on the
+/// committed prefix. So the results only depend on the seed and the
+/// options - not on the number of threads.
+///
+/// The tables of the decoder are built when the simulation is created. If a
+/// cache budget evicts them, the first thread to need one builds it again
+/// while the others wait (see \ref set_cache_budget).
+///
+class simulation final
+{
+public:
+  ///
+  /// Constructors
+  ///
+
+  ///
+  /// \throws \ref simulation_exception if the batch size is 0.
+  ///
+  explicit simulation (linearcode code, simulation_options options = {});
+
+public:
+  ///
+  /// Observers
+  ///
+
+  [[nodiscard]] const linearcode &
+  code () const &noexcept
+  {
+    return m_code;
+  }
+
+  [[nodiscard]] const simulation_options &
+  options () const &noexcept
+  {
+    return m_options;
+  }
+
+public:
+  ///
+  /// Operations
+  ///
+
+  ///
+  /// \brief Simulates frames until a stopping rule is met or \ref
+  /// simulation_options::max_frames are sent.
+  /// \param point The index of the point, which tells apart the random
+  /// streams of different points.
+  /// \throws \ref simulation_exception unless \f$0 \leq p \leq 1\f$.
+  /// Otherwise the first exception of a thread, such as \c std::bad_alloc
+  /// from the build of a table, once the threads are stopped.
+  ///
+  [[nodiscard]] simulation_point run (double crossover_probability,
+                                      std::uint64_t point = 0);
+
+  ///
+  /// \brief Runs every point of a curve in order. The index of a point is
+  /// its position in \a crossover_probabilities.
+  ///
+  [[nodiscard]] std::vector<simulation_point>
+  curve (std::span<const double> crossover_probabilities);
+
+private:
+  ///
+  /// \brief Sends frames `first .. first + count` and adds up their results.
+  /// \param arena The buffers of the batch are allocated from it.
+  ///
+  [[nodiscard]] simulation_point
+  run_batch (double crossover_probability, std::uint64_t key,
+             std::size_t first, std::size_t count,
+             std::pmr::memory_resource *arena);
+
+  ///
+  /// \return Whether \a point meets a stopping rule.
+  ///
+  [[nodiscard]] bool is_done (const simulation_point &point) const noexcept;
+
+private:
+  linearcode m_code;
+  simulation_options m_options;
+};
+
+} // namespace patrick
+
+#endif // PATRICK_SIMULATION_H_INCLUDED
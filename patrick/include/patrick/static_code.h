@@ -0,0 +1,418 @@
+/// \file
+
+#ifndef PATRICK_STATIC_CODE_H_INCLUDED
+#define PATRICK_STATIC_CODE_H_INCLUDED
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include <fmt/core.h>
+
+#include <patrick/core.h>
+
+namespace patrick
+{
+
+///
+/// \class static_linear_code_exception
+/// \brief Indicates an exceptional behaviour during an operation of a
+/// \ref static_linear_code instance. When it is thrown while the tables of a
+/// code are computed, the program is ill-formed instead.
+///
+class static_linear_code_exception : public std::runtime_error
+{
+public:
+  explicit static_linear_code_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+///
+/// \class static_generator
+/// \brief A \f$K \times N\f$ generator matrix which is known at compile
+/// time, so that it may be the template argument of \ref
+/// static_linear_code.
+/// \details Entry \f$(i, j)\f$ is bit \f$j\f$ of `rows[i]`.
+///
+template <std::size_t K, std::size_t N> struct static_generator
+{
+  static_assert (0 < K && K <= N && N <= 64,
+                 "The rows of a static generator are single blocks.");
+
+  static constexpr std::size_t basis_size = K;
+  static constexpr std::size_t word_size = N;
+
+  std::array<std::uint64_t, K> rows{};
+
+  ///
+  /// \param bitstrs The rows, as strings of \f$N\f$ characters which are
+  /// '0' or '1'.
+  ///
+  consteval static_generator (std::initializer_list<std::string_view> bitstrs)
+  {
+    if (bitstrs.size () != K)
+      throw static_linear_code_exception{ "Wrong number of rows." };
+    std::size_t i = 0;
+    for (const std::string_view bitstr : bitstrs)
+      {
+        if (bitstr.size () != N)
+          throw static_linear_code_exception{ "Wrong row length." };
+        for (std::size_t j = 0; j < N; ++j)
+          if (bitstr[j] == '1')
+            rows[i] |= std::uint64_t{ 1 } << j;
+          else if (bitstr[j] != '0')
+            throw static_linear_code_exception{ "Bad input string." };
+        ++i;
+      }
+  }
+};
+
+namespace details
+{
+
+///
+/// \brief The reduced row echelon form of a \ref static_generator and the
+/// column order which brings it into standard form, as in \ref
+/// linearcode::permutation.
+///
+template <std::size_t K, std::size_t N> struct static_systematic_form
+{
+  std::array<std::uint64_t, K> rows{};
+  std::array<std::size_t, N> permutation{};
+};
+
+template <std::size_t K, std::size_t N>
+consteval static_systematic_form<K, N>
+reduce_static_generator (const static_generator<K, N> &generator)
+{
+  static_systematic_form<K, N> form{ .rows = generator.rows };
+  std::array<bool, N> is_pivot{};
+  std::size_t rank = 0;
+  for (std::size_t c = 0; c < N && rank < K; ++c)
+    {
+      const std::uint64_t bit = std::uint64_t{ 1 } << c;
+      std::size_t pivot = rank;
+      while (pivot < K && !(form.rows[pivot] & bit))
+        ++pivot;
+      if (pivot == K)
+        continue;
+
+      std::swap (form.rows[rank], form.rows[pivot]);
+      for (std::size_t r = 0; r < K; ++r)
+        if (r != rank && (form.rows[r] & bit))
+          form.rows[r] ^= form.rows[rank];
+      form.permutation[rank++] = c;
+      is_pivot[c] = true;
+    }
+  if (rank != K)
+    throw static_linear_code_exception{
+      "The rows of a static generator are not linearly independent."
+    };
+
+  for (std::size_t c = 0; c < N; ++c)
+    if (!is_pivot[c])
+      form.permutation[rank++] = c;
+  return form;
+}
+
+///
+/// \brief The parity matrix \f$(A^{T} | I)\f$ of a systematic form
+/// \f$(I | A)\f$, in the original column order.
+///
+template <std::size_t K, std::size_t N>
+consteval std::array<std::uint64_t, N - K>
+static_parity_rows (const static_systematic_form<K, N> &form)
+{
+  std::array<std::uint64_t, N - K> parity{};
+  for (std::size_t j = 0; j < N - K; ++j)
+    {
+      const std::size_t redundancy = form.permutation[K + j];
+      parity[j] = std::uint64_t{ 1 } << redundancy;
+      for (std::size_t i = 0; i < K; ++i)
+        if ((form.rows[i] >> redundancy) & 1u)
+          parity[j] |= std::uint64_t{ 1 } << form.permutation[i];
+    }
+  return parity;
+}
+
+template <std::size_t R>
+constexpr std::size_t
+static_syndrome_of (const std::array<std::uint64_t, R> &parity,
+                    std::uint64_t word) noexcept
+{
+  std::size_t syndrome = 0;
+  for (std::size_t j = 0; j < R; ++j)
+    syndrome |= std::size_t (std::popcount (parity[j] & word) & 1) << j;
+  return syndrome;
+}
+
+///
+/// \return The next larger word with as many bits set as \a word.
+///
+constexpr std::uint64_t
+next_of_same_weight (std::uint64_t word) noexcept
+{
+  const std::uint64_t lowest = word & (~word + 1);
+  const std::uint64_t ripple = word + lowest;
+  return ripple | (((word ^ ripple) >> 2) / lowest);
+}
+
+///
+/// \brief Visits the words of length \a N and weight \a w in increasing
+/// order, until \a f returns true.
+///
+template <std::size_t N, typename Function>
+constexpr void
+for_each_of_weight (std::size_t w, Function f)
+{
+  const std::uint64_t first = (std::uint64_t{ 1 } << w) - 1;
+  const std::uint64_t last = first << (N - w);
+  for (std::uint64_t word = first;; word = next_of_same_weight (word))
+    if (f (word) || word == last)
+      return;
+}
+
+///
+/// \brief The lightest word of every coset, indexed by syndrome. The cosets
+/// are searched by increasing weight.
+///
+template <std::size_t N, std::size_t R>
+consteval std::array<std::uint64_t, std::size_t{ 1 } << R>
+static_coset_leaders (const std::array<std::uint64_t, R> &parity)
+{
+  constexpr std::size_t num_rows = std::size_t{ 1 } << R;
+  std::array<std::uint64_t, num_rows> leaders{};
+  std::array<bool, num_rows> found{};
+  found[0] = true;
+  std::size_t count = 1;
+  for (std::size_t w = 1; w < N && count < num_rows; ++w)
+    for_each_of_weight<N> (w, [&] (const std::uint64_t word) {
+      const std::size_t s = static_syndrome_of (parity, word);
+      if (!found[s])
+        {
+          found[s] = true;
+          leaders[s] = word;
+          ++count;
+        }
+      return count == num_rows;
+    });
+  return leaders;
+}
+
+///
+/// \brief Finds the minimum distance by going through all codewords in Gray
+/// code order if there are few of them, and otherwise through the words of
+/// increasing weight until one has syndrome zero.
+///
+template <std::size_t K, std::size_t N>
+consteval std::size_t
+static_min_distance (const static_systematic_form<K, N> &form,
+                     const std::array<std::uint64_t, N - K> &parity)
+{
+  if constexpr (K <= 16)
+    {
+      std::size_t min_distance = N;
+      std::uint64_t cword = 0;
+      for (std::size_t i = 1; i < (std::size_t{ 1 } << K); ++i)
+        {
+          cword ^= form.rows[std::countr_zero (i)];
+          min_distance = std::min<std::size_t> (min_distance,
+                                                std::popcount (cword));
+        }
+      return min_distance;
+    }
+  else
+    {
+      for (std::size_t w = 1; w < N; ++w)
+        {
+          bool found = false;
+          for_each_of_weight<N> (w, [&] (const std::uint64_t word) {
+            return found = static_syndrome_of (parity, word) == 0;
+          });
+          if (found)
+            return w;
+        }
+      return N;
+    }
+}
+
+} // namespace details
+
+///
+/// \class static_linear_code
+/// \brief A linear code whose generator \a G is a compile time constant.
+/// \details Its properties, parity matrix and syndrome table are computed
+/// during compilation and are static constants, so nothing is built at
+/// runtime and nothing is checked before use. The systematic form is the
+/// same as the one of \ref linearcode::from_generator with the same matrix,
+/// and so are the information positions.
+///
+/// Words are single 64-bit blocks, packed like the rows of \ref
+/// details::bitmatrix. Encoding, syndromes and extracting the information
+/// are folds over the rows, which the compiler unrolls.
+///
+template <static_generator G> class static_linear_code final
+{
+public:
+  ///
+  /// Related types
+  ///
+
+  using block_type = std::uint64_t;
+  using decoding_result = linearcode::decoding_result;
+
+  struct properties_type
+  {
+    std::size_t word_size{ 0 };
+    std::size_t basis_size{ 0 };
+    std::size_t min_distance{ 0 };
+    std::size_t max_errors_detect{ 0 };
+    std::size_t max_errors_correct{ 0 };
+  };
+
+  struct packed_result
+  {
+    block_type iword{ 0 };
+    block_type error{ 0 };
+  };
+
+private:
+  static constexpr std::size_t k = decltype (G)::basis_size;
+  static constexpr std::size_t n = decltype (G)::word_size;
+  static constexpr std::size_t r = n - k;
+
+  static_assert (r <= 16, "The syndrome table would have over 2^16 rows.");
+
+public:
+  ///
+  /// Tables
+  ///
+
+  ///
+  /// \brief The systematic generator and the information positions.
+  ///
+  static constexpr auto systematic_form
+      = details::reduce_static_generator (G);
+
+  ///
+  /// \brief The rows of the parity matrix. Bit \f$j\f$ of a syndrome is the
+  /// parity of the word masked by row \f$j\f$.
+  ///
+  static constexpr auto parity_rows
+      = details::static_parity_rows (systematic_form);
+
+  ///
+  /// \brief The coset leaders, indexed by syndrome.
+  ///
+  static constexpr auto coset_leaders
+      = details::static_coset_leaders<n> (parity_rows);
+
+  static constexpr properties_type properties = [] {
+    const std::size_t d
+        = details::static_min_distance (systematic_form, parity_rows);
+    return properties_type{ .word_size = n,
+                            .basis_size = k,
+                            .min_distance = d,
+                            .max_errors_detect = d - 1,
+                            .max_errors_correct = (d - 1) / 2 };
+  }();
+
+public:
+  ///
+  /// Operations on packed words
+  ///
+
+  [[nodiscard]] static constexpr block_type
+  encode (block_type iword) noexcept
+  {
+    return [iword]<std::size_t... I> (std::index_sequence<I...>) {
+      return (((block_type{ 0 } - ((iword >> I) & 1u))
+               & systematic_form.rows[I])
+              ^ ...);
+    }(std::make_index_sequence<k>{});
+  }
+
+  [[nodiscard]] static constexpr std::size_t
+  syndrome_of (block_type word) noexcept
+  {
+    return [word]<std::size_t... J> (std::index_sequence<J...>) {
+      return ((std::size_t (std::popcount (parity_rows[J] & word) & 1) << J)
+              | ... | 0);
+    }(std::make_index_sequence<r>{});
+  }
+
+  [[nodiscard]] static constexpr bool
+  contains (block_type word) noexcept
+  {
+    return syndrome_of (word) == 0;
+  }
+
+  ///
+  /// \brief Corrects \a word to the nearest codeword by a single lookup.
+  ///
+  [[nodiscard]] static constexpr packed_result
+  decode (block_type word) noexcept
+  {
+    const block_type error = coset_leaders[syndrome_of (word)];
+    const block_type cword = word ^ error;
+    const block_type iword = [cword]<std::size_t... I> (
+                                 std::index_sequence<I...>) {
+      return (
+          (((cword >> systematic_form.permutation[I]) & 1u) << I) | ...);
+    }(std::make_index_sequence<k>{});
+    return packed_result{ .iword = iword, .error = error };
+  }
+
+public:
+  ///
+  /// Operations on words
+  ///
+
+  ///
+  /// \throws \ref static_linear_code_exception if \a iword is not of size
+  /// \f$k\f$.
+  ///
+  [[nodiscard]] static codeword
+  encode (const infoword &iword)
+  {
+    return details::unpack<details::codeword_tag> (
+        std::array{ encode (pack (iword, k)) }.data (), n);
+  }
+
+  ///
+  /// \throws \ref static_linear_code_exception if \a cword is not of size
+  /// \f$n\f$.
+  ///
+  [[nodiscard]] static decoding_result
+  decode (const codeword &cword)
+  {
+    const auto result = decode (pack (cword, n));
+    return decoding_result{
+      .iword = details::unpack<details::infoword_tag> (&result.iword, k),
+      .error = details::unpack<details::codeword_tag> (&result.error, n)
+    };
+  }
+
+private:
+  template <typename Tag>
+  [[nodiscard]] static block_type
+  pack (const details::word<Tag> &w, std::size_t size)
+  {
+    if (static_cast<std::size_t> (w.vec.cols ()) != size)
+      throw static_linear_code_exception{ fmt::format (
+          "Word '{}' is not of size {}.", w, size) };
+    block_type packed = 0;
+    details::pack (w, &packed);
+    return packed;
+  }
+};
+
+} // namespace patrick
+
+#endif // PATRICK_STATIC_CODE_H_INCLUDED
@@ -0,0 +1,331 @@
+/// \file
+
+#ifndef PATRICK_STATS_H_INCLUDED
+#define PATRICK_STATS_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#ifdef PATRICK_ENABLE_STATS
+#include <atomic>
+#endif
+
+namespace patrick
+{
+
+///
+/// \brief The tables and matrices of a \ref linearcode which are built on
+/// demand.
+///
+enum class lazy_table
+{
+  Codewords,
+  ParityMatrix,
+  SlepianTable,
+  SyndromeTable,
+  PackedSyndromeTable,
+  /// A solution of \ref linearcode::decode_erasures, of which there is one
+  /// per erasure pattern.
+  ErasureSolution
+};
+
+///
+/// \brief What a \ref linearcode has done since it was created or its stats
+/// were reset.
+/// \details The counters are only kept if the library is built with \c
+/// PATRICK_ENABLE_STATS. Otherwise, they cost nothing and stay 0.
+///
+struct linearcode_stats
+{
+  static constexpr std::size_t num_strategies = 6;
+  static constexpr std::size_t num_tables = 6;
+
+  ///
+  /// \brief The heaviest corrected error with a bucket of its own in \ref
+  /// corrected_weights. The last bucket counts every heavier one too.
+  ///
+  static constexpr std::size_t max_counted_weight = 15;
+
+  struct build_type
+  {
+    std::uint64_t builds{ 0 };
+
+    ///
+    /// \brief The time spent building, including the tables which were
+    /// built on the way.
+    ///
+    std::uint64_t nanoseconds{ 0 };
+
+    ///
+    /// \brief The bytes held by the built tables, like \ref
+    /// linearcode::cache_bytes counts them.
+    ///
+    std::uint64_t bytes{ 0 };
+
+    bool operator== (const build_type &) const noexcept = default;
+  };
+
+  ///
+  /// \brief Words encoded by \ref linearcode::encode and \ref
+  /// linearcode::encode_batch.
+  ///
+  std::uint64_t encodes{ 0 };
+
+  ///
+  /// \brief Words given to \ref linearcode::decode, by strategy, whether or
+  /// not they were decoded. \ref linearcode::decode_batch counts its words
+  /// under the strategy it decodes like.
+  ///
+  std::array<std::uint64_t, num_strategies> decodes{};
+  std::uint64_t soft_decodes{ 0 };
+  std::uint64_t erasure_decodes{ 0 };
+
+  ///
+  /// \brief The number of decoded words by the weight of the error which
+  /// was corrected.
+  ///
+  std::array<std::uint64_t, max_counted_weight + 1> corrected_weights{};
+
+  ///
+  /// \brief Words on which the decoder failed.
+  ///
+  std::uint64_t uncorrectable{ 0 };
+
+  ///
+  /// \brief The builds of every \ref lazy_table.
+  ///
+  std::array<build_type, num_tables> builds{};
+
+  [[nodiscard]] const build_type &
+  build (lazy_table table) const noexcept
+  {
+    return builds[std::size_t (table)];
+  }
+
+  bool operator== (const linearcode_stats &) const noexcept = default;
+};
+
+namespace details
+{
+
+#ifdef PATRICK_ENABLE_STATS
+inline constexpr bool stats_enabled = true;
+#else
+inline constexpr bool stats_enabled = false;
+#endif
+
+///
+/// \brief The decoders under which \ref stats_counters counts words:
+/// the strategies of \ref linearcode::decode by their value, then these.
+///
+inline constexpr std::size_t soft_decoder = linearcode_stats::num_strategies;
+inline constexpr std::size_t erasure_decoder = soft_decoder + 1;
+
+#ifdef PATRICK_ENABLE_STATS
+
+///
+/// \brief The counters behind \ref linearcode_stats. They are relaxed
+/// atomics, so that threads which share a code may count at once, and a
+/// copy starts from the counts of the original.
+///
+class stats_counters
+{
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  stats_counters () = default;
+
+  stats_counters (const stats_counters &other) noexcept { *this = other; }
+
+  stats_counters &
+  operator= (const stats_counters &other) noexcept
+  {
+    const auto snapshot = other.snapshot ();
+    store (m_encodes, snapshot.encodes);
+    for (std::size_t i = 0; i < snapshot.decodes.size (); ++i)
+      store (m_decodes[i], snapshot.decodes[i]);
+    store (m_decodes[soft_decoder], snapshot.soft_decodes);
+    store (m_decodes[erasure_decoder], snapshot.erasure_decodes);
+    for (std::size_t i = 0; i < snapshot.corrected_weights.size (); ++i)
+      store (m_corrected_weights[i], snapshot.corrected_weights[i]);
+    store (m_uncorrectable, snapshot.uncorrectable);
+    for (std::size_t i = 0; i < snapshot.builds.size (); ++i)
+      {
+        store (m_builds[i].builds, snapshot.builds[i].builds);
+        store (m_builds[i].nanoseconds, snapshot.builds[i].nanoseconds);
+        store (m_builds[i].bytes, snapshot.builds[i].bytes);
+      }
+    return *this;
+  }
+
+  [[nodiscard]] static clock_type::time_point
+  now () noexcept
+  {
+    return clock_type::now ();
+  }
+
+  void
+  count_encodes (std::uint64_t count) noexcept
+  {
+    add (m_encodes, count);
+  }
+
+  void
+  count_decode (std::size_t decoder, std::size_t weight) noexcept
+  {
+    add (m_decodes[decoder], 1);
+    add (m_corrected_weights[std::min (
+             weight, linearcode_stats::max_counted_weight)],
+         1);
+  }
+
+  void
+  count_uncorrectable (std::size_t decoder) noexcept
+  {
+    add (m_decodes[decoder], 1);
+    add (m_uncorrectable, 1);
+  }
+
+  ///
+  /// \brief Counts a build of \a table which started at \a start.
+  /// \param bytes_of Returns the bytes held by the built table.
+  ///
+  template <typename BytesOf>
+  void
+  count_build (lazy_table table, clock_type::time_point start,
+               BytesOf &&bytes_of) noexcept
+  {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds> (
+        clock_type::now () - start);
+    auto &counters = m_builds[std::size_t (table)];
+    add (counters.builds, 1);
+    add (counters.nanoseconds, elapsed.count ());
+    add (counters.bytes, bytes_of ());
+  }
+
+  [[nodiscard]] linearcode_stats
+  snapshot () const noexcept
+  {
+    linearcode_stats result;
+    result.encodes = load (m_encodes);
+    for (std::size_t i = 0; i < result.decodes.size (); ++i)
+      result.decodes[i] = load (m_decodes[i]);
+    result.soft_decodes = load (m_decodes[soft_decoder]);
+    result.erasure_decodes = load (m_decodes[erasure_decoder]);
+    for (std::size_t i = 0; i < result.corrected_weights.size (); ++i)
+      result.corrected_weights[i] = load (m_corrected_weights[i]);
+    result.uncorrectable = load (m_uncorrectable);
+    for (std::size_t i = 0; i < result.builds.size (); ++i)
+      result.builds[i] = { .builds = load (m_builds[i].builds),
+                           .nanoseconds = load (m_builds[i].nanoseconds),
+                           .bytes = load (m_builds[i].bytes) };
+    return result;
+  }
+
+  void
+  reset () noexcept
+  {
+    *this = stats_counters{};
+  }
+
+private:
+  using counter_type = std::atomic<std::uint64_t>;
+
+  static void
+  add (counter_type &counter, std::uint64_t value) noexcept
+  {
+    counter.fetch_add (value, std::memory_order_relaxed);
+  }
+
+  static void
+  store (counter_type &counter, std::uint64_t value) noexcept
+  {
+    counter.store (value, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static std::uint64_t
+  load (const counter_type &counter) noexcept
+  {
+    return counter.load (std::memory_order_relaxed);
+  }
+
+  struct build_counters
+  {
+    counter_type builds{ 0 };
+    counter_type nanoseconds{ 0 };
+    counter_type bytes{ 0 };
+  };
+
+  counter_type m_encodes{ 0 };
+  std::array<counter_type, erasure_decoder + 1> m_decodes{};
+  std::array<counter_type, linearcode_stats::max_counted_weight + 1>
+      m_corrected_weights{};
+  counter_type m_uncorrectable{ 0 };
+  std::array<build_counters, linearcode_stats::num_tables> m_builds{};
+};
+
+#else
+
+///
+/// \brief Stands in for the counters when they are compiled out. Every
+/// operation does nothing, and it takes no space as a member marked \c
+/// [[no_unique_address]].
+///
+class stats_counters
+{
+public:
+  struct clock_type
+  {
+    struct time_point
+    {
+    };
+  };
+
+  [[nodiscard]] static clock_type::time_point
+  now () noexcept
+  {
+    return {};
+  }
+
+  void
+  count_encodes (std::uint64_t) noexcept
+  {
+  }
+
+  void
+  count_decode (std::size_t, std::size_t) noexcept
+  {
+  }
+
+  void
+  count_uncorrectable (std::size_t) noexcept
+  {
+  }
+
+  template <typename BytesOf>
+  void
+  count_build (lazy_table, clock_type::time_point, BytesOf &&) noexcept
+  {
+  }
+
+  [[nodiscard]] linearcode_stats
+  snapshot () const noexcept
+  {
+    return {};
+  }
+
+  void
+  reset () noexcept
+  {
+  }
+};
+
+#endif
+
+} // namespace details
+
+} // namespace patrick
+
+#endif // PATRICK_STATS_H_INCLUDED
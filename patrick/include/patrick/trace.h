@@ -0,0 +1,222 @@
+/// \file
+
+#ifndef PATRICK_TRACE_H_INCLUDED
+#define PATRICK_TRACE_H_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
+
+namespace patrick
+{
+
+///
+/// \class trace_exception
+/// \brief Indicates an exceptional behaviour while tracing.
+///
+class trace_exception : public std::runtime_error
+{
+public:
+  explicit trace_exception (const std::string &msg)
+      : std::runtime_error{ fmt::format ("patrick: {}", msg) }
+  {
+  }
+};
+
+///
+/// \brief A named number attached to a \ref trace_event.
+///
+struct trace_arg
+{
+  std::string_view key;
+  double value{ 0 };
+};
+
+///
+/// \brief A span of work - a table build, a batch or a simulation.
+///
+struct trace_event
+{
+  std::string_view name;
+  std::string_view category;
+
+  ///
+  /// \brief The start on the steady clock.
+  ///
+  std::uint64_t start_ns{ 0 };
+  std::uint64_t duration_ns{ 0 };
+
+  ///
+  /// \brief A small number which tells apart the threads of the process.
+  ///
+  std::uint64_t thread{ 0 };
+  std::span<const trace_arg> args{};
+};
+
+///
+/// \class trace_sink
+/// \brief Receives the spans of the library once they end.
+/// \details Spans may end on several threads at once, so \ref write must
+/// be thread-safe.
+///
+class trace_sink
+{
+public:
+  virtual ~trace_sink () = default;
+
+  virtual void write (const trace_event &event) = 0;
+};
+
+///
+/// \class chrome_trace_sink
+/// \brief Writes the spans as the JSON array of complete events of the
+/// Chrome trace format, which chrome://tracing and Perfetto open.
+///
+class chrome_trace_sink final : public trace_sink
+{
+public:
+  ///
+  /// \brief Writes to \a out, which must outlive the sink.
+  ///
+  explicit chrome_trace_sink (std::ostream &out);
+
+  ///
+  /// \brief Writes to a new file at \a path.
+  /// \throws \ref trace_exception if it cannot be opened.
+  ///
+  explicit chrome_trace_sink (const std::string &path);
+
+  ///
+  /// \brief Closes the array.
+  ///
+  ~chrome_trace_sink () override;
+
+  chrome_trace_sink (const chrome_trace_sink &) = delete;
+  chrome_trace_sink &operator= (const chrome_trace_sink &) = delete;
+
+  void write (const trace_event &event) override;
+
+private:
+  std::unique_ptr<std::ofstream> m_file;
+  std::ostream &m_out;
+  std::mutex m_mutex;
+  bool m_empty{ true };
+};
+
+///
+/// \brief Sends the spans of the library to \a sink, or turns tracing off
+/// if it is null. It is off unless this is called.
+/// \details Spans which are open keep the sink they started with.
+///
+void set_trace_sink (std::shared_ptr<trace_sink> sink);
+
+///
+/// \return The sink which spans are sent to, or null if tracing is off.
+///
+[[nodiscard]] std::shared_ptr<trace_sink> current_trace_sink ();
+
+namespace details
+{
+
+///
+/// \brief Whether there is a sink. Spans check this before anything else,
+/// so that they cost a single relaxed load while tracing is off.
+///
+extern std::atomic<bool> tracing;
+
+///
+/// \return The number of the calling thread in \ref trace_event::thread.
+///
+[[nodiscard]] std::uint64_t trace_thread () noexcept;
+
+///
+/// \brief Measures the span of work from its creation to its destruction
+/// and sends it to the sink, if there was one when it was created.
+///
+class trace_span
+{
+public:
+  static constexpr std::size_t max_args = 4;
+
+  trace_span (std::string_view name, std::string_view category) noexcept
+      : m_name{ name }, m_category{ category }
+  {
+    if (!tracing.load (std::memory_order_relaxed)) [[likely]]
+      return;
+    try
+      {
+        m_sink = current_trace_sink ();
+      }
+    catch (...)
+      {
+        return;
+      }
+    m_start = std::chrono::steady_clock::now ();
+  }
+
+  ~trace_span ()
+  {
+    if (!m_sink) [[likely]]
+      return;
+    const auto end = std::chrono::steady_clock::now ();
+    const auto since_epoch = [] (auto duration) {
+      return std::uint64_t (
+          std::chrono::duration_cast<std::chrono::nanoseconds> (duration)
+              .count ());
+    };
+    try
+      {
+        m_sink->write (
+            { .name = m_name,
+              .category = m_category,
+              .start_ns = since_epoch (m_start.time_since_epoch ()),
+              .duration_ns = since_epoch (end - m_start),
+              .thread = trace_thread (),
+              .args = std::span{ m_args }.first (m_num_args) });
+      }
+    catch (...)
+      {
+        // A span must not throw while the stack unwinds, and a trace with
+        // a span less is better than none.
+      }
+  }
+
+  trace_span (const trace_span &) = delete;
+  trace_span &operator= (const trace_span &) = delete;
+
+  ///
+  /// \brief Attaches a number to the span. Those past \ref max_args are
+  /// dropped.
+  ///
+  void
+  arg (std::string_view key, double value) noexcept
+  {
+    if (m_sink && m_num_args < max_args)
+      m_args[m_num_args++] = { key, value };
+  }
+
+private:
+  std::string_view m_name;
+  std::string_view m_category;
+  std::shared_ptr<trace_sink> m_sink;
+  std::chrono::steady_clock::time_point m_start;
+  std::array<trace_arg, max_args> m_args{};
+  std::size_t m_num_args{ 0 };
+};
+
+} // namespace details
+
+} // namespace patrick
+
+#endif // PATRICK_TRACE_H_INCLUDED
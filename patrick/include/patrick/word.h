@@ -89,7 +89,7 @@ template <typename T> struct word
     vec.resize (1, num_bits);
 
     for (std::size_t i = 0; i < num_bits; ++i)
-      vec (num_bits - i - 1) = (word_as_num & (1 << i)) > 0;
+      vec (num_bits - i - 1) = i < 64 && ((word_as_num >> i) & 1ull);
   }
 
   ///
@@ -113,12 +113,16 @@ template <typename T> struct word
     return std::count (std::cbegin (vec), std::cend (vec), 1);
   }
 
+  ///
+  /// \note Only the last 64 positions of longer words fit in the result.
+  ///
   [[nodiscard]] unsigned long long
   to_ullong () const noexcept
   {
     auto result = 0ull;
-    for (long i = 0; i < vec.size (); ++i)
-      result |= vec (vec.size () - i - 1) << i;
+    for (long i = 0; i < std::min<long> (vec.size (), 64); ++i)
+      result |= static_cast<unsigned long long> (vec (vec.size () - i - 1))
+                << i;
     return result;
   }
 
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include <patrick/core.h>
+#include <patrick/trace.h>
+
+namespace patrick
+{
+
+namespace
+{
+
+using block_type = details::bitmatrix::block_type;
+
+} // namespace
+
+void
+linearcode::prepare_packed_syndrome_table () const
+{
+  details::trace_span span{ "packed_syndrome_table", "table" };
+  const auto start = m_stats.now ();
+  const std::size_t stride = m_packed_generator.stride ();
+  const auto &table = *syndrome_table ();
+  std::pmr::vector<block_type> packed (table.size () * stride, 0,
+                                       m_table_resource);
+  for (const auto &[s, leader] : table)
+    {
+      std::size_t index = 0;
+      for (long i = 0; i < s.vec.cols (); ++i)
+        index |= std::size_t (s.vec (i) & 1) << i;
+      details::pack (leader, packed.data () + index * stride);
+    }
+  m_lazy_packed_syndrome_table.emplace (std::move (packed));
+  m_stats.count_build (lazy_table::PackedSyndromeTable, start, [&] {
+    return m_lazy_packed_syndrome_table->size () * sizeof (block_type);
+  });
+  account_for (lazy_table::PackedSyndromeTable);
+}
+
+void
+linearcode::information_of (const block_type *cword,
+                            block_type *iword) const noexcept
+{
+  const std::size_t k = m_packed_generator.rows ();
+  std::fill_n (iword, details::bitmatrix::blocks_for (k), 0);
+  for (std::size_t i = 0; i < k; ++i)
+    {
+      const std::size_t j = m_permutation[i];
+      iword[i / 64] |= ((cword[j / 64] >> (j % 64)) & 1) << (i % 64);
+    }
+}
+
+void
+linearcode::encode_batch (std::span<const block_type> infowords,
+                          std::span<block_type> codewords,
+                          std::size_t count) const noexcept
+{
+  const std::size_t k_stride
+      = details::bitmatrix::blocks_for (m_packed_generator.rows ());
+  const std::size_t n_stride = m_packed_generator.stride ();
+  details::trace_span span{ "encode_batch", "batch" };
+  span.arg ("count", count);
+  m_stats.count_encodes (count);
+  for (std::size_t w = 0; w < count; ++w)
+    {
+      const block_type *iword = infowords.data () + w * k_stride;
+      block_type *cword = codewords.data () + w * n_stride;
+      std::fill_n (cword, n_stride, 0);
+      for (std::size_t b = 0; b < k_stride; ++b)
+        for (block_type bits = iword[b]; bits != 0; bits &= bits - 1)
+          {
+            const block_type *row
+                = m_packed_generator.row (b * 64 + std::countr_zero (bits));
+            for (std::size_t c = 0; c < n_stride; ++c)
+              cword[c] ^= row[c];
+          }
+    }
+}
+
+std::size_t
+linearcode::decode_batch (std::span<const block_type> received,
+                          std::span<block_type> infowords, std::size_t count,
+                          std::span<std::uint8_t> failures)
+{
+  const std::size_t n = m_packed_generator.cols ();
+  const std::size_t k = m_packed_generator.rows ();
+  const std::size_t k_stride = details::bitmatrix::blocks_for (k);
+  const std::size_t n_stride = m_packed_generator.stride ();
+  const bool generic = m_family.kind == code_family::Generic;
+  details::trace_span span{ "decode_batch", "batch" };
+  span.arg ("count", count);
+  const details::cache_use use{ m_cache };
+
+  if (generic && n - k <= max_packed_table_redundancy
+      && (is_built (lazy_table::PackedSyndromeTable)
+          || affords (lazy_table::PackedSyndromeTable)))
+    {
+      const details::bitmatrix &H = packed_parity_matrix ();
+      const block_type *leaders = packed_syndrome_table ().data ();
+      for (std::size_t w = 0; w < count; ++w)
+        {
+          const block_type *word = received.data () + w * n_stride;
+          std::size_t s = 0;
+          for (std::size_t i = 0; i < H.rows (); ++i)
+            {
+              const block_type *h = H.row (i);
+              int parity = 0;
+              for (std::size_t b = 0; b < n_stride; ++b)
+                parity ^= std::popcount (h[b] & word[b]);
+              s |= std::size_t (parity & 1) << i;
+            }
+          // The information bits of the word corrected by the leader.
+          const block_type *leader = leaders + s * n_stride;
+          if constexpr (details::stats_enabled)
+            {
+              std::size_t weight = 0;
+              for (std::size_t b = 0; b < n_stride; ++b)
+                weight += std::popcount (leader[b]);
+              m_stats.count_decode (
+                  std::size_t (decoding_strategy::Syndromes), weight);
+            }
+          block_type *iword = infowords.data () + w * k_stride;
+          std::fill_n (iword, k_stride, 0);
+          for (std::size_t i = 0; i < k; ++i)
+            {
+              const std::size_t j = m_permutation[i];
+              const block_type bit
+                  = ((word[j / 64] ^ leader[j / 64]) >> (j % 64)) & 1;
+              iword[i / 64] |= bit << (i % 64);
+            }
+        }
+      if (!failures.empty ())
+        std::fill_n (failures.begin (), count, 0);
+      return 0;
+    }
+
+  std::size_t num_failures = 0;
+  for (std::size_t w = 0; w < count; ++w)
+    {
+      const block_type *word = received.data () + w * n_stride;
+      block_type *iword = infowords.data () + w * k_stride;
+      bool failed = false;
+      try
+        {
+          using enum decoding_strategy;
+          const auto cword
+              = details::unpack<details::codeword_tag> (word, n);
+          details::pack (generic ? decode<Syndromes> (cword).iword
+                                 : decode<Auto> (cword).iword,
+                         iword);
+        }
+      catch (const linearcode_exception &)
+        {
+          information_of (word, iword);
+          failed = true;
+        }
+      num_failures += failed;
+      if (!failures.empty ())
+        failures[w] = failed;
+    }
+  span.arg ("failures", num_failures);
+  return num_failures;
+}
+
+} // namespace patrick
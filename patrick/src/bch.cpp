@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <patrick/bch.h>
+#include <patrick/core.h>
+#include <patrick/cpu.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+namespace
+{
+
+using element_type = galois_field::element_type;
+
+constexpr std::size_t chien_lanes = 8;
+
+///
+/// \brief Collects the positions \f$i < n\f$ at which the accumulated sum
+/// of the terms of \f$\Lambda\f$ is zero.
+///
+[[nodiscard]] std::vector<std::size_t>
+roots_of (const std::vector<element_type> &sums, std::size_t n)
+{
+  std::vector<std::size_t> roots;
+  for (std::size_t i = 0; i < n; ++i)
+    if (sums[i] == 0)
+      roots.push_back (i);
+  return roots;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+[[nodiscard]] __attribute__ ((target ("avx2"))) std::vector<std::size_t>
+chien_search_avx2 (const galois_field &field,
+                   std::span<const element_type> locator, std::size_t n)
+{
+  const auto antilog = field.antilog_table ();
+  const auto *table = reinterpret_cast<const int *> (antilog.data ());
+  const int order = static_cast<int> (field.order ());
+
+  const std::size_t blocks = (n + chien_lanes - 1) / chien_lanes;
+  std::vector<element_type> sums (blocks * chien_lanes, locator[0]);
+
+  const __m256i zero = _mm256_setzero_si256 ();
+  const __m256i order_v = _mm256_set1_epi32 (order);
+  for (std::size_t j = 1; j < locator.size (); ++j)
+    {
+      if (locator[j] == 0)
+        continue;
+
+      // Lane l of block b holds the exponent of the j-th term at position
+      // i = 8b + l, which is log(lambda_j) - ij reduced modulo the order.
+      const int term = static_cast<int> (field.log (locator[j]));
+      const int stride = static_cast<int> ((j % order) * chien_lanes % order);
+      alignas (32) int lanes[chien_lanes];
+      for (std::size_t l = 0; l < chien_lanes; ++l)
+        lanes[l] = (term + order - static_cast<int> (j * l % order)) % order;
+
+      __m256i exponent = _mm256_load_si256 (
+          reinterpret_cast<const __m256i *> (lanes));
+      const __m256i step = _mm256_set1_epi32 (stride);
+      auto *out = reinterpret_cast<__m256i *> (sums.data ());
+      for (std::size_t b = 0; b < blocks; ++b)
+        {
+          const __m256i values = _mm256_i32gather_epi32 (table, exponent, 4);
+          _mm256_storeu_si256 (
+              out + b,
+              _mm256_xor_si256 (_mm256_loadu_si256 (out + b), values));
+          exponent = _mm256_sub_epi32 (exponent, step);
+          exponent = _mm256_add_epi32 (
+              exponent,
+              _mm256_and_si256 (_mm256_cmpgt_epi32 (zero, exponent), order_v));
+        }
+    }
+  return roots_of (sums, n);
+}
+
+#endif
+
+///
+/// \return The product of two polynomials over \f$F_{2}\f$, given by their
+/// coefficients.
+///
+[[nodiscard]] std::vector<std::uint8_t>
+multiply (const std::vector<std::uint8_t> &a, std::uint32_t b)
+{
+  const std::size_t b_degree = std::bit_width (b) - 1;
+  std::vector<std::uint8_t> result (a.size () + b_degree, 0);
+  for (std::size_t i = 0; i < a.size (); ++i)
+    if (a[i])
+      for (std::size_t j = 0; j <= b_degree; ++j)
+        result[i + j] ^= (b >> j) & 1u;
+  return result;
+}
+
+} // namespace
+
+[[nodiscard]] std::vector<std::uint8_t>
+bch_generator_polynomial (const galois_field &field, std::size_t t)
+{
+  // The conjugates alpha^i, alpha^2i, ... share a minimal polynomial, so the
+  // least common multiple is the product of the distinct ones.
+  const std::size_t n = field.order ();
+  std::vector<std::uint8_t> result{ 1 };
+  std::vector<bool> covered (n, false);
+  for (std::size_t i = 1; i <= 2 * t; ++i)
+    {
+      if (covered[i])
+        continue;
+      for (std::size_t j = i; !covered[j]; j = (2 * j) % n)
+        covered[j] = true;
+      result = multiply (result, field.minimal_polynomial (i));
+    }
+  return result;
+}
+
+[[nodiscard]] std::vector<element_type>
+bch_syndromes (const galois_field &field, const codeword &received,
+               std::size_t t)
+{
+  const auto antilog = field.antilog_table ();
+  const std::size_t order = field.order ();
+
+  std::vector<std::size_t> positions;
+  for (long i = 0; i < received.vec.size (); ++i)
+    if (received.vec (i) & 1)
+      positions.push_back (static_cast<std::size_t> (i) % order);
+
+  std::vector<element_type> syndromes (2 * t, 0);
+  for (std::size_t j = 1; j <= 2 * t; j += 2)
+    {
+      element_type s = 0;
+      for (const std::size_t i : positions)
+        s ^= antilog[i * j % order];
+      syndromes[j - 1] = s;
+    }
+  for (std::size_t j = 2; j <= 2 * t; j += 2)
+    syndromes[j - 1]
+        = field.mul (syndromes[j / 2 - 1], syndromes[j / 2 - 1]);
+  return syndromes;
+}
+
+[[nodiscard]] std::vector<element_type>
+berlekamp_massey (const galois_field &field,
+                  std::span<const element_type> syndromes)
+{
+  // The current connection polynomial, and the one before the last length
+  // change, together with its discrepancy.
+  std::vector<element_type> current{ 1 };
+  std::vector<element_type> previous{ 1 };
+  element_type previous_discrepancy = 1;
+  std::size_t length = 0;
+  std::size_t shift = 1;
+
+  for (std::size_t r = 0; r < syndromes.size (); ++r)
+    {
+      element_type discrepancy = syndromes[r];
+      for (std::size_t i = 1; i <= length && i < current.size (); ++i)
+        discrepancy ^= field.mul (current[i], syndromes[r - i]);
+
+      if (discrepancy == 0)
+        {
+          ++shift;
+          continue;
+        }
+
+      // current(x) -= d / b * x^shift * previous(x)
+      const element_type scale = field.div (discrepancy, previous_discrepancy);
+      auto updated = current;
+      updated.resize (std::max (current.size (), previous.size () + shift), 0);
+      for (std::size_t i = 0; i < previous.size (); ++i)
+        updated[i + shift] ^= field.mul (scale, previous[i]);
+
+      if (2 * length <= r)
+        {
+          length = r + 1 - length;
+          previous = std::move (current);
+          previous_discrepancy = discrepancy;
+          shift = 1;
+        }
+      else
+        ++shift;
+      current = std::move (updated);
+    }
+
+  while (current.size () > 1 && current.back () == 0)
+    current.pop_back ();
+  return current;
+}
+
+[[nodiscard]] std::vector<std::size_t>
+chien_search_scalar (const galois_field &field,
+                     std::span<const element_type> locator, std::size_t n)
+{
+  const auto antilog = field.antilog_table ();
+  const std::size_t order = field.order ();
+
+  std::vector<element_type> sums (n, locator[0]);
+  for (std::size_t j = 1; j < locator.size (); ++j)
+    {
+      if (locator[j] == 0)
+        continue;
+
+      const std::size_t step = j % order;
+      std::size_t exponent = field.log (locator[j]);
+      for (std::size_t i = 0; i < n; ++i)
+        {
+          sums[i] ^= antilog[exponent];
+          exponent = exponent >= step ? exponent - step
+                                      : exponent + order - step;
+        }
+    }
+  return roots_of (sums, n);
+}
+
+[[nodiscard]] std::vector<std::size_t>
+chien_search (const galois_field &field,
+              std::span<const element_type> locator, std::size_t n)
+{
+  assert (!locator.empty ());
+#if defined(__x86_64__) || defined(__i386__)
+  if (cpu ().avx2)
+    return chien_search_avx2 (field, locator, n);
+#endif
+  return chien_search_scalar (field, locator, n);
+}
+
+} // namespace details
+
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_with_chien (const codeword &cword) const
+{
+  if (m_family.kind != code_family::BCH)
+    throw linearcode_exception{ fmt::format (
+        "Cannot decode with a Chien search, because {} is not a BCH code.",
+        m_properties.special_name) };
+  if (m_family_code)
+    return decode_shortened (cword, &linearcode::decode_with_chien);
+  ensure_word_size (cword);
+
+  const auto &field = *m_field;
+
+  const std::size_t n = m_packed_generator.cols ();
+  codeword error{ Eigen::RowVectorXi::Zero (n) };
+
+  const auto syndromes = details::bch_syndromes (field, cword, m_family.t);
+  if (std::ranges::any_of (syndromes, [] (auto s) { return s != 0; }))
+    {
+      const auto locator = details::berlekamp_massey (field, syndromes);
+      const std::size_t num_errors = locator.size () - 1;
+      const auto positions = num_errors <= m_family.t
+                                 ? details::chien_search (field, locator, n)
+                                 : std::vector<std::size_t>{};
+      if (num_errors > m_family.t || positions.size () != num_errors)
+        throw linearcode_exception{ fmt::format (
+            "Cannot decode codeword '{}' because more than {} errors were "
+            "found.",
+            cword, m_family.t) };
+      for (const std::size_t p : positions)
+        error.vec (p) = 1;
+    }
+
+  return decoding_result{ .iword = information_of (cword + error),
+                          .error = std::move (error) };
+}
+
+} // namespace patrick
@@ -0,0 +1,359 @@
+#include <array>
+#include <cassert>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <patrick/bitmatrix.h>
+#include <patrick/cpu.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+///
+/// Constructors
+///
+
+[[nodiscard]] bitmatrix
+bitmatrix::from_eigen (const Eigen::MatrixXi &m)
+{
+  bitmatrix result (m.rows (), m.cols ());
+  for (long r = 0; r < m.rows (); ++r)
+    for (long c = 0; c < m.cols (); ++c)
+      if (m (r, c) % 2)
+        result.flip (r, c);
+  return result;
+}
+
+[[nodiscard]] bitmatrix
+bitmatrix::identity (std::size_t n)
+{
+  bitmatrix result (n, n);
+  for (std::size_t i = 0; i < n; ++i)
+    result.flip (i, i);
+  return result;
+}
+
+[[nodiscard]] Eigen::MatrixXi
+bitmatrix::to_eigen () const
+{
+  Eigen::MatrixXi result (m_rows, m_cols);
+  for (std::size_t r = 0; r < m_rows; ++r)
+    for (std::size_t c = 0; c < m_cols; ++c)
+      result (r, c) = get (r, c);
+  return result;
+}
+
+///
+/// Operations
+///
+
+void
+bitmatrix::swap_rows (std::size_t a, std::size_t b) noexcept
+{
+  if (a == b)
+    return;
+  std::swap_ranges (row (a), row (a) + m_stride, row (b));
+}
+
+[[nodiscard]] bitmatrix
+bitmatrix::select_columns (std::span<const std::size_t> columns) const
+{
+  bitmatrix result (m_rows, columns.size ());
+  for (std::size_t r = 0; r < m_rows; ++r)
+    for (std::size_t j = 0; j < columns.size (); ++j)
+      if (get (r, columns[j]))
+        result.flip (r, j);
+  return result;
+}
+
+namespace
+{
+
+///
+/// \brief Swaps the bits of \a tile which are in column block \f$1\f$ of
+/// row block \f$0\f$ and column block \f$0\f$ of row block \f$1\f$, for
+/// all pairs of \a j by \a j blocks on the diagonal.
+///
+void
+transpose64_stage (bitmatrix::block_type *tile, std::size_t j,
+                   bitmatrix::block_type mask) noexcept
+{
+  for (std::size_t k = 0; k < 64; k = ((k | j) + 1) & ~j)
+    {
+      const bitmatrix::block_type t = ((tile[k] >> j) ^ tile[k | j]) & mask;
+      tile[k] ^= t << j;
+      tile[k | j] ^= t;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__ ((target ("avx2"))) void
+transpose64_avx2 (bitmatrix::block_type *tile) noexcept
+{
+  // While the blocks span at least 4 rows, the rows k..k+3 are swapped with
+  // rows k+j..k+j+3 at once.
+  bitmatrix::block_type mask = 0x00000000FFFFFFFFull;
+  std::size_t j = 32;
+  for (; j >= 4; j >>= 1, mask ^= mask << j)
+    {
+      const __m256i m = _mm256_set1_epi64x (mask);
+      const __m128i shift = _mm_cvtsi64_si128 (j);
+      for (std::size_t k = 0; k < 64; k = ((k | j) + 4) & ~j)
+        {
+          auto *lo = reinterpret_cast<__m256i *> (tile + k);
+          auto *hi = reinterpret_cast<__m256i *> (tile + (k | j));
+          const __m256i a = _mm256_loadu_si256 (lo);
+          const __m256i b = _mm256_loadu_si256 (hi);
+          const __m256i t = _mm256_and_si256 (
+              _mm256_xor_si256 (_mm256_srl_epi64 (a, shift), b), m);
+          _mm256_storeu_si256 (
+              lo, _mm256_xor_si256 (a, _mm256_sll_epi64 (t, shift)));
+          _mm256_storeu_si256 (hi, _mm256_xor_si256 (b, t));
+        }
+    }
+  for (; j != 0; j >>= 1, mask ^= mask << j)
+    transpose64_stage (tile, j, mask);
+}
+
+#endif
+
+} // namespace
+
+void
+transpose64_scalar (bitmatrix::block_type *tile) noexcept
+{
+  // Swap the off-diagonal 32x32 quadrants, then the 16x16 sub-quadrants of
+  // every quadrant, and so on down to single bits.
+  bitmatrix::block_type mask = 0x00000000FFFFFFFFull;
+  for (std::size_t j = 32; j != 0; j >>= 1, mask ^= mask << j)
+    transpose64_stage (tile, j, mask);
+}
+
+void
+transpose64 (bitmatrix::block_type *tile) noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+  if (cpu ().avx2)
+    return transpose64_avx2 (tile);
+#endif
+  transpose64_scalar (tile);
+}
+
+[[nodiscard]] bitmatrix
+bitmatrix::transpose () const
+{
+  bitmatrix result (m_cols, m_rows);
+  std::array<block_type, block_bits> tile;
+  const std::size_t row_tiles = blocks_for (m_rows);
+  for (std::size_t ti = 0; ti < row_tiles; ++ti)
+    for (std::size_t tj = 0; tj < m_stride; ++tj)
+      {
+        const std::size_t r0 = ti * block_bits;
+        const std::size_t rn = std::min (block_bits, m_rows - r0);
+        for (std::size_t i = 0; i < rn; ++i)
+          tile[i] = row (r0 + i)[tj];
+        std::fill (tile.begin () + rn, tile.end (), 0);
+
+        transpose64 (tile.data ());
+
+        const std::size_t c0 = tj * block_bits;
+        const std::size_t cn = std::min (block_bits, m_cols - c0);
+        for (std::size_t j = 0; j < cn; ++j)
+          result.row (c0 + j)[ti] = tile[j];
+      }
+  return result;
+}
+
+[[nodiscard]] bitmatrix
+orthogonal_complement (const bitmatrix &m,
+                       std::span<const std::size_t> columns)
+{
+  const std::size_t k = m.rows ();
+  const std::size_t n = m.cols ();
+  assert (columns.size () == n);
+
+  // Up to the column order m = (I | A) and its complement is (A^T | I). The
+  // rows of A^T are read off the transpose of m and then scattered back to
+  // the systematic columns.
+  const bitmatrix m_t = m.transpose ();
+  bool in_order = true;
+  for (std::size_t i = 0; i < k && in_order; ++i)
+    in_order = columns[i] == i;
+
+  bitmatrix result (n - k, n);
+  for (std::size_t j = 0; j < n - k; ++j)
+    {
+      const std::size_t col = columns[k + j];
+      if (in_order)
+        std::copy_n (m_t.row (col), m_t.stride (), result.row (j));
+      else
+        for (std::size_t i = 0; i < k; ++i)
+          if (m_t.get (col, i))
+            result.flip (j, columns[i]);
+      result.flip (j, col);
+    }
+  return result;
+}
+
+[[nodiscard]] std::vector<std::uint64_t>
+weight_distribution (const bitmatrix &basis)
+{
+  const std::size_t stride = basis.stride ();
+  std::vector<std::uint64_t> distribution (basis.cols () + 1, 0);
+  std::vector<bitmatrix::block_type> current (stride, 0);
+
+  distribution[0] = 1;
+  const std::uint64_t total = std::uint64_t{ 1 } << basis.rows ();
+  for (std::uint64_t i = 1; i < total; ++i)
+    {
+      // The i-th Gray code differs from the previous one in the lowest set
+      // bit of i.
+      const bitmatrix::block_type *row = basis.row (std::countr_zero (i));
+      std::size_t weight = 0;
+      for (std::size_t b = 0; b < stride; ++b)
+        {
+          current[b] ^= row[b];
+          weight += std::popcount (current[b]);
+        }
+      ++distribution[weight];
+    }
+  return distribution;
+}
+
+///
+/// Elimination
+///
+
+namespace
+{
+
+///
+/// \brief Maximum number of pivots handled by a single lookup table.
+/// \note 8 pivots make a table of 256 rows which stays in L1 for matrices
+/// with up to a few thousand columns.
+///
+constexpr std::size_t max_group_size = 8;
+
+[[nodiscard]] std::size_t
+group_size_for (std::size_t rows) noexcept
+{
+  // Building a table of 2^g rows only pays off when there are enough rows to
+  // clear with it. For small matrices this degrades to ordinary elimination.
+  const std::size_t g = std::bit_width (rows) / 2;
+  return std::clamp<std::size_t> (g, 1, max_group_size);
+}
+
+} // namespace
+
+std::vector<std::size_t>
+reduce_to_echelon_form (bitmatrix &m)
+{
+  using block_type = bitmatrix::block_type;
+
+  const std::size_t rows = m.rows ();
+  const std::size_t cols = m.cols ();
+  const std::size_t stride = m.stride ();
+  const std::size_t group_size = group_size_for (rows);
+
+  std::vector<std::size_t> pivots;
+  pivots.reserve (std::min (rows, cols));
+
+  std::vector<block_type> table ((std::size_t{ 1 } << max_group_size)
+                                 * stride);
+
+  // Pivots of the group currently being collected. The pivot row of the i-th
+  // one is row `group_begin + i`.
+  std::vector<std::size_t> group;
+  group.reserve (group_size);
+  std::size_t group_begin = 0;
+
+  auto clear_with_group = [&] () {
+    if (group.empty ())
+      return;
+
+    // The pivot rows are zero left of the group's first pivot, so that part
+    // of the rows never has to be touched.
+    const std::size_t first_block = group.front () / bitmatrix::block_bits;
+    const std::size_t num_entries = std::size_t{ 1 } << group.size ();
+    std::fill_n (table.begin (), stride, 0);
+    for (std::size_t idx = 1; idx < num_entries; ++idx)
+      {
+        const std::size_t prev = idx & (idx - 1);
+        const block_type *src = m.row (group_begin + std::countr_zero (idx));
+        block_type *dst = table.data () + idx * stride;
+        const block_type *base = table.data () + prev * stride;
+        for (std::size_t b = first_block; b < stride; ++b)
+          dst[b] = base[b] ^ src[b];
+      }
+
+    // The pivot rows are reduced among themselves, so the combination of
+    // them selected by a row's bits in the pivot columns clears exactly
+    // those bits.
+    for (std::size_t r = 0; r < rows; ++r)
+      {
+        if (r >= group_begin && r < group_begin + group.size ())
+          continue;
+        std::size_t idx = 0;
+        for (std::size_t i = 0; i < group.size (); ++i)
+          idx |= std::size_t{ m.get (r, group[i]) } << i;
+        if (idx == 0)
+          continue;
+        block_type *dst = m.row (r);
+        const block_type *src = table.data () + idx * stride;
+        for (std::size_t b = first_block; b < stride; ++b)
+          dst[b] ^= src[b];
+      }
+
+    pivots.insert (pivots.end (), group.cbegin (), group.cend ());
+    group_begin += group.size ();
+    group.clear ();
+  };
+
+  for (std::size_t c = 0; c < cols && group_begin + group.size () < rows; ++c)
+    {
+      const std::size_t next_row = group_begin + group.size ();
+
+      // Look for a row with a one in column c, once the pivots of the current
+      // group are accounted for. Rows which are inspected get reduced by the
+      // group as they are scanned.
+      std::size_t found = rows;
+      for (std::size_t r = next_row; r < rows; ++r)
+        {
+          for (std::size_t i = 0; i < group.size (); ++i)
+            if (m.get (r, group[i]))
+              m.xor_row (r, group_begin + i);
+          if (m.get (r, c))
+            {
+              found = r;
+              break;
+            }
+        }
+
+      if (found == rows)
+        continue;
+
+      m.swap_rows (found, next_row);
+      // Keep the group's pivot block equal to the identity.
+      for (std::size_t i = 0; i < group.size (); ++i)
+        if (m.get (group_begin + i, c))
+          m.xor_row (group_begin + i, next_row);
+      group.push_back (c);
+
+      if (group.size () == group_size)
+        clear_with_group ();
+    }
+  clear_with_group ();
+
+  assert (pivots.size () <= std::min (rows, cols));
+  return pivots;
+}
+
+} // namespace details
+
+} // namespace patrick
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <patrick/cache.h>
+#include <patrick/core.h>
+#include <patrick/trace.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+std::atomic<std::size_t> cache_budget{ 0 };
+std::atomic<std::uint64_t> cache_clock{ 0 };
+
+///
+/// \brief Keeps the slots which account for any bytes, from the one which
+/// did so first.
+///
+class cache_registry
+{
+public:
+  ///
+  /// \brief The registry is never destroyed, so that codes which are
+  /// destroyed along with the statics may still leave it.
+  ///
+  [[nodiscard]] static cache_registry &
+  instance ()
+  {
+    static auto *registry = new cache_registry;
+    return *registry;
+  }
+
+  std::mutex mutex;
+  std::vector<cache_slot *> slots;
+  cache_usage usage;
+
+  [[nodiscard]] static std::size_t
+  total (const cache_slot &slot) noexcept
+  {
+    return std::accumulate (slot.m_bytes.cbegin (), slot.m_bytes.cend (),
+                            std::size_t{ 0 });
+  }
+
+  ///
+  /// \brief Takes \a table of \a slot out of the accounts.
+  /// \note Expects the mutex to be locked.
+  ///
+  void
+  forget (cache_slot &slot, std::size_t table) noexcept
+  {
+    if (slot.m_bytes[table] == 0)
+      return;
+    usage.bytes -= slot.m_bytes[table];
+    --usage.tables;
+    slot.m_bytes[table] = 0;
+    if (total (slot) == 0)
+      std::erase (slots, &slot);
+  }
+
+  ///
+  /// \brief Evicts the tables of the least recently used codes but \a keep
+  /// until the total is within the budget.
+  /// \note Expects the mutex to be locked.
+  ///
+  void
+  evict_over_budget (const cache_slot *keep) noexcept
+  {
+    std::vector<const cache_slot *> busy;
+    while (usage.budget != 0 && usage.bytes > usage.budget)
+      {
+        cache_slot *victim = nullptr;
+        for (cache_slot *slot : slots)
+          if (slot != keep && std::ranges::find (busy, slot) == busy.end ()
+              && (!victim
+                  || slot->m_last_use.load (std::memory_order_relaxed)
+                         < victim->m_last_use.load (
+                             std::memory_order_relaxed)))
+            victim = slot;
+        if (!victim)
+          return;
+
+        victim->m_evicting.store (true);
+        if (victim->m_users.load () != 0)
+          {
+            victim->m_evicting.store (false);
+            try
+              {
+                busy.push_back (victim);
+              }
+            catch (...)
+              {
+                // Without memory to remember it, give up for now.
+                return;
+              }
+            continue;
+          }
+
+        const std::size_t table
+            = std::ranges::max_element (victim->m_bytes)
+              - victim->m_bytes.begin ();
+        trace_span span{ "evict", "table" };
+        span.arg ("table", table);
+        span.arg ("bytes", victim->m_bytes[table]);
+        victim->m_owner->evict (lazy_table (table));
+        forget (*victim, table);
+        ++usage.evictions;
+        victim->m_evicting.store (false);
+      }
+  }
+};
+
+///
+/// Slots
+///
+
+cache_slot::~cache_slot ()
+{
+  auto &registry = cache_registry::instance ();
+  std::scoped_lock lock{ registry.mutex };
+  for (std::size_t table = 0; table < m_bytes.size (); ++table)
+    registry.forget (*this, table);
+}
+
+void
+cache_slot::add (lazy_table table, std::size_t bytes)
+{
+  if (bytes == 0)
+    return;
+  auto &registry = cache_registry::instance ();
+  std::scoped_lock lock{ registry.mutex };
+  if (cache_registry::total (*this) == 0)
+    registry.slots.push_back (this);
+  if (m_bytes[std::size_t (table)] == 0)
+    ++registry.usage.tables;
+  m_bytes[std::size_t (table)] += bytes;
+  registry.usage.bytes += bytes;
+  // The tick before the build, so that codes used after it are more recent.
+  m_last_use.store (cache_clock.fetch_add (1, std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+  registry.evict_over_budget (this);
+}
+
+void
+cache_slot::drop (lazy_table table) noexcept
+{
+  auto &registry = cache_registry::instance ();
+  std::scoped_lock lock{ registry.mutex };
+  registry.forget (*this, std::size_t (table));
+}
+
+void
+cache_slot::take_over (cache_slot &other) noexcept
+{
+  auto &registry = cache_registry::instance ();
+  std::scoped_lock lock{ registry.mutex };
+  if (cache_registry::total (other) == 0)
+    return;
+  // Both slots belong to the same code now, so the order is kept.
+  std::ranges::replace (registry.slots, &other, this);
+  m_bytes = std::exchange (other.m_bytes, {});
+  m_last_use.store (other.m_last_use.load (std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+}
+
+} // namespace details
+
+///
+/// Configuration
+///
+
+void
+set_cache_budget (std::size_t bytes)
+{
+  auto &registry = details::cache_registry::instance ();
+  std::scoped_lock lock{ registry.mutex };
+  registry.usage.budget = bytes;
+  details::cache_budget.store (bytes, std::memory_order_relaxed);
+  registry.evict_over_budget (nullptr);
+}
+
+[[nodiscard]] cache_usage
+current_cache_usage ()
+{
+  auto &registry = details::cache_registry::instance ();
+  std::scoped_lock lock{ registry.mutex };
+  return registry.usage;
+}
+
+} // namespace patrick
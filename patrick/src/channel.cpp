@@ -0,0 +1,551 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <patrick/bitmatrix.h>
+#include <patrick/channel.h>
+#include <patrick/cpu.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+namespace
+{
+
+///
+/// \brief The coefficients of the approximations of Cephes. The logarithm is
+/// taken of a mantissa in \f$[\sqrt{1/2}, \sqrt{2})\f$ and the sine and
+/// cosine of an angle in \f$[-\pi/4, \pi/4]\f$.
+///
+constexpr float log_coefficients[]{
+  7.0376836292e-2f,  -1.1514610310e-1f, 1.1676998740e-1f,
+  -1.2420140846e-1f, 1.4249322787e-1f,  -1.6668057665e-1f,
+  2.0000714765e-1f,  -2.4999993993e-1f, 3.3333331174e-1f,
+};
+constexpr float log_low = -2.12194440e-4f;
+constexpr float log_high = 0.693359375f;
+constexpr float sin_coefficients[]{ -1.9515295891e-4f, 8.3321608736e-3f,
+                                    -1.6666654611e-1f };
+constexpr float cos_coefficients[]{ 2.443315711809948e-5f,
+                                    -1.388731625493765e-3f,
+                                    4.166664568298827e-2f };
+constexpr float half_pi = 1.57079632679489661923f;
+constexpr float uniform_scale = 0x1.0p-24f;
+
+///
+/// \brief Advances the interleaved generators by one step.
+/// \param out The outputs of the 4 generators are written here.
+///
+void
+xoshiro_step (gaussian_generator::state_type &state,
+              std::uint64_t *out) noexcept
+{
+  for (std::size_t l = 0; l < 4; ++l)
+    {
+      std::uint64_t *s = state.data () + l;
+      out[l] = std::rotl (s[0] + s[12], 23) + s[0];
+      const std::uint64_t t = s[4] << 17;
+      s[8] ^= s[0];
+      s[12] ^= s[4];
+      s[4] ^= s[8];
+      s[0] ^= s[12];
+      s[8] ^= t;
+      s[12] = std::rotl (s[12], 45);
+    }
+}
+
+///
+/// \return \f$\sqrt{-2 \log u}\f$ for \f$u \in (0, 1]\f$.
+///
+float
+box_muller_radius (float u) noexcept
+{
+  // u = m 2^e with m in [sqrt(1/2), sqrt(2)).
+  const auto bits = std::bit_cast<std::uint32_t> (u);
+  std::int32_t e = std::int32_t (bits >> 23) - 126;
+  float m = std::bit_cast<float> ((bits & 0x007fffff) | 0x3f000000);
+  if (m < 0.70710678118654752440f)
+    {
+      e -= 1;
+      m = m + m;
+    }
+  const float x = m - 1.0f;
+  const float z = x * x;
+  float p = log_coefficients[0];
+  for (std::size_t i = 1; i < std::size (log_coefficients); ++i)
+    p = p * x + log_coefficients[i];
+  float y = p * x * z;
+  y = y + float (e) * log_low;
+  y = y - 0.5f * z;
+  const float log = (x + y) + float (e) * log_high;
+  return std::sqrt (-2.0f * log);
+}
+
+///
+/// \brief The sine and cosine of \f$2 \pi t\f$ for \f$t \in [0, 1)\f$.
+///
+std::pair<float, float>
+box_muller_angle (float t) noexcept
+{
+  // 2 pi t = q pi / 2 + x for an integer q and x in [-pi/4, pi/4].
+  const float y = 4.0f * t;
+  const float q = std::nearbyint (y);
+  const float x = (y - q) * half_pi;
+  const float z = x * x;
+  const float s
+      = ((sin_coefficients[0] * z + sin_coefficients[1]) * z
+         + sin_coefficients[2])
+            * z * x
+        + x;
+  const float c = ((cos_coefficients[0] * z + cos_coefficients[1]) * z
+                   + cos_coefficients[2])
+                      * z * z
+                  - 0.5f * z + 1.0f;
+
+  const auto quadrant = std::uint32_t (q);
+  const float sin = quadrant & 1 ? c : s;
+  const float cos = quadrant & 1 ? s : c;
+  return { std::bit_cast<float> (std::bit_cast<std::uint32_t> (sin)
+                                 ^ (quadrant & 2) << 30),
+           std::bit_cast<float> (std::bit_cast<std::uint32_t> (cos)
+                                 ^ ((quadrant + 1) & 2) << 30) };
+}
+
+} // namespace
+
+#if defined(__x86_64__) || defined(__i386__)
+
+namespace
+{
+
+__attribute__ ((target ("avx2"))) inline __m256i
+rotl_avx2 (__m256i x, int k) noexcept
+{
+  return _mm256_or_si256 (_mm256_slli_epi64 (x, k),
+                          _mm256_srli_epi64 (x, 64 - k));
+}
+
+__attribute__ ((target ("avx2"))) inline __m256
+polynomial_avx2 (__m256 x, const float *coefficients,
+                 std::size_t size) noexcept
+{
+  __m256 p = _mm256_set1_ps (coefficients[0]);
+  for (std::size_t i = 1; i < size; ++i)
+    p = _mm256_add_ps (_mm256_mul_ps (p, x),
+                       _mm256_set1_ps (coefficients[i]));
+  return p;
+}
+
+///
+/// \brief Advances the interleaved generators, which are held in \a s, by
+/// one step.
+/// \return The outputs of the 4 generators.
+///
+__attribute__ ((target ("avx2"))) inline __m256i
+xoshiro_step_avx2 (__m256i (&s)[4]) noexcept
+{
+  const __m256i result
+      = _mm256_add_epi64 (rotl_avx2 (_mm256_add_epi64 (s[0], s[3]), 23), s[0]);
+  const __m256i t = _mm256_slli_epi64 (s[1], 17);
+  s[2] = _mm256_xor_si256 (s[2], s[0]);
+  s[3] = _mm256_xor_si256 (s[3], s[1]);
+  s[1] = _mm256_xor_si256 (s[1], s[2]);
+  s[0] = _mm256_xor_si256 (s[0], s[3]);
+  s[2] = _mm256_xor_si256 (s[2], t);
+  s[3] = rotl_avx2 (s[3], 45);
+  return result;
+}
+
+} // namespace
+
+__attribute__ ((target ("avx2"))) void
+gaussian_blocks_avx2 (gaussian_generator::state_type &state, float *out,
+                      std::size_t num_blocks) noexcept
+{
+  auto *words = reinterpret_cast<__m256i *> (state.data ());
+  __m256i s[4];
+  for (std::size_t w = 0; w < 4; ++w)
+    s[w] = _mm256_loadu_si256 (words + w);
+
+  const __m256 scale = _mm256_set1_ps (uniform_scale);
+  const __m256 one = _mm256_set1_ps (1.0f);
+  const __m256 half = _mm256_set1_ps (0.5f);
+  for (std::size_t block = 0; block < num_blocks; ++block)
+    {
+      // The 8 halves of the 4 outputs give 24-bit uniforms.
+      const __m256i radii = _mm256_srli_epi32 (xoshiro_step_avx2 (s), 8);
+      const __m256i angles = _mm256_srli_epi32 (xoshiro_step_avx2 (s), 8);
+      const __m256 u = _mm256_mul_ps (
+          _mm256_add_ps (_mm256_cvtepi32_ps (radii), one), scale);
+      const __m256 t = _mm256_mul_ps (_mm256_cvtepi32_ps (angles), scale);
+
+      // The radius.
+      const __m256i bits = _mm256_castps_si256 (u);
+      __m256i e = _mm256_sub_epi32 (_mm256_srli_epi32 (bits, 23),
+                                    _mm256_set1_epi32 (126));
+      __m256 m = _mm256_castsi256_ps (_mm256_or_si256 (
+          _mm256_and_si256 (bits, _mm256_set1_epi32 (0x007fffff)),
+          _mm256_set1_epi32 (0x3f000000)));
+      const __m256 small = _mm256_cmp_ps (
+          m, _mm256_set1_ps (0.70710678118654752440f), _CMP_LT_OQ);
+      e = _mm256_add_epi32 (e, _mm256_castps_si256 (small));
+      m = _mm256_blendv_ps (m, _mm256_add_ps (m, m), small);
+      const __m256 x = _mm256_sub_ps (m, one);
+      const __m256 z = _mm256_mul_ps (x, x);
+      const __m256 fe = _mm256_cvtepi32_ps (e);
+      __m256 y = _mm256_mul_ps (
+          _mm256_mul_ps (polynomial_avx2 (x, log_coefficients,
+                                          std::size (log_coefficients)),
+                         x),
+          z);
+      y = _mm256_add_ps (y, _mm256_mul_ps (fe, _mm256_set1_ps (log_low)));
+      y = _mm256_sub_ps (y, _mm256_mul_ps (half, z));
+      const __m256 log = _mm256_add_ps (
+          _mm256_add_ps (x, y),
+          _mm256_mul_ps (fe, _mm256_set1_ps (log_high)));
+      const __m256 radius
+          = _mm256_sqrt_ps (_mm256_mul_ps (_mm256_set1_ps (-2.0f), log));
+
+      // The angle.
+      const __m256 ay = _mm256_mul_ps (_mm256_set1_ps (4.0f), t);
+      const __m256 q = _mm256_round_ps (
+          ay, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      const __m256 ax
+          = _mm256_mul_ps (_mm256_sub_ps (ay, q), _mm256_set1_ps (half_pi));
+      const __m256 az = _mm256_mul_ps (ax, ax);
+      const __m256 s = _mm256_add_ps (
+          _mm256_mul_ps (
+              _mm256_mul_ps (polynomial_avx2 (az, sin_coefficients,
+                                              std::size (sin_coefficients)),
+                             az),
+              ax),
+          ax);
+      const __m256 c = _mm256_add_ps (
+          _mm256_sub_ps (
+              _mm256_mul_ps (
+                  _mm256_mul_ps (
+                      polynomial_avx2 (az, cos_coefficients,
+                                       std::size (cos_coefficients)),
+                      az),
+                  az),
+              _mm256_mul_ps (half, az)),
+          one);
+      const __m256i quadrant = _mm256_cvtps_epi32 (q);
+      const __m256 swap = _mm256_castsi256_ps (_mm256_cmpeq_epi32 (
+          _mm256_and_si256 (quadrant, _mm256_set1_epi32 (1)),
+          _mm256_set1_epi32 (1)));
+      const __m256i two = _mm256_set1_epi32 (2);
+      const __m256 sin = _mm256_xor_ps (
+          _mm256_blendv_ps (s, c, swap),
+          _mm256_castsi256_ps (_mm256_slli_epi32 (
+              _mm256_and_si256 (quadrant, two), 30)));
+      const __m256 cos = _mm256_xor_ps (
+          _mm256_blendv_ps (c, s, swap),
+          _mm256_castsi256_ps (_mm256_slli_epi32 (
+              _mm256_and_si256 (
+                  _mm256_add_epi32 (quadrant, _mm256_set1_epi32 (1)), two),
+              30)));
+
+      _mm256_storeu_ps (out + block * gaussian_generator::block_size,
+                        _mm256_mul_ps (radius, cos));
+      _mm256_storeu_ps (out + block * gaussian_generator::block_size + 8,
+                        _mm256_mul_ps (radius, sin));
+    }
+
+  for (std::size_t w = 0; w < 4; ++w)
+    _mm256_storeu_si256 (words + w, s[w]);
+}
+
+#endif
+
+void
+gaussian_blocks_scalar (gaussian_generator::state_type &state, float *out,
+                        std::size_t num_blocks) noexcept
+{
+  for (std::size_t block = 0; block < num_blocks; ++block)
+    {
+      std::uint32_t halves[2][8];
+      for (auto &h : halves)
+        {
+          std::uint64_t words[4];
+          xoshiro_step (state, words);
+          for (std::size_t i = 0; i < 8; ++i)
+            h[i] = std::uint32_t (words[i / 2] >> (i % 2 * 32)) >> 8;
+        }
+
+      float *normals = out + block * gaussian_generator::block_size;
+      for (std::size_t i = 0; i < 8; ++i)
+        {
+          const float radius = box_muller_radius (
+              (float (halves[0][i]) + 1.0f) * uniform_scale);
+          const auto [sin, cos]
+              = box_muller_angle (float (halves[1][i]) * uniform_scale);
+          normals[i] = radius * cos;
+          normals[i + 8] = radius * sin;
+        }
+    }
+}
+
+void
+gaussian_blocks (gaussian_generator::state_type &state, float *out,
+                 std::size_t num_blocks) noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+  if (cpu ().avx2)
+    return gaussian_blocks_avx2 (state, out, num_blocks);
+#endif
+  gaussian_blocks_scalar (state, out, num_blocks);
+}
+
+gaussian_generator::gaussian_generator (std::uint64_t seed) noexcept
+{
+  xoshiro256pp expand{ seed };
+  for (auto &s : m_state)
+    s = expand ();
+}
+
+void
+gaussian_generator::fill (std::span<float> out) noexcept
+{
+  std::size_t i = 0;
+  for (; i < out.size () && m_spare_used < block_size; ++i)
+    out[i] = m_spare[m_spare_used++];
+
+  const std::size_t num_blocks = (out.size () - i) / block_size;
+  gaussian_blocks (m_state, out.data () + i, num_blocks);
+  i += num_blocks * block_size;
+
+  if (i < out.size ())
+    {
+      gaussian_blocks (m_state, m_spare.data (), 1);
+      m_spare_used = 0;
+      for (; i < out.size (); ++i)
+        out[i] = m_spare[m_spare_used++];
+    }
+}
+
+} // namespace details
+
+///
+/// Binary symmetric channel
+///
+
+binary_symmetric_channel::binary_symmetric_channel (
+    double crossover_probability, std::uint64_t seed)
+    : m_flips{ crossover_probability, seed }
+{
+  if (!(crossover_probability >= 0 && crossover_probability <= 1))
+    throw channel_exception{ fmt::format (
+        "Cannot create a binary symmetric channel with crossover "
+        "probability {}.",
+        crossover_probability) };
+}
+
+void
+binary_symmetric_channel::corrupt (std::span<std::uint64_t> bits,
+                                   std::size_t num_bits) noexcept
+{
+  m_flips.for_each (num_bits, [bits] (std::uint64_t position) {
+    bits[position / 64] ^= std::uint64_t{ 1 } << (position % 64);
+  });
+}
+
+[[nodiscard]] codeword
+binary_symmetric_channel::transmit (const codeword &cword)
+{
+  const std::size_t n = cword.vec.cols ();
+  std::vector<std::uint64_t> bits (details::bitmatrix::blocks_for (n));
+  details::pack (cword, bits.data ());
+  corrupt (bits, n);
+  return details::unpack<details::codeword_tag> (bits.data (), n);
+}
+
+void
+binary_symmetric_channel::reseed (std::uint64_t seed) noexcept
+{
+  m_flips.reseed (seed);
+}
+
+///
+/// AWGN channel
+///
+
+awgn_channel::awgn_channel (double noise_deviation, std::uint64_t seed)
+    : m_noise_deviation{ noise_deviation }, m_gen{ seed }
+{
+  if (!(noise_deviation > 0 && std::isfinite (noise_deviation)))
+    throw channel_exception{ fmt::format (
+        "Cannot create an AWGN channel with noise deviation {}.",
+        noise_deviation) };
+}
+
+[[nodiscard]] awgn_channel
+awgn_channel::from_ebn0 (double ebn0_db, double rate, std::uint64_t seed)
+{
+  if (!(rate > 0 && rate <= 1))
+    throw channel_exception{ fmt::format (
+        "Cannot create an AWGN channel for a code of rate {}.", rate) };
+
+  const double ebn0 = std::pow (10.0, ebn0_db / 10);
+  return awgn_channel{ std::sqrt (1 / (2 * rate * ebn0)), seed };
+}
+
+void
+awgn_channel::transmit (std::span<const std::uint64_t> bits,
+                        std::size_t num_bits, std::span<float> llrs) noexcept
+{
+  const auto deviation = float (m_noise_deviation);
+  const auto scale = float (2 / (m_noise_deviation * m_noise_deviation));
+  m_gen.fill (llrs.first (num_bits));
+  for (std::size_t i = 0; i < num_bits; ++i)
+    {
+      const float x = (bits[i / 64] >> (i % 64)) & 1 ? -1.0f : 1.0f;
+      llrs[i] = scale * (x + deviation * llrs[i]);
+    }
+}
+
+[[nodiscard]] std::vector<float>
+awgn_channel::transmit (const codeword &cword)
+{
+  const std::size_t n = cword.vec.cols ();
+  std::vector<std::uint64_t> bits (details::bitmatrix::blocks_for (n));
+  details::pack (cword, bits.data ());
+  std::vector<float> llrs (n);
+  transmit (bits, n, llrs);
+  return llrs;
+}
+
+void
+awgn_channel::reseed (std::uint64_t seed) noexcept
+{
+  m_gen = details::gaussian_generator{ seed };
+}
+
+///
+/// Gilbert-Elliott channel
+///
+
+gilbert_elliott_channel::gilbert_elliott_channel (parameters_type parameters,
+                                                  std::uint64_t seed)
+    : m_parameters{ parameters }, m_transitions{ 0, 0 }, m_flips{ 0, 0 }
+{
+  for (const double p : { parameters.good_to_bad, parameters.bad_to_good,
+                          parameters.good_error, parameters.bad_error })
+    if (!(p >= 0 && p <= 1))
+      throw channel_exception{ fmt::format (
+          "Cannot create a Gilbert-Elliott channel with probability {}.",
+          p) };
+  if (parameters.bad_to_good == 0)
+    throw channel_exception{
+      "Cannot create a Gilbert-Elliott channel which never leaves its bad "
+      "state."
+    };
+
+  reseed (seed);
+}
+
+void
+gilbert_elliott_channel::corrupt (std::span<std::uint64_t> bits,
+                                  std::size_t num_bits) noexcept
+{
+  for (std::uint64_t position = 0; position < num_bits;)
+    {
+      // The last bit before the next transition.
+      const std::uint64_t last
+          = position + m_transitions.next (num_bits - position);
+      const std::uint64_t end = std::min<std::uint64_t> (last + 1, num_bits);
+      m_flips.for_each (end - position, [bits, position] (std::uint64_t i) {
+        const std::uint64_t flip = position + i;
+        bits[flip / 64] ^= std::uint64_t{ 1 } << (flip % 64);
+      });
+      if (last < num_bits)
+        {
+          m_bad = !m_bad;
+          m_transitions.set_probability (m_bad ? m_parameters.bad_to_good
+                                               : m_parameters.good_to_bad);
+          m_flips.set_probability (m_bad ? m_parameters.bad_error
+                                         : m_parameters.good_error);
+        }
+      position = end;
+    }
+}
+
+[[nodiscard]] codeword
+gilbert_elliott_channel::transmit (const codeword &cword)
+{
+  const std::size_t n = cword.vec.cols ();
+  std::vector<std::uint64_t> bits (details::bitmatrix::blocks_for (n));
+  details::pack (cword, bits.data ());
+  corrupt (bits, n);
+  return details::unpack<details::codeword_tag> (bits.data (), n);
+}
+
+void
+gilbert_elliott_channel::reseed (std::uint64_t seed) noexcept
+{
+  details::xoshiro256pp expand{ seed };
+  const double bad = m_parameters.good_to_bad
+                     / (m_parameters.good_to_bad + m_parameters.bad_to_good);
+  m_bad = expand.uniform () <= bad;
+  m_transitions = details::geometric_skipper{
+    m_bad ? m_parameters.bad_to_good : m_parameters.good_to_bad, expand ()
+  };
+  m_flips = details::geometric_skipper{
+    m_bad ? m_parameters.bad_error : m_parameters.good_error, expand ()
+  };
+}
+
+///
+/// Binary erasure channel
+///
+
+binary_erasure_channel::binary_erasure_channel (double erasure_probability,
+                                                std::uint64_t seed)
+    : m_erasures{ erasure_probability, seed }
+{
+  if (!(erasure_probability >= 0 && erasure_probability <= 1))
+    throw channel_exception{ fmt::format (
+        "Cannot create a binary erasure channel with erasure probability {}.",
+        erasure_probability) };
+}
+
+void
+binary_erasure_channel::erase (std::span<std::uint64_t> bits,
+                               std::span<std::uint64_t> erasures,
+                               std::size_t num_bits) noexcept
+{
+  std::fill_n (erasures.begin (), details::bitmatrix::blocks_for (num_bits),
+               0);
+  m_erasures.for_each (num_bits, [bits, erasures] (std::uint64_t position) {
+    const std::uint64_t mask = std::uint64_t{ 1 } << (position % 64);
+    bits[position / 64] &= ~mask;
+    erasures[position / 64] |= mask;
+  });
+}
+
+[[nodiscard]] binary_erasure_channel::received_type
+binary_erasure_channel::transmit (const codeword &cword)
+{
+  const std::size_t n = cword.vec.cols ();
+  std::vector<std::uint64_t> bits (details::bitmatrix::blocks_for (n));
+  std::vector<std::uint64_t> erasures (bits.size ());
+  details::pack (cword, bits.data ());
+  erase (bits, erasures, n);
+  return { details::unpack<details::codeword_tag> (bits.data (), n),
+           details::unpack<details::codeword_tag> (erasures.data (), n) };
+}
+
+void
+binary_erasure_channel::reseed (std::uint64_t seed) noexcept
+{
+  m_erasures.reseed (seed);
+}
+
+} // namespace patrick
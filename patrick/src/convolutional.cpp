@@ -0,0 +1,524 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <patrick/convolutional.h>
+#include <patrick/cpu.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+namespace
+{
+
+using metric_type = trellis::metric_type;
+using decision_type = trellis::decision_type;
+
+///
+/// \brief The number of states whose metrics a vector register holds.
+///
+constexpr std::size_t lanes = 16;
+
+#if defined(__x86_64__) || defined(__i386__)
+
+///
+/// \pre There are at least 32 states.
+///
+__attribute__ ((target ("avx2"))) void
+add_compare_select_avx2 (const metric_type *lane_masks,
+                         std::size_t num_outputs, std::size_t num_states,
+                         const metric_type *symbols,
+                         const metric_type *metrics, metric_type *next,
+                         decision_type *decisions)
+{
+  const std::size_t half = num_states / 2;
+  const std::size_t blocks = half / lanes;
+  const __m256i offset = _mm256_set1_epi16 (
+      static_cast<metric_type> (num_outputs * trellis::max_symbol));
+  const __m256i low_half = _mm256_set1_epi32 (0xffff);
+
+  __m256i received[convolutional_code::max_outputs];
+  for (std::size_t i = 0; i < num_outputs; ++i)
+    received[i] = _mm256_set1_epi16 (symbols[i]);
+
+  for (std::size_t j = 0; j < blocks; ++j)
+    {
+      // Split the metrics of states 32j.. into the even and the odd ones.
+      const __m256i a = _mm256_loadu_si256 (
+          reinterpret_cast<const __m256i *> (metrics + 2 * lanes * j));
+      const __m256i b = _mm256_loadu_si256 (
+          reinterpret_cast<const __m256i *> (metrics + 2 * lanes * j + lanes));
+      const __m256i even = _mm256_permute4x64_epi64 (
+          _mm256_packus_epi32 (_mm256_and_si256 (a, low_half),
+                               _mm256_and_si256 (b, low_half)),
+          0xd8);
+      const __m256i odd = _mm256_permute4x64_epi64 (
+          _mm256_packus_epi32 (_mm256_srli_epi32 (a, 16),
+                               _mm256_srli_epi32 (b, 16)),
+          0xd8);
+
+      __m256i chosen[2];
+      for (std::size_t input = 0; input < 2; ++input)
+        {
+          const metric_type *masks
+              = lane_masks + (2 * j + input) * 2 * num_outputs * lanes;
+          __m256i even_cost = offset;
+          __m256i odd_cost = offset;
+          for (std::size_t i = 0; i < num_outputs; ++i)
+            {
+              const __m256i even_mask = _mm256_loadu_si256 (
+                  reinterpret_cast<const __m256i *> (masks + i * lanes));
+              const __m256i odd_mask
+                  = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (
+                      masks + (num_outputs + i) * lanes));
+              even_cost = _mm256_add_epi16 (
+                  even_cost,
+                  _mm256_sub_epi16 (_mm256_xor_si256 (received[i], even_mask),
+                                    even_mask));
+              odd_cost = _mm256_add_epi16 (
+                  odd_cost,
+                  _mm256_sub_epi16 (_mm256_xor_si256 (received[i], odd_mask),
+                                    odd_mask));
+            }
+          const __m256i from_even = _mm256_add_epi16 (even, even_cost);
+          const __m256i from_odd = _mm256_add_epi16 (odd, odd_cost);
+          _mm256_storeu_si256 (
+              reinterpret_cast<__m256i *> (next + input * half + lanes * j),
+              _mm256_min_epi16 (from_even, from_odd));
+          chosen[input] = _mm256_cmpgt_epi16 (from_even, from_odd);
+        }
+
+      // One byte per decision, those of input 0 first.
+      const auto bits = static_cast<std::uint32_t> (
+          _mm256_movemask_epi8 (_mm256_permute4x64_epi64 (
+              _mm256_packs_epi16 (chosen[0], chosen[1]), 0xd8)));
+      decisions[j] = static_cast<decision_type> (bits);
+      decisions[blocks + j] = static_cast<decision_type> (bits >> 16);
+    }
+}
+
+#endif
+
+} // namespace
+
+trellis::trellis (std::size_t constraint_length,
+                  std::span<const std::uint32_t> polynomials)
+    : m_constraint_length{ constraint_length },
+      m_num_outputs{ polynomials.size () }
+{
+  const std::size_t states = num_states ();
+  m_outputs.resize (2 * states);
+  for (std::size_t state = 0; state < states; ++state)
+    for (std::size_t input = 0; input < 2; ++input)
+      {
+        const std::uint32_t reg = (input << (constraint_length - 1)) | state;
+        std::uint32_t output = 0;
+        for (std::size_t i = 0; i < m_num_outputs; ++i)
+          output |= (std::popcount (reg & polynomials[i]) & 1u) << i;
+        m_outputs[2 * state + input] = output;
+      }
+
+  const std::size_t half = states / 2;
+  if (half < lanes)
+    return;
+  m_lane_masks.resize (2 * states * m_num_outputs);
+  auto mask = m_lane_masks.begin ();
+  for (std::size_t j = 0; j < half / lanes; ++j)
+    for (std::size_t input = 0; input < 2; ++input)
+      for (std::size_t parity = 0; parity < 2; ++parity)
+        for (std::size_t i = 0; i < m_num_outputs; ++i)
+          for (std::size_t lane = 0; lane < lanes; ++lane)
+            {
+              const std::size_t state = 2 * (lanes * j + lane) + parity;
+              *mask++ = ((output_of (state, input) >> i) & 1u) ? 0 : -1;
+            }
+}
+
+void
+trellis::add_compare_select (std::span<const metric_type> symbols,
+                             std::span<const metric_type> metrics,
+                             std::span<metric_type> next,
+                             std::span<decision_type> decisions) const noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+  if (!m_lane_masks.empty () && cpu ().avx2)
+    {
+      assert (symbols.size () == m_num_outputs);
+      assert (metrics.size () == num_states ());
+      assert (next.size () == num_states ());
+      assert (decisions.size () == decision_words ());
+      add_compare_select_avx2 (m_lane_masks.data (), m_num_outputs,
+                               num_states (), symbols.data (), metrics.data (),
+                               next.data (), decisions.data ());
+      return;
+    }
+#endif
+  add_compare_select_scalar (symbols, metrics, next, decisions);
+}
+
+void
+trellis::add_compare_select_scalar (
+    std::span<const metric_type> symbols, std::span<const metric_type> metrics,
+    std::span<metric_type> next,
+    std::span<decision_type> decisions) const noexcept
+{
+  assert (symbols.size () == m_num_outputs);
+  assert (metrics.size () == num_states () && next.size () == num_states ());
+  assert (decisions.size () == decision_words ());
+
+  // The costs of all the outputs a branch may have.
+  std::array<metric_type, std::size_t{ 1 } << convolutional_code::max_outputs>
+      costs;
+  for (std::uint32_t output = 0; output < (1u << m_num_outputs); ++output)
+    {
+      int cost = static_cast<int> (m_num_outputs) * max_symbol;
+      for (std::size_t i = 0; i < m_num_outputs; ++i)
+        cost += ((output >> i) & 1u) ? symbols[i] : -symbols[i];
+      costs[output] = static_cast<metric_type> (cost);
+    }
+
+  std::fill (decisions.begin (), decisions.end (), 0);
+  const std::size_t half = num_states () / 2;
+  for (std::size_t t = 0; t < num_states (); ++t)
+    {
+      const std::size_t input = t / half;
+      const std::size_t even = 2 * (t % half);
+      const auto from_even = static_cast<metric_type> (
+          metrics[even] + costs[output_of (even, input)]);
+      const auto from_odd = static_cast<metric_type> (
+          metrics[even + 1] + costs[output_of (even + 1, input)]);
+      next[t] = std::min (from_even, from_odd);
+      if (from_even > from_odd)
+        decisions[t / decision_bits] |= decision_type{ 1 }
+                                        << (t % decision_bits);
+    }
+}
+
+} // namespace details
+
+namespace
+{
+
+using metric_type = details::trellis::metric_type;
+
+///
+/// \brief Path metrics are lowered once the one of state 0 exceeds this.
+/// The others then stay below \f$2^{15}\f$, since they differ by less than
+/// \f$2^{13}\f$ and a step adds less than \f$2^{10}\f$.
+///
+constexpr metric_type renormalization_threshold = 1 << 14;
+
+///
+/// \brief The path metric of the states which the encoder cannot start in.
+/// Any path from state 0 is better, but it is still in range.
+///
+constexpr metric_type unreachable_metric = 1 << 13;
+
+} // namespace
+
+///
+/// Constructors
+///
+
+convolutional_code::convolutional_code (std::size_t constraint_length,
+                                        std::vector<std::uint32_t> polynomials,
+                                        const Eigen::MatrixXi &puncturing)
+    : m_polynomials{ std::move (polynomials) }
+{
+  const std::size_t n = m_polynomials.size ();
+  if (constraint_length < 2 || constraint_length > max_constraint_length)
+    throw convolutional_code_exception{ fmt::format (
+        "Constraint length {} is not between 2 and {}.", constraint_length,
+        max_constraint_length) };
+  if (n < 2 || n > max_outputs)
+    throw convolutional_code_exception{ fmt::format (
+        "A code of rate 1/{} is not supported.", n) };
+
+  std::uint32_t taps = 0;
+  for (const std::uint32_t polynomial : m_polynomials)
+    {
+      if (polynomial == 0 || polynomial >> constraint_length != 0)
+        throw convolutional_code_exception{ fmt::format (
+            "Polynomial {:o} does not fit constraint length {}.", polynomial,
+            constraint_length) };
+      taps |= polynomial;
+    }
+  if ((taps >> (constraint_length - 1)) == 0)
+    throw convolutional_code_exception{ fmt::format (
+        "No polynomial taps the input, so the constraint length is less than "
+        "{}.",
+        constraint_length) };
+
+  std::size_t period = 1;
+  if (puncturing.size () == 0)
+    m_transmitted.assign (n, true);
+  else
+    {
+      if (static_cast<std::size_t> (puncturing.rows ()) != n)
+        throw convolutional_code_exception{ fmt::format (
+            "A puncturing pattern needs {} rows, but it has {}.", n,
+            puncturing.rows ()) };
+      period = puncturing.cols ();
+      for (std::size_t j = 0; j < period; ++j)
+        {
+          if ((puncturing.col (j).array () == 0).all ())
+            throw convolutional_code_exception{ fmt::format (
+                "Column {} of the puncturing pattern has no 1.", j) };
+          for (std::size_t i = 0; i < n; ++i)
+            m_transmitted.push_back (puncturing (i, j) != 0);
+        }
+    }
+
+  m_trellis = details::trellis{ constraint_length, m_polynomials };
+  m_properties = properties_type{
+    .constraint_length = constraint_length,
+    .num_outputs = n,
+    .num_states = m_trellis.num_states (),
+    .puncturing_period = period,
+    .num_transmitted = static_cast<std::size_t> (
+        std::count (m_transmitted.begin (), m_transmitted.end (), true)),
+  };
+}
+
+///
+/// Operations
+///
+
+std::vector<convolutional_code::bit_type>
+convolutional_code::encode (std::span<const bit_type> message,
+                            bool terminate) const
+{
+  const std::size_t n = m_properties.num_outputs;
+  const std::size_t steps
+      = message.size () + (terminate ? m_properties.constraint_length - 1 : 0);
+  std::vector<bit_type> transmitted;
+  transmitted.reserve (steps * m_properties.num_transmitted
+                           / m_properties.puncturing_period
+                       + n);
+
+  std::size_t state = 0;
+  std::size_t slot = 0;
+  for (std::size_t step = 0; step < steps; ++step)
+    {
+      const std::size_t input
+          = step < message.size () ? message[step] & 1u : 0;
+      const std::uint32_t output = m_trellis.output_of (state, input);
+      for (std::size_t i = 0; i < n; ++i, ++slot)
+        if (m_transmitted[slot])
+          transmitted.push_back ((output >> i) & 1u);
+      if (slot == m_transmitted.size ())
+        slot = 0;
+      state = ((input << (m_properties.constraint_length - 1)) | state) >> 1;
+    }
+  return transmitted;
+}
+
+std::vector<convolutional_code::bit_type>
+convolutional_code::decode (std::span<const bit_type> received,
+                            bool terminated) const
+{
+  viterbi_decoder decoder{ *this };
+  std::vector<bit_type> decoded;
+  decoded.reserve (received.size () * rate () + 1);
+  decoder.push_hard (received, decoded);
+  decoder.finish (terminated, decoded);
+  return decoded;
+}
+
+std::vector<convolutional_code::bit_type>
+convolutional_code::decode_soft (std::span<const float> llrs,
+                                 bool terminated) const
+{
+  viterbi_decoder decoder{ *this };
+  std::vector<bit_type> decoded;
+  decoded.reserve (llrs.size () * rate () + 1);
+  decoder.push (llrs, decoded);
+  decoder.finish (terminated, decoded);
+  return decoded;
+}
+
+///
+/// Viterbi decoder
+///
+
+viterbi_decoder::viterbi_decoder (const convolutional_code &code,
+                                  std::size_t traceback_depth,
+                                  float llr_scale)
+    : m_code{ code }, m_depth{ traceback_depth }, m_llr_scale{ llr_scale }
+{
+  const auto &properties = code.properties ();
+  if (m_depth == 0)
+    m_depth = (properties.puncturing_period > 1 ? 10 : 5)
+              * properties.constraint_length;
+  if (m_depth < properties.constraint_length)
+    throw convolutional_code_exception{ fmt::format (
+        "Traceback depth {} is less than the constraint length {}.", m_depth,
+        properties.constraint_length) };
+
+  const auto &trellis = code.trellis ();
+  m_metrics.resize (trellis.num_states ());
+  m_next_metrics.resize (trellis.num_states ());
+  m_symbols.resize (trellis.num_outputs ());
+  m_decisions.resize (2 * m_depth * trellis.decision_words ());
+  reset ();
+}
+
+void
+viterbi_decoder::reset ()
+{
+  std::fill (m_metrics.begin (), m_metrics.end (), unreachable_metric);
+  m_metrics[0] = 0;
+  m_has_symbols = false;
+  m_slot = 0;
+  m_oldest = 0;
+  m_stored = 0;
+  m_emitted = 0;
+
+  std::vector<bit_type> none;
+  advance (none);
+}
+
+void
+viterbi_decoder::push (std::span<const float> llrs,
+                       std::vector<bit_type> &decoded)
+{
+  constexpr float bound = details::trellis::max_symbol;
+  for (const float llr : llrs)
+    {
+      const float scaled = std::clamp (llr * m_llr_scale, -bound, bound);
+      push_symbol (static_cast<metric_type> (std::lround (scaled)), decoded);
+    }
+}
+
+void
+viterbi_decoder::push_hard (std::span<const bit_type> received,
+                            std::vector<bit_type> &decoded)
+{
+  constexpr metric_type bound = details::trellis::max_symbol;
+  for (const bit_type bit : received)
+    push_symbol (bit ? -bound : bound, decoded);
+}
+
+void
+viterbi_decoder::finish (bool terminated, std::vector<bit_type> &decoded)
+{
+  // The rest of an incomplete step is punctured.
+  if (m_has_symbols)
+    {
+      const std::size_t n = m_symbols.size ();
+      std::fill (m_symbols.begin () + m_slot % n, m_symbols.end (), 0);
+      step (decoded);
+    }
+
+  const std::size_t best
+      = terminated ? 0
+                   : std::min_element (m_metrics.begin (), m_metrics.end ())
+                         - m_metrics.begin ();
+  trace_back (best, m_stored, decoded);
+  if (terminated)
+    decoded.resize (
+        decoded.size ()
+        - std::min (m_emitted,
+                    m_code.properties ().constraint_length - 1));
+  reset ();
+}
+
+void
+viterbi_decoder::push_symbol (metric_type symbol,
+                              std::vector<bit_type> &decoded)
+{
+  m_symbols[m_slot % m_symbols.size ()] = symbol;
+  m_has_symbols = true;
+  ++m_slot;
+  advance (decoded);
+}
+
+void
+viterbi_decoder::advance (std::vector<bit_type> &decoded)
+{
+  const std::size_t n = m_symbols.size ();
+  const std::size_t slots = m_code.properties ().puncturing_period * n;
+  for (;;)
+    {
+      if (m_slot % n == 0 && m_has_symbols)
+        {
+          step (decoded);
+          if (m_slot == slots)
+            m_slot = 0;
+        }
+      if (m_code.is_transmitted (m_slot))
+        return;
+      m_symbols[m_slot % n] = 0;
+      ++m_slot;
+    }
+}
+
+void
+viterbi_decoder::step (std::vector<bit_type> &decoded)
+{
+  const std::size_t words = m_code.trellis ().decision_words ();
+  const std::size_t capacity = m_decisions.size () / words;
+  const std::size_t newest = (m_oldest + m_stored) % capacity;
+  m_code.trellis ().add_compare_select (
+      m_symbols, m_metrics, m_next_metrics,
+      std::span{ m_decisions }.subspan (newest * words, words));
+  std::swap (m_metrics, m_next_metrics);
+  m_has_symbols = false;
+
+  if (m_metrics[0] > renormalization_threshold)
+    {
+      const metric_type least
+          = *std::min_element (m_metrics.begin (), m_metrics.end ());
+      for (auto &metric : m_metrics)
+        metric -= least;
+    }
+
+  if (++m_stored == capacity)
+    {
+      const std::size_t best
+          = std::min_element (m_metrics.begin (), m_metrics.end ())
+            - m_metrics.begin ();
+      trace_back (best, m_depth, decoded);
+    }
+}
+
+void
+viterbi_decoder::trace_back (std::size_t state, std::size_t count,
+                             std::vector<bit_type> &decoded)
+{
+  const auto &trellis = m_code.trellis ();
+  const std::size_t words = trellis.decision_words ();
+  const std::size_t capacity = m_decisions.size () / words;
+  const std::size_t half = trellis.num_states () / 2;
+  const std::size_t input_shift = trellis.constraint_length () - 2;
+
+  const std::size_t first = decoded.size ();
+  decoded.resize (first + count);
+  for (std::size_t s = m_stored; s-- > 0;)
+    {
+      if (s < count)
+        decoded[first + s] = state >> input_shift;
+      const decision_type *decisions
+          = &m_decisions[(m_oldest + s) % capacity * words];
+      const std::size_t odd
+          = (decisions[state / details::trellis::decision_bits]
+             >> (state % details::trellis::decision_bits))
+            & 1u;
+      state = 2 * (state % half) + odd;
+    }
+
+  m_oldest = (m_oldest + count) % capacity;
+  m_stored -= count;
+  m_emitted += count;
+}
+
+} // namespace patrick
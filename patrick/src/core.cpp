@@ -1,19 +1,159 @@
+#include <bit>
 #include <cassert>
-
-#include <fmt/os.h>
+#include <limits>
+#include <numeric>
 
 #include <patrick/core.h>
+#include <patrick/trace.h>
 
 namespace patrick
 {
 
-template <typename... T>
-inline void
-unimplemented ([[maybe_unused]] T &&...args)
+namespace
+{
+
+template <typename Tag>
+[[nodiscard]] std::size_t
+bytes_of (const details::word<Tag> &w) noexcept
+{
+  return sizeof (w) + w.vec.size () * sizeof (int);
+}
+
+template <typename Tag, typename Allocator>
+[[nodiscard]] std::size_t
+bytes_of (const std::vector<details::word<Tag>, Allocator> &words) noexcept
+{
+  std::size_t bytes = 0;
+  for (const auto &w : words)
+    bytes += bytes_of (w);
+  return bytes;
+}
+
+[[nodiscard]] std::size_t
+bytes_of (const details::bitmatrix &m) noexcept
+{
+  return sizeof (m)
+         + m.rows () * m.stride () * sizeof (details::bitmatrix::block_type);
+}
+
+[[nodiscard]] std::size_t
+bytes_of (const Eigen::MatrixXi &m) noexcept
+{
+  return sizeof (m) + m.size () * sizeof (int);
+}
+
+[[nodiscard]] std::size_t
+bytes_of (const linearcode::slepian_table_type &slepian_table) noexcept
+{
+  std::size_t bytes = 0;
+  for (const auto &row : slepian_table)
+    bytes += bytes_of (row.leader) + bytes_of (row.columns);
+  return bytes;
+}
+
+///
+/// \brief The nodes of a hash table are counted with their next pointer
+/// and cached hash, besides the buckets.
+///
+template <typename Map>
+[[nodiscard]] std::size_t
+overhead_of (const Map &map) noexcept
+{
+  return map.bucket_count () * sizeof (void *)
+         + map.size () * (sizeof (void *) + sizeof (std::size_t));
+}
+
+[[nodiscard]] std::size_t
+bytes_of (const linearcode::syndrome_table_type &table) noexcept
+{
+  std::size_t bytes = overhead_of (table);
+  for (const auto &[syndr, leader] : table)
+    bytes += bytes_of (syndr) + bytes_of (leader);
+  return bytes;
+}
+
+///
+/// \return \f$2^{bits}\f$ times \a bytes, or the largest size if that does
+/// not fit.
+///
+[[nodiscard]] std::size_t
+times_power_of_two (std::size_t bytes, std::size_t bits) noexcept
+{
+  constexpr std::size_t max = std::numeric_limits<std::size_t>::max ();
+  if (bits >= std::numeric_limits<std::size_t>::digits || bytes > max >> bits)
+    return max;
+  return bytes << bits;
+}
+
+[[nodiscard]] std::size_t
+saturated_sum (std::size_t a, std::size_t b) noexcept
+{
+  return a > std::numeric_limits<std::size_t>::max () - b
+             ? std::numeric_limits<std::size_t>::max ()
+             : a + b;
+}
+
+///
+/// \brief Copies \a table, if there is one, into \a resource. A plain copy
+/// of a container of the tables would be allocated from the default
+/// resource instead.
+///
+template <typename Table>
+[[nodiscard]] std::optional<Table>
+copy_of (const std::optional<Table> &table,
+         std::pmr::memory_resource *resource)
+{
+  if (!table)
+    return std::nullopt;
+  return std::optional<Table>{ std::in_place, *table, resource };
+}
+
+[[nodiscard]] std::optional<linearcode::slepian_table_type>
+copy_of (const std::optional<linearcode::slepian_table_type> &table,
+         std::pmr::memory_resource *resource)
 {
-  assert (0);
+  if (!table)
+    return std::nullopt;
+  std::optional<linearcode::slepian_table_type> copy{ std::in_place,
+                                                       resource };
+  copy->reserve (table->size ());
+  for (const auto &row : *table)
+    copy->push_back (
+        { .leader = row.leader,
+          .columns = linearcode::codewords_type{ row.columns, resource } });
+  return copy;
 }
 
+///
+/// \brief Moves on to the next error pattern of the same weight, in the order
+/// of the numbers which the patterns spell with position 0 as their most
+/// significant bit. The coset leaders are the first patterns of the least
+/// weight in their cosets in this order.
+/// \param offsets The positions of the pattern counted back from the last
+/// one, in increasing order. The first pattern of a weight has the offsets
+/// \f$0, 1, \dots\f$.
+/// \return Whether there was a next pattern.
+///
+[[nodiscard]] bool
+next_error_pattern (std::vector<std::size_t> &offsets,
+                    std::size_t n) noexcept
+{
+  for (std::size_t i = 0; i < offsets.size (); ++i)
+    {
+      const std::size_t bound
+          = i + 1 < offsets.size () ? offsets[i + 1] : n;
+      if (offsets[i] + 1 < bound)
+        {
+          ++offsets[i];
+          std::iota (offsets.begin (), offsets.begin () + i, 0);
+          return true;
+        }
+    }
+  return false;
+}
+
+} // namespace
+
 ///
 /// Constructors
 ///
@@ -23,32 +163,227 @@ unimplemented ([[maybe_unused]] T &&...args)
 [[nodiscard]] [[maybe_unused]] linearcode
 linearcode::from_parity_equations (const Eigen::MatrixXi &parity_equations)
 {
-  return linearcode{ parity_equations };
+  return from_packed_parity_equations (
+      details::bitmatrix::from_eigen (parity_equations), family_type{},
+      std::nullopt);
 }
 
 [[nodiscard]] [[maybe_unused]] linearcode
 linearcode::from_generator (const Eigen::MatrixXi &generator_matrix)
 {
-  // TODO: Put the generator matrix into standard form.
-  // For now, assume that is done already.
-  return linearcode{ generator_matrix };
+  return from_packed_generator (
+      details::bitmatrix::from_eigen (generator_matrix), family_type{},
+      std::nullopt);
 }
 
 [[nodiscard]] [[maybe_unused]] linearcode
 linearcode::from_dual (const linearcode &code)
 {
-  unimplemented (code);
+  const std::size_t k = code.m_packed_generator.rows ();
+  if (k == code.m_packed_generator.cols ())
+    throw linearcode_exception{
+      "Cannot instantiate the dual of a code which is the whole space."
+    };
+
+  // The parity matrix is the identity at the redundancy positions of the
+  // code, which therefore become the information positions of the dual.
+  std::vector<std::size_t> permutation (code.m_permutation.cbegin (),
+                                        code.m_permutation.cend ());
+  std::rotate (permutation.begin (), permutation.begin () + k,
+               permutation.end ());
+  return linearcode{ code.packed_parity_matrix (), std::move (permutation),
+                     family_type{}, std::nullopt };
+}
+
+[[nodiscard]] linearcode
+linearcode::from_packed_generator (
+    details::bitmatrix generator, family_type family,
+    std::optional<std::size_t> known_min_distance)
+{
+  const std::vector<std::size_t> pivots
+      = details::reduce_to_echelon_form (generator);
+
+  if (pivots.empty ())
+    throw linearcode_exception (
+        "Cannot instantiate a linearcode from the empty matrix.");
+  if (pivots.size () != generator.rows ())
+    throw linearcode_exception{ fmt::format (
+        "Cannot instantiate a linearcode from a generator matrix of rank {} "
+        "with {} rows.",
+        pivots.size (), generator.rows ()) };
+
+  // The pivot columns of the reduced generator form an identity matrix, so
+  // moving them to the front brings it into standard form (I | A).
+  std::vector<std::size_t> permutation;
+  permutation.reserve (generator.cols ());
+  std::vector<bool> is_pivot (generator.cols (), false);
+  for (const std::size_t p : pivots)
+    {
+      permutation.push_back (p);
+      is_pivot[p] = true;
+    }
+  for (std::size_t c = 0; c < generator.cols (); ++c)
+    if (!is_pivot[c])
+      permutation.push_back (c);
+
+  return linearcode{ std::move (generator), std::move (permutation), family,
+                     known_min_distance };
+}
+
+[[nodiscard]] linearcode
+linearcode::from_packed_parity_equations (
+    details::bitmatrix parity, family_type family,
+    std::optional<std::size_t> known_min_distance)
+{
+  const std::vector<std::size_t> pivots
+      = details::reduce_to_echelon_form (parity);
+  parity.resize_rows (pivots.size ());
+
+  const std::size_t n = parity.cols ();
+  if (pivots.size () == n)
+    throw linearcode_exception{ fmt::format (
+        "Cannot instantiate a linearcode from parity equations of rank {}, "
+        "whose only solution is the null vector.",
+        n) };
+
+  // The reduced equations are the identity at their pivot columns, so the
+  // free columns give a basis of the solutions directly: every free column
+  // determines the pivot columns which are set along with it.
+  std::vector<std::size_t> columns (pivots.cbegin (), pivots.cend ());
+  std::vector<bool> is_pivot (n, false);
+  for (const std::size_t p : pivots)
+    is_pivot[p] = true;
+  for (std::size_t c = 0; c < n; ++c)
+    if (!is_pivot[c])
+      columns.push_back (c);
+
+  details::bitmatrix generator
+      = details::orthogonal_complement (parity, columns);
+  std::rotate (columns.begin (), columns.begin () + pivots.size (),
+               columns.end ());
+  return linearcode{ std::move (generator), std::move (columns), family,
+                     known_min_distance };
 }
 
 /// Actual ctor.
 
-linearcode::linearcode (const Eigen::MatrixXi &generator_matrix)
-    : m_generator{ generator_matrix }
+linearcode::linearcode (details::bitmatrix generator,
+                        std::vector<std::size_t> permutation,
+                        family_type family,
+                        std::optional<std::size_t> known_min_distance)
+    : m_packed_generator{ std::move (generator) },
+      m_permutation{ std::move (permutation) }, m_family{ family }
 {
-  if (m_generator.isZero ())
+  if (m_packed_generator.is_zero ())
     throw linearcode_exception (
         "Cannot instantiate a linearcode from the empty matrix.");
-  evaluate_properties_of ();
+  evaluate_properties_of (known_min_distance);
+  if (m_family.kind == code_family::BCH)
+    m_field.emplace (m_family.m);
+}
+
+linearcode::linearcode (const linearcode &other,
+                        [[maybe_unused]] const details::cache_use &use)
+    : m_packed_generator{ other.m_packed_generator },
+      m_permutation{ other.m_permutation },
+      m_properties{ other.m_properties }, m_family{ other.m_family },
+      m_family_code{ other.m_family_code },
+      m_family_positions{ other.m_family_positions },
+      m_table_resource{ other.m_table_resource },
+      m_lazy_codewords{ copy_of (other.m_lazy_codewords, m_table_resource) },
+      m_lazy_generator_matrix{ other.m_lazy_generator_matrix },
+      m_lazy_parity_matrix{ other.m_lazy_parity_matrix },
+      m_lazy_packed_parity_matrix{ other.m_lazy_packed_parity_matrix },
+      m_lazy_slepian_table{ copy_of (other.m_lazy_slepian_table,
+                                     m_table_resource) },
+      m_lazy_syndrome_table{ copy_of (other.m_lazy_syndrome_table,
+                                      m_table_resource) },
+      m_lazy_packed_syndrome_table{ copy_of (
+          other.m_lazy_packed_syndrome_table, m_table_resource) },
+      m_field{ other.m_field },
+      m_erasure_solutions{ other.m_erasure_solutions },
+      m_stats{ other.m_stats }
+{
+  mark_present_built ();
+  using enum lazy_table;
+  for (const lazy_table table : { Codewords, SlepianTable, SyndromeTable,
+                                  PackedSyndromeTable, ErasureSolution })
+    account_for (table);
+}
+
+linearcode::linearcode (linearcode &&other,
+                        [[maybe_unused]] const details::cache_use &use)
+    : m_packed_generator{ other.m_packed_generator },
+      m_permutation{ other.m_permutation },
+      m_properties{ std::move (other.m_properties) },
+      m_family{ other.m_family },
+      m_family_code{ std::move (other.m_family_code) },
+      m_family_positions{ std::move (other.m_family_positions) },
+      m_table_resource{ other.m_table_resource },
+      m_lazy_codewords{ std::exchange (other.m_lazy_codewords, {}) },
+      m_lazy_generator_matrix{ std::exchange (other.m_lazy_generator_matrix,
+                                              {}) },
+      m_lazy_parity_matrix{ std::exchange (other.m_lazy_parity_matrix, {}) },
+      m_lazy_packed_parity_matrix{ std::exchange (
+          other.m_lazy_packed_parity_matrix, {}) },
+      m_lazy_slepian_table{ std::exchange (other.m_lazy_slepian_table, {}) },
+      m_lazy_syndrome_table{ std::exchange (other.m_lazy_syndrome_table, {}) },
+      m_lazy_packed_syndrome_table{ std::exchange (
+          other.m_lazy_packed_syndrome_table, {}) },
+      m_field{ std::move (other.m_field) },
+      m_erasure_solutions{ std::exchange (other.m_erasure_solutions, {}) },
+      m_stats{ other.m_stats }
+{
+  mark_present_built ();
+  other.mark_present_built ();
+  m_cache.take_over (other.m_cache);
+}
+
+void
+linearcode::mark_present_built () noexcept
+{
+  auto mark = [&] (lazy_table table, bool present) {
+    m_built[std::size_t (table)].store (present, std::memory_order_release);
+  };
+  mark (lazy_table::Codewords, m_lazy_codewords.has_value ());
+  mark (lazy_table::ParityMatrix, m_lazy_packed_parity_matrix.has_value ());
+  mark (lazy_table::SlepianTable, m_lazy_slepian_table.has_value ());
+  mark (lazy_table::SyndromeTable, m_lazy_syndrome_table.has_value ());
+  mark (lazy_table::PackedSyndromeTable,
+        m_lazy_packed_syndrome_table.has_value ());
+  m_generator_matrix_built.store (m_lazy_generator_matrix.has_value (),
+                                  std::memory_order_release);
+}
+
+void
+linearcode::build (lazy_table table) const
+{
+  std::scoped_lock lock{ m_build_mutex };
+  // Another thread may have built it while this one waited.
+  if (m_built[std::size_t (table)].load (std::memory_order_relaxed))
+    return;
+  switch (table)
+    {
+    case lazy_table::Codewords:
+      prepare_codewords ();
+      break;
+    case lazy_table::ParityMatrix:
+      prepare_parity_matrix ();
+      break;
+    case lazy_table::SlepianTable:
+      prepare_slepian_table ();
+      break;
+    case lazy_table::SyndromeTable:
+      prepare_syndrome_table ();
+      break;
+    case lazy_table::PackedSyndromeTable:
+      prepare_packed_syndrome_table ();
+      break;
+    default:
+      // The erasure solutions are found one by one by erasure_solution.
+      return;
+    }
+  mark_built (table);
 }
 
 ///
@@ -58,16 +393,21 @@ linearcode::linearcode (const Eigen::MatrixXi &generator_matrix)
 [[nodiscard]] syndrome
 linearcode::syndrome_of (const codeword &cword) const
 {
-  if (cword.vec.cols () != m_generator.cols ())
-    throw linearcode_exception{ fmt::format (
-        "Codeword '{}' has incompatible dimensions to be part "
-        "of a code, whose generator matrix has {} columns.",
-        cword, m_generator.cols ()) };
-  const auto &H = parity_matrix ();
-  const auto product
-      = cword.vec.operator* (H.transpose ()).unaryExpr ([&] (const int x) {
-          return x % 2;
-        });
+  ensure_word_size (cword);
+  using block_type = details::bitmatrix::block_type;
+  const details::bitmatrix &H = packed_parity_matrix ();
+  std::vector<block_type> packed (H.stride ());
+  details::pack (cword, packed.data ());
+
+  Eigen::RowVectorXi product (H.rows ());
+  for (std::size_t r = 0; r < H.rows (); ++r)
+    {
+      const block_type *h = H.row (r);
+      int parity = 0;
+      for (std::size_t b = 0; b < H.stride (); ++b)
+        parity ^= std::popcount (h[b] & packed[b]);
+      product (r) = parity & 1;
+    }
   return syndrome{ std::move (product) };
 }
 
@@ -94,24 +434,86 @@ linearcode::contains (const codeword &cword) const
 ///
 
 void
-linearcode::evaluate_properties_of ()
+linearcode::ensure_word_size (const codeword &cword) const
 {
-  prepare_codewords ();
+  if (static_cast<std::size_t> (cword.vec.cols ())
+      != m_packed_generator.cols ())
+    throw linearcode_exception{ fmt::format (
+        "Codeword '{}' has incompatible dimensions to be part "
+        "of a code, whose generator matrix has {} columns.",
+        cword, m_packed_generator.cols ()) };
+}
 
-  // Safety: prepare_codeword_cache() populates this optional.
-  assert (m_lazy_codewords.has_value ());
+void
+linearcode::evaluate_properties_of (
+    std::optional<std::size_t> known_min_distance)
+{
+  const std::size_t n = m_packed_generator.cols ();
+  const std::size_t k = m_packed_generator.rows ();
 
-  auto it = std::find_if (std::cbegin (*m_lazy_codewords),
-                          std::cend (*m_lazy_codewords),
-                          [&] (const auto &c) { return c.weight () > 0; });
+  std::size_t min_distance = 0;
+  if (known_min_distance)
+    {
+      // Safety: Only the named ctors of code families know the distance.
+      assert (*known_min_distance > 0 && *known_min_distance <= n);
+      min_distance = *known_min_distance;
+    }
+  else if (std::min (k, n - k) > max_enumerated_dimension)
+    throw linearcode_exception{ fmt::format (
+        "Cannot evaluate the minimum distance of a [{}, {}] code, because "
+        "both it and its dual have more than 2^{} codewords.",
+        n, k, max_enumerated_dimension) };
+  else if (k <= n - k)
+    {
+      const auto distribution
+          = details::weight_distribution (m_packed_generator);
+      const auto it = std::find_if (distribution.cbegin () + 1,
+                                    distribution.cend (),
+                                    [] (const auto a) { return a > 0; });
+      min_distance = std::distance (distribution.cbegin (), it);
+    }
+  else
+    {
+      // MacWilliams identity: the weight distribution of the code is
+      // A_j = 2^{-(n-k)} sum_i B_i K_j(i), where B is the distribution of the
+      // dual and K_j is the j-th Krawtchouk polynomial. Only the sign of A_j
+      // matters here, so the scaling is left out.
+      const auto dual_distribution
+          = details::weight_distribution (packed_parity_matrix ());
+      auto binomial = [] (std::size_t a, std::size_t b) -> __int128 {
+        if (b > a)
+          return 0;
+        __int128 result = 1;
+        for (std::size_t i = 1; i <= b; ++i)
+          result = result * (a - b + i) / i;
+        return result;
+      };
+      auto krawtchouk = [&] (std::size_t j, std::size_t i) {
+        __int128 result = 0;
+        for (std::size_t s = 0; s <= j; ++s)
+          {
+            const __int128 term = binomial (i, s) * binomial (n - i, j - s);
+            result += (s % 2) ? -term : term;
+          }
+        return result;
+      };
+      for (std::size_t j = 1; j <= n && min_distance == 0; ++j)
+        {
+          __int128 a_j = 0;
+          for (std::size_t i = 0; i <= n; ++i)
+            if (dual_distribution[i] > 0)
+              a_j += dual_distribution[i] * krawtchouk (j, i);
+          if (a_j > 0)
+            min_distance = j;
+        }
+    }
 
-  if (it == std::cend (*m_lazy_codewords))
+  if (min_distance == 0 || min_distance > n)
     throw linearcode_exception{ "Cannot find min_distance parameter." };
 
-  auto min_distance = it->weight ();
   m_properties.min_distance = min_distance;
-  m_properties.word_size = static_cast<std::size_t> (m_generator.cols ());
-  m_properties.basis_size = static_cast<std::size_t> (m_generator.rows ());
+  m_properties.word_size = n;
+  m_properties.basis_size = k;
   m_properties.max_errors_detect = min_distance - 1;
   m_properties.max_errors_correct = (min_distance - 1) / 2;
 }
@@ -119,32 +521,64 @@ linearcode::evaluate_properties_of ()
 void
 linearcode::prepare_codewords () const
 {
+  details::trace_span span{ "codewords", "table" };
+  const auto start = m_stats.now ();
   // Use the rows of the generator matrix, because properties may still not be
   // initialized.
-  const std::size_t basis_size = m_generator.rows ();
-  const std::size_t total_codeword_count = 1 << basis_size;
-  std::vector<codeword> codewords;
+  const std::size_t basis_size = m_packed_generator.rows ();
+  span.arg ("k", basis_size);
+  const std::size_t total_codeword_count = std::size_t{ 1 } << basis_size;
+  codewords_type codewords{ m_table_resource };
   codewords.reserve (total_codeword_count);
   for (std::size_t iword_as_num = 0; iword_as_num < total_codeword_count;
        ++iword_as_num)
-    codewords.push_back (encode (infoword{ iword_as_num, basis_size }));
+    codewords.push_back (
+        encode_uncounted (infoword{ iword_as_num, basis_size }));
   std::sort (std::begin (codewords), std::end (codewords),
              [] (const auto &c1, const auto &c2) {
                return c1.weight () < c2.weight ();
              });
-  m_lazy_codewords = codewords;
+  m_lazy_codewords.emplace (std::move (codewords));
+  m_stats.count_build (lazy_table::Codewords, start,
+                       [&] { return bytes_of (*m_lazy_codewords); });
+  account_for (lazy_table::Codewords);
+}
+
+void
+linearcode::prepare_generator_matrix () const
+{
+  std::scoped_lock lock{ m_build_mutex };
+  // Another thread may have built it while this one waited.
+  if (m_lazy_generator_matrix)
+    return;
+  m_lazy_generator_matrix.emplace (m_packed_generator.to_eigen ());
+  m_generator_matrix_built.store (true, std::memory_order_release);
 }
 
 void
 linearcode::prepare_parity_matrix () const
 {
-  const std::size_t k = m_generator.rows ();
-  const std::size_t n = m_generator.cols ();
-  const std::size_t t = n - k;
-  Eigen::MatrixXi _parity_matrix (t, k + t);
-  _parity_matrix.rightCols (t) = Eigen::MatrixXi::Identity (t, t);
-  _parity_matrix.leftCols (k) = m_generator.rightCols (t).transpose ();
-  m_lazy_parity_matrix.emplace (std::move (_parity_matrix));
+  details::trace_span span{ "parity_matrix", "table" };
+  const auto start = m_stats.now ();
+  // In standard form G = (I | A) and H = (A^T | I).
+  auto _parity_matrix
+      = details::orthogonal_complement (m_packed_generator, m_permutation);
+  m_lazy_parity_matrix.emplace (_parity_matrix.to_eigen ());
+  m_lazy_packed_parity_matrix.emplace (std::move (_parity_matrix));
+  m_stats.count_build (lazy_table::ParityMatrix, start, [&] {
+    return bytes_of (*m_lazy_parity_matrix)
+           + bytes_of (*m_lazy_packed_parity_matrix);
+  });
+}
+
+[[nodiscard]] infoword
+linearcode::information_of (const codeword &cword) const
+{
+  const std::size_t k = m_packed_generator.rows ();
+  Eigen::RowVectorXi vec (k);
+  for (std::size_t i = 0; i < k; ++i)
+    vec (i) = cword.vec (m_permutation[i]);
+  return infoword{ std::move (vec) };
 }
 
 ///
@@ -153,20 +587,39 @@ linearcode::prepare_parity_matrix () const
 
 [[nodiscard]] [[maybe_unused]] codeword
 linearcode::encode (const infoword &iword) const
+{
+  codeword cword = encode_uncounted (iword);
+  m_stats.count_encodes (1);
+  return cword;
+}
+
+[[nodiscard]] codeword
+linearcode::encode_uncounted (const infoword &iword) const
 {
   // Safety: This invariant is established during instantiation.
-  assert (!m_generator.isZero ());
+  assert (!m_packed_generator.is_zero ());
 
-  if (iword.vec.cols () != m_generator.rows ())
+  if (static_cast<std::size_t> (iword.vec.cols ())
+      != m_packed_generator.rows ())
     throw linearcode_exception{ fmt::format (
         "Trying to encode infoword '{}' which has size n={}, whereas the code "
         "expects n={}.",
-        iword, iword.vec.cols (), m_generator.rows ()) };
-  const auto product
-      = iword.vec.operator* (m_generator).unaryExpr ([&] (const int x) {
-          return x % 2;
-        });
-  return codeword{ std::move (product) };
+        iword, iword.vec.cols (), m_packed_generator.rows ()) };
+
+  // The codeword is the sum of the generator rows selected by the infoword.
+  using block_type = details::bitmatrix::block_type;
+  const std::size_t stride = m_packed_generator.stride ();
+  std::vector<block_type> packed (stride, 0);
+  for (long i = 0; i < iword.vec.cols (); ++i)
+    {
+      if (!(iword.vec (i) & 1))
+        continue;
+      const block_type *row = m_packed_generator.row (i);
+      for (std::size_t b = 0; b < stride; ++b)
+        packed[b] ^= row[b];
+    }
+  return details::unpack<details::codeword_tag> (packed.data (),
+                                                 m_packed_generator.cols ());
 }
 
 ///
@@ -193,21 +646,24 @@ linearcode::encode (const infoword &iword) const
 void
 linearcode::prepare_slepian_table () const
 {
+  details::trace_span span{ "slepian_table", "table" };
+  const auto start = m_stats.now ();
   const std::size_t n = properties ().word_size;
   const std::size_t k = properties ().basis_size;
-  const std::size_t num_rows = 1 << (n - k);
-  const std::size_t num_words = 1 << n;
+  span.arg ("n", n);
+  span.arg ("k", k);
+  const std::size_t num_rows = std::size_t{ 1 } << (n - k);
+  const std::size_t num_words = std::size_t{ 1 } << n;
 
-  std::vector<coset> slepian_table;
+  slepian_table_type slepian_table{ m_table_resource };
   slepian_table.reserve (num_rows);
 
-  if (!m_lazy_codewords.has_value ())
-    prepare_codewords ();
+  ensure_built (lazy_table::Codewords);
 
   // The first row (coset) of the Slepian table contains the codewords
   // themselves.
   slepian_table.emplace_back ([&] () {
-    std::vector<codeword> non_null_codewords;
+    codewords_type non_null_codewords{ m_table_resource };
     non_null_codewords.resize (m_lazy_codewords->size () - 1);
     std::copy (m_lazy_codewords->cbegin () + 1, m_lazy_codewords->cend (),
                non_null_codewords.begin ());
@@ -248,7 +704,7 @@ linearcode::prepare_slepian_table () const
       codeword leader = next_leader ();
       used[leader.to_ullong ()] = true;
 
-      std::vector<codeword> words;
+      codewords_type words{ m_table_resource };
       std::transform (table_header_words.cbegin (), table_header_words.cend (),
                       std::back_inserter (words), [&] (const codeword &c) {
                         const codeword c_ = c + leader;
@@ -260,22 +716,27 @@ linearcode::prepare_slepian_table () const
     }
 
   m_lazy_slepian_table.emplace (std::move (slepian_table));
+  m_stats.count_build (lazy_table::SlepianTable, start,
+                       [&] { return bytes_of (*m_lazy_slepian_table); });
+  account_for (lazy_table::SlepianTable);
 }
 
 [[nodiscard]] linearcode::decoding_result
 linearcode::decode_with_slepian (const codeword &cword)
 {
-  if (!m_lazy_slepian_table)
-    prepare_slepian_table ();
+  if (!is_built (lazy_table::SlepianTable)
+      && !affords (lazy_table::SlepianTable))
+    return decode_with_syndromes (cword);
+  ensure_built (lazy_table::SlepianTable);
 
   const std::size_t num_rows
-      = 1 << (properties ().word_size - properties ().basis_size);
+      = std::size_t{ 1 }
+        << (properties ().word_size - properties ().basis_size);
   /// Safety: That's a property of the Slepian table.
   assert (m_lazy_slepian_table->size () == num_rows);
 
   const codeword &topleft = m_lazy_slepian_table->front ().leader;
-  const std::vector<codeword> &codewords
-      = m_lazy_slepian_table->front ().columns;
+  const codewords_type &codewords = m_lazy_slepian_table->front ().columns;
 
   codeword corrected_cword;
   codeword correction;
@@ -315,67 +776,62 @@ linearcode::decode_with_slepian (const codeword &cword)
   /// based on the fact that the encoding is systematic, meaning that the
   /// positions of the codeword which contain information are the same as kept
   /// the same as in the infoword. Therefore, we have to _cut_ the codeword and
-  /// get only the K rightmost of them. The rightmost are used because of the
-  /// requirement that we made on the generator matrix, that it is in _standard
-  /// form_ G = (E|A).
-  const std::size_t k = properties ().basis_size;
-  return decoding_result{ .iword
-                          = infoword{ corrected_cword.vec.leftCols (k) },
+  /// get only the K information positions of it. Those are the pivot columns
+  /// of the generator, which make up the identity part of its _standard form_
+  /// G = (E|A).
+  return decoding_result{ .iword = information_of (corrected_cword),
                           .error = correction };
 }
 
 void
 linearcode::prepare_syndrome_table () const
 {
+  details::trace_span span{ "syndrome_table", "table" };
+  const auto start = m_stats.now ();
   const std::size_t n = properties ().word_size;
   const std::size_t k = properties ().basis_size;
-  const std::size_t num_rows = 1 << (n - k);
-  const std::size_t num_words = 1 << n;
-
-  std::vector<bool> used (num_words, false);
-
-  auto out = fmt::output_file ("debug-syndromes-leader.log");
-  auto next_leader = [&] () {
-    std::size_t min_weight = n;
-    codeword min_c{ 0, n };
-    for (auto i = 0ull; i < num_words; ++i)
-      {
-        if (used[i])
-          continue;
-        codeword c{ i, n };
-        if (auto c_weight = c.weight (); c_weight < min_weight)
-          {
-            min_weight = c_weight;
-            min_c = c;
-          }
-      }
-
-    out.print ("next_leader -> {}\n", min_c);
-    return min_c;
-  };
+  span.arg ("n", n);
+  span.arg ("k", k);
+  const std::size_t num_rows = std::size_t{ 1 } << (n - k);
 
-  syndrome_table_type table;
+  syndrome_table_type table{ m_table_resource };
   table.reserve (num_rows);
 
-  while (table.size () < num_rows)
+  // The first pattern of a coset by increasing weight is its leader, so the
+  // search stops at the heaviest leader rather than going over all 2^n
+  // words.
+  for (std::size_t w = 0; w <= n && table.size () < num_rows; ++w)
     {
-      auto leader = next_leader ();
-      used[leader.to_ullong ()] = true;
-      const auto syndr = syndrome_of (leader);
-      table.try_emplace (syndr, leader);
+      std::vector<std::size_t> offsets (w);
+      std::iota (offsets.begin (), offsets.end (), 0);
+      do
+        {
+          codeword leader{ Eigen::RowVectorXi::Zero (n) };
+          for (const std::size_t o : offsets)
+            leader.vec (n - 1 - o) = 1;
+          const auto syndr = syndrome_of (leader);
+          table.try_emplace (syndr, std::move (leader));
+        }
+      while (table.size () < num_rows && next_error_pattern (offsets, n));
     }
 
   m_lazy_syndrome_table.emplace (std::move (table));
+  m_stats.count_build (lazy_table::SyndromeTable, start,
+                       [&] { return bytes_of (*m_lazy_syndrome_table); });
+  account_for (lazy_table::SyndromeTable);
 }
 
 [[nodiscard]] linearcode::decoding_result
 linearcode::decode_with_syndromes (const codeword &cword)
 {
-  if (!m_lazy_syndrome_table)
-    prepare_syndrome_table ();
+  if (!is_built (lazy_table::SyndromeTable)
+      && !affords (lazy_table::SyndromeTable))
+    return decode_by_search (cword);
+  ensure_built (lazy_table::SyndromeTable);
 
   const std::size_t num_rows
-      = 1 << (properties ().word_size - properties ().basis_size);
+      = std::size_t{ 1 }
+        << (properties ().word_size - properties ().basis_size);
   /// Safety: That's a property of the syndrome table.
   assert (m_lazy_syndrome_table->size () == num_rows);
   const auto &syndrome_table = *m_lazy_syndrome_table;
@@ -384,10 +840,190 @@ linearcode::decode_with_syndromes (const codeword &cword)
   const codeword error = syndrome_table.at (s);
   const codeword corrected_cword = cword + error;
 
-  const std::size_t k = properties ().basis_size;
-  return decoding_result{ .iword
-                          = infoword{ corrected_cword.vec.leftCols (k) },
+  return decoding_result{ .iword = information_of (corrected_cword),
                           .error = error };
 }
 
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_by_search (const codeword &cword) const
+{
+  using block_type = details::bitmatrix::block_type;
+  const syndrome s = syndrome_of (cword);
+  const details::bitmatrix &H = packed_parity_matrix ();
+  const std::size_t n = H.cols ();
+  const std::size_t r = H.rows ();
+  const std::size_t stride = details::bitmatrix::blocks_for (r);
+
+  // The columns of the parity matrix are the syndromes of single errors.
+  std::vector<block_type> columns (n * stride, 0);
+  std::vector<block_type> target (stride, 0);
+  for (std::size_t i = 0; i < r; ++i)
+    {
+      const block_type bit = block_type{ 1 } << (i % 64);
+      for (std::size_t j = 0; j < n; ++j)
+        if (H.get (i, j))
+          columns[j * stride + i / 64] |= bit;
+      if (s.vec (i) & 1)
+        target[i / 64] |= bit;
+    }
+
+  auto decoded = [&] (std::span<const std::size_t> support) {
+    codeword error{ Eigen::RowVectorXi::Zero (n) };
+    for (const std::size_t p : support)
+      error.vec (p) = 1;
+    return decoding_result{ .iword = information_of (cword + error),
+                            .error = std::move (error) };
+  };
+
+  // The parity matrix has full rank, so every coset has a leader of weight
+  // at most n - k, which is the one the syndrome table holds.
+  std::vector<block_type> sum (stride);
+  std::vector<std::size_t> support;
+  for (std::size_t w = 0; w <= std::min (r, n); ++w)
+    {
+      std::vector<std::size_t> offsets (w);
+      std::iota (offsets.begin (), offsets.end (), 0);
+      do
+        {
+          std::ranges::fill (sum, 0);
+          for (const std::size_t o : offsets)
+            for (std::size_t b = 0; b < stride; ++b)
+              sum[b] ^= columns[(n - 1 - o) * stride + b];
+          if (sum == target)
+            {
+              support.clear ();
+              for (const std::size_t o : offsets)
+                support.push_back (n - 1 - o);
+              return decoded (support);
+            }
+        }
+      while (next_error_pattern (offsets, n));
+    }
+
+  throw linearcode_exception{ fmt::format (
+      "Cannot decode codeword '{}' because no error pattern has its "
+      "syndrome.",
+      cword) };
+}
+
+///
+/// Caches
+///
+
+[[nodiscard]] std::size_t
+linearcode::table_bytes (lazy_table table) const noexcept
+{
+  switch (table)
+    {
+    case lazy_table::Codewords:
+      return m_lazy_codewords ? bytes_of (*m_lazy_codewords) : 0;
+    case lazy_table::ParityMatrix:
+      return (m_lazy_parity_matrix ? bytes_of (*m_lazy_parity_matrix) : 0)
+             + (m_lazy_packed_parity_matrix
+                    ? bytes_of (*m_lazy_packed_parity_matrix)
+                    : 0);
+    case lazy_table::SlepianTable:
+      return m_lazy_slepian_table ? bytes_of (*m_lazy_slepian_table) : 0;
+    case lazy_table::SyndromeTable:
+      return m_lazy_syndrome_table ? bytes_of (*m_lazy_syndrome_table) : 0;
+    case lazy_table::PackedSyndromeTable:
+      return m_lazy_packed_syndrome_table
+                 ? m_lazy_packed_syndrome_table->size ()
+                       * sizeof (details::bitmatrix::block_type)
+                 : 0;
+    case lazy_table::ErasureSolution:
+      {
+        std::size_t bytes = overhead_of (m_erasure_solutions);
+        for (const auto &[mask, solution] : m_erasure_solutions)
+          bytes += mask.size () * sizeof (details::bitmatrix::block_type)
+                   + bytes_of (solution);
+        return m_erasure_solutions.empty () ? 0 : bytes;
+      }
+    }
+  return 0;
+}
+
+[[nodiscard]] bool
+linearcode::affords (lazy_table table) const noexcept
+{
+  // The tables are estimated by the bytes of their words, as in \ref
+  // bytes_of, before they are built.
+  const std::size_t n = m_packed_generator.cols ();
+  const std::size_t k = m_packed_generator.rows ();
+  const std::size_t word = sizeof (codeword) + n * sizeof (int);
+  const std::size_t node = sizeof (syndrome) + (n - k) * sizeof (int)
+                           + 3 * sizeof (void *) + sizeof (std::size_t);
+
+  std::size_t bytes = 0;
+  auto add = [&] (lazy_table part, std::size_t estimate) {
+    if (!is_built (part))
+      bytes = saturated_sum (bytes, estimate);
+  };
+  switch (table)
+    {
+    case lazy_table::SlepianTable:
+      add (lazy_table::SlepianTable, times_power_of_two (word, n));
+      add (lazy_table::Codewords, times_power_of_two (word, k));
+      break;
+    case lazy_table::PackedSyndromeTable:
+      add (lazy_table::PackedSyndromeTable,
+           times_power_of_two (m_packed_generator.stride ()
+                                   * sizeof (details::bitmatrix::block_type),
+                               n - k));
+      [[fallthrough]];
+    case lazy_table::SyndromeTable:
+      add (lazy_table::SyndromeTable, times_power_of_two (word + node, n - k));
+      break;
+    case lazy_table::Codewords:
+      add (lazy_table::Codewords, times_power_of_two (word, k));
+      break;
+    default:
+      break;
+    }
+  return details::cache_affords (bytes);
+}
+
+void
+linearcode::evict (lazy_table table) noexcept
+{
+  // No thread uses the code, and the next one to do so sees the mark.
+  m_built[std::size_t (table)].store (false, std::memory_order_relaxed);
+  switch (table)
+    {
+    case lazy_table::Codewords:
+      m_lazy_codewords.reset ();
+      break;
+    case lazy_table::SlepianTable:
+      m_lazy_slepian_table.reset ();
+      break;
+    case lazy_table::SyndromeTable:
+      m_lazy_syndrome_table.reset ();
+      break;
+    case lazy_table::PackedSyndromeTable:
+      m_lazy_packed_syndrome_table.reset ();
+      break;
+    case lazy_table::ErasureSolution:
+      m_erasure_solutions.clear ();
+      break;
+    default:
+      // The parity matrix is never accounted for, since the syndromes of
+      // every decoder need it.
+      break;
+    }
+}
+
+[[nodiscard]] std::size_t
+linearcode::cache_bytes () const noexcept
+{
+  std::size_t bytes = 0;
+  for (std::size_t table = 0; table < linearcode_stats::num_tables; ++table)
+    bytes += table_bytes (lazy_table (table));
+  if (m_lazy_generator_matrix)
+    bytes += bytes_of (*m_lazy_generator_matrix);
+  if (m_field)
+    bytes += 2 * (m_field->order () + 1)
+             * sizeof (details::galois_field::element_type);
+  return bytes;
+}
+
 } // namespace patrick
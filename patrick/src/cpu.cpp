@@ -0,0 +1,27 @@
+#include <patrick/cpu.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+[[nodiscard]] const cpu_features &
+cpu () noexcept
+{
+  static const cpu_features features = [] () {
+    cpu_features f;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init ();
+    f.ssse3 = __builtin_cpu_supports ("ssse3");
+    f.avx2 = __builtin_cpu_supports ("avx2");
+    f.pclmul = __builtin_cpu_supports ("pclmul");
+#endif
+    return f;
+  }();
+  return features;
+}
+
+} // namespace details
+
+} // namespace patrick
@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include <patrick/bch.h>
+#include <patrick/bitmatrix.h>
+#include <patrick/cpu.h>
+#include <patrick/cyclic.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+namespace
+{
+
+using digit_type = polynomial_divisor::digit_type;
+constexpr std::size_t digit_bits = polynomial_divisor::digit_bits;
+
+///
+/// \brief The carry-less product of two digits.
+///
+struct product
+{
+  digit_type low;
+  digit_type high;
+};
+
+struct portable_multiply
+{
+  [[nodiscard]] product
+  operator() (digit_type a, digit_type b) const noexcept
+  {
+    product result{ 0, 0 };
+    for (std::size_t i = 0; i < digit_bits; ++i)
+      {
+        const digit_type mask = -((a >> i) & 1u);
+        result.low ^= (b << i) & mask;
+        if (i > 0)
+          result.high ^= (b >> (digit_bits - i)) & mask;
+      }
+    return result;
+  }
+};
+
+#if defined(__x86_64__)
+
+struct pclmul_multiply
+{
+  [[nodiscard]] __attribute__ ((target ("pclmul"))) product
+  operator() (digit_type a, digit_type b) const noexcept
+  {
+    const __m128i p = _mm_clmulepi64_si128 (
+        _mm_cvtsi64_si128 (static_cast<long long> (a)),
+        _mm_cvtsi64_si128 (static_cast<long long> (b)), 0x00);
+    return { static_cast<digit_type> (_mm_cvtsi128_si64 (p)),
+             static_cast<digit_type> (
+                 _mm_cvtsi128_si64 (_mm_unpackhi_epi64 (p, p))) };
+  }
+};
+
+#endif
+
+///
+/// \brief Appends digits to a remainder of degree \f$r \leq 64\f$.
+///
+template <typename Multiply> class single_digit_reducer
+{
+public:
+  explicit single_digit_reducer (const reduction_constants &constants)
+      : m_degree{ constants.degree }, m_divisor{ constants.divisor[0] },
+        m_barrett{ constants.barrett },
+        m_mask{ m_degree == digit_bits ? ~digit_type{ 0 }
+                                       : (digit_type{ 1 } << m_degree) - 1 }
+  {
+  }
+
+  void
+  append (digit_type d) noexcept
+  {
+    // The top 64 coefficients of s x^64 + d, from x^r up.
+    const digit_type top
+        = m_degree == digit_bits
+              ? m_state
+              : (m_state << (digit_bits - m_degree)) | (d >> m_degree);
+    const digit_type quotient = m_multiply (top, m_barrett).high ^ top;
+    m_state = (d ^ m_multiply (quotient, m_divisor).low) & m_mask;
+  }
+
+  [[nodiscard]] digit_type
+  state () const noexcept
+  {
+    return m_state;
+  }
+
+private:
+  Multiply m_multiply;
+  std::size_t m_degree;
+  digit_type m_divisor;
+  digit_type m_barrett;
+  digit_type m_mask;
+  digit_type m_state{ 0 };
+};
+
+template <typename Multiply>
+void
+remainder_with (const reduction_constants &constants,
+                std::span<const digit_type> dividend,
+                std::span<digit_type> remainder) noexcept
+{
+  Multiply multiply;
+  const std::size_t r = constants.degree;
+  const std::size_t n = dividend.size ();
+
+  if (r > digit_bits)
+    {
+      // The remainder spans several digits, which are all reduced at once
+      // by each quotient digit.
+      const std::size_t digits = remainder.size ();
+      const std::size_t top_digit = r / digit_bits;
+      const std::size_t top_shift = r % digit_bits;
+      std::vector<digit_type> appended (digits + 2, 0);
+      std::vector<digit_type> subtrahend (digits + 2, 0);
+      std::fill (remainder.begin (), remainder.end (), 0);
+      for (std::size_t i = n; i-- > 0;)
+        {
+          appended[0] = dividend[i];
+          std::copy (remainder.begin (), remainder.end (),
+                     appended.begin () + 1);
+
+          const digit_type top
+              = top_shift == 0
+                    ? appended[top_digit]
+                    : (appended[top_digit] >> top_shift)
+                          | (appended[top_digit + 1]
+                             << (digit_bits - top_shift));
+          const digit_type quotient
+              = multiply (top, constants.barrett).high ^ top;
+
+          std::fill (subtrahend.begin (), subtrahend.end (), 0);
+          for (std::size_t j = 0; j < constants.divisor.size (); ++j)
+            {
+              const auto p = multiply (quotient, constants.divisor[j]);
+              subtrahend[j] ^= p.low;
+              subtrahend[j + 1] ^= p.high;
+            }
+          for (std::size_t j = 0; j < digits; ++j)
+            remainder[j] = appended[j] ^ subtrahend[j];
+          if (top_shift != 0)
+            remainder[digits - 1] &= (digit_type{ 1 } << top_shift) - 1;
+        }
+      return;
+    }
+
+  single_digit_reducer<Multiply> reducer{ constants };
+  std::size_t pos = n;
+  if (n >= 16)
+    {
+      // Fold 8 digits at a time into 4 lanes of 2 digits each. Lane l
+      // holds digits pos + 7 - 2l and pos + 6 - 2l.
+      const auto [x128, x192, x512, x576] = constants.folding;
+      std::array<product, 4> lanes;
+      pos = n - 8;
+      for (std::size_t l = 0; l < 4; ++l)
+        lanes[l] = { dividend[pos + 6 - 2 * l], dividend[pos + 7 - 2 * l] };
+      while (pos >= 8)
+        {
+          pos -= 8;
+          for (std::size_t l = 0; l < 4; ++l)
+            {
+              const auto a = multiply (lanes[l].high, x576);
+              const auto b = multiply (lanes[l].low, x512);
+              lanes[l] = { a.low ^ b.low ^ dividend[pos + 6 - 2 * l],
+                           a.high ^ b.high ^ dividend[pos + 7 - 2 * l] };
+            }
+        }
+      for (std::size_t l = 0; l < 3; ++l)
+        {
+          const auto a = multiply (lanes[l].high, x192);
+          const auto b = multiply (lanes[l].low, x128);
+          lanes[l + 1].low ^= a.low ^ b.low;
+          lanes[l + 1].high ^= a.high ^ b.high;
+        }
+      reducer.append (lanes[3].high);
+      reducer.append (lanes[3].low);
+    }
+  for (std::size_t i = pos; i-- > 0;)
+    reducer.append (dividend[i]);
+  remainder[0] = reducer.state ();
+}
+
+#if defined(__x86_64__)
+
+__attribute__ ((target ("pclmul"))) void
+remainder_pclmul (const reduction_constants &constants,
+                  std::span<const digit_type> dividend,
+                  std::span<digit_type> remainder) noexcept
+{
+  remainder_with<pclmul_multiply> (constants, dividend, remainder);
+}
+
+#endif
+
+[[nodiscard]] std::size_t
+degree_of (std::span<const digit_type> poly) noexcept
+{
+  for (std::size_t i = poly.size (); i-- > 0;)
+    if (poly[i] != 0)
+      return i * digit_bits + std::bit_width (poly[i]) - 1;
+  return 0;
+}
+
+} // namespace
+
+polynomial_divisor::polynomial_divisor (std::span<const digit_type> divisor)
+{
+  const std::size_t r = degree_of (divisor);
+  assert (r > 0);
+  m_constants.degree = r;
+  m_constants.divisor.assign (divisor.begin (),
+                              divisor.begin () + r / digit_bits + 1);
+
+  // Long division of x^(r + 64) by g, keeping the quotient bits below
+  // x^64.
+  std::vector<digit_type> dividend ((r + digit_bits) / digit_bits + 1, 0);
+  auto flip = [&] (std::size_t bit) {
+    dividend[bit / digit_bits] ^= digit_type{ 1 } << (bit % digit_bits);
+  };
+  flip (r + digit_bits);
+  for (std::size_t b = r + digit_bits + 1; b-- > r;)
+    if ((dividend[b / digit_bits] >> (b % digit_bits)) & 1u)
+      {
+        if (b - r < digit_bits)
+          m_constants.barrett |= digit_type{ 1 } << (b - r);
+        for (std::size_t j = 0; j <= r; ++j)
+          if ((divisor[j / digit_bits] >> (j % digit_bits)) & 1u)
+            flip (b - r + j);
+      }
+
+  if (r <= digit_bits)
+    {
+      const std::array<std::size_t, 4> exponents{ 128, 192, 512, 576 };
+      for (std::size_t i = 0; i < exponents.size (); ++i)
+        {
+          std::vector<digit_type> power (exponents[i] / digit_bits + 1, 0);
+          power.back () = 1;
+          remainder_with<portable_multiply> (
+              m_constants, power, std::span{ &m_constants.folding[i], 1 });
+        }
+    }
+}
+
+void
+polynomial_divisor::remainder (std::span<const digit_type> dividend,
+                               std::span<digit_type> remainder) const noexcept
+{
+#if defined(__x86_64__)
+  if (cpu ().pclmul)
+    return remainder_pclmul (m_constants, dividend, remainder);
+#endif
+  remainder_portable (dividend, remainder);
+}
+
+void
+polynomial_divisor::remainder_portable (
+    std::span<const digit_type> dividend,
+    std::span<digit_type> remainder) const noexcept
+{
+  assert (remainder.size () == remainder_digits ());
+  remainder_with<portable_multiply> (m_constants, dividend, remainder);
+}
+
+} // namespace details
+
+namespace
+{
+
+using digit_type = cyclic_code::digit_type;
+
+[[nodiscard]] std::span<const digit_type>
+checked_generator (std::span<const digit_type> generator)
+{
+  for (std::size_t i = 0; i < generator.size (); ++i)
+    if (generator[i] > (i == 0 ? 1u : 0u))
+      return generator;
+  throw cyclic_code_exception{
+    "The generator polynomial has to be of degree at least 1."
+  };
+}
+
+} // namespace
+
+///
+/// Constructors
+///
+
+cyclic_code::cyclic_code (std::size_t n, std::span<const digit_type> generator)
+    : m_divisor{ checked_generator (generator) }
+{
+  const std::size_t r = m_divisor.degree ();
+  if (r >= n)
+    throw cyclic_code_exception{ fmt::format (
+        "Cannot instantiate a cyclic code of length {} with a generator of "
+        "degree {}.",
+        n, r) };
+  m_properties = properties_type{ .word_size = n, .basis_size = n - r };
+}
+
+[[nodiscard]] cyclic_code
+cyclic_code::hamming (std::size_t r)
+{
+  if (r < details::galois_field::min_degree
+      || r > details::galois_field::max_degree)
+    throw cyclic_code_exception{ fmt::format (
+        "Cannot instantiate a Hamming code with {} parity bits.", r) };
+
+  const digit_type generator
+      = details::galois_field::default_primitive_polynomial (r);
+  return cyclic_code{ (std::size_t{ 1 } << r) - 1,
+                      std::span{ &generator, 1 } };
+}
+
+[[nodiscard]] cyclic_code
+cyclic_code::bch (std::size_t m, std::size_t t)
+{
+  if (m < details::galois_field::min_degree
+      || m > details::galois_field::max_degree)
+    throw cyclic_code_exception{ fmt::format (
+        "Cannot instantiate a BCH code of length 2^{} - 1.", m) };
+
+  const details::galois_field field{ m };
+  const std::size_t n = field.order ();
+  if (t == 0 || 2 * t >= n)
+    throw cyclic_code_exception{ fmt::format (
+        "Cannot instantiate a BCH code of length {} which corrects {} "
+        "errors.",
+        n, t) };
+
+  const auto coefficients = details::bch_generator_polynomial (field, t);
+  std::vector<digit_type> generator (
+      details::bitmatrix::blocks_for (coefficients.size ()), 0);
+  for (std::size_t i = 0; i < coefficients.size (); ++i)
+    generator[i / details::polynomial_divisor::digit_bits]
+        |= digit_type (coefficients[i])
+           << (i % details::polynomial_divisor::digit_bits);
+  return cyclic_code{ n, generator };
+}
+
+///
+/// Observers
+///
+
+[[nodiscard]] bool
+cyclic_code::is_cyclic () const
+{
+  const std::size_t n = m_properties.word_size;
+  std::vector<digit_type> power (details::bitmatrix::blocks_for (n + 1), 0);
+  power[0] = 1;
+  power[n / details::polynomial_divisor::digit_bits]
+      ^= digit_type{ 1 } << (n % details::polynomial_divisor::digit_bits);
+
+  std::vector<digit_type> remainder (m_divisor.remainder_digits ());
+  m_divisor.remainder (power, remainder);
+  return std::all_of (remainder.begin (), remainder.end (),
+                      [] (digit_type d) { return d == 0; });
+}
+
+///
+/// Operations
+///
+
+void
+cyclic_code::ensure_digits (std::size_t digits, std::size_t bits) const
+{
+  if (digits != details::bitmatrix::blocks_for (bits))
+    throw cyclic_code_exception{ fmt::format (
+        "Expected {} bits packed into {} digits, but {} digits were given.",
+        bits, details::bitmatrix::blocks_for (bits), digits) };
+}
+
+void
+cyclic_code::encode (std::span<const digit_type> message,
+                     std::span<digit_type> cword) const
+{
+  constexpr std::size_t digit_bits = details::polynomial_divisor::digit_bits;
+  const std::size_t n = m_properties.word_size;
+  const std::size_t k = m_properties.basis_size;
+  const std::size_t r = n - k;
+  ensure_digits (message.size (), k);
+  ensure_digits (cword.size (), n);
+
+  // c(x) = m(x) x^r + (m(x) x^r mod g(x))
+  std::fill (cword.begin (), cword.end (), 0);
+  const std::size_t offset = r / digit_bits;
+  const std::size_t shift = r % digit_bits;
+  for (std::size_t i = 0; i < message.size (); ++i)
+    {
+      digit_type d = message[i];
+      if (i + 1 == message.size () && k % digit_bits != 0)
+        d &= (digit_type{ 1 } << (k % digit_bits)) - 1;
+      cword[offset + i] |= d << shift;
+      if (shift != 0 && offset + i + 1 < cword.size ())
+        cword[offset + i + 1] |= d >> (digit_bits - shift);
+    }
+
+  std::vector<digit_type> remainder (m_divisor.remainder_digits ());
+  m_divisor.remainder (cword, remainder);
+  for (std::size_t i = 0; i < remainder.size (); ++i)
+    cword[i] ^= remainder[i];
+}
+
+[[nodiscard]] codeword
+cyclic_code::encode (const infoword &iword) const
+{
+  const std::size_t n = m_properties.word_size;
+  const std::size_t k = m_properties.basis_size;
+  if (static_cast<std::size_t> (iword.vec.cols ()) != k)
+    throw cyclic_code_exception{ fmt::format (
+        "Trying to encode infoword '{}' which has size n={}, whereas the code "
+        "expects n={}.",
+        iword, iword.vec.cols (), k) };
+
+  std::vector<digit_type> message (details::bitmatrix::blocks_for (k));
+  std::vector<digit_type> cword (details::bitmatrix::blocks_for (n));
+  details::pack (iword, message.data ());
+  encode (message, cword);
+  return details::unpack<details::codeword_tag> (cword.data (), n);
+}
+
+void
+cyclic_code::syndrome_of (std::span<const digit_type> cword,
+                          std::span<digit_type> syndrome) const
+{
+  ensure_digits (cword.size (), m_properties.word_size);
+  ensure_digits (syndrome.size (), m_divisor.degree ());
+  m_divisor.remainder (cword, syndrome);
+}
+
+[[nodiscard]] syndrome
+cyclic_code::syndrome_of (const codeword &cword) const
+{
+  const std::size_t n = m_properties.word_size;
+  if (static_cast<std::size_t> (cword.vec.cols ()) != n)
+    throw cyclic_code_exception{ fmt::format (
+        "Trying to use codeword '{}' which has size n={}, whereas the code "
+        "expects n={}.",
+        cword, cword.vec.cols (), n) };
+
+  std::vector<digit_type> packed (details::bitmatrix::blocks_for (n));
+  std::vector<digit_type> remainder (m_divisor.remainder_digits ());
+  details::pack (cword, packed.data ());
+  syndrome_of (packed, remainder);
+  return details::unpack<details::syndrome_tag> (remainder.data (),
+                                                 m_divisor.degree ());
+}
+
+[[nodiscard]] bool
+cyclic_code::contains (const codeword &cword) const
+{
+  return syndrome_of (cword).weight () == 0;
+}
+
+} // namespace patrick
@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <numeric>
+
+#include <patrick/core.h>
+
+namespace patrick
+{
+
+namespace
+{
+
+///
+/// \return Whether each of the \a n positions is one of \a positions.
+/// \throws \ref linearcode_exception if a position is out of range or
+/// repeated.
+///
+[[nodiscard]] std::vector<bool>
+marked_positions (std::span<const std::size_t> positions, std::size_t n)
+{
+  std::vector<bool> marked (n, false);
+  for (const std::size_t p : positions)
+    {
+      if (p >= n)
+        throw linearcode_exception{ fmt::format (
+            "Cannot remove position {} of a code of length {}.", p, n) };
+      if (marked[p])
+        throw linearcode_exception{ fmt::format (
+            "Cannot remove position {} twice.", p) };
+      marked[p] = true;
+    }
+  return marked;
+}
+
+///
+/// \return The positions of \a w in \a kept, in that order.
+///
+template <typename Tag>
+[[nodiscard]] details::word<Tag>
+select (const details::word<Tag> &w, const std::vector<std::size_t> &kept)
+{
+  Eigen::RowVectorXi vec (kept.size ());
+  for (std::size_t i = 0; i < kept.size (); ++i)
+    vec (i) = w.vec (kept[i]);
+  return details::word<Tag>{ std::move (vec) };
+}
+
+[[nodiscard]] details::bitmatrix
+select_rows (const details::bitmatrix &m, const std::vector<std::size_t> &rows)
+{
+  details::bitmatrix result (rows.size (), m.cols ());
+  for (std::size_t r = 0; r < rows.size (); ++r)
+    std::copy_n (m.row (rows[r]), m.stride (), result.row (r));
+  return result;
+}
+
+} // namespace
+
+void
+linearcode::shortened_from (const linearcode &mother,
+                            const std::vector<std::size_t> &kept)
+{
+  if (mother.m_family.kind == code_family::Generic)
+    return;
+  m_family = mother.m_family;
+  if (!mother.m_family_code)
+    {
+      m_family_code
+          = std::make_shared<const linearcode> (from_family (m_family));
+      m_family_positions = kept;
+      return;
+    }
+  m_family_code = mother.m_family_code;
+  m_family_positions.clear ();
+  for (const std::size_t p : kept)
+    m_family_positions.push_back (mother.m_family_positions[p]);
+}
+
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_shortened (
+    const codeword &cword,
+    decoding_result (linearcode::*decoder) (const codeword &) const) const
+{
+  ensure_word_size (cword);
+  const std::size_t n = m_family_code->m_packed_generator.cols ();
+  codeword lengthened{ Eigen::RowVectorXi::Zero (n) };
+  for (std::size_t i = 0; i < m_family_positions.size (); ++i)
+    lengthened.vec (m_family_positions[i]) = cword.vec (i);
+
+  const codeword lengthened_error
+      = (m_family_code.get ()->*decoder) (lengthened).error;
+  codeword error = select (lengthened_error, m_family_positions);
+  if (error.weight () != lengthened_error.weight ())
+    throw linearcode_exception{ fmt::format (
+        "Cannot decode codeword '{}' because the nearest codeword of the {} "
+        "code is not zero at the positions it is shortened at.",
+        cword, m_family_code->m_properties.special_name) };
+  return decoding_result{ .iword = information_of (cword + error),
+                          .error = std::move (error) };
+}
+
+[[nodiscard]] linearcode
+linearcode::shorten (std::span<const std::size_t> positions) const
+{
+  const std::size_t n = m_packed_generator.cols ();
+  const std::size_t k = m_packed_generator.rows ();
+  const std::vector<bool> removed = marked_positions (positions, n);
+  // The tables of this code are read off below.
+  const details::cache_use use{ m_cache };
+
+  std::vector<std::size_t> kept;
+  std::vector<std::size_t> new_index (n, n);
+  for (std::size_t c = 0; c < n; ++c)
+    if (!removed[c])
+      {
+        new_index[c] = kept.size ();
+        kept.push_back (c);
+      }
+
+  std::size_t num_information = 0;
+  for (std::size_t i = 0; i < k; ++i)
+    num_information += removed[m_permutation[i]];
+  if (num_information == k)
+    throw linearcode_exception{ fmt::format (
+        "Cannot shorten a code of dimension {} at all of its information "
+        "positions.",
+        k) };
+
+  if (num_information != positions.size ())
+    {
+      // The codewords which are zero at the positions are the solutions of
+      // the parity equations without them.
+      auto code = from_packed_parity_equations (
+          packed_parity_matrix ().select_columns (kept), family_type{},
+          m_properties.min_distance);
+      code.set_special_name ("Shortened " + m_properties.special_name);
+      code.set_table_resource (m_table_resource);
+      code.shortened_from (*this, kept);
+      return code;
+    }
+
+  // The rows of the systematic generator at the removed positions are the
+  // codewords which are not zero there. The others stay in standard form.
+  std::vector<std::size_t> rows;
+  std::vector<std::size_t> permutation;
+  for (std::size_t i = 0; i < k; ++i)
+    if (!removed[m_permutation[i]])
+      {
+        rows.push_back (i);
+        permutation.push_back (new_index[m_permutation[i]]);
+      }
+  for (std::size_t i = k; i < n; ++i)
+    permutation.push_back (new_index[m_permutation[i]]);
+
+  linearcode code{ select_rows (m_packed_generator.select_columns (kept),
+                                rows),
+                   std::move (permutation), family_type{},
+                   m_properties.min_distance };
+  code.set_special_name ("Shortened " + m_properties.special_name);
+  code.set_table_resource (m_table_resource);
+  code.shortened_from (*this, kept);
+
+  // The parity matrix is (A^T | I) in standard form, so removing rows of A
+  // only removes columns of it.
+  if (m_lazy_packed_parity_matrix)
+    {
+      auto parity = m_lazy_packed_parity_matrix->select_columns (kept);
+      code.m_lazy_parity_matrix.emplace (parity.to_eigen ());
+      code.m_lazy_packed_parity_matrix.emplace (std::move (parity));
+      code.mark_built (lazy_table::ParityMatrix);
+    }
+
+  auto avoids_removed = [&] (const codeword &cword) {
+    return std::ranges::none_of (
+        positions, [&] (const std::size_t p) { return cword.vec (p) != 0; });
+  };
+
+  if (m_lazy_codewords)
+    {
+      codewords_type codewords{ m_table_resource };
+      for (const auto &cword : *m_lazy_codewords)
+        if (avoids_removed (cword))
+          codewords.push_back (select (cword, kept));
+      code.m_lazy_codewords.emplace (std::move (codewords));
+      code.mark_built (lazy_table::Codewords);
+      code.account_for (lazy_table::Codewords);
+    }
+
+  if (m_lazy_syndrome_table)
+    {
+      // The syndromes are the same, so a leader which avoids the positions
+      // is still the lightest word of its coset. The other cosets are
+      // searched by increasing weight.
+      const std::size_t num_rows = m_lazy_syndrome_table->size ();
+      syndrome_table_type table{ m_table_resource };
+      table.reserve (num_rows);
+      for (const auto &[s, leader] : *m_lazy_syndrome_table)
+        if (avoids_removed (leader))
+          table.emplace (s, select (leader, kept));
+
+      const std::size_t length = kept.size ();
+      for (std::size_t w = 1; w <= length && table.size () < num_rows; ++w)
+        {
+          std::vector<std::size_t> support (w);
+          std::iota (support.begin (), support.end (), 0);
+          while (table.size () < num_rows)
+            {
+              codeword error{ Eigen::RowVectorXi::Zero (length) };
+              for (const std::size_t p : support)
+                error.vec (p) = 1;
+              table.try_emplace (code.syndrome_of (error), std::move (error));
+
+              // Move on to the next support in lexicographic order.
+              std::size_t i = w;
+              while (i > 0 && support[i - 1] == length - w + i - 1)
+                --i;
+              if (i == 0)
+                break;
+              ++support[i - 1];
+              for (std::size_t j = i; j < w; ++j)
+                support[j] = support[j - 1] + 1;
+            }
+        }
+      code.m_lazy_syndrome_table.emplace (std::move (table));
+      code.mark_built (lazy_table::SyndromeTable);
+      code.account_for (lazy_table::SyndromeTable);
+    }
+
+  return code;
+}
+
+[[nodiscard]] linearcode
+linearcode::puncture (std::span<const std::size_t> positions) const
+{
+  const std::size_t n = m_packed_generator.cols ();
+  const std::size_t k = m_packed_generator.rows ();
+  const std::vector<bool> removed = marked_positions (positions, n);
+  // The tables of this code are read off below.
+  const details::cache_use use{ m_cache };
+
+  std::vector<std::size_t> kept;
+  std::vector<std::size_t> new_index (n, n);
+  for (std::size_t c = 0; c < n; ++c)
+    if (!removed[c])
+      {
+        new_index[c] = kept.size ();
+        kept.push_back (c);
+      }
+
+  // Removing fewer positions than the distance keeps codewords apart.
+  const std::size_t d = m_properties.min_distance;
+  const auto min_distance = positions.size () < d
+                                ? std::optional{ d - positions.size () }
+                                : std::nullopt;
+
+  const bool all_redundancy = std::ranges::none_of (
+      m_permutation.cbegin (), m_permutation.cbegin () + k,
+      [&] (const std::size_t p) { return removed[p]; });
+  if (!all_redundancy)
+    {
+      auto code = from_packed_generator (
+          m_packed_generator.select_columns (kept), family_type{},
+          min_distance);
+      code.set_special_name ("Punctured " + m_properties.special_name);
+      code.set_table_resource (m_table_resource);
+      return code;
+    }
+
+  // The identity part of the generator is untouched, so it stays in
+  // standard form.
+  std::vector<std::size_t> permutation;
+  for (const std::size_t p : m_permutation)
+    if (!removed[p])
+      permutation.push_back (new_index[p]);
+
+  linearcode code{ m_packed_generator.select_columns (kept),
+                   std::move (permutation), family_type{}, min_distance };
+  code.set_special_name ("Punctured " + m_properties.special_name);
+  code.set_table_resource (m_table_resource);
+
+  // Row j of the parity matrix is the only one which checks redundancy
+  // position `m_permutation[k + j]`, so it goes away along with it.
+  std::vector<std::size_t> parity_rows;
+  for (std::size_t j = 0; j < n - k; ++j)
+    if (!removed[m_permutation[k + j]])
+      parity_rows.push_back (j);
+
+  if (m_lazy_packed_parity_matrix)
+    {
+      auto parity = select_rows (
+          m_lazy_packed_parity_matrix->select_columns (kept), parity_rows);
+      code.m_lazy_parity_matrix.emplace (parity.to_eigen ());
+      code.m_lazy_packed_parity_matrix.emplace (std::move (parity));
+      code.mark_built (lazy_table::ParityMatrix);
+    }
+
+  if (m_lazy_codewords)
+    {
+      codewords_type codewords{ m_table_resource };
+      codewords.reserve (m_lazy_codewords->size ());
+      for (const auto &cword : *m_lazy_codewords)
+        codewords.push_back (select (cword, kept));
+      std::ranges::stable_sort (codewords, {}, &codeword::weight);
+      code.m_lazy_codewords.emplace (std::move (codewords));
+      code.mark_built (lazy_table::Codewords);
+      code.account_for (lazy_table::Codewords);
+    }
+
+  if (m_lazy_syndrome_table)
+    {
+      // A word without the positions can be completed at them to any of
+      // the syndromes which agree with its own on the remaining rows. So the
+      // lightest of their leaders leads its coset.
+      syndrome_table_type table{ m_table_resource };
+      table.reserve (m_lazy_syndrome_table->size ()
+                     >> (n - k - parity_rows.size ()));
+      for (const auto &[s, leader] : *m_lazy_syndrome_table)
+        {
+          auto error = select (leader, kept);
+          auto [it, inserted]
+              = table.try_emplace (select (s, parity_rows), error);
+          if (!inserted && error.weight () < it->second.weight ())
+            it->second = std::move (error);
+        }
+      code.m_lazy_syndrome_table.emplace (std::move (table));
+      code.mark_built (lazy_table::SyndromeTable);
+      code.account_for (lazy_table::SyndromeTable);
+    }
+
+  return code;
+}
+
+} // namespace patrick
@@ -0,0 +1,129 @@
+#include <bit>
+#include <numeric>
+#include <vector>
+
+#include <patrick/core.h>
+#include <patrick/trace.h>
+
+namespace patrick
+{
+
+namespace
+{
+
+using block_type = details::bitmatrix::block_type;
+
+///
+/// \return The parity of the dot product of \a a and \a b.
+///
+bool
+dot (const block_type *a, const block_type *b, std::size_t blocks) noexcept
+{
+  int parity = 0;
+  for (std::size_t i = 0; i < blocks; ++i)
+    parity ^= std::popcount (a[i] & b[i]);
+  return parity & 1;
+}
+
+} // namespace
+
+const details::bitmatrix &
+linearcode::erasure_solution (std::vector<block_type> mask,
+                              std::span<const std::size_t> positions)
+{
+  if (const auto it = m_erasure_solutions.find (mask);
+      it != m_erasure_solutions.end ())
+    return it->second;
+
+  details::trace_span span{ "erasure_solution", "table" };
+  span.arg ("erasures", positions.size ());
+  const auto start = m_stats.now ();
+  // Reducing (H_E | I) leaves T on the right. H_E may only be reduced to
+  // the identity over the zero matrix if its columns are independent.
+  const details::bitmatrix &H = packed_parity_matrix ();
+  const std::size_t e = positions.size ();
+  const std::size_t r = H.rows ();
+  details::bitmatrix augmented{ r, e + r };
+  for (std::size_t i = 0; i < r; ++i)
+    {
+      for (std::size_t j = 0; j < e; ++j)
+        augmented.set (i, j, H.get (i, positions[j]));
+      augmented.set (i, e + i, true);
+    }
+  const auto pivots = details::reduce_to_echelon_form (augmented);
+  if (e > 0 && (pivots.size () < e || pivots[e - 1] != e - 1))
+    throw linearcode_exception{ fmt::format (
+        "Cannot tell apart {} erased bits whose columns of the parity matrix "
+        "are dependent.",
+        e) };
+
+  std::vector<std::size_t> right (r);
+  std::iota (right.begin (), right.end (), e);
+  if (m_erasure_solutions.size () >= max_erasure_solutions)
+    {
+      m_erasure_solutions.clear ();
+      m_cache.drop (lazy_table::ErasureSolution);
+    }
+  const auto it = m_erasure_solutions
+                      .emplace (std::move (mask),
+                                augmented.select_columns (right))
+                      .first;
+  const std::size_t bytes = [&] {
+    const auto &[key, solution] = *it;
+    return key.size () * sizeof (block_type) + sizeof (solution)
+           + solution.rows () * solution.stride () * sizeof (block_type);
+  }();
+  m_stats.count_build (lazy_table::ErasureSolution, start,
+                       [&] { return bytes; });
+  m_cache.add (lazy_table::ErasureSolution, bytes);
+  return it->second;
+}
+
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_erasures (const codeword &cword, const codeword &erasures)
+{
+  ensure_word_size (cword);
+  ensure_word_size (erasures);
+
+  const details::cache_use use{ m_cache };
+  return counted (details::erasure_decoder, [&] () -> decoding_result {
+    const std::size_t n = m_packed_generator.cols ();
+    std::vector<block_type> mask (details::bitmatrix::blocks_for (n));
+    std::vector<block_type> bits (mask.size ());
+    details::pack (erasures, mask.data ());
+    details::pack (cword, bits.data ());
+    std::vector<std::size_t> positions;
+    for (std::size_t i = 0; i < n; ++i)
+      if (erasures.vec (i) & 1)
+        positions.push_back (i);
+    for (std::size_t b = 0; b < bits.size (); ++b)
+      bits[b] &= ~mask[b];
+
+    // The syndrome of the word with its erased bits cleared is H_E x for the
+    // erased bits x, so that T H_E x = (x | 0) = T s.
+    const details::bitmatrix &H = packed_parity_matrix ();
+    const std::size_t r = H.rows ();
+    std::vector<block_type> s (details::bitmatrix::blocks_for (r));
+    for (std::size_t i = 0; i < r; ++i)
+      if (dot (H.row (i), bits.data (), H.stride ()))
+        s[i / 64] |= block_type{ 1 } << (i % 64);
+
+    const details::bitmatrix &T
+        = erasure_solution (std::move (mask), positions);
+    for (std::size_t i = positions.size (); i < r; ++i)
+      if (dot (T.row (i), s.data (), T.stride ()))
+        throw linearcode_exception{ fmt::format (
+            "The bits of '{}' which are not erased are not part of a "
+            "codeword.",
+            cword) };
+    for (std::size_t j = 0; j < positions.size (); ++j)
+      if (dot (T.row (j), s.data (), T.stride ()))
+        bits[positions[j] / 64] |= block_type{ 1 } << (positions[j] % 64);
+
+    const auto decoded
+        = details::unpack<details::codeword_tag> (bits.data (), n);
+    return { information_of (decoded), decoded + cword };
+  });
+}
+
+} // namespace patrick
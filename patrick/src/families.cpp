@@ -0,0 +1,308 @@
+#include <array>
+#include <bit>
+#include <cassert>
+#include <string_view>
+
+#include <patrick/bch.h>
+#include <patrick/core.h>
+#include <patrick/gf2m.h>
+
+namespace patrick
+{
+
+namespace
+{
+
+[[nodiscard]] constexpr std::uint32_t
+bits_of (std::string_view bitstr)
+{
+  std::uint32_t result = 0;
+  for (std::size_t i = 0; i < bitstr.size (); ++i)
+    result |= std::uint32_t (bitstr[i] == '1') << i;
+  return result;
+}
+
+///
+/// \brief The matrix \f$B\f$ of the extended Golay code. Bit \f$j\f$ of row
+/// \f$i\f$ is \f$B_{ij}\f$. It is symmetric and \f$B^{2} = I\f$, which the
+/// decoder relies on.
+///
+// clang-format off
+constexpr std::array<std::uint32_t, 12> golay_b = {
+  bits_of ("110111000101"),
+  bits_of ("101110001011"),
+  bits_of ("011100010111"),
+  bits_of ("111000101101"),
+  bits_of ("110001011011"),
+  bits_of ("100010110111"),
+  bits_of ("000101101111"),
+  bits_of ("001011011101"),
+  bits_of ("010110111001"),
+  bits_of ("101101110001"),
+  bits_of ("011011100011"),
+  bits_of ("111111111110"),
+};
+// clang-format on
+
+///
+/// \return \f$vB\f$, that is the sum of the rows of \f$B\f$ selected by
+/// \a v.
+///
+[[nodiscard]] std::uint32_t
+golay_times_b (std::uint32_t v) noexcept
+{
+  std::uint32_t result = 0;
+  for (std::size_t i = 0; i < golay_b.size (); ++i)
+    if ((v >> i) & 1u)
+      result ^= golay_b[i];
+  return result;
+}
+
+///
+/// \throws linearcode_exception if the generator of the \a name code of
+/// length \a n and dimension \a k takes more bits than a code of a family
+/// may hold.
+///
+void
+ensure_generator_fits (std::string_view name, std::size_t n, std::size_t k)
+{
+  if (k > linearcode::max_family_generator_bits / n)
+    throw linearcode_exception{ fmt::format (
+        "Cannot instantiate the {} code of length {} and dimension {}, "
+        "whose generator takes more than {} bits.",
+        name, n, k, linearcode::max_family_generator_bits) };
+}
+
+} // namespace
+
+///
+/// Code families
+///
+
+[[nodiscard]] linearcode
+linearcode::hamming (std::size_t r)
+{
+  if (r < 2 || r > details::galois_field::max_degree)
+    throw linearcode_exception{ fmt::format (
+        "Cannot instantiate a Hamming code with {} parity bits.", r) };
+
+  const std::size_t n = (std::size_t{ 1 } << r) - 1;
+  ensure_generator_fits ("Hamming", n, n - r);
+  details::bitmatrix parity (r, n);
+  for (std::size_t c = 0; c < n; ++c)
+    for (std::size_t i = 0; i < r; ++i)
+      if (((c + 1) >> i) & 1u)
+        parity.flip (i, c);
+
+  auto code = from_packed_parity_equations (
+      std::move (parity), family_type{ .kind = code_family::Hamming, .m = r },
+      3);
+  code.set_special_name ("Hamming");
+  return code;
+}
+
+[[nodiscard]] linearcode
+linearcode::bch (std::size_t m, std::size_t t)
+{
+  if (m < details::galois_field::min_degree
+      || m > details::galois_field::max_degree)
+    throw linearcode_exception{ fmt::format (
+        "Cannot instantiate a BCH code of length 2^{} - 1.", m) };
+
+  const details::galois_field field{ m };
+  const std::size_t n = field.order ();
+  if (t == 0 || 2 * t >= n)
+    throw linearcode_exception{ fmt::format (
+        "Cannot instantiate a BCH code of length {} which corrects {} "
+        "errors.",
+        n, t) };
+
+  const auto generator_poly = details::bch_generator_polynomial (field, t);
+  const std::size_t redundancy = generator_poly.size () - 1;
+  if (redundancy >= n)
+    throw linearcode_exception{ fmt::format (
+        "The BCH code of length {} which corrects {} errors is trivial.", n,
+        t) };
+
+  // Row i is x^i g(x).
+  const std::size_t k = n - redundancy;
+  ensure_generator_fits ("BCH", n, k);
+  details::bitmatrix generator (k, n);
+  for (std::size_t row = 0; row < k; ++row)
+    for (std::size_t d = 0; d <= redundancy; ++d)
+      if (generator_poly[d])
+        generator.flip (row, row + d);
+
+  auto code = from_packed_generator (
+      std::move (generator),
+      family_type{ .kind = code_family::BCH, .m = m, .t = t }, 2 * t + 1);
+  code.set_special_name ("BCH");
+  return code;
+}
+
+[[nodiscard]] linearcode
+linearcode::golay24 ()
+{
+  details::bitmatrix generator (12, 24);
+  for (std::size_t i = 0; i < 12; ++i)
+    {
+      generator.flip (i, i);
+      for (std::size_t j = 0; j < 12; ++j)
+        if ((golay_b[i] >> j) & 1u)
+          generator.flip (i, 12 + j);
+    }
+
+  auto code = from_packed_generator (
+      std::move (generator), family_type{ .kind = code_family::Golay }, 8);
+  code.set_special_name ("Golay");
+  return code;
+}
+
+[[nodiscard]] linearcode
+linearcode::reed_muller (std::size_t r, std::size_t m)
+{
+  if (m == 0 || m > details::galois_field::max_degree || r > m)
+    throw linearcode_exception{ fmt::format (
+        "Cannot instantiate the Reed-Muller code RM({}, {}).", r, m) };
+
+  const std::size_t n = std::size_t{ 1 } << m;
+
+  // Every monomial is identified by the mask of the variables in it.
+  std::vector<std::size_t> monomials;
+  for (std::size_t degree = 0; degree <= r; ++degree)
+    for (std::size_t mask = 0; mask < n; ++mask)
+      if (static_cast<std::size_t> (std::popcount (mask)) == degree)
+        monomials.push_back (mask);
+  ensure_generator_fits ("Reed-Muller", n, monomials.size ());
+
+  details::bitmatrix generator (monomials.size (), n);
+  for (std::size_t row = 0; row < monomials.size (); ++row)
+    for (std::size_t p = 0; p < n; ++p)
+      if ((p & monomials[row]) == monomials[row])
+        generator.flip (row, p);
+
+  auto code = from_packed_generator (
+      std::move (generator),
+      family_type{ .kind = code_family::ReedMuller, .m = m, .r = r },
+      std::size_t{ 1 } << (m - r));
+  code.set_special_name ("Reed-Muller");
+  return code;
+}
+
+[[nodiscard]] linearcode
+linearcode::from_family (const family_type &family)
+{
+  using enum code_family;
+  switch (family.kind)
+    {
+    case Hamming:
+      return hamming (family.m);
+    case BCH:
+      return bch (family.m, family.t);
+    case Golay:
+      return golay24 ();
+    case ReedMuller:
+      return reed_muller (family.r, family.m);
+    default:
+      throw linearcode_exception{
+        "Cannot instantiate a generic code from its family."
+      };
+    }
+}
+
+///
+/// Decoding
+///
+
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_with_structure (const codeword &cword)
+{
+  using enum code_family;
+  switch (m_family.kind)
+    {
+    case Hamming:
+      return decode_hamming (cword);
+    case Golay:
+      return decode_golay (cword);
+    case BCH:
+      return decode_with_chien (cword);
+    case ReedMuller:
+      return m_family.r == 1 ? decode_with_hadamard (cword)
+                             : decode_with_majority (cword);
+    default:
+      return decode_with_slepian (cword);
+    }
+}
+
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_hamming (const codeword &cword) const
+{
+  if (m_family_code)
+    return decode_shortened (cword, &linearcode::decode_hamming);
+  ensure_word_size (cword);
+
+  const std::size_t n = m_packed_generator.cols ();
+  std::size_t position = 0;
+  for (std::size_t j = 0; j < n; ++j)
+    if (cword.vec (j) & 1)
+      position ^= j + 1;
+
+  codeword error{ Eigen::RowVectorXi::Zero (n) };
+  if (position != 0)
+    error.vec (position - 1) = 1;
+  return decoding_result{ .iword = information_of (cword + error),
+                          .error = std::move (error) };
+}
+
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_golay (const codeword &cword) const
+{
+  if (m_family_code)
+    return decode_shortened (cword, &linearcode::decode_golay);
+  ensure_word_size (cword);
+
+  std::uint32_t r1 = 0;
+  std::uint32_t r2 = 0;
+  for (std::size_t j = 0; j < 12; ++j)
+    {
+      r1 |= std::uint32_t (cword.vec (j) & 1) << j;
+      r2 |= std::uint32_t (cword.vec (12 + j) & 1) << j;
+    }
+
+  // The received word is (u + e1 | uB + e2), so the syndromes are
+  // s1 = e1 B + e2 and s2 = s1 B = e1 + e2 B. If at most 3 errors happened,
+  // either one of the halves of the error is at most a single bit, and the
+  // other half is read off one of the syndromes.
+  auto weight = [] (std::uint32_t v) { return std::popcount (v); };
+  const std::uint32_t s1 = golay_times_b (r1) ^ r2;
+  const std::uint32_t s2 = golay_times_b (s1);
+
+  std::optional<std::pair<std::uint32_t, std::uint32_t> > error_halves;
+  if (weight (s1) <= 3)
+    error_halves.emplace (0, s1);
+  else if (weight (s2) <= 3)
+    error_halves.emplace (s2, 0);
+  for (std::size_t i = 0; i < golay_b.size () && !error_halves; ++i)
+    {
+      if (weight (s1 ^ golay_b[i]) <= 2)
+        error_halves.emplace (1u << i, s1 ^ golay_b[i]);
+      else if (weight (s2 ^ golay_b[i]) <= 2)
+        error_halves.emplace (s2 ^ golay_b[i], 1u << i);
+    }
+
+  if (!error_halves)
+    throw linearcode_exception{ fmt::format (
+        "Cannot decode codeword '{}' because more than 3 errors were found.",
+        cword) };
+
+  codeword error{ Eigen::RowVectorXi::Zero (24) };
+  for (std::size_t j = 0; j < 12; ++j)
+    {
+      error.vec (j) = (error_halves->first >> j) & 1u;
+      error.vec (12 + j) = (error_halves->second >> j) & 1u;
+    }
+  return decoding_result{ .iword = information_of (cword + error),
+                          .error = std::move (error) };
+}
+
+} // namespace patrick
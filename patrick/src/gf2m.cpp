@@ -0,0 +1,106 @@
+#include <array>
+
+#include <patrick/gf2m.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+namespace
+{
+
+// clang-format off
+constexpr std::array<std::uint32_t, galois_field::max_degree + 1>
+    primitive_polynomials = {
+      0, 0,
+      0x7,     // x^2 + x + 1
+      0xB,     // x^3 + x + 1
+      0x13,    // x^4 + x + 1
+      0x25,    // x^5 + x^2 + 1
+      0x43,    // x^6 + x + 1
+      0x89,    // x^7 + x^3 + 1
+      0x11D,   // x^8 + x^4 + x^3 + x^2 + 1
+      0x211,   // x^9 + x^4 + 1
+      0x409,   // x^10 + x^3 + 1
+      0x805,   // x^11 + x^2 + 1
+      0x1053,  // x^12 + x^6 + x^4 + x + 1
+      0x201B,  // x^13 + x^4 + x^3 + x + 1
+      0x4443,  // x^14 + x^10 + x^6 + x + 1
+      0x8003,  // x^15 + x + 1
+      0x1100B, // x^16 + x^12 + x^3 + x + 1
+    };
+// clang-format on
+
+} // namespace
+
+[[nodiscard]] std::uint32_t
+galois_field::default_primitive_polynomial (std::size_t m)
+{
+  if (m < min_degree || m > max_degree)
+    throw galois_field_exception{ fmt::format (
+        "GF(2^{}) is not supported. The degree has to be in [{}, {}].", m,
+        min_degree, max_degree) };
+  return primitive_polynomials[m];
+}
+
+galois_field::galois_field (std::size_t m, std::uint32_t primitive_polynomial)
+    : m_degree{ m }, m_order{ (std::size_t{ 1 } << m) - 1 },
+      m_polynomial{ primitive_polynomial }, m_antilog (2 * m_order, 0),
+      m_log (m_order + 1, 0)
+{
+  if (m < min_degree || m > max_degree)
+    throw galois_field_exception{ fmt::format (
+        "GF(2^{}) is not supported. The degree has to be in [{}, {}].", m,
+        min_degree, max_degree) };
+  if ((primitive_polynomial >> m) != 1)
+    throw galois_field_exception{ fmt::format (
+        "Polynomial {:#x} is not of degree {}.", primitive_polynomial, m) };
+
+  element_type a = 1;
+  for (std::size_t i = 0; i < m_order; ++i)
+    {
+      // alpha^i must not repeat before all nonzero elements are visited.
+      if (i > 0 && a == 1)
+        throw galois_field_exception{ fmt::format (
+            "Polynomial {:#x} is not primitive.", primitive_polynomial) };
+      m_antilog[i] = m_antilog[i + m_order] = a;
+      m_log[a] = i;
+      a <<= 1;
+      if (a >> m)
+        a ^= primitive_polynomial;
+    }
+}
+
+[[nodiscard]] std::uint32_t
+galois_field::minimal_polynomial (std::size_t i) const
+{
+  // Multiply out (x + alpha^j) for every j in the cyclotomic coset
+  // {i, 2i, 4i, ...}. The coefficients are in GF(2^m) while doing so, but the
+  // result has coefficients in F_2.
+  std::vector<element_type> poly{ 1 };
+  std::size_t j = i % m_order;
+  do
+    {
+      const element_type root = exp (j);
+      poly.push_back (0);
+      for (std::size_t d = poly.size () - 1; d > 0; --d)
+        poly[d] = add (poly[d - 1], mul (poly[d], root));
+      poly[0] = mul (poly[0], root);
+      j = (2 * j) % m_order;
+    }
+  while (j != i % m_order);
+
+  std::uint32_t result = 0;
+  for (std::size_t d = 0; d < poly.size (); ++d)
+    {
+      assert (poly[d] <= 1);
+      result |= poly[d] << d;
+    }
+  return result;
+}
+
+} // namespace details
+
+} // namespace patrick
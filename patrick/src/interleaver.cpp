@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <array>
+
+#include <patrick/interleaver.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+namespace
+{
+
+using block_type = bitmatrix::block_type;
+constexpr std::size_t block_bits = bitmatrix::block_bits;
+
+[[nodiscard]] constexpr block_type
+low_mask (std::size_t count) noexcept
+{
+  return count >= block_bits ? ~block_type{ 0 }
+                             : (block_type{ 1 } << count) - 1;
+}
+
+///
+/// \return The 64 bits of \a in from bit \a offset on. Bits past the end of
+/// \a in are 0.
+///
+[[nodiscard]] block_type
+read_bits (std::span<const block_type> in, std::size_t offset) noexcept
+{
+  const std::size_t index = offset / block_bits;
+  const std::size_t shift = offset % block_bits;
+  block_type bits = in[index] >> shift;
+  if (shift != 0 && index + 1 < in.size ())
+    bits |= in[index + 1] << (block_bits - shift);
+  return bits;
+}
+
+///
+/// \brief Overwrites \a count bits of \a out from bit \a offset on with the
+/// low bits of \a bits, which must be zero above them.
+///
+void
+write_bits (std::span<block_type> out, std::size_t offset, block_type bits,
+            std::size_t count) noexcept
+{
+  const std::size_t index = offset / block_bits;
+  const std::size_t shift = offset % block_bits;
+  const block_type mask = low_mask (count);
+  out[index] = (out[index] & ~(mask << shift)) | (bits << shift);
+  if (shift + count > block_bits)
+    {
+      const std::size_t rest = block_bits - shift;
+      out[index + 1] = (out[index + 1] & ~(mask >> rest)) | (bits >> rest);
+    }
+}
+
+///
+/// \brief Copies \a count bits of \a in from bit \a from on to \a out from
+/// bit \a to on, a word at a time.
+///
+void
+copy_bits (std::span<const block_type> in, std::size_t from,
+           std::span<block_type> out, std::size_t to,
+           std::size_t count) noexcept
+{
+  for (std::size_t i = 0; i < count; i += block_bits)
+    {
+      const std::size_t n = std::min (block_bits, count - i);
+      write_bits (out, to + i, read_bits (in, from + i) & low_mask (n), n);
+    }
+}
+
+} // namespace
+
+void
+transpose_stream (std::span<const block_type> in, std::span<block_type> out,
+                  std::size_t rows, std::size_t cols) noexcept
+{
+  std::array<block_type, block_bits> tile;
+  for (std::size_t r0 = 0; r0 < rows; r0 += block_bits)
+    for (std::size_t c0 = 0; c0 < cols; c0 += block_bits)
+      {
+        const std::size_t rn = std::min (block_bits, rows - r0);
+        const std::size_t cn = std::min (block_bits, cols - c0);
+        for (std::size_t i = 0; i < rn; ++i)
+          tile[i] = read_bits (in, (r0 + i) * cols + c0) & low_mask (cn);
+        std::fill (tile.begin () + rn, tile.end (), 0);
+
+        transpose64 (tile.data ());
+
+        for (std::size_t j = 0; j < cn; ++j)
+          write_bits (out, (c0 + j) * rows + r0, tile[j], rn);
+      }
+
+  // Keep the unused bits of the last block zero.
+  const std::size_t size = rows * cols;
+  if (size % block_bits != 0)
+    out[size / block_bits] &= low_mask (size % block_bits);
+}
+
+} // namespace details
+
+///
+/// Block interleaver
+///
+
+block_interleaver::block_interleaver (std::size_t rows, std::size_t cols)
+    : m_rows{ rows }, m_cols{ cols }
+{
+  if (rows == 0 || cols == 0)
+    throw interleaver_exception{ fmt::format (
+        "Cannot interleave with a {}x{} matrix.", rows, cols) };
+}
+
+void
+block_interleaver::interleave (std::span<const std::uint64_t> in,
+                               std::span<std::uint64_t> out) const
+{
+  const std::size_t blocks = details::bitmatrix::blocks_for (size ());
+  if (in.size () < blocks || out.size () < blocks)
+    throw interleaver_exception{ fmt::format (
+        "Cannot interleave {} bits with fewer than {} blocks.", size (),
+        blocks) };
+  details::transpose_stream (in, out, m_rows, m_cols);
+}
+
+void
+block_interleaver::deinterleave (std::span<const std::uint64_t> in,
+                                 std::span<std::uint64_t> out) const
+{
+  const std::size_t blocks = details::bitmatrix::blocks_for (size ());
+  if (in.size () < blocks || out.size () < blocks)
+    throw interleaver_exception{ fmt::format (
+        "Cannot deinterleave {} bits with fewer than {} blocks.", size (),
+        blocks) };
+  details::transpose_stream (in, out, m_cols, m_rows);
+}
+
+[[nodiscard]] codeword
+block_interleaver::interleave (std::span<const codeword> cwords) const
+{
+  std::size_t total = 0;
+  for (const auto &cword : cwords)
+    total += cword.vec.cols ();
+  if (total != size ())
+    throw interleaver_exception{ fmt::format (
+        "Cannot interleave {} bits with a block of {} bits.", total,
+        size ()) };
+
+  Eigen::RowVectorXi concatenated (size ());
+  std::size_t offset = 0;
+  for (const auto &cword : cwords)
+    {
+      concatenated.segment (offset, cword.vec.cols ()) = cword.vec;
+      offset += cword.vec.cols ();
+    }
+
+  std::vector<std::uint64_t> in (details::bitmatrix::blocks_for (size ()));
+  std::vector<std::uint64_t> out (in.size ());
+  details::pack (codeword{ std::move (concatenated) }, in.data ());
+  interleave (in, out);
+  return details::unpack<details::codeword_tag> (out.data (), size ());
+}
+
+[[nodiscard]] std::vector<codeword>
+block_interleaver::deinterleave (const codeword &stream) const
+{
+  if (static_cast<std::size_t> (stream.vec.cols ()) != size ())
+    throw interleaver_exception{ fmt::format (
+        "Cannot deinterleave {} bits with a block of {} bits.",
+        stream.vec.cols (), size ()) };
+
+  std::vector<std::uint64_t> in (details::bitmatrix::blocks_for (size ()));
+  std::vector<std::uint64_t> out (in.size ());
+  details::pack (stream, in.data ());
+  deinterleave (in, out);
+  const auto bits = details::unpack<details::codeword_tag> (out.data (),
+                                                             size ());
+
+  std::vector<codeword> cwords;
+  cwords.reserve (m_rows);
+  for (std::size_t r = 0; r < m_rows; ++r)
+    cwords.emplace_back (bits.vec.segment (r * m_cols, m_cols));
+  return cwords;
+}
+
+///
+/// Convolutional interleaver
+///
+
+convolutional_interleaver::convolutional_interleaver (std::size_t branches,
+                                                      std::size_t delay,
+                                                      direction_type direction)
+    : m_delay{ delay }, m_delays (branches), m_lines (branches)
+{
+  if (branches == 0)
+    throw interleaver_exception{ "Cannot interleave with 0 branches." };
+
+  for (std::size_t i = 0; i < branches; ++i)
+    {
+      const std::size_t position
+          = direction == direction_type::Interleave ? i : branches - 1 - i;
+      m_delays[i] = position * delay;
+      m_lines[i].resize (details::bitmatrix::blocks_for (m_delays[i]), 0);
+    }
+}
+
+void
+convolutional_interleaver::push (std::span<const std::uint64_t> in,
+                                 std::span<std::uint64_t> out,
+                                 std::size_t num_bits)
+{
+  const std::size_t blocks = details::bitmatrix::blocks_for (num_bits);
+  if (num_bits % branches () != 0)
+    throw interleaver_exception{ fmt::format (
+        "Cannot interleave {} bits with {} branches.", num_bits,
+        branches ()) };
+  if (in.size () < blocks || out.size () < blocks)
+    throw interleaver_exception{ fmt::format (
+        "Cannot interleave {} bits with fewer than {} blocks.", num_bits,
+        blocks) };
+  if (num_bits == 0)
+    return;
+
+  // Branch i is row i of the transposed stream.
+  const std::size_t length = num_bits / branches ();
+  m_branches_in.resize (blocks);
+  m_branches_out.resize (blocks);
+  details::transpose_stream (in, m_branches_in, length, branches ());
+
+  std::vector<std::uint64_t> joined;
+  for (std::size_t i = 0; i < branches (); ++i)
+    {
+      const std::size_t delay = m_delays[i];
+      if (delay == 0)
+        {
+          details::copy_bits (m_branches_in, i * length, m_branches_out,
+                              i * length, length);
+          continue;
+        }
+
+      // The branch is its delay line followed by its new bits. The oldest
+      // of them leave it, and the newest stay in the line.
+      joined.assign (details::bitmatrix::blocks_for (delay + length), 0);
+      details::copy_bits (m_lines[i], 0, joined, 0, delay);
+      details::copy_bits (m_branches_in, i * length, joined, delay, length);
+      details::copy_bits (joined, 0, m_branches_out, i * length, length);
+      details::copy_bits (joined, length, m_lines[i], 0, delay);
+    }
+
+  details::transpose_stream (m_branches_out, out, branches (), length);
+}
+
+[[nodiscard]] codeword
+convolutional_interleaver::push (const codeword &stream)
+{
+  const std::size_t num_bits = stream.vec.cols ();
+  std::vector<std::uint64_t> in (details::bitmatrix::blocks_for (num_bits));
+  std::vector<std::uint64_t> out (in.size ());
+  details::pack (stream, in.data ());
+  push (in, out, num_bits);
+  return details::unpack<details::codeword_tag> (out.data (), num_bits);
+}
+
+void
+convolutional_interleaver::reset () noexcept
+{
+  for (auto &line : m_lines)
+    std::fill (line.begin (), line.end (), 0);
+}
+
+} // namespace patrick
@@ -0,0 +1,668 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+
+#include <patrick/bitmatrix.h>
+#include <patrick/polar.h>
+
+namespace patrick
+{
+
+namespace
+{
+
+///
+/// \brief The check node update of min-sum decoding.
+///
+inline float
+check_node (float a, float b) noexcept
+{
+  return std::copysign (std::min (std::abs (a), std::abs (b)), a * b);
+}
+
+///
+/// \brief The variable node update, given the bit \a left of the check.
+///
+inline float
+variable_node (float a, float b, std::uint8_t left) noexcept
+{
+  return left ? b - a : b + a;
+}
+
+///
+/// \brief The logarithm of \f$\phi(x) = 1 - E[\tanh(L / 2)]\f$ for
+/// \f$L \sim N(x, 2x)\f$, approximated as by Chung.
+///
+double
+log_phi (double x) noexcept
+{
+  if (x <= 0)
+    return 0;
+  if (x < 10)
+    return std::min (0.0, -0.4527 * std::pow (x, 0.86) + 0.0218);
+  return 0.5 * std::log (std::numbers::pi / x) - x / 4
+         + std::log1p (-10 / (7 * x));
+}
+
+///
+/// \brief The mean of the log-likelihood ratio of the worse channel, when
+/// both of its inputs have mean \a mean.
+///
+double
+gaussian_minus (double mean) noexcept
+{
+  const double log_input = log_phi (mean);
+  const double target
+      = log_input + std::log (2 - std::exp (log_input)); // 1 - (1 - phi)^2
+  double low = 0;
+  double high = mean;
+  for (std::size_t i = 0; i < 60; ++i)
+    {
+      const double middle = (low + high) / 2;
+      (log_phi (middle) > target ? low : high) = middle;
+    }
+  return (low + high) / 2;
+}
+
+///
+/// \return The reliability of every bit channel, the higher the better.
+///
+std::vector<double>
+reliabilities (std::size_t m, polar_code::construction_type construction,
+               double design_snr)
+{
+  const double snr = std::pow (10.0, design_snr / 10);
+  // Starting from the channel, the worse of the two channels of a node is
+  // its left child.
+  std::vector<double> values{
+    construction == polar_code::construction_type::Bhattacharyya ? snr
+                                                                 : 4 * snr
+  };
+  for (std::size_t level = 0; level < m; ++level)
+    {
+      std::vector<double> next (2 * values.size ());
+      for (std::size_t j = 0; j < values.size (); ++j)
+        if (construction == polar_code::construction_type::Bhattacharyya)
+          {
+            // The values are -log(Z).
+            next[2 * j] = values[j] - std::log (2 - std::exp (-values[j]));
+            next[2 * j + 1] = 2 * values[j];
+          }
+        else
+          {
+            next[2 * j] = gaussian_minus (values[j]);
+            next[2 * j + 1] = 2 * values[j];
+          }
+      values = std::move (next);
+    }
+  return values;
+}
+
+codeword
+error_of (std::span<const float> llrs, std::span<const std::uint8_t> cword)
+{
+  Eigen::RowVectorXi vec (cword.size ());
+  for (std::size_t i = 0; i < cword.size (); ++i)
+    vec (i) = (llrs[i] < 0) ^ cword[i];
+  return codeword{ std::move (vec) };
+}
+
+} // namespace
+
+namespace details
+{
+
+void
+polar_transform (std::span<std::uint64_t> bits, std::size_t m) noexcept
+{
+  constexpr std::array<std::uint64_t, 6> lower_halves{
+    0x5555555555555555, 0x3333333333333333, 0x0f0f0f0f0f0f0f0f,
+    0x00ff00ff00ff00ff, 0x0000ffff0000ffff, 0x00000000ffffffff
+  };
+  const std::size_t n = std::size_t{ 1 } << m;
+  for (std::size_t s = 0; s < std::min<std::size_t> (m, 6); ++s)
+    for (auto &digit : bits)
+      digit ^= (digit >> (1u << s)) & lower_halves[s];
+  for (std::size_t half = 1; half < n / 64; half *= 2)
+    for (std::size_t start = 0; start < n / 64; start += 2 * half)
+      for (std::size_t i = start; i < start + half; ++i)
+        bits[i] ^= bits[i + half];
+}
+
+///
+/// \class list_decoder
+/// \brief The state of successive cancellation list decoding of a word.
+/// \details Every path points to a buffer of log-likelihood ratios and one
+/// of bits per depth of the tree. Buffers are reference counted, and a path
+/// which is about to write to a buffer it shares gets its own one first.
+///
+class list_decoder
+{
+public:
+  list_decoder (const polar_code &code, std::span<const float> llrs,
+                std::size_t list_size)
+      : m_code{ code }, m_llrs{ llrs }, m_list_size{ list_size },
+        m_log_size{ code.m_log_size }
+  {
+    const std::size_t n = code.properties ().word_size;
+    m_alpha.resize (m_log_size + 1);
+    m_beta.resize (m_log_size + 1);
+    for (std::size_t d = 0; d <= m_log_size; ++d)
+      {
+        m_alpha[d].reset (d == 0 ? 0 : list_size, n >> d);
+        m_beta[d].reset (list_size, n >> d);
+      }
+
+    m_paths.resize (list_size);
+    for (std::size_t p = list_size; p-- > 0;)
+      m_free_paths.push_back (p);
+    const std::size_t first = take_path ();
+    for (std::size_t d = 0; d <= m_log_size; ++d)
+      {
+        if (d > 0)
+          m_paths[first].alpha[d] = m_alpha[d].acquire ();
+        m_paths[first].beta[d] = m_beta[d].acquire ();
+      }
+  }
+
+  [[nodiscard]] polar_code::decoding_result
+  run ()
+  {
+    decode (0, 0);
+
+    std::sort (m_active.begin (), m_active.end (),
+               [this] (std::size_t p, std::size_t q) {
+                 return m_paths[p].metric < m_paths[q].metric;
+               });
+    const std::size_t n = m_code.properties ().word_size;
+    for (const std::size_t p : m_active)
+      {
+        const std::span<const std::uint8_t> cword{ beta (p, 0), n };
+        if (auto iword = m_code.information_of (cword))
+          return { .iword = std::move (*iword),
+                   .error = error_of (m_llrs, cword) };
+      }
+    throw polar_code_exception{ fmt::format (
+        "None of the {} paths satisfies the CRC.", m_active.size ()) };
+  }
+
+private:
+  using buffer_index = std::uint32_t;
+
+  ///
+  /// \brief The reference counted buffers of a depth.
+  ///
+  template <typename T> struct buffer_pool
+  {
+    std::vector<T> storage;
+    std::vector<buffer_index> references;
+    std::vector<buffer_index> available;
+    std::size_t size{ 0 };
+
+    void
+    reset (std::size_t count, std::size_t buffer_size)
+    {
+      size = buffer_size;
+      storage.assign (count * buffer_size, T{});
+      references.assign (count, 0);
+      available.resize (count);
+      std::iota (available.rbegin (), available.rend (), 0);
+    }
+
+    [[nodiscard]] T *
+    at (buffer_index b) noexcept
+    {
+      return storage.data () + b * size;
+    }
+
+    [[nodiscard]] buffer_index
+    acquire ()
+    {
+      assert (!available.empty ());
+      const buffer_index b = available.back ();
+      available.pop_back ();
+      references[b] = 1;
+      return b;
+    }
+
+    void
+    release (buffer_index b)
+    {
+      if (--references[b] == 0)
+        available.push_back (b);
+    }
+
+    ///
+    /// \brief Makes \a b a buffer which is not shared, copying its contents
+    /// if \a keep.
+    ///
+    T *
+    writable (buffer_index &b, bool keep)
+    {
+      if (references[b] > 1)
+        {
+          const buffer_index own = acquire ();
+          if (keep)
+            std::copy_n (at (b), size, at (own));
+          release (b);
+          b = own;
+        }
+      return at (b);
+    }
+  };
+
+  struct path
+  {
+    float metric{ 0 };
+    std::array<buffer_index, polar_code::max_log_size + 1> alpha{};
+    std::array<buffer_index, polar_code::max_log_size + 1> beta{};
+  };
+
+  [[nodiscard]] std::size_t
+  take_path ()
+  {
+    const std::size_t p = m_free_paths.back ();
+    m_free_paths.pop_back ();
+    m_active.push_back (p);
+    return p;
+  }
+
+  [[nodiscard]] std::size_t
+  clone (std::size_t p)
+  {
+    const std::size_t q = take_path ();
+    m_paths[q] = m_paths[p];
+    for (std::size_t d = 0; d <= m_log_size; ++d)
+      {
+        if (d > 0)
+          ++m_alpha[d].references[m_paths[q].alpha[d]];
+        ++m_beta[d].references[m_paths[q].beta[d]];
+      }
+    return q;
+  }
+
+  void
+  kill (std::size_t p)
+  {
+    for (std::size_t d = 0; d <= m_log_size; ++d)
+      {
+        if (d > 0)
+          m_alpha[d].release (m_paths[p].alpha[d]);
+        m_beta[d].release (m_paths[p].beta[d]);
+      }
+    std::erase (m_active, p);
+    m_free_paths.push_back (p);
+  }
+
+  [[nodiscard]] const float *
+  alpha (std::size_t p, std::size_t d) noexcept
+  {
+    return d == 0 ? m_llrs.data () : m_alpha[d].at (m_paths[p].alpha[d]);
+  }
+
+  [[nodiscard]] const std::uint8_t *
+  beta (std::size_t p, std::size_t d) noexcept
+  {
+    return m_beta[d].at (m_paths[p].beta[d]);
+  }
+
+  ///
+  /// \pre \a d is not 0, since the channel values are never written.
+  ///
+  [[nodiscard]] float *
+  writable_alpha (std::size_t p, std::size_t d)
+  {
+    return m_alpha[d].writable (m_paths[p].alpha[d], false);
+  }
+
+  [[nodiscard]] std::uint8_t *
+  writable_beta (std::size_t p, std::size_t d, bool keep)
+  {
+    return m_beta[d].writable (m_paths[p].beta[d], keep);
+  }
+
+  void
+  decode (std::size_t d, std::size_t j)
+  {
+    const std::size_t size = std::size_t{ 1 } << (m_log_size - d);
+    const std::size_t half = size / 2;
+    if (m_code.type_of (d, j) == polar_code::node_type::RateZero)
+      {
+        // Every frozen bit which the path disagrees with is a penalty.
+        for (const std::size_t p : m_active)
+          {
+            const float *a = alpha (p, d);
+            for (std::size_t i = 0; i < size; ++i)
+              m_paths[p].metric += std::max (0.0f, -a[i]);
+            std::uint8_t *b = writable_beta (p, d, false);
+            std::fill_n (b, size, 0);
+          }
+        return;
+      }
+    if (d == m_log_size)
+      {
+        split ();
+        return;
+      }
+
+    for (const std::size_t p : m_active)
+      {
+        const float *a = alpha (p, d);
+        float *child = writable_alpha (p, d + 1);
+        for (std::size_t i = 0; i < half; ++i)
+          child[i] = check_node (a[i], a[half + i]);
+      }
+    decode (d + 1, 2 * j);
+
+    for (const std::size_t p : m_active)
+      {
+        std::uint8_t *b = writable_beta (p, d, false);
+        std::copy_n (beta (p, d + 1), half, b);
+        const float *a = alpha (p, d);
+        float *child = writable_alpha (p, d + 1);
+        for (std::size_t i = 0; i < half; ++i)
+          child[i] = variable_node (a[i], a[half + i], b[i]);
+      }
+    decode (d + 1, 2 * j + 1);
+
+    for (const std::size_t p : m_active)
+      {
+        std::uint8_t *b = writable_beta (p, d, true);
+        const std::uint8_t *right = beta (p, d + 1);
+        for (std::size_t i = 0; i < half; ++i)
+          {
+            b[i] ^= right[i];
+            b[half + i] = right[i];
+          }
+      }
+  }
+
+  ///
+  /// \brief Extends every path with both values of an information bit and
+  /// keeps the best \ref m_list_size of them.
+  ///
+  void
+  split ()
+  {
+    struct candidate
+    {
+      float metric;
+      std::size_t path;
+      std::uint8_t bit;
+    };
+    std::vector<candidate> candidates;
+    for (const std::size_t p : m_active)
+      {
+        const float a = alpha (p, m_log_size)[0];
+        const float metric = m_paths[p].metric;
+        candidates.push_back ({ metric + std::max (0.0f, -a), p, 0 });
+        candidates.push_back ({ metric + std::max (0.0f, a), p, 1 });
+      }
+    if (candidates.size () > m_list_size)
+      {
+        std::nth_element (candidates.begin (),
+                          candidates.begin () + m_list_size - 1,
+                          candidates.end (),
+                          [] (const candidate &x, const candidate &y) {
+                            return x.metric < y.metric;
+                          });
+        candidates.resize (m_list_size);
+      }
+
+    // Kill the paths without a continuation first, so that their buffers
+    // are available to the ones with two.
+    std::vector<std::uint8_t> continuations (m_list_size, 0);
+    for (const auto &c : candidates)
+      ++continuations[c.path];
+    for (const std::size_t p : std::vector<std::size_t>{ m_active })
+      if (continuations[p] == 0)
+        kill (p);
+
+    std::vector<bool> taken (m_list_size, false);
+    for (const auto &c : candidates)
+      {
+        std::size_t p = c.path;
+        if (taken[p])
+          p = clone (p);
+        taken[p] = true;
+        m_paths[p].metric = c.metric;
+        *writable_beta (p, m_log_size, false) = c.bit;
+      }
+  }
+
+private:
+  const polar_code &m_code;
+  std::span<const float> m_llrs;
+  std::size_t m_list_size;
+  std::size_t m_log_size;
+
+  std::vector<buffer_pool<float> > m_alpha;
+  std::vector<buffer_pool<std::uint8_t> > m_beta;
+
+  std::vector<path> m_paths;
+  std::vector<std::size_t> m_active;
+  std::vector<std::size_t> m_free_paths;
+};
+
+} // namespace details
+
+///
+/// Constructors
+///
+
+polar_code::polar_code (std::size_t m, std::size_t k,
+                        construction_type construction, double design_snr,
+                        std::uint64_t crc)
+    : m_log_size{ m }
+{
+  const std::size_t crc_size = crc == 0 ? 0 : std::bit_width (crc) - 1;
+  if (m == 0 || m > max_log_size || k == 0 || (crc != 0 && crc_size == 0)
+      || k + crc_size > (std::size_t{ 1 } << m))
+    throw polar_code_exception{ fmt::format (
+        "Cannot instantiate a polar code of length 2^{} with {} information "
+        "and {} CRC bits.",
+        m, k, crc_size) };
+
+  const std::size_t n = std::size_t{ 1 } << m;
+  m_properties = properties_type{
+    .word_size = n, .basis_size = k, .crc_size = crc_size
+  };
+  if (crc != 0)
+    m_crc.emplace (k + crc_size, std::span{ &crc, 1 });
+
+  // The most reliable channels carry information, ties going to the later
+  // ones.
+  const auto reliability = reliabilities (m, construction, design_snr);
+  std::vector<std::size_t> order (n);
+  std::iota (order.begin (), order.end (), 0);
+  std::stable_sort (order.begin (), order.end (),
+                    [&reliability] (std::size_t i, std::size_t j) {
+                      return reliability[i] > reliability[j]
+                             || (reliability[i] == reliability[j] && i > j);
+                    });
+  m_frozen.assign (n, true);
+  for (std::size_t i = 0; i < k + crc_size; ++i)
+    m_frozen[order[i]] = false;
+  for (std::size_t i = 0; i < n; ++i)
+    if (!m_frozen[i])
+      m_information_set.push_back (i);
+
+  std::vector<std::size_t> prefix (n + 1, 0);
+  for (std::size_t i = 0; i < n; ++i)
+    prefix[i + 1] = prefix[i] + !m_frozen[i];
+  m_node_types.resize (2 * n);
+  for (std::size_t d = 0; d <= m; ++d)
+    {
+      const std::size_t size = n >> d;
+      for (std::size_t j = 0; j < (std::size_t{ 1 } << d); ++j)
+        {
+          const std::size_t first = j * size;
+          const std::size_t last = first + size - 1;
+          const std::size_t count = prefix[last + 1] - prefix[first];
+          node_type type = node_type::Other;
+          if (count == 0)
+            type = node_type::RateZero;
+          else if (count == size)
+            type = node_type::RateOne;
+          else if (count == 1 && !m_frozen[last])
+            type = node_type::Repetition;
+          else if (count == size - 1 && m_frozen[first])
+            type = node_type::SingleParityCheck;
+          m_node_types[(std::size_t{ 1 } << d) + j] = type;
+        }
+    }
+}
+
+///
+/// Operations
+///
+
+codeword
+polar_code::encode (const infoword &iword) const
+{
+  const std::size_t k = m_properties.basis_size;
+  if (static_cast<std::size_t> (iword.vec.cols ()) != k)
+    throw polar_code_exception{ fmt::format (
+        "Cannot encode a word of {} bits with a code of dimension {}.",
+        iword.vec.cols (), k) };
+
+  const std::size_t n = m_properties.word_size;
+  std::vector<std::uint64_t> u (details::bitmatrix::blocks_for (n), 0);
+  auto set = [&u] (std::size_t i, int bit) {
+    u[i / 64] |= std::uint64_t (bit & 1) << (i % 64);
+  };
+  for (std::size_t j = 0; j < k; ++j)
+    set (m_information_set[j], iword.vec (j));
+  if (m_crc)
+    {
+      const codeword check = m_crc->encode (iword);
+      for (std::size_t j = 0; j < m_properties.crc_size; ++j)
+        set (m_information_set[k + j], check.vec (j));
+    }
+
+  details::polar_transform (u, m_log_size);
+  return details::unpack<details::codeword_tag> (u.data (), n);
+}
+
+polar_code::decoding_result
+polar_code::decode (const codeword &cword, std::size_t list_size) const
+{
+  std::vector<float> llrs (cword.vec.cols ());
+  for (std::size_t i = 0; i < llrs.size (); ++i)
+    llrs[i] = cword.vec (i) ? -1.0f : 1.0f;
+  return decode_soft (llrs, list_size);
+}
+
+polar_code::decoding_result
+polar_code::decode_soft (std::span<const float> llrs,
+                         std::size_t list_size) const
+{
+  const std::size_t n = m_properties.word_size;
+  if (llrs.size () != n || list_size == 0)
+    throw polar_code_exception{ fmt::format (
+        "Cannot decode {} values with {} paths for a code of length {}.",
+        llrs.size (), list_size, n) };
+
+  if (list_size > 1)
+    return details::list_decoder{ *this, llrs, list_size }.run ();
+
+  std::vector<float> scratch (n);
+  std::vector<std::uint8_t> cword (n);
+  decode_fast (0, 0, llrs, cword, scratch);
+  auto iword = information_of (cword);
+  if (!iword)
+    throw polar_code_exception{ "The decoded word does not satisfy the CRC." };
+  return { .iword = std::move (*iword), .error = error_of (llrs, cword) };
+}
+
+void
+polar_code::decode_fast (std::size_t depth, std::size_t index,
+                         std::span<const float> alpha,
+                         std::span<std::uint8_t> beta,
+                         std::vector<float> &scratch) const
+{
+  switch (type_of (depth, index))
+    {
+    case node_type::RateZero:
+      std::fill (beta.begin (), beta.end (), 0);
+      return;
+    case node_type::RateOne:
+      for (std::size_t i = 0; i < alpha.size (); ++i)
+        beta[i] = alpha[i] < 0;
+      return;
+    case node_type::Repetition:
+      {
+        const float sum = std::accumulate (alpha.begin (), alpha.end (), 0.0f);
+        std::fill (beta.begin (), beta.end (), sum < 0);
+        return;
+      }
+    case node_type::SingleParityCheck:
+      {
+        std::uint8_t parity = 0;
+        std::size_t weakest = 0;
+        for (std::size_t i = 0; i < alpha.size (); ++i)
+          {
+            beta[i] = alpha[i] < 0;
+            parity ^= beta[i];
+            if (std::abs (alpha[i]) < std::abs (alpha[weakest]))
+              weakest = i;
+          }
+        beta[weakest] ^= parity;
+        return;
+      }
+    case node_type::Other:
+      break;
+    }
+
+  // The log-likelihood ratios of the children of depth d + 1 are at
+  // n - 2^(m - d) in the scratch.
+  const std::size_t half = alpha.size () / 2;
+  const std::span<float> child{ scratch.data () + scratch.size ()
+                                    - alpha.size (),
+                                half };
+  for (std::size_t i = 0; i < half; ++i)
+    child[i] = check_node (alpha[i], alpha[half + i]);
+  decode_fast (depth + 1, 2 * index, child, beta.first (half), scratch);
+  for (std::size_t i = 0; i < half; ++i)
+    child[i] = variable_node (alpha[i], alpha[half + i], beta[i]);
+  decode_fast (depth + 1, 2 * index + 1, child, beta.last (half), scratch);
+  for (std::size_t i = 0; i < half; ++i)
+    beta[i] ^= beta[half + i];
+}
+
+std::optional<infoword>
+polar_code::information_of (std::span<const std::uint8_t> cword) const
+{
+  const std::size_t n = m_properties.word_size;
+  std::vector<std::uint64_t> u (details::bitmatrix::blocks_for (n), 0);
+  for (std::size_t i = 0; i < n; ++i)
+    u[i / 64] |= std::uint64_t{ cword[i] } << (i % 64);
+  details::polar_transform (u, m_log_size);
+  auto bit = [&] (std::size_t j) {
+    const std::size_t i = m_information_set[j];
+    return static_cast<int> ((u[i / 64] >> (i % 64)) & 1u);
+  };
+
+  const std::size_t k = m_properties.basis_size;
+  Eigen::RowVectorXi message (k);
+  for (std::size_t j = 0; j < k; ++j)
+    message (j) = bit (j);
+  if (m_crc)
+    {
+      // The CRC is the remainder in the low positions of the cyclic code.
+      const std::size_t r = m_properties.crc_size;
+      Eigen::RowVectorXi check (k + r);
+      for (std::size_t j = 0; j < r; ++j)
+        check (j) = bit (k + j);
+      check.tail (k) = message;
+      if (!m_crc->contains (codeword{ std::move (check) }))
+        return std::nullopt;
+    }
+  return infoword{ std::move (message) };
+}
+
+} // namespace patrick
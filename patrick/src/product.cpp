@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+#include <patrick/product.h>
+
+namespace patrick
+{
+
+namespace
+{
+
+///
+/// \brief The weights of the extrinsic information in consecutive half
+/// iterations of soft decoding, and of the reliability of bits which have
+/// no competitor, as proposed by Pyndiah.
+///
+constexpr std::array<float, 8> extrinsic_weights{ 0.2f, 0.3f, 0.5f, 0.7f,
+                                                  0.9f, 1.0f, 1.0f, 1.0f };
+constexpr std::array<float, 8> fallback_weights{ 0.2f, 0.4f, 0.6f, 0.8f,
+                                                 1.0f, 1.0f, 1.0f, 1.0f };
+
+///
+/// \brief The pairs of hard passes which clean up the decisions of soft
+/// decoding at most. Hard passes may flip the same bits back and forth
+/// forever, so they are bounded like the ones of \ref product_code::decode.
+///
+constexpr std::size_t clean_up_iterations = 8;
+
+///
+/// \brief Calls \a f with every index below \a count, splitting them into
+/// contiguous ranges for up to \a num_threads threads. The first exception
+/// of \a f stops the other ranges and is thrown once the threads are joined.
+///
+template <typename Function>
+void
+parallel_for (std::size_t count, std::size_t num_threads, Function f)
+{
+  const std::size_t workers = std::min (count, num_threads);
+  if (workers <= 1)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+        f (i);
+      return;
+    }
+
+  std::mutex mutex;
+  std::exception_ptr failure;
+  std::atomic<bool> failed{ false };
+  const auto run_range = [&] (std::size_t first, std::size_t last) {
+    try
+      {
+        for (std::size_t i = first;
+             i < last && !failed.load (std::memory_order_relaxed); ++i)
+          f (i);
+      }
+    catch (...)
+      {
+        std::scoped_lock lock{ mutex };
+        if (!failure)
+          failure = std::current_exception ();
+        failed = true;
+      }
+  };
+
+  const std::size_t chunk = (count + workers - 1) / workers;
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve (workers - 1);
+    for (std::size_t start = chunk; start < count; start += chunk)
+      threads.emplace_back (run_range, start, std::min (start + chunk, count));
+    run_range (0, chunk);
+  }
+  if (failure)
+    std::rethrow_exception (failure);
+}
+
+///
+/// \brief Decodes a line with the fast decoder of its component code.
+/// \return The nearest codeword, if the decoder finds one.
+///
+std::optional<codeword>
+decode_line (linearcode &code, const codeword &line)
+{
+  using enum linearcode::decoding_strategy;
+  try
+    {
+      const auto result
+          = code.family ().kind == linearcode::code_family::Generic
+                ? code.decode<Syndromes> (line)
+                : code.decode<Auto> (line);
+      return line + result.error;
+    }
+  catch (const linearcode_exception &)
+    {
+      return std::nullopt;
+    }
+}
+
+///
+/// \brief The Chase-Pyndiah decoder of a line.
+/// \param input The log-likelihood ratios of the line.
+/// \param extrinsic The extrinsic information of the bits is written here.
+/// \param decision The decided codeword is written here.
+///
+template <typename In, typename Out, typename Bits>
+void
+chase_pyndiah (linearcode &code, const In &input, Out extrinsic,
+               Bits decision, float fallback, std::size_t chase_positions)
+{
+  const std::size_t n = input.size ();
+  Eigen::RowVectorXi hard (n);
+  for (std::size_t i = 0; i < n; ++i)
+    hard (i) = input (i) < 0;
+
+  std::vector<std::size_t> weakest (n);
+  std::iota (weakest.begin (), weakest.end (), 0);
+  const std::size_t p = std::min (chase_positions, n);
+  std::partial_sort (weakest.begin (), weakest.begin () + p, weakest.end (),
+                     [&input] (std::size_t i, std::size_t j) {
+                       return std::abs (input (i)) < std::abs (input (j));
+                     });
+
+  // The metric of a candidate is the total reliability of the hard
+  // decisions which it contradicts.
+  std::vector<Eigen::RowVectorXi> candidates;
+  std::vector<float> metrics;
+  for (std::size_t pattern = 0; pattern < (std::size_t{ 1 } << p); ++pattern)
+    {
+      codeword test{ hard };
+      for (std::size_t b = 0; b < p; ++b)
+        if ((pattern >> b) & 1)
+          test.vec (weakest[b]) ^= 1;
+      const auto candidate = decode_line (code, test);
+      if (!candidate)
+        continue;
+      float metric = 0;
+      for (std::size_t i = 0; i < n; ++i)
+        if (candidate->vec (i) != hard (i))
+          metric += std::abs (input (i));
+      candidates.push_back (candidate->vec);
+      metrics.push_back (metric);
+    }
+  if (candidates.empty ())
+    {
+      candidates.push_back (hard);
+      metrics.push_back (0);
+    }
+
+  const std::size_t best
+      = std::min_element (metrics.begin (), metrics.end ()) - metrics.begin ();
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      const int bit = candidates[best] (i);
+      float competitor = std::numeric_limits<float>::infinity ();
+      for (std::size_t c = 0; c < candidates.size (); ++c)
+        if (candidates[c] (i) != bit)
+          competitor = std::min (competitor, metrics[c]);
+
+      const float sign = bit ? -1.0f : 1.0f;
+      decision (i) = bit;
+      extrinsic (i) = std::isinf (competitor)
+                          ? sign * fallback
+                          : sign * (competitor - metrics[best]) - input (i);
+    }
+}
+
+} // namespace
+
+///
+/// Constructors
+///
+
+product_code::product_code (linearcode row_code, linearcode column_code,
+                            std::size_t num_threads)
+    : m_row_code{ std::move (row_code) },
+      m_column_code{ std::move (column_code) },
+      m_num_threads{ num_threads == 0
+                         ? std::max (1u, std::thread::hardware_concurrency ())
+                         : num_threads }
+{
+  const auto &rows = m_row_code.properties ();
+  const auto &columns = m_column_code.properties ();
+  m_properties = properties_type{
+    .word_size = rows.word_size * columns.word_size,
+    .basis_size = rows.basis_size * columns.basis_size,
+    .min_distance = rows.min_distance * columns.min_distance,
+  };
+
+  // Build the tables of the component decoders before any thread uses them.
+  // Should they be evicted, linearcode builds them again once for all
+  // threads.
+  (void)decode_line (m_row_code,
+                     codeword{ Eigen::RowVectorXi::Zero (rows.word_size) });
+  (void)decode_line (m_column_code,
+                     codeword{ Eigen::RowVectorXi::Zero (columns.word_size) });
+}
+
+///
+/// Operations
+///
+
+bool
+product_code::contains (const codeword &cword) const
+{
+  const std::size_t n1 = m_row_code.properties ().word_size;
+  const std::size_t n2 = m_column_code.properties ().word_size;
+  if (static_cast<std::size_t> (cword.vec.cols ()) != n1 * n2)
+    return false;
+
+  const Eigen::Map<const bit_matrix> bits (cword.vec.data (), n2, n1);
+  for (std::size_t r = 0; r < n2; ++r)
+    if (!m_row_code.contains (codeword{ bits.row (r) }))
+      return false;
+  for (std::size_t c = 0; c < n1; ++c)
+    if (!m_column_code.contains (codeword{ bits.col (c).transpose () }))
+      return false;
+  return true;
+}
+
+codeword
+product_code::encode (const infoword &iword) const
+{
+  const std::size_t k1 = m_row_code.properties ().basis_size;
+  const std::size_t k2 = m_column_code.properties ().basis_size;
+  const std::size_t n1 = m_row_code.properties ().word_size;
+  const std::size_t n2 = m_column_code.properties ().word_size;
+  if (static_cast<std::size_t> (iword.vec.cols ()) != k1 * k2)
+    throw product_code_exception{ fmt::format (
+        "Cannot encode a word of {} bits with a code of dimension {}.",
+        iword.vec.cols (), k1 * k2) };
+
+  const Eigen::Map<const bit_matrix> message (iword.vec.data (), k2, k1);
+  bit_matrix rows (k2, n1);
+  for (std::size_t r = 0; r < k2; ++r)
+    rows.row (r) = m_row_code.encode (infoword{ message.row (r) }).vec;
+
+  Eigen::RowVectorXi result (n1 * n2);
+  Eigen::Map<bit_matrix> bits (result.data (), n2, n1);
+  for (std::size_t c = 0; c < n1; ++c)
+    bits.col (c) = m_column_code.encode (infoword{ rows.col (c).transpose () })
+                       .vec.transpose ();
+  return codeword{ std::move (result) };
+}
+
+product_code::decoding_result
+product_code::decode (const codeword &cword, std::size_t max_iterations)
+{
+  const std::size_t n1 = m_row_code.properties ().word_size;
+  const std::size_t n2 = m_column_code.properties ().word_size;
+  if (static_cast<std::size_t> (cword.vec.cols ()) != n1 * n2)
+    throw product_code_exception{ fmt::format (
+        "Cannot decode a word of {} bits with a code of length {}.",
+        cword.vec.cols (), n1 * n2) };
+
+  bit_matrix bits = Eigen::Map<const bit_matrix> (cword.vec.data (), n2, n1);
+  for (std::size_t iteration = 0; iteration < max_iterations; ++iteration)
+    if (!hard_iteration (bits))
+      break;
+  return result_of (bits, cword);
+}
+
+product_code::decoding_result
+product_code::decode_soft (std::span<const float> llrs,
+                           std::size_t iterations, std::size_t chase_positions)
+{
+  const std::size_t n1 = m_row_code.properties ().word_size;
+  const std::size_t n2 = m_column_code.properties ().word_size;
+  if (llrs.size () != n1 * n2)
+    throw product_code_exception{ fmt::format (
+        "Cannot decode {} values with a code of length {}.", llrs.size (),
+        n1 * n2) };
+
+  const soft_matrix channel
+      = Eigen::Map<const soft_matrix> (llrs.data (), n2, n1);
+  soft_matrix extrinsic = soft_matrix::Zero (n2, n1);
+  // Without soft passes, the hard decisions are cleaned up on their own.
+  bit_matrix decisions = (channel.array () < 0).cast<int> ();
+  for (std::size_t half = 0; half < 2 * iterations; ++half)
+    {
+      const std::size_t step = std::min (half, extrinsic_weights.size () - 1);
+      const soft_matrix input = channel + extrinsic_weights[step] * extrinsic;
+      const float fallback
+          = fallback_weights[step] * input.cwiseAbs ().mean ();
+      soft_pass (input, extrinsic, decisions, half % 2 == 1, fallback,
+                 chase_positions);
+    }
+
+  Eigen::RowVectorXi hard (n1 * n2);
+  for (std::size_t i = 0; i < n1 * n2; ++i)
+    hard (i) = llrs[i] < 0;
+  for (std::size_t iteration = 0; iteration < clean_up_iterations;
+       ++iteration)
+    if (!hard_iteration (decisions))
+      break;
+  return result_of (decisions, codeword{ std::move (hard) });
+}
+
+bool
+product_code::hard_iteration (bit_matrix &bits)
+{
+  const std::size_t n1 = m_row_code.properties ().word_size;
+  const std::size_t n2 = m_column_code.properties ().word_size;
+
+  // Threads write to separate lines, so they only share the flag.
+  std::atomic<bool> changed{ false };
+  parallel_for (n2, m_num_threads, [&] (std::size_t r) {
+    const codeword line{ bits.row (r) };
+    const auto decoded = decode_line (m_row_code, line);
+    if (decoded && decoded->vec != line.vec)
+      {
+        bits.row (r) = decoded->vec;
+        changed.store (true, std::memory_order_relaxed);
+      }
+  });
+  parallel_for (n1, m_num_threads, [&] (std::size_t c) {
+    const codeword line{ bits.col (c).transpose () };
+    const auto decoded = decode_line (m_column_code, line);
+    if (decoded && decoded->vec != line.vec)
+      {
+        bits.col (c) = decoded->vec.transpose ();
+        changed.store (true, std::memory_order_relaxed);
+      }
+  });
+  return changed.load ();
+}
+
+void
+product_code::soft_pass (const soft_matrix &input, soft_matrix &extrinsic,
+                         bit_matrix &decisions, bool columns, float fallback,
+                         std::size_t chase_positions)
+{
+  if (columns)
+    parallel_for (input.cols (), m_num_threads, [&] (std::size_t c) {
+      chase_pyndiah (m_column_code, input.col (c), extrinsic.col (c),
+                     decisions.col (c), fallback, chase_positions);
+    });
+  else
+    parallel_for (input.rows (), m_num_threads, [&] (std::size_t r) {
+      chase_pyndiah (m_row_code, input.row (r), extrinsic.row (r),
+                     decisions.row (r), fallback, chase_positions);
+    });
+}
+
+product_code::decoding_result
+product_code::result_of (const bit_matrix &bits,
+                         const codeword &received) const
+{
+  const std::size_t n1 = m_row_code.properties ().word_size;
+  const std::size_t n2 = m_column_code.properties ().word_size;
+  codeword decoded{ Eigen::Map<const Eigen::RowVectorXi> (bits.data (),
+                                                         n1 * n2) };
+  if (!contains (decoded))
+    throw product_code_exception{
+      "The word could not be decoded to a codeword of the product code."
+    };
+
+  // The information bits are at the information positions of both codes.
+  const std::size_t k1 = m_row_code.properties ().basis_size;
+  const std::size_t k2 = m_column_code.properties ().basis_size;
+  const auto &row_positions = m_row_code.permutation ();
+  const auto &column_positions = m_column_code.permutation ();
+  Eigen::RowVectorXi message (k1 * k2);
+  for (std::size_t r = 0; r < k2; ++r)
+    for (std::size_t c = 0; c < k1; ++c)
+      message (r * k1 + c) = bits (column_positions[r], row_positions[c]);
+
+  return decoding_result{ .iword = infoword{ std::move (message) },
+                          .error = received + decoded };
+}
+
+} // namespace patrick
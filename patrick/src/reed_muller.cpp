@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <patrick/core.h>
+#include <patrick/cpu.h>
+#include <patrick/reed_muller.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+namespace
+{
+
+template <typename T>
+void
+hadamard_stage (T *values, std::size_t n, std::size_t half)
+{
+  for (std::size_t i = 0; i < n; i += 2 * half)
+    for (std::size_t j = i; j < i + half; ++j)
+      {
+        const T a = values[j];
+        const T b = values[j + half];
+        values[j] = a + b;
+        values[j + half] = a - b;
+      }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+///
+/// \brief The AVX2 vector operations on a type of correlations.
+///
+template <typename T> struct avx2_lanes;
+
+template <> struct avx2_lanes<std::int16_t>
+{
+  static constexpr std::size_t width = 16;
+
+  __attribute__ ((target ("avx2"))) static void
+  butterfly (std::int16_t *a, std::int16_t *b)
+  {
+    const __m256i x = _mm256_loadu_si256 (reinterpret_cast<__m256i *> (a));
+    const __m256i y = _mm256_loadu_si256 (reinterpret_cast<__m256i *> (b));
+    _mm256_storeu_si256 (reinterpret_cast<__m256i *> (a),
+                         _mm256_add_epi16 (x, y));
+    _mm256_storeu_si256 (reinterpret_cast<__m256i *> (b),
+                         _mm256_sub_epi16 (x, y));
+  }
+};
+
+template <> struct avx2_lanes<std::int32_t>
+{
+  static constexpr std::size_t width = 8;
+
+  __attribute__ ((target ("avx2"))) static void
+  butterfly (std::int32_t *a, std::int32_t *b)
+  {
+    const __m256i x = _mm256_loadu_si256 (reinterpret_cast<__m256i *> (a));
+    const __m256i y = _mm256_loadu_si256 (reinterpret_cast<__m256i *> (b));
+    _mm256_storeu_si256 (reinterpret_cast<__m256i *> (a),
+                         _mm256_add_epi32 (x, y));
+    _mm256_storeu_si256 (reinterpret_cast<__m256i *> (b),
+                         _mm256_sub_epi32 (x, y));
+  }
+};
+
+template <> struct avx2_lanes<float>
+{
+  static constexpr std::size_t width = 8;
+
+  __attribute__ ((target ("avx2"))) static void
+  butterfly (float *a, float *b)
+  {
+    const __m256 x = _mm256_loadu_ps (a);
+    const __m256 y = _mm256_loadu_ps (b);
+    _mm256_storeu_ps (a, _mm256_add_ps (x, y));
+    _mm256_storeu_ps (b, _mm256_sub_ps (x, y));
+  }
+};
+
+template <typename T>
+__attribute__ ((target ("avx2"))) void
+fast_hadamard_transform_avx2 (std::span<T> values)
+{
+  using lanes = avx2_lanes<T>;
+  const std::size_t n = values.size ();
+  T *data = values.data ();
+
+  // The butterflies of the first stages are narrower than a vector.
+  std::size_t half = 1;
+  for (; half < n && half < lanes::width; half *= 2)
+    hadamard_stage (data, n, half);
+  for (; half < n; half *= 2)
+    for (std::size_t i = 0; i < n; i += 2 * half)
+      for (std::size_t j = i; j < i + half; j += lanes::width)
+        lanes::butterfly (data + j, data + j + half);
+}
+
+#endif
+
+///
+/// \return The position of the largest magnitude among the transformed
+/// correlations, and whether the value there is negative.
+///
+template <typename T>
+[[nodiscard]] std::pair<std::size_t, bool>
+strongest_of (std::span<const T> transformed)
+{
+  std::size_t best = 0;
+  for (std::size_t a = 1; a < transformed.size (); ++a)
+    if (std::abs (transformed[a]) > std::abs (transformed[best]))
+      best = a;
+  return { best, transformed[best] < 0 };
+}
+
+///
+/// \return The codeword of \f$RM(1, m)\f$ whose bit at position \f$p\f$ is
+/// \f$\langle a, p \rangle + c\f$.
+///
+[[nodiscard]] codeword
+affine_word (std::size_t n, std::size_t a, bool complement)
+{
+  codeword result{ Eigen::RowVectorXi::Zero (n) };
+  for (std::size_t p = 0; p < n; ++p)
+    result.vec (p) = (std::popcount (a & p) & 1) ^ complement;
+  return result;
+}
+
+///
+/// \brief Correlates the hard decisions of \a cword with every codeword of
+/// \f$RM(1, m)\f$ in the range of \a T.
+///
+template <typename T>
+[[nodiscard]] std::pair<std::size_t, bool>
+correlate (const codeword &cword, std::size_t n)
+{
+  std::vector<T> values (n);
+  for (std::size_t p = 0; p < n; ++p)
+    values[p] = (cword.vec (p) & 1) ? T (-1) : T (1);
+  fast_hadamard_transform<T> (values);
+  return strongest_of<T> (values);
+}
+
+} // namespace
+
+template <typename T>
+void
+fast_hadamard_transform_scalar (std::span<T> values)
+{
+  assert (std::has_single_bit (values.size ()));
+  for (std::size_t half = 1; half < values.size (); half *= 2)
+    hadamard_stage (values.data (), values.size (), half);
+}
+
+template <typename T>
+void
+fast_hadamard_transform (std::span<T> values)
+{
+  assert (std::has_single_bit (values.size ()));
+#if defined(__x86_64__) || defined(__i386__)
+  if (cpu ().avx2)
+    return fast_hadamard_transform_avx2 (values);
+#endif
+  fast_hadamard_transform_scalar (values);
+}
+
+template void fast_hadamard_transform (std::span<std::int16_t>);
+template void fast_hadamard_transform (std::span<std::int32_t>);
+template void fast_hadamard_transform (std::span<float>);
+template void fast_hadamard_transform_scalar (std::span<std::int16_t>);
+template void fast_hadamard_transform_scalar (std::span<std::int32_t>);
+template void fast_hadamard_transform_scalar (std::span<float>);
+
+} // namespace details
+
+///
+/// Decoding
+///
+
+void
+linearcode::ensure_reed_muller (std::size_t max_order) const
+{
+  if (m_family.kind != code_family::ReedMuller || m_family.r > max_order)
+    throw linearcode_exception{ fmt::format (
+        "Cannot decode {} code with a Reed-Muller decoder of order up to {}.",
+        m_properties.special_name, max_order) };
+}
+
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_with_hadamard (const codeword &cword) const
+{
+  ensure_reed_muller (1);
+  if (m_family_code)
+    return decode_shortened (cword, &linearcode::decode_with_hadamard);
+  ensure_word_size (cword);
+
+  // Each correlation is at most n in magnitude.
+  const std::size_t n = m_packed_generator.cols ();
+  const auto [a, complement]
+      = n <= std::numeric_limits<std::int16_t>::max ()
+            ? details::correlate<std::int16_t> (cword, n)
+            : details::correlate<std::int32_t> (cword, n);
+
+  const codeword decoded = details::affine_word (n, a, complement);
+  return decoding_result{ .iword = information_of (decoded),
+                          .error = cword + decoded };
+}
+
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_with_majority (const codeword &cword) const
+{
+  ensure_reed_muller (m_family.m);
+  if (m_family_code)
+    return decode_shortened (cword, &linearcode::decode_with_majority);
+  ensure_word_size (cword);
+
+  const std::size_t n = m_packed_generator.cols ();
+  std::vector<std::uint8_t> residual (n);
+  for (std::size_t p = 0; p < n; ++p)
+    residual[p] = cword.vec (p) & 1;
+
+  // The coefficient of a monomial x_M of degree d, once the monomials of
+  // higher degree are removed, is the sum of the bits over any coset of the
+  // subspace spanned by M. There are 2^(m - d) disjoint ones which vote.
+  std::vector<std::uint8_t> votes (n);
+  std::vector<std::size_t> present;
+  for (std::size_t degree = m_family.r + 1; degree-- > 0;)
+    {
+      present.clear ();
+      for (std::size_t mask = 0; mask < n; ++mask)
+        {
+          if (static_cast<std::size_t> (std::popcount (mask)) != degree)
+            continue;
+
+          std::fill (votes.begin (), votes.end (), 0);
+          for (std::size_t p = 0; p < n; ++p)
+            votes[p & ~mask] ^= residual[p];
+          std::size_t ones = 0;
+          for (std::size_t p = 0; p < n; ++p)
+            if ((p & mask) == 0)
+              ones += votes[p];
+
+          const std::size_t voters = n >> degree;
+          if (2 * ones == voters)
+            throw linearcode_exception{ fmt::format (
+                "Cannot decode codeword '{}' because the votes for a "
+                "coefficient are tied.",
+                cword) };
+          if (2 * ones > voters)
+            present.push_back (mask);
+        }
+
+      for (const std::size_t mask : present)
+        for (std::size_t p = 0; p < n; ++p)
+          if ((p & mask) == mask)
+            residual[p] ^= 1;
+    }
+
+  // What is left after removing every monomial is the error.
+  codeword error{ Eigen::RowVectorXi::Zero (n) };
+  for (std::size_t p = 0; p < n; ++p)
+    error.vec (p) = residual[p];
+  return decoding_result{ .iword = information_of (cword + error),
+                          .error = std::move (error) };
+}
+
+[[nodiscard]] linearcode::decoding_result
+linearcode::decode_soft (std::span<const float> llrs)
+{
+  const std::size_t n = m_packed_generator.cols ();
+  if (llrs.size () != n)
+    throw linearcode_exception{ fmt::format (
+        "Trying to decode {} log-likelihood ratios with a code of length {}.",
+        llrs.size (), n) };
+
+  const details::cache_use use{ m_cache };
+  return counted (details::soft_decoder, [&] () -> decoding_result {
+    codeword hard{ Eigen::RowVectorXi::Zero (n) };
+    for (std::size_t p = 0; p < n; ++p)
+      hard.vec (p) = llrs[p] < 0;
+
+    if (m_family.kind != code_family::ReedMuller || m_family.r != 1
+        || m_family_code)
+      return decode_with_structure (hard);
+
+    std::vector<float> values (llrs.begin (), llrs.end ());
+    details::fast_hadamard_transform<float> (values);
+    const auto [a, complement] = details::strongest_of<float> (values);
+
+    const codeword decoded = details::affine_word (n, a, complement);
+    return decoding_result{ .iword = information_of (decoded),
+                            .error = hard + decoded };
+  });
+}
+
+} // namespace patrick
@@ -0,0 +1,534 @@
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <patrick/bch.h>
+#include <patrick/cpu.h>
+#include <patrick/reed_solomon.h>
+
+namespace patrick
+{
+
+namespace details
+{
+
+namespace
+{
+
+using symbol_type = region_multiplier::symbol_type;
+
+#if defined(__x86_64__) || defined(__i386__)
+
+///
+/// \return The number of bytes that were processed - a multiple of 32.
+///
+__attribute__ ((target ("avx2"))) std::size_t
+multiply_add_avx2 (const symbol_type *low, const symbol_type *high,
+                   const symbol_type *src, symbol_type *dst, std::size_t size)
+{
+  const __m256i low_table = _mm256_broadcastsi128_si256 (
+      _mm_load_si128 (reinterpret_cast<const __m128i *> (low)));
+  const __m256i high_table = _mm256_broadcastsi128_si256 (
+      _mm_load_si128 (reinterpret_cast<const __m128i *> (high)));
+  const __m256i nibble = _mm256_set1_epi8 (0x0f);
+
+  std::size_t i = 0;
+  for (; i + 32 <= size; i += 32)
+    {
+      const __m256i x
+          = _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (src + i));
+      const __m256i product = _mm256_xor_si256 (
+          _mm256_shuffle_epi8 (low_table, _mm256_and_si256 (x, nibble)),
+          _mm256_shuffle_epi8 (
+              high_table,
+              _mm256_and_si256 (_mm256_srli_epi64 (x, 4), nibble)));
+      auto *out = reinterpret_cast<__m256i *> (dst + i);
+      _mm256_storeu_si256 (
+          out, _mm256_xor_si256 (_mm256_loadu_si256 (out), product));
+    }
+  return i;
+}
+
+///
+/// \return The number of bytes that were processed - a multiple of 16.
+///
+__attribute__ ((target ("ssse3"))) std::size_t
+multiply_add_ssse3 (const symbol_type *low, const symbol_type *high,
+                    const symbol_type *src, symbol_type *dst, std::size_t size)
+{
+  const __m128i low_table
+      = _mm_load_si128 (reinterpret_cast<const __m128i *> (low));
+  const __m128i high_table
+      = _mm_load_si128 (reinterpret_cast<const __m128i *> (high));
+  const __m128i nibble = _mm_set1_epi8 (0x0f);
+
+  std::size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      const __m128i x
+          = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (src + i));
+      const __m128i product = _mm_xor_si128 (
+          _mm_shuffle_epi8 (low_table, _mm_and_si128 (x, nibble)),
+          _mm_shuffle_epi8 (high_table,
+                            _mm_and_si128 (_mm_srli_epi64 (x, 4), nibble)));
+      auto *out = reinterpret_cast<__m128i *> (dst + i);
+      _mm_storeu_si128 (out, _mm_xor_si128 (_mm_loadu_si128 (out), product));
+    }
+  return i;
+}
+
+#endif
+
+} // namespace
+
+region_multiplier::region_multiplier (const galois_field &field,
+                                      symbol_type constant)
+    : m_constant{ constant }
+{
+  assert (field.degree () == 8);
+  for (symbol_type x = 0; x < 16; ++x)
+    {
+      m_low[x] = field.mul (constant, x);
+      m_high[x] = field.mul (constant, x << 4);
+    }
+}
+
+void
+region_multiplier::multiply_add (std::span<const symbol_type> src,
+                                 std::span<symbol_type> dst) const noexcept
+{
+  assert (src.size () == dst.size ());
+  if (m_constant == 0)
+    return;
+
+  std::size_t done = 0;
+#if defined(__x86_64__) || defined(__i386__)
+  if (cpu ().avx2)
+    done = multiply_add_avx2 (m_low.data (), m_high.data (), src.data (),
+                              dst.data (), src.size ());
+  else if (cpu ().ssse3)
+    done = multiply_add_ssse3 (m_low.data (), m_high.data (), src.data (),
+                               dst.data (), src.size ());
+#endif
+  multiply_add_scalar (src.subspan (done), dst.subspan (done));
+}
+
+void
+region_multiplier::multiply_add_scalar (
+    std::span<const symbol_type> src,
+    std::span<symbol_type> dst) const noexcept
+{
+  assert (src.size () == dst.size ());
+  for (std::size_t i = 0; i < src.size (); ++i)
+    dst[i] ^= m_low[src[i] & 0x0f] ^ m_high[src[i] >> 4];
+}
+
+} // namespace details
+
+namespace
+{
+
+using element_type = details::galois_field::element_type;
+
+///
+/// \brief The size of the blocks in which shards are combined.
+///
+constexpr std::size_t shard_block_size = 4096;
+
+void
+ensure_shard_count (std::size_t count, std::size_t expected)
+{
+  if (count != expected)
+    throw reed_solomon_exception{ fmt::format (
+        "Expected {} shards, but {} were given.", expected, count) };
+}
+
+void
+ensure_shard_size (std::size_t size, std::size_t expected)
+{
+  if (size != expected)
+    throw reed_solomon_exception{ fmt::format (
+        "Shards have to be of the same size, but one of {} bytes differs "
+        "from {} bytes.",
+        size, expected) };
+}
+
+///
+/// \return The mask of \a positions, after checking that they are
+/// distinct and less than \a n.
+///
+[[nodiscard]] std::vector<bool>
+mark_positions (std::span<const std::size_t> positions, std::size_t n)
+{
+  std::vector<bool> marked (n, false);
+  for (const std::size_t p : positions)
+    {
+      if (p >= n || marked[p])
+        throw reed_solomon_exception{ fmt::format (
+            "Position {} is out of range or repeated.", p) };
+      marked[p] = true;
+    }
+  return marked;
+}
+
+} // namespace
+
+///
+/// Constructors
+///
+
+reed_solomon::reed_solomon (std::size_t n, std::size_t k)
+{
+  if (k == 0 || k >= n || n > max_word_size)
+    throw reed_solomon_exception{ fmt::format (
+        "Cannot instantiate a Reed-Solomon code with n={} and k={}.", n, k) };
+
+  const std::size_t redundancy = n - k;
+  m_properties = properties_type{ .word_size = n,
+                                  .basis_size = k,
+                                  .min_distance = redundancy + 1,
+                                  .max_errors_correct = redundancy / 2 };
+
+  // g(x) = (x - a^0)(x - a^1)...(x - a^(n-k-1))
+  m_generator = { 1 };
+  for (std::size_t j = 0; j < redundancy; ++j)
+    {
+      const element_type root = m_field.exp (j);
+      m_generator.push_back (0);
+      for (std::size_t d = m_generator.size () - 1; d > 0; --d)
+        m_generator[d]
+            = m_generator[d - 1] ^ m_field.mul (m_generator[d], root);
+      m_generator[0] = m_field.mul (m_generator[0], root);
+    }
+
+  m_generator_products.resize (redundancy);
+  for (std::size_t j = 0; j < redundancy; ++j)
+    for (std::size_t x = 0; x < 256; ++x)
+      m_generator_products[j][x]
+          = m_field.mul (m_generator[redundancy - 1 - j], x);
+
+  // The remainders of x^d modulo g(x) for d = n - k, ..., n - 1, which
+  // belong to the message symbols from the last to the first one.
+  std::vector<symbol_type> remainder (m_generator.begin (),
+                                      m_generator.end () - 1);
+  m_parity_rows.resize (redundancy * k);
+  for (std::size_t i = k; i-- > 0;)
+    {
+      for (std::size_t j = 0; j < redundancy; ++j)
+        m_parity_rows[j * k + i] = details::region_multiplier{
+          m_field, remainder[redundancy - 1 - j]
+        };
+
+      const symbol_type top = remainder.back ();
+      for (std::size_t d = redundancy - 1; d > 0; --d)
+        remainder[d] = remainder[d - 1] ^ m_field.mul (top, m_generator[d]);
+      remainder[0] = m_field.mul (top, m_generator[0]);
+    }
+}
+
+///
+/// Operations
+///
+
+[[nodiscard]] std::vector<reed_solomon::symbol_type>
+reed_solomon::encode (std::span<const symbol_type> message) const
+{
+  std::vector<symbol_type> cword (m_properties.word_size);
+  encode (message, std::span{ cword }.subspan (m_properties.basis_size));
+  std::copy (message.begin (), message.end (), cword.begin ());
+  return cword;
+}
+
+void
+reed_solomon::encode (std::span<const symbol_type> message,
+                      std::span<symbol_type> parity) const
+{
+  const std::size_t redundancy
+      = m_properties.word_size - m_properties.basis_size;
+  if (message.size () != m_properties.basis_size
+      || parity.size () != redundancy)
+    throw reed_solomon_exception{ fmt::format (
+        "Trying to encode {} symbols into {} parity symbols, whereas the "
+        "code expects {} and {}.",
+        message.size (), parity.size (), m_properties.basis_size,
+        redundancy) };
+
+  // The remainder of m(x) x^(n-k) divided by g(x), computed by a shift
+  // register which holds it from the highest coefficient.
+  std::fill (parity.begin (), parity.end (), 0);
+  for (const symbol_type symbol : message)
+    {
+      const symbol_type feedback = symbol ^ parity[0];
+      for (std::size_t j = 0; j + 1 < redundancy; ++j)
+        parity[j] = parity[j + 1] ^ m_generator_products[j][feedback];
+      parity[redundancy - 1] = m_generator_products[redundancy - 1][feedback];
+    }
+}
+
+[[nodiscard]] std::vector<reed_solomon::symbol_type>
+reed_solomon::syndrome_of (std::span<const symbol_type> received) const
+{
+  if (received.size () != m_properties.word_size)
+    throw reed_solomon_exception{ fmt::format (
+        "Trying to decode a word of {} symbols, whereas the code expects {}.",
+        received.size (), m_properties.word_size) };
+
+  const auto antilog = m_field.antilog_table ();
+  std::vector<symbol_type> syndromes (m_properties.word_size
+                                      - m_properties.basis_size);
+  for (std::size_t j = 0; j < syndromes.size (); ++j)
+    {
+      // Horner's rule at alpha^j, multiplying through the logarithms.
+      element_type s = 0;
+      for (const symbol_type symbol : received)
+        s = (s == 0 ? 0 : antilog[m_field.log (s) + j]) ^ symbol;
+      syndromes[j] = s;
+    }
+  return syndromes;
+}
+
+[[nodiscard]] std::vector<element_type>
+reed_solomon::errata_locator (std::span<const symbol_type> syndromes,
+                              std::span<const std::size_t> erasures) const
+{
+  const std::size_t n = m_properties.word_size;
+
+  // The locator of the erasures, prod (1 + X x) with X = alpha^(n - 1 - p).
+  std::vector<element_type> locator{ 1 };
+  for (const std::size_t p : erasures)
+    {
+      const element_type x = m_field.exp (n - 1 - p);
+      locator.push_back (0);
+      for (std::size_t d = locator.size () - 1; d > 0; --d)
+        locator[d] ^= m_field.mul (locator[d - 1], x);
+    }
+
+  // Berlekamp-Massey, continued from the erasure locator over the syndromes
+  // which the erasures leave unused.
+  std::vector<element_type> previous = locator;
+  std::size_t length = erasures.size ();
+  for (std::size_t r = erasures.size (); r < syndromes.size (); ++r)
+    {
+      previous.insert (previous.begin (), 0);
+
+      element_type discrepancy = 0;
+      for (std::size_t j = 0; j < locator.size () && j <= r; ++j)
+        discrepancy ^= m_field.mul (locator[j], syndromes[r - j]);
+      if (discrepancy == 0)
+        continue;
+
+      auto updated = locator;
+      updated.resize (std::max (locator.size (), previous.size ()), 0);
+      for (std::size_t j = 0; j < previous.size (); ++j)
+        updated[j] ^= m_field.mul (discrepancy, previous[j]);
+
+      if (2 * length <= r + erasures.size ())
+        {
+          length = r + 1 + erasures.size () - length;
+          const element_type inverse = m_field.inv (discrepancy);
+          previous = std::move (locator);
+          for (auto &c : previous)
+            c = m_field.mul (c, inverse);
+        }
+      locator = std::move (updated);
+    }
+
+  while (locator.size () > 1 && locator.back () == 0)
+    locator.pop_back ();
+  return locator;
+}
+
+[[nodiscard]] reed_solomon::decoding_result
+reed_solomon::decode (std::span<const symbol_type> received,
+                      std::span<const std::size_t> erasures) const
+{
+  const std::size_t n = m_properties.word_size;
+  const std::size_t k = m_properties.basis_size;
+  const auto syndromes = syndrome_of (received);
+  (void)mark_positions (erasures, n);
+
+  decoding_result result{
+    .message = std::vector<symbol_type> (received.begin (),
+                                         received.begin () + k),
+    .error = std::vector<symbol_type> (n, 0)
+  };
+  if (std::ranges::all_of (syndromes, [] (auto s) { return s == 0; }))
+    return result;
+
+  const auto locator = errata_locator (syndromes, erasures);
+  const std::size_t num_errata = locator.size () - 1;
+  const auto roots = 2 * num_errata <= n - k + erasures.size ()
+                         ? details::chien_search (m_field, locator, n)
+                         : std::vector<std::size_t>{};
+  if (roots.empty () || roots.size () != num_errata)
+    throw reed_solomon_exception{ fmt::format (
+        "Cannot decode a word with {} erasures, because there are more "
+        "errors than the code can correct.",
+        erasures.size ()) };
+
+  // Forney's algorithm: with Omega(x) = S(x) Lambda(x) mod x^(n-k), the
+  // value at the position of X is X Omega(1 / X) / Lambda'(1 / X).
+  std::vector<element_type> evaluator (syndromes.size (), 0);
+  for (std::size_t i = 0; i < syndromes.size (); ++i)
+    for (std::size_t j = 0; j < locator.size () && i + j < evaluator.size ();
+         ++j)
+      evaluator[i + j] ^= m_field.mul (syndromes[i], locator[j]);
+
+  std::vector<element_type> derivative (locator.size () - 1, 0);
+  for (std::size_t j = 1; j < locator.size (); j += 2)
+    derivative[j - 1] = locator[j];
+
+  for (const std::size_t i : roots)
+    {
+      const element_type x = m_field.exp (i);
+      const element_type x_inverse = m_field.inv (x);
+      const element_type value = m_field.div (
+          m_field.mul (x, m_field.evaluate (evaluator, x_inverse)),
+          m_field.evaluate (derivative, x_inverse));
+      result.error[n - 1 - i] = value;
+    }
+
+  for (std::size_t i = 0; i < k; ++i)
+    result.message[i] ^= result.error[i];
+  return result;
+}
+
+void
+reed_solomon::combine_shards (
+    std::span<const std::span<const symbol_type> > inputs,
+    std::span<const details::region_multiplier> rows,
+    std::span<const std::span<symbol_type> > outputs) const
+{
+  assert (rows.size () == inputs.size () * outputs.size ());
+  if (outputs.empty ())
+    return;
+
+  const std::size_t size = outputs.front ().size ();
+  for (std::size_t offset = 0; offset < size; offset += shard_block_size)
+    {
+      const std::size_t count = std::min (shard_block_size, size - offset);
+      for (std::size_t o = 0; o < outputs.size (); ++o)
+        for (std::size_t i = 0; i < inputs.size (); ++i)
+          rows[o * inputs.size () + i].multiply_add (
+              inputs[i].subspan (offset, count),
+              outputs[o].subspan (offset, count));
+    }
+}
+
+void
+reed_solomon::encode_shards (
+    std::span<const std::span<const symbol_type> > data,
+    std::span<const std::span<symbol_type> > parity) const
+{
+  const std::size_t k = m_properties.basis_size;
+  ensure_shard_count (data.size (), k);
+  ensure_shard_count (parity.size (), m_properties.word_size - k);
+  const std::size_t size = data.front ().size ();
+  for (const auto shard : data)
+    ensure_shard_size (shard.size (), size);
+  for (const auto shard : parity)
+    {
+      ensure_shard_size (shard.size (), size);
+      std::fill (shard.begin (), shard.end (), 0);
+    }
+
+  combine_shards (data, m_parity_rows, parity);
+}
+
+void
+reed_solomon::reconstruct_shards (
+    std::span<const std::span<symbol_type> > shards,
+    std::span<const std::size_t> missing) const
+{
+  const std::size_t n = m_properties.word_size;
+  const std::size_t k = m_properties.basis_size;
+  ensure_shard_count (shards.size (), n);
+  for (const auto shard : shards)
+    ensure_shard_size (shard.size (), shards.front ().size ());
+
+  const auto lost = mark_positions (missing, n);
+  if (missing.size () > n - k)
+    throw reed_solomon_exception{ fmt::format (
+        "Cannot reconstruct {} missing shards with {} parity shards.",
+        missing.size (), n - k) };
+  if (missing.empty ())
+    return;
+
+  // The first k available shards are the message times the matching rows
+  // of the systematic generator.
+  std::vector<std::size_t> available;
+  for (std::size_t i = 0; i < n && available.size () < k; ++i)
+    if (!lost[i])
+      available.push_back (i);
+
+  std::vector<element_type> system (k * 2 * k, 0);
+  auto entry = [&] (std::size_t r, std::size_t c) -> element_type & {
+    return system[r * 2 * k + c];
+  };
+  for (std::size_t r = 0; r < k; ++r)
+    {
+      const std::size_t shard = available[r];
+      for (std::size_t c = 0; c < k; ++c)
+        entry (r, c) = shard < k
+                           ? element_type (shard == c)
+                           : m_parity_rows[(shard - k) * k + c].constant ();
+      entry (r, k + r) = 1;
+    }
+
+  // Gauss-Jordan elimination leaves the inverse in the right half. The
+  // rows of a systematic MDS generator are always independent.
+  for (std::size_t c = 0; c < k; ++c)
+    {
+      std::size_t pivot = c;
+      while (entry (pivot, c) == 0)
+        ++pivot;
+      for (std::size_t j = 0; j < 2 * k; ++j)
+        std::swap (entry (c, j), entry (pivot, j));
+
+      const element_type inverse = m_field.inv (entry (c, c));
+      for (std::size_t j = 0; j < 2 * k; ++j)
+        entry (c, j) = m_field.mul (entry (c, j), inverse);
+      for (std::size_t r = 0; r < k; ++r)
+        if (r != c && entry (r, c) != 0)
+          {
+            const element_type factor = entry (r, c);
+            for (std::size_t j = 0; j < 2 * k; ++j)
+              entry (r, j) ^= m_field.mul (factor, entry (c, j));
+          }
+    }
+
+  std::vector<std::span<const symbol_type> > inputs;
+  for (const std::size_t shard : available)
+    inputs.emplace_back (shards[shard]);
+
+  std::vector<std::span<symbol_type> > lost_data;
+  std::vector<details::region_multiplier> rows;
+  for (std::size_t d = 0; d < k; ++d)
+    if (lost[d])
+      {
+        lost_data.push_back (shards[d]);
+        std::fill (shards[d].begin (), shards[d].end (), 0);
+        for (std::size_t c = 0; c < k; ++c)
+          rows.emplace_back (m_field, entry (d, k + c));
+      }
+  combine_shards (inputs, rows, lost_data);
+
+  // All data shards are there now, so the lost parity is encoded anew.
+  std::vector<std::span<const symbol_type> > data (shards.begin (),
+                                                   shards.begin () + k);
+  std::vector<std::span<symbol_type> > lost_parity;
+  rows.clear ();
+  for (std::size_t j = 0; j < n - k; ++j)
+    if (lost[k + j])
+      {
+        lost_parity.push_back (shards[k + j]);
+        std::fill (shards[k + j].begin (), shards[k + j].end (), 0);
+        rows.insert (rows.end (), m_parity_rows.begin () + j * k,
+                     m_parity_rows.begin () + (j + 1) * k);
+      }
+  combine_shards (data, rows, lost_parity);
+}
+
+} // namespace patrick
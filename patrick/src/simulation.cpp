@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <exception>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <patrick/bitmatrix.h>
+#include <patrick/channel.h>
+#include <patrick/simulation.h>
+#include <patrick/trace.h>
+
+namespace patrick
+{
+
+namespace
+{
+
+///
+/// \brief Adds up the results of two runs at the same point.
+///
+void
+accumulate (simulation_point &total, const simulation_point &part) noexcept
+{
+  total.frames += part.frames;
+  total.frame_errors += part.frame_errors;
+  total.bit_errors += part.bit_errors;
+  total.bits += part.bits;
+}
+
+///
+/// \return The bytes of the buffers of \ref simulation::run_batch for \a
+/// count frames, with room for their alignment.
+///
+[[nodiscard]] std::size_t
+batch_bytes (std::size_t n, std::size_t k, std::size_t count) noexcept
+{
+  const std::size_t n_stride = details::bitmatrix::blocks_for (n);
+  const std::size_t k_stride = details::bitmatrix::blocks_for (k);
+  return count * ((2 * k_stride + n_stride) * sizeof (std::uint64_t) + 1)
+         + 4 * alignof (std::max_align_t);
+}
+
+} // namespace
+
+///
+/// Constructors
+///
+
+simulation::simulation (linearcode code, simulation_options options)
+    : m_code{ std::move (code) }, m_options{ options }
+{
+  if (m_options.batch_size == 0)
+    throw simulation_exception{ "Cannot simulate batches of 0 frames." };
+  if (m_options.num_threads == 0)
+    m_options.num_threads
+        = std::max (1u, std::thread::hardware_concurrency ());
+
+  // Build the tables of the decoder before any thread uses them. Should they
+  // be evicted, linearcode builds them again once for all threads.
+  const auto &properties = m_code.properties ();
+  std::vector<std::uint64_t> word (
+      details::bitmatrix::blocks_for (properties.word_size));
+  std::vector<std::uint64_t> iword (
+      details::bitmatrix::blocks_for (properties.basis_size));
+  (void)m_code.decode_batch (word, iword, 1);
+}
+
+///
+/// Operations
+///
+
+[[nodiscard]] simulation_point
+simulation::run_batch (double crossover_probability, std::uint64_t key,
+                       std::size_t first, std::size_t count,
+                       std::pmr::memory_resource *arena)
+{
+  const std::size_t n = m_code.properties ().word_size;
+  const std::size_t k = m_code.properties ().basis_size;
+  const std::size_t n_stride = details::bitmatrix::blocks_for (n);
+  const std::size_t k_stride = details::bitmatrix::blocks_for (k);
+  details::trace_span span{ "simulation_batch", "simulation" };
+  span.arg ("first", first);
+  span.arg ("count", count);
+  const double gap_scale = 1 / std::log1p (-crossover_probability);
+
+  std::pmr::vector<std::uint64_t> sent (count * k_stride, arena);
+  std::pmr::vector<std::uint64_t> received (count * n_stride, arena);
+  std::pmr::vector<std::uint64_t> decoded (count * k_stride, arena);
+  std::pmr::vector<std::uint8_t> failures (count, arena);
+  for (std::size_t f = 0; f < count; ++f)
+    {
+      details::philox4x32 gen{ key, first + f };
+      const std::span<std::uint64_t> iword{ sent.data () + f * k_stride,
+                                            k_stride };
+      for (auto &block : iword)
+        block = gen ();
+      if (k % 64 != 0)
+        iword.back () &= (std::uint64_t{ 1 } << (k % 64)) - 1;
+
+      std::uint64_t *cword = received.data () + f * n_stride;
+      m_code.encode_batch (iword, { cword, n_stride }, 1);
+      if (crossover_probability > 0)
+        for (std::uint64_t position
+             = details::geometric_gap (gen.uniform (), gap_scale);
+             position < n;
+             position += details::geometric_gap (gen.uniform (), gap_scale)
+                         + 1)
+          cword[position / 64] ^= std::uint64_t{ 1 } << (position % 64);
+    }
+  (void)m_code.decode_batch (received, decoded, count, failures);
+
+  // A decoder failure is a frame error even if the information bits
+  // happen to be right. They are read off the received word.
+  simulation_point result{ .crossover_probability = crossover_probability,
+                           .frames = count,
+                           .bits = count * k };
+  for (std::size_t f = 0; f < count; ++f)
+    {
+      std::size_t bit_errors = 0;
+      for (std::size_t b = 0; b < k_stride; ++b)
+        bit_errors += std::popcount (sent[f * k_stride + b]
+                                     ^ decoded[f * k_stride + b]);
+      result.frame_errors += failures[f] || bit_errors > 0;
+      result.bit_errors += bit_errors;
+    }
+  return result;
+}
+
+[[nodiscard]] bool
+simulation::is_done (const simulation_point &point) const noexcept
+{
+  if (point.frames >= m_options.max_frames)
+    return true;
+  if (m_options.target_frame_errors > 0
+      && point.frame_errors >= m_options.target_frame_errors)
+    return true;
+  if (m_options.relative_precision > 0 && point.frame_errors > 0)
+    {
+      const auto [low, high] = point.frame_error_interval ();
+      const double fer = point.frame_error_rate ();
+      return high - fer <= m_options.relative_precision * fer
+             && fer - low <= m_options.relative_precision * fer;
+    }
+  return false;
+}
+
+[[nodiscard]] simulation_point
+simulation::run (double crossover_probability, std::uint64_t point)
+{
+  if (!(crossover_probability >= 0 && crossover_probability <= 1))
+    throw simulation_exception{ fmt::format (
+        "Cannot simulate a binary symmetric channel with crossover "
+        "probability {}.",
+        crossover_probability) };
+
+  details::trace_span span{ "simulation", "simulation" };
+  span.arg ("crossover_probability", crossover_probability);
+  simulation_point total{ .crossover_probability = crossover_probability };
+  if (m_options.max_frames == 0)
+    return total;
+
+  // Every point gets unrelated streams.
+  const std::uint64_t key
+      = details::xoshiro256pp{ m_options.seed
+                               ^ (point * 0x9e3779b97f4a7c15ull) }();
+  const std::size_t batch_size = m_options.batch_size;
+  const std::size_t num_batches
+      = (m_options.max_frames + batch_size - 1) / batch_size;
+
+  // The results of the batches which are done, but cannot be committed
+  // before the ones in front of them.
+  std::vector<std::optional<simulation_point> > pending (
+      std::min (num_batches, m_options.num_threads));
+  std::size_t committed = 0;
+  std::mutex mutex;
+  std::atomic<std::size_t> next{ 0 };
+  std::atomic<bool> done{ false };
+
+  // The first exception of a worker stops the others, and is thrown once
+  // they are joined.
+  std::exception_ptr failure;
+
+  const auto work = [&] {
+    try
+      {
+        // Every batch starts over at the front of the scratch buffer of its
+        // thread, which only falls back to the heap if a batch overflows it.
+        std::vector<std::byte> scratch (
+            batch_bytes (m_code.properties ().word_size,
+                         m_code.properties ().basis_size,
+                         std::min (batch_size, m_options.max_frames)));
+        for (;;)
+          {
+            const std::size_t batch = next.fetch_add (1);
+            if (batch >= num_batches || done.load (std::memory_order_relaxed))
+              return;
+            const std::size_t first = batch * batch_size;
+            std::pmr::monotonic_buffer_resource arena{ scratch.data (),
+                                                       scratch.size () };
+            const auto result = run_batch (
+                crossover_probability, key, first,
+                std::min (batch_size, m_options.max_frames - first), &arena);
+
+            std::scoped_lock lock{ mutex };
+            if (done)
+              return;
+            if (batch - committed >= pending.size ())
+              pending.resize (batch - committed + 1);
+            pending[batch - committed] = result;
+            while (!pending.empty () && pending.front ())
+              {
+                accumulate (total, *pending.front ());
+                pending.erase (pending.begin ());
+                ++committed;
+                if (is_done (total))
+                  {
+                    done = true;
+                    return;
+                  }
+              }
+          }
+      }
+    catch (...)
+      {
+        std::scoped_lock lock{ mutex };
+        if (!failure)
+          failure = std::current_exception ();
+        done = true;
+      }
+  };
+
+  {
+    std::vector<std::jthread> threads;
+    const std::size_t workers = std::min (num_batches, m_options.num_threads);
+    threads.reserve (workers - 1);
+    for (std::size_t t = 1; t < workers; ++t)
+      threads.emplace_back (work);
+    work ();
+  }
+  if (failure)
+    std::rethrow_exception (failure);
+  span.arg ("frames", total.frames);
+  span.arg ("frame_errors", total.frame_errors);
+  return total;
+}
+
+[[nodiscard]] std::vector<simulation_point>
+simulation::curve (std::span<const double> crossover_probabilities)
+{
+  std::vector<simulation_point> points;
+  points.reserve (crossover_probabilities.size ());
+  for (std::size_t i = 0; i < crossover_probabilities.size (); ++i)
+    points.push_back (run (crossover_probabilities[i], i));
+  return points;
+}
+
+} // namespace patrick
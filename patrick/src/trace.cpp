@@ -0,0 +1,119 @@
+#include <patrick/trace.h>
+
+namespace patrick
+{
+
+namespace
+{
+
+std::mutex sink_mutex;
+std::shared_ptr<trace_sink> sink;
+
+///
+/// \brief Writes \a text as a JSON string.
+///
+void
+write_string (std::ostream &out, std::string_view text)
+{
+  out << '"';
+  for (const char c : text)
+    {
+      if (c == '"' || c == '\\')
+        out << '\\' << c;
+      else if (static_cast<unsigned char> (c) < 0x20)
+        out << fmt::format ("\\u{:04x}", int (c));
+      else
+        out << c;
+    }
+  out << '"';
+}
+
+} // namespace
+
+namespace details
+{
+
+std::atomic<bool> tracing{ false };
+
+[[nodiscard]] std::uint64_t
+trace_thread () noexcept
+{
+  static std::atomic<std::uint64_t> next{ 1 };
+  thread_local const std::uint64_t thread = next.fetch_add (1);
+  return thread;
+}
+
+} // namespace details
+
+///
+/// Sinks
+///
+
+chrome_trace_sink::chrome_trace_sink (std::ostream &out) : m_out{ out }
+{
+  m_out << "[";
+}
+
+chrome_trace_sink::chrome_trace_sink (const std::string &path)
+    : m_file{ std::make_unique<std::ofstream> (path) }, m_out{ *m_file }
+{
+  if (!*m_file)
+    throw trace_exception{ fmt::format (
+        "Cannot open the trace file '{}'.", path) };
+  m_out << "[";
+}
+
+chrome_trace_sink::~chrome_trace_sink ()
+{
+  m_out << "\n]\n";
+  m_out.flush ();
+}
+
+void
+chrome_trace_sink::write (const trace_event &event)
+{
+  std::scoped_lock lock{ m_mutex };
+  m_out << (m_empty ? "\n" : ",\n") << "{\"name\":";
+  m_empty = false;
+  write_string (m_out, event.name);
+  m_out << ",\"cat\":";
+  write_string (m_out, event.category);
+  m_out << fmt::format (",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},"
+                        "\"pid\":1,\"tid\":{}",
+                        event.start_ns / 1e3, event.duration_ns / 1e3,
+                        event.thread);
+  if (!event.args.empty ())
+    {
+      m_out << ",\"args\":{";
+      for (std::size_t i = 0; i < event.args.size (); ++i)
+        {
+          if (i > 0)
+            m_out << ",";
+          write_string (m_out, event.args[i].key);
+          m_out << ":" << fmt::format ("{}", event.args[i].value);
+        }
+      m_out << "}";
+    }
+  m_out << "}";
+}
+
+///
+/// Configuration
+///
+
+void
+set_trace_sink (std::shared_ptr<trace_sink> new_sink)
+{
+  std::scoped_lock lock{ sink_mutex };
+  details::tracing.store (new_sink != nullptr, std::memory_order_relaxed);
+  sink = std::move (new_sink);
+}
+
+[[nodiscard]] std::shared_ptr<trace_sink>
+current_trace_sink ()
+{
+  std::scoped_lock lock{ sink_mutex };
+  return sink;
+}
+
+} // namespace patrick
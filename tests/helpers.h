@@ -0,0 +1,91 @@
+/// \file
+
+#ifndef PATRICK_TESTS_HELPERS_H_INCLUDED
+#define PATRICK_TESTS_HELPERS_H_INCLUDED
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <patrick/word.h>
+
+namespace patrick::test
+{
+
+///
+/// \brief An infoword of \a size uniformly random bits.
+///
+inline infoword
+random_infoword (std::size_t size, std::mt19937_64 &gen)
+{
+  Eigen::RowVectorXi vec (size);
+  for (auto &b : vec)
+    b = gen () & 1;
+  return infoword{ std::move (vec) };
+}
+
+///
+/// \brief An error of length \a n and weight \a weight at random positions.
+///
+inline codeword
+random_error (std::size_t n, std::size_t weight, std::mt19937_64 &gen)
+{
+  codeword error{ Eigen::RowVectorXi::Zero (n) };
+  while (error.weight () < weight)
+    error.vec (gen () % n) = 1;
+  return error;
+}
+
+///
+/// \brief BPSK over an AWGN channel with \f$E_{s}/N_{0}\f$ of \a snr dB.
+/// \return The log-likelihood ratios of the received bits.
+///
+inline std::vector<float>
+transmit (const codeword &cword, double snr, std::mt19937_64 &gen)
+{
+  const float sigma = std::sqrt (1 / (2 * std::pow (10.0f, snr / 10)));
+  std::normal_distribution<float> noise{ 0.0f, sigma };
+  std::vector<float> llrs;
+  for (const int b : cword.vec)
+    llrs.push_back (2 * ((b ? -1.0f : 1.0f) + noise (gen)) / (sigma * sigma));
+  return llrs;
+}
+
+///
+/// \brief Allocates from the heap until it is told to fail.
+///
+class failing_resource final : public std::pmr::memory_resource
+{
+public:
+  std::atomic<bool> fail{ false };
+
+private:
+  void *
+  do_allocate (std::size_t bytes, std::size_t alignment) override
+  {
+    if (fail.load ())
+      throw std::bad_alloc{};
+    return std::pmr::new_delete_resource ()->allocate (bytes, alignment);
+  }
+
+  void
+  do_deallocate (void *p, std::size_t bytes, std::size_t alignment) override
+  {
+    std::pmr::new_delete_resource ()->deallocate (p, bytes, alignment);
+  }
+
+  [[nodiscard]] bool
+  do_is_equal (const memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+} // namespace patrick::test
+
+#endif // PATRICK_TESTS_HELPERS_H_INCLUDED
@@ -0,0 +1,180 @@
+#include <array>
+#include <memory_resource>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/batch.h>
+#include <patrick/channel.h>
+
+using namespace patrick;
+
+namespace
+{
+
+linearcode
+generic_code ()
+{
+  return linearcode::from_generator (Eigen::MatrixXi{
+      { 1, 0, 0, 0, 0, 1, 1, 0, 1, 1, 0, 1 },
+      { 0, 1, 0, 0, 0, 1, 0, 1, 1, 0, 1, 1 },
+      { 0, 0, 1, 0, 0, 0, 1, 1, 0, 1, 1, 1 },
+      { 0, 0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 1 },
+      { 0, 0, 0, 0, 1, 0, 1, 0, 1, 1, 1, 0 } });
+}
+
+} // namespace
+
+TEST (TestBatch, TestMatchesWordByWord)
+{
+  std::mt19937_64 gen{ 44 };
+  for (auto code : { generic_code (), linearcode::hamming (4),
+                     linearcode::bch (5, 2), linearcode::reed_muller (1, 4) })
+    {
+      const std::size_t n = code.properties ().word_size;
+      const std::size_t k = code.properties ().basis_size;
+      const bool generic
+          = code.family ().kind == linearcode::code_family::Generic;
+      const std::size_t count = 300;
+
+      std::vector<std::uint64_t> infowords (count);
+      for (auto &iword : infowords)
+        iword = gen () & ((std::uint64_t{ 1 } << k) - 1);
+      std::vector<std::uint64_t> codewords (count);
+      code.encode_batch (infowords, codewords, count);
+      for (std::size_t w = 0; w < count; ++w)
+        EXPECT_EQ (details::unpack<details::codeword_tag> (&codewords[w], n),
+                   code.encode (details::unpack<details::infoword_tag> (
+                       &infowords[w], k)));
+
+      // Up to 4 errors, so that some words of the BCH code fail.
+      for (std::size_t w = 0; w < count; ++w)
+        for (std::size_t e = 0; e < w % 5; ++e)
+          codewords[w] ^= std::uint64_t{ 1 } << (gen () % n);
+      std::vector<std::uint64_t> decoded (count);
+      std::vector<std::uint8_t> failures (count);
+      const std::size_t num_failures
+          = code.decode_batch (codewords, decoded, count, failures);
+
+      std::size_t expected_failures = 0;
+      for (std::size_t w = 0; w < count; ++w)
+        {
+          const auto cword = details::unpack<details::codeword_tag> (
+              &codewords[w], n);
+          try
+            {
+              using enum linearcode::decoding_strategy;
+              const auto result = generic ? code.decode<Syndromes> (cword)
+                                          : code.decode<Auto> (cword);
+              EXPECT_EQ (details::unpack<details::infoword_tag> (
+                             &decoded[w], k),
+                         result.iword);
+              EXPECT_FALSE (failures[w]);
+            }
+          catch (const linearcode_exception &)
+            {
+              ++expected_failures;
+              EXPECT_TRUE (failures[w]);
+            }
+        }
+      EXPECT_EQ (num_failures, expected_failures);
+    }
+}
+
+TEST (TestBatch, TestLongCode)
+{
+  // The packed table of a code of 30 bits has only 32 cosets, and its
+  // leaders are found without going over the 2^30 words.
+  const std::size_t positions[]{ 0 };
+  auto code = linearcode::from_generator (
+      linearcode::hamming (5).shorten (positions).generator_matrix ());
+  ASSERT_EQ (code.properties ().word_size, 30);
+  ASSERT_EQ (code.family ().kind, linearcode::code_family::Generic);
+
+  std::mt19937_64 gen{ 30 };
+  const std::size_t count = 100;
+  std::vector<std::uint64_t> infowords (count);
+  for (auto &iword : infowords)
+    iword = gen () & ((std::uint64_t{ 1 } << 25) - 1);
+  std::vector<std::uint64_t> codewords (count);
+  code.encode_batch (infowords, codewords, count);
+  for (std::size_t w = 0; w < count; ++w)
+    codewords[w] ^= std::uint64_t{ 1 } << (w % 30);
+
+  std::vector<std::uint64_t> decoded (count);
+  EXPECT_EQ (code.decode_batch (codewords, decoded, count), 0);
+  EXPECT_EQ (decoded, infowords);
+}
+
+TEST (TestBatch, TestEncode)
+{
+  auto code = linearcode::bch (7, 3);
+  const std::size_t n = code.properties ().word_size;
+  const std::size_t k = code.properties ().basis_size;
+  const std::size_t n_stride = details::bitmatrix::blocks_for (n);
+  const std::size_t k_stride = details::bitmatrix::blocks_for (k);
+
+  std::mt19937_64 gen{ 4 };
+  const std::size_t count = 20;
+  std::vector<std::uint64_t> infowords (count * k_stride);
+  for (std::size_t w = 0; w < count; ++w)
+    for (std::size_t i = 0; i < k; ++i)
+      infowords[w * k_stride + i / 64] |= (gen () & 1) << (i % 64);
+  std::vector<std::uint64_t> codewords (count * n_stride);
+  code.encode_batch (infowords, codewords, count);
+  for (std::size_t w = 0; w < count; ++w)
+    EXPECT_EQ (details::unpack<details::codeword_tag> (
+                   codewords.data () + w * n_stride, n),
+               code.encode (details::unpack<details::infoword_tag> (
+                   infowords.data () + w * k_stride, k)));
+}
+
+TEST (TestBatch, TestTransfer)
+{
+  // A batch is sent like its words one by one.
+  auto code = generic_code ();
+  binary_symmetric_channel batched{ 0.05, 9 };
+  binary_symmetric_channel single{ 0.05, 9 };
+  batch_workspace workspace;
+
+  std::mt19937_64 gen{ 9 };
+  for (const std::size_t count : { 100, 7, 250 })
+    {
+      std::vector<std::uint64_t> infowords (count);
+      for (auto &iword : infowords)
+        iword = gen () & 0x1f;
+      std::vector<std::uint64_t> decoded (count);
+      EXPECT_EQ (transfer_batch (code, batched, infowords, decoded, count,
+                                 workspace),
+                 0);
+      for (std::size_t w = 0; w < count; ++w)
+        {
+          const auto received = single.transmit (code.encode (
+              details::unpack<details::infoword_tag> (&infowords[w], 5)));
+          EXPECT_EQ (details::unpack<details::infoword_tag> (&decoded[w], 5),
+                     code.decode<linearcode::decoding_strategy::Syndromes> (
+                             received)
+                         .iword);
+        }
+    }
+  EXPECT_GE (workspace.codewords.capacity (), 250);
+}
+
+TEST (TestBatch, TestWorkspaceResource)
+{
+  // The buffers come out of the arena, which has no upstream to fall back
+  // to.
+  std::array<std::byte, 4096> buffer;
+  std::pmr::monotonic_buffer_resource arena{
+    buffer.data (), buffer.size (), std::pmr::null_memory_resource ()
+  };
+  batch_workspace workspace{ &arena };
+  auto code = generic_code ();
+  binary_symmetric_channel channel{ 0.05, 3 };
+
+  std::vector<std::uint64_t> infowords (64, 0b10110);
+  std::vector<std::uint64_t> decoded (64);
+  EXPECT_EQ (transfer_batch (code, channel, infowords, decoded, 64, workspace),
+             0);
+  EXPECT_EQ (workspace.codewords.get_allocator ().resource (), &arena);
+}
@@ -0,0 +1,131 @@
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <patrick/bch.h>
+#include <patrick/core.h>
+
+#include "helpers.h"
+
+using namespace patrick;
+using namespace patrick::test;
+using element_type = details::galois_field::element_type;
+
+TEST (TestBCH, TestBerlekampMassey)
+{
+  const details::galois_field field{ 4 };
+
+  // Errors at positions 2 and 9 give Lambda(x) = (1 + a^2 x)(1 + a^9 x).
+  codeword received{ Eigen::RowVectorXi::Zero (15) };
+  received.vec (2) = received.vec (9) = 1;
+  const auto syndromes = details::bch_syndromes (field, received, 2);
+  ASSERT_EQ (syndromes.size (), 4);
+  EXPECT_EQ (syndromes[0], field.add (field.exp (2), field.exp (9)));
+  EXPECT_EQ (syndromes[1], field.mul (syndromes[0], syndromes[0]));
+
+  const auto locator = details::berlekamp_massey (field, syndromes);
+  const std::vector<element_type> expected{
+    1, field.add (field.exp (2), field.exp (9)), field.exp (11)
+  };
+  EXPECT_EQ (locator, expected);
+  EXPECT_EQ (details::chien_search (field, locator, 15),
+             (std::vector<std::size_t>{ 2, 9 }));
+}
+
+TEST (TestBCH, TestChienSearchPaths)
+{
+  // Whichever kernel is dispatched to has to agree with the portable one,
+  // including at lengths which are not a multiple of the vector width.
+  const details::galois_field field{ 10 };
+  std::mt19937_64 gen{ 10 };
+  for (std::size_t trial = 0; trial < 20; ++trial)
+    {
+      std::vector<element_type> locator{ 1 };
+      for (std::size_t j = 0; j <= trial; ++j)
+        locator.push_back (gen () % (field.order () + 1));
+      for (const std::size_t n : { 1023ul, 1000ul, 13ul })
+        EXPECT_EQ (details::chien_search (field, locator, n),
+                   details::chien_search_scalar (field, locator, n));
+    }
+}
+
+TEST (TestBCH, TestDecode)
+{
+  using enum linearcode::decoding_strategy;
+
+  std::mt19937_64 gen{ 29 };
+  for (const auto &[m, t] :
+       { std::pair{ 4ul, 2ul }, std::pair{ 8ul, 8ul },
+         std::pair{ 10ul, 16ul } })
+    {
+      auto code = linearcode::bch (m, t);
+      const std::size_t n = code.properties ().word_size;
+      const std::size_t k = code.properties ().basis_size;
+      for (std::size_t trial = 0; trial < 20; ++trial)
+        {
+          const infoword iword = random_infoword (k, gen);
+          const codeword error = random_error (n, trial % (t + 1), gen);
+          const auto result = code.decode<ChienSearch> (
+              code.encode (iword) + error);
+          EXPECT_EQ (result.iword, iword);
+          EXPECT_EQ (result.error, error);
+        }
+    }
+
+  // Auto picks the algebraic decoder, which agrees with the tables.
+  auto bch2 = linearcode::bch (4, 2);
+  auto bch2_ = bch2;
+  const codeword received = bch2.encode (random_infoword (7, gen))
+                            + random_error (15, 2, gen);
+  EXPECT_EQ (bch2.decode<Auto> (received).error,
+             bch2_.decode<Syndromes> (received).error);
+}
+
+TEST (TestBCH, TestDecodeFailures)
+{
+  using enum linearcode::decoding_strategy;
+
+  // Three errors at these positions are detected by the [15, 7, 5] code,
+  // since no codeword is within distance 2 of the received word.
+  auto code = linearcode::bch (4, 2);
+  codeword received{ Eigen::RowVectorXi::Zero (15) };
+  received.vec (0) = received.vec (1) = received.vec (3) = 1;
+  EXPECT_THROW ((void)code.decode<ChienSearch> (received),
+                linearcode_exception);
+
+  auto hamming = linearcode::hamming (3);
+  EXPECT_THROW ((void)hamming.decode<ChienSearch> (codeword{ "1100110" }),
+                linearcode_exception);
+}
+
+TEST (TestBCH, TestSharedAcrossThreads)
+{
+  // Nothing is built yet when the threads decode with the code at once.
+  auto code = linearcode::bch (6, 3);
+  const std::size_t n = code.properties ().word_size;
+  const std::size_t k = code.properties ().basis_size;
+  std::mt19937_64 gen{ 63 };
+  std::vector<infoword> iwords;
+  std::vector<codeword> received;
+  for (std::size_t w = 0; w < 32; ++w)
+    {
+      iwords.push_back (random_infoword (k, gen));
+      received.push_back (code.encode (iwords.back ())
+                          + random_error (n, w % 4, gen));
+    }
+
+  std::vector<std::size_t> wrong (4, 0);
+  {
+    std::vector<std::jthread> threads;
+    for (std::size_t t = 0; t < wrong.size (); ++t)
+      threads.emplace_back ([&, t] {
+        wrong[t] += code.generator_matrix ().rows () != long (k);
+        for (std::size_t w = 0; w < received.size (); ++w)
+          wrong[t] += code.decode (received[w]).iword != iwords[w];
+      });
+  }
+  for (const std::size_t count : wrong)
+    EXPECT_EQ (count, 0);
+}
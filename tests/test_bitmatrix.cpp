@@ -0,0 +1,137 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <patrick/bitmatrix.h>
+
+using namespace patrick;
+using details::bitmatrix;
+
+///
+/// Helpers
+///
+
+static bitmatrix
+random_bitmatrix (std::size_t rows, std::size_t cols, std::uint64_t seed)
+{
+  std::mt19937_64 gen{ seed };
+  bitmatrix m (rows, cols);
+  for (std::size_t r = 0; r < rows; ++r)
+    for (std::size_t c = 0; c < cols; ++c)
+      m.set (r, c, gen () & 1);
+  return m;
+}
+
+static bool
+is_reduced_echelon_form (const bitmatrix &m,
+                         const std::vector<std::size_t> &pivots)
+{
+  for (std::size_t i = 0; i < pivots.size (); ++i)
+    {
+      if (i > 0 && pivots[i] <= pivots[i - 1])
+        return false;
+      for (std::size_t r = 0; r < m.rows (); ++r)
+        if (m.get (r, pivots[i]) != (r == i))
+          return false;
+      for (std::size_t c = 0; c < pivots[i]; ++c)
+        if (m.get (i, c))
+          return false;
+    }
+  for (std::size_t r = pivots.size (); r < m.rows (); ++r)
+    for (std::size_t c = 0; c < m.cols (); ++c)
+      if (m.get (r, c))
+        return false;
+  return true;
+}
+
+TEST (TestBitmatrix, TestEigenRoundTrip)
+{
+  Eigen::MatrixXi m{ 3, 5 };
+  // clang-format off
+  m << 1, 0, 3, 0, 1,
+       0, 1, 1, 2, 0,
+       1, 1, 0, 1, 1;
+  // clang-format on
+
+  const auto packed = bitmatrix::from_eigen (m);
+  EXPECT_EQ (packed.rows (), 3);
+  EXPECT_EQ (packed.cols (), 5);
+  EXPECT_EQ (packed.stride (), 1);
+  EXPECT_TRUE (packed.get (0, 2));
+  EXPECT_FALSE (packed.get (1, 3));
+
+  const Eigen::MatrixXi expected = m.unaryExpr ([] (int x) { return x % 2; });
+  EXPECT_EQ (packed.to_eigen (), expected);
+}
+
+TEST (TestBitmatrix, TestTranspose)
+{
+  for (const auto &[rows, cols] :
+       { std::pair{ 7ul, 5ul }, std::pair{ 64ul, 64ul },
+         std::pair{ 100ul, 300ul } })
+    {
+      const auto m = random_bitmatrix (rows, cols, rows * cols);
+      const auto t = m.transpose ();
+      ASSERT_EQ (t.rows (), cols);
+      ASSERT_EQ (t.cols (), rows);
+      for (std::size_t r = 0; r < rows; ++r)
+        for (std::size_t c = 0; c < cols; ++c)
+          EXPECT_EQ (m.get (r, c), t.get (c, r));
+      EXPECT_EQ (t.transpose (), m);
+    }
+}
+
+TEST (TestBitmatrix, TestReduceFullRank)
+{
+  Eigen::MatrixXi g{ 3, 6 };
+  // clang-format off
+  g << 0, 1, 1, 0, 1, 1,
+       1, 1, 0, 1, 0, 0,
+       1, 0, 0, 0, 1, 1;
+  // clang-format on
+
+  auto m = bitmatrix::from_eigen (g);
+  const auto pivots = details::reduce_to_echelon_form (m);
+  EXPECT_EQ (pivots, (std::vector<std::size_t>{ 0, 1, 2 }));
+  EXPECT_TRUE (is_reduced_echelon_form (m, pivots));
+}
+
+TEST (TestBitmatrix, TestReduceRankDeficient)
+{
+  Eigen::MatrixXi g{ 3, 4 };
+  // clang-format off
+  g << 0, 1, 1, 0,
+       0, 1, 0, 1,
+       0, 0, 1, 1;
+  // clang-format on
+
+  auto m = bitmatrix::from_eigen (g);
+  const auto pivots = details::reduce_to_echelon_form (m);
+  EXPECT_EQ (pivots, (std::vector<std::size_t>{ 1, 2 }));
+  EXPECT_TRUE (is_reduced_echelon_form (m, pivots));
+}
+
+TEST (TestBitmatrix, TestReduceLarge)
+{
+  // Large enough to use groups of 8 pivots per lookup table.
+  auto m = random_bitmatrix (600, 2000, 42);
+  const auto original = m;
+  const auto pivots = details::reduce_to_echelon_form (m);
+  EXPECT_EQ (pivots.size (), 600);
+  EXPECT_TRUE (is_reduced_echelon_form (m, pivots));
+
+  // The reduced rows must span the original rows: reducing each original row
+  // by the pivot rows has to give zero.
+  for (std::size_t r = 0; r < original.rows (); r += 37)
+    {
+      bitmatrix row (1, original.cols ());
+      std::copy_n (original.row (r), original.stride (), row.row (0));
+      for (std::size_t i = 0; i < pivots.size (); ++i)
+        if (row.get (0, pivots[i]))
+          for (std::size_t b = 0; b < row.stride (); ++b)
+            row.row (0)[b] ^= m.row (i)[b];
+      EXPECT_TRUE (row.is_zero ());
+    }
+}
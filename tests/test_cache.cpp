@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <barrier>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <patrick/cache.h>
+#include <patrick/core.h>
+
+using namespace patrick;
+
+namespace
+{
+
+///
+/// \brief Lifts the budget once a test is over, even if it fails.
+///
+struct budget_guard
+{
+  explicit budget_guard (std::size_t bytes) { set_cache_budget (bytes); }
+  ~budget_guard () { set_cache_budget (0); }
+};
+
+linearcode
+generic_hamming (std::size_t r)
+{
+  return linearcode::from_generator (
+      linearcode::hamming (r).generator_matrix ());
+}
+
+} // namespace
+
+TEST (TestCache, TestAccounting)
+{
+  const auto before = current_cache_usage ();
+  EXPECT_EQ (before.budget, 0);
+  {
+    auto code = generic_hamming (3);
+    (void)code.syndrome_table ();
+    const auto built = current_cache_usage ();
+    EXPECT_EQ (built.tables, before.tables + 1);
+    const std::size_t bytes = built.bytes - before.bytes;
+    EXPECT_GT (bytes, 0);
+
+    // A copy holds tables of its own, while a move takes them over.
+    auto copy = code;
+    EXPECT_EQ (current_cache_usage ().bytes, before.bytes + 2 * bytes);
+    EXPECT_EQ (current_cache_usage ().tables, before.tables + 2);
+    auto moved = std::move (code);
+    EXPECT_EQ (current_cache_usage ().bytes, before.bytes + 2 * bytes);
+  }
+  EXPECT_EQ (current_cache_usage ().bytes, before.bytes);
+  EXPECT_EQ (current_cache_usage ().tables, before.tables);
+}
+
+TEST (TestCache, TestEvictsLeastRecentlyUsed)
+{
+  using enum linearcode::decoding_strategy;
+  auto a = generic_hamming (4);
+  auto b = generic_hamming (4);
+  auto c = generic_hamming (4);
+  const auto cword = a.encode (infoword{ 0b101, 11 });
+
+  const auto before = current_cache_usage ();
+  (void)a.decode<Syndromes> (cword);
+  const std::size_t bytes = current_cache_usage ().bytes - before.bytes;
+  const budget_guard guard{ 2 * bytes + bytes / 2 };
+  (void)b.decode<Syndromes> (cword);
+  (void)a.decode<Syndromes> (cword);
+  const std::size_t b_bytes = b.cache_bytes ();
+
+  // The table of b is the least recently used one.
+  (void)c.decode<Syndromes> (cword);
+  auto usage = current_cache_usage ();
+  EXPECT_EQ (usage.evictions, before.evictions + 1);
+  EXPECT_EQ (usage.tables, before.tables + 2);
+  EXPECT_LE (usage.bytes, usage.budget);
+  EXPECT_EQ (b.cache_bytes (), b_bytes - bytes);
+  EXPECT_EQ (a.cache_bytes (), b_bytes);
+
+  // It is built again once it is needed.
+  EXPECT_EQ (b.decode<Syndromes> (cword).iword, infoword (0b101, 11));
+  EXPECT_EQ (b.cache_bytes (), b_bytes);
+
+  // A smaller budget evicts right away.
+  set_cache_budget (1);
+  usage = current_cache_usage ();
+  EXPECT_EQ (usage.tables, before.tables);
+  EXPECT_EQ (usage.bytes, before.bytes);
+}
+
+TEST (TestCache, TestDowngrades)
+{
+  using enum linearcode::decoding_strategy;
+  const budget_guard guard{ 1 };
+  const auto before = current_cache_usage ();
+
+  auto code = generic_hamming (3);
+  const infoword iword{ 0b1011, 4 };
+  codeword received = code.encode (iword);
+  received.vec (5) ^= 1;
+  for (const auto &result : { code.decode<SlepyanTable> (received),
+                              code.decode<Syndromes> (received),
+                              code.decode (received) })
+    {
+      EXPECT_EQ (result.iword, iword);
+      EXPECT_EQ (result.error.weight (), 1);
+    }
+
+  std::vector<std::uint64_t> words (3);
+  std::vector<std::uint64_t> iwords{ 0b1011, 0b0110, 0b1111 };
+  code.encode_batch (iwords, words, 3);
+  words[1] ^= 0b1000;
+  std::vector<std::uint64_t> decoded (3);
+  EXPECT_EQ (code.decode_batch (words, decoded, 3), 0);
+  EXPECT_EQ (decoded, iwords);
+
+  // No table was built.
+  EXPECT_EQ (current_cache_usage ().tables, before.tables);
+
+  // The search goes on past t errors, and finds the leaders of the table.
+  auto golay = linearcode::from_generator (
+      linearcode::golay24 ().generator_matrix ());
+  codeword far = golay.encode (infoword{ 0, 12 });
+  for (const long p : { 0, 5, 13, 20 })
+    far.vec (p) = 1;
+  const auto heavy = golay.decode<Syndromes> (far);
+  EXPECT_EQ (heavy.error.weight (), 4);
+  EXPECT_TRUE (golay.contains (far + heavy.error));
+  far.vec (20) = 0;
+  EXPECT_EQ (golay.decode<Syndromes> (far).error.weight (), 3);
+
+  // A word with two errors is as far from several codewords of the extended
+  // Hamming code, and the search picks the same one as the table.
+  auto searched = linearcode::from_generator (
+      linearcode::reed_muller (1, 3).generator_matrix ());
+  std::vector<linearcode::decoding_result> results;
+  for (unsigned long long w = 0; w < 256; ++w)
+    results.push_back (searched.decode<Syndromes> (codeword{ w, 8 }));
+  EXPECT_EQ (current_cache_usage ().tables, before.tables);
+
+  set_cache_budget (0);
+  auto tabled = linearcode::from_generator (
+      linearcode::reed_muller (1, 3).generator_matrix ());
+  for (unsigned long long w = 0; w < 256; ++w)
+    {
+      const auto result = tabled.decode<Syndromes> (codeword{ w, 8 });
+      EXPECT_EQ (results[w].iword, result.iword);
+      EXPECT_EQ (results[w].error, result.error);
+    }
+  EXPECT_EQ (results[0b11000000].error.weight (), 2);
+}
+
+TEST (TestCache, TestRebuildsOnceAcrossThreads)
+{
+  using enum linearcode::decoding_strategy;
+  auto code = generic_hamming (4);
+  std::vector<infoword> iwords;
+  std::vector<codeword> received;
+  for (std::size_t w = 0; w < 15; ++w)
+    {
+      iwords.emplace_back ((w * 0x2d5) & 0x7ff, 11);
+      received.push_back (code.encode (iwords.back ()));
+      // A single error, which the code corrects.
+      received.back ().vec (long (w)) ^= 1;
+    }
+
+  const auto before = current_cache_usage ();
+  (void)code.decode<Syndromes> (received.front ());
+  const std::size_t bytes = current_cache_usage ().bytes - before.bytes;
+  // Room for the table of one code only.
+  const budget_guard guard{ bytes + bytes / 2 };
+
+  // Each round, the table which another code builds again evicts the one of
+  // the idle code, and then all workers need it again at once, which evicts
+  // the other table in turn.
+  constexpr int rounds = 20;
+  constexpr int num_workers = 4;
+  std::barrier sync{ num_workers + 1 };
+  std::atomic<std::size_t> wrong{ 0 };
+  std::vector<std::thread> workers;
+  for (int i = 0; i < num_workers; ++i)
+    workers.emplace_back ([&] {
+      for (int round = 0; round < rounds; ++round)
+        {
+          sync.arrive_and_wait ();
+          for (std::size_t w = 0; w < received.size (); ++w)
+            if (code.decode<Syndromes> (received[w]).iword != iwords[w])
+              ++wrong;
+          sync.arrive_and_wait ();
+        }
+    });
+
+  auto other = generic_hamming (4);
+  for (int round = 0; round < rounds; ++round)
+    {
+      (void)other.decode<Syndromes> (received.front ());
+      sync.arrive_and_wait ();
+      sync.arrive_and_wait ();
+    }
+  for (auto &worker : workers)
+    worker.join ();
+
+  EXPECT_EQ (wrong.load (), 0);
+  EXPECT_GE (current_cache_usage ().evictions,
+             before.evictions + 2 * rounds - 1);
+}
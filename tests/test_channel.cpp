@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+
+#include <patrick/channel.h>
+
+using namespace patrick;
+
+TEST (TestChannel, TestXoshiro)
+{
+  details::xoshiro256pp gen{ 42 };
+  details::xoshiro256pp same{ 42 };
+  details::xoshiro256pp other{ 43 };
+  std::size_t equal = 0;
+  for (std::size_t i = 0; i < 1000; ++i)
+    {
+      const auto x = gen ();
+      EXPECT_EQ (x, same ());
+      equal += x == other ();
+      const double u = gen.uniform ();
+      EXPECT_EQ (u, same.uniform ());
+      EXPECT_GT (u, 0.0);
+      EXPECT_LE (u, 1.0);
+    }
+  EXPECT_EQ (equal, 0);
+}
+
+TEST (TestChannel, TestBinarySymmetricChannel)
+{
+  // The number of flips is within 5 standard deviations of its mean.
+  for (const double p : { 1e-4, 0.01, 0.3 })
+    {
+      binary_symmetric_channel channel{ p, 7 };
+      const std::size_t num_bits = 1 << 22;
+      std::vector<std::uint64_t> bits (num_bits / 64, 0);
+      channel.corrupt (bits, num_bits);
+      std::size_t flips = 0;
+      for (const auto b : bits)
+        flips += std::popcount (b);
+      const double mean = p * num_bits;
+      EXPECT_NEAR (flips, mean, 5 * std::sqrt (mean * (1 - p)));
+    }
+
+  binary_symmetric_channel never{ 0, 1 };
+  binary_symmetric_channel always{ 1, 1 };
+  const codeword zero{ 0, 100 };
+  EXPECT_EQ (never.transmit (zero), zero);
+  EXPECT_EQ (always.transmit (zero).weight (), 100);
+
+  EXPECT_THROW ((binary_symmetric_channel{ -0.1, 1 }), channel_exception);
+  EXPECT_THROW ((binary_symmetric_channel{ 1.5, 1 }), channel_exception);
+}
+
+TEST (TestChannel, TestReproducibleStreams)
+{
+  // The flips do not depend on how the stream is split into calls.
+  const std::size_t num_bits = 64 * 1000;
+  binary_symmetric_channel whole{ 0.02, 99 };
+  std::vector<std::uint64_t> expected (num_bits / 64, 0);
+  whole.corrupt (expected, num_bits);
+
+  binary_symmetric_channel pieces{ 0.02, 99 };
+  std::vector<std::uint64_t> bits (num_bits / 64, 0);
+  for (std::size_t start = 0; start < num_bits; start += 640)
+    {
+      std::vector<std::uint64_t> piece (10, 0);
+      pieces.corrupt (piece, 640);
+      std::copy (piece.cbegin (), piece.cend (), bits.begin () + start / 64);
+    }
+  EXPECT_EQ (bits, expected);
+
+  pieces.reseed (99);
+  std::fill (bits.begin (), bits.end (), 0);
+  pieces.corrupt (bits, num_bits);
+  EXPECT_EQ (bits, expected);
+}
+
+TEST (TestChannel, TestPhilox)
+{
+  // The known answers of Random123.
+  using block_type = details::philox4x32::block_type;
+  EXPECT_EQ (details::philox4x32::encrypt ({ 0, 0, 0, 0 }, { 0, 0 }),
+             (block_type{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }));
+  EXPECT_EQ (details::philox4x32::encrypt (
+                 { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff },
+                 { 0xffffffff, 0xffffffff }),
+             (block_type{ 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }));
+  EXPECT_EQ (details::philox4x32::encrypt (
+                 { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 },
+                 { 0xa4093822, 0x299f31d0 }),
+             (block_type{ 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }));
+
+  details::philox4x32 gen{ 5, 1 };
+  details::philox4x32 other{ 5, 2 };
+  const auto first = gen ();
+  EXPECT_NE (first, other ());
+  EXPECT_EQ (first, (details::philox4x32{ 5, 1 }) ());
+}
+
+TEST (TestChannel, TestGaussianGenerator)
+{
+  // The kernels agree.
+  details::gaussian_generator::state_type state{};
+  details::gaussian_generator::state_type same{};
+  for (std::size_t i = 0; i < state.size (); ++i)
+    state[i] = same[i] = 0x9e3779b97f4a7c15ull * (i + 1);
+  std::vector<float> expected (64 * 16);
+  std::vector<float> normals (64 * 16);
+  details::gaussian_blocks_scalar (state, expected.data (), 64);
+  details::gaussian_blocks (same, normals.data (), 64);
+  EXPECT_EQ (state, same);
+  for (std::size_t i = 0; i < normals.size (); ++i)
+    EXPECT_FLOAT_EQ (normals[i], expected[i]);
+
+  // The moments and the tails are within 5 standard deviations of theirs.
+  details::gaussian_generator gen{ 41 };
+  const std::size_t count = 1 << 20;
+  normals.resize (count);
+  gen.fill (normals);
+  double sum = 0;
+  double squares = 0;
+  std::size_t tails = 0;
+  for (const float x : normals)
+    {
+      sum += x;
+      squares += x * x;
+      tails += std::abs (x) > 2;
+    }
+  EXPECT_NEAR (sum / count, 0, 5 / std::sqrt (count));
+  EXPECT_NEAR (squares / count, 1, 5 * std::sqrt (2.0 / count));
+  const double tail = std::erfc (2 / std::sqrt (2.0));
+  EXPECT_NEAR (tails, tail * count, 5 * std::sqrt (tail * count));
+
+  // The normals do not depend on how the stream is split into calls.
+  details::gaussian_generator whole{ 7 };
+  details::gaussian_generator pieces{ 7 };
+  expected.resize (1000);
+  whole.fill (expected);
+  normals.resize (1000);
+  for (std::size_t start = 0; start < 1000; start += 40)
+    pieces.fill (std::span<float>{ normals }.subspan (start, 40));
+  EXPECT_EQ (normals, expected);
+}
+
+TEST (TestChannel, TestAwgnChannel)
+{
+  // A bit is flipped by the hard decision with probability Q(1 / sigma).
+  auto channel = awgn_channel::from_ebn0 (2, 0.5, 3);
+  const double sigma = channel.noise_deviation ();
+  EXPECT_NEAR (sigma, std::sqrt (1 / std::pow (10.0, 0.2)), 1e-12);
+
+  const std::size_t num_bits = 1 << 20;
+  std::vector<std::uint64_t> bits (num_bits / 64, 0x00ff00ff00ff00ffull);
+  std::vector<float> llrs (num_bits);
+  channel.transmit (bits, num_bits, llrs);
+  std::size_t flips = 0;
+  for (std::size_t i = 0; i < num_bits; ++i)
+    flips += (llrs[i] < 0) != bool ((bits[i / 64] >> (i % 64)) & 1);
+  const double p = 0.5 * std::erfc (1 / (sigma * std::sqrt (2.0)));
+  EXPECT_NEAR (flips, p * num_bits, 5 * std::sqrt (p * num_bits));
+
+  awgn_channel quiet{ 1e-3, 1 };
+  const codeword cword{ 0b1011, 6 };
+  const auto received = quiet.transmit (cword);
+  ASSERT_EQ (received.size (), 6);
+  for (std::size_t i = 0; i < 6; ++i)
+    EXPECT_NEAR (received[i], cword.vec (i) ? -2e6 : 2e6, 2e4);
+
+  EXPECT_THROW ((awgn_channel{ 0, 1 }), channel_exception);
+  EXPECT_THROW ((void)awgn_channel::from_ebn0 (0, 0, 1), channel_exception);
+}
+
+TEST (TestChannel, TestGilbertElliottChannel)
+{
+  const gilbert_elliott_channel::parameters_type parameters{
+    .good_to_bad = 0.001, .bad_to_good = 0.05, .good_error = 0.0005,
+    .bad_error = 0.3
+  };
+  gilbert_elliott_channel channel{ parameters, 11 };
+  const double p = channel.crossover_probability ();
+  EXPECT_NEAR (p, (50 * 0.0005 + 0.3) / 51, 1e-12);
+
+  const std::size_t num_bits = 1 << 23;
+  std::vector<std::uint64_t> bits (num_bits / 64, 0);
+  channel.corrupt (bits, num_bits);
+
+  // The flips are in bursts: a flip is far more likely right after another
+  // one than on average. The mean is loose, since the bursts are long.
+  std::size_t flips = 0;
+  std::size_t pairs = 0;
+  bool previous = false;
+  for (std::size_t i = 0; i < num_bits; ++i)
+    {
+      const bool flip = (bits[i / 64] >> (i % 64)) & 1;
+      flips += flip;
+      pairs += flip && previous;
+      previous = flip;
+    }
+  EXPECT_NEAR (double (flips) / num_bits, p, 0.2 * p);
+  EXPECT_GT (double (pairs) / flips, 0.2);
+
+  // The flips do not depend on how the stream is split into calls.
+  gilbert_elliott_channel pieces{ parameters, 11 };
+  std::vector<std::uint64_t> split (num_bits / 64, 0);
+  for (std::size_t start = 0; start < num_bits; start += 6400)
+    {
+      std::vector<std::uint64_t> piece (100, 0);
+      pieces.corrupt (piece, std::min<std::size_t> (6400, num_bits - start));
+      std::copy_n (piece.cbegin (),
+                   std::min<std::size_t> (100, split.size () - start / 64),
+                   split.begin () + start / 64);
+    }
+  EXPECT_EQ (split, bits);
+
+  // Without transitions, it is a binary symmetric channel.
+  gilbert_elliott_channel good{ { .good_to_bad = 0, .good_error = 1 }, 1 };
+  EXPECT_FALSE (good.is_bad ());
+  EXPECT_EQ (good.transmit (codeword{ 0, 70 }).weight (), 70);
+
+  EXPECT_THROW ((gilbert_elliott_channel{ { .bad_to_good = 0 }, 1 }),
+                channel_exception);
+  EXPECT_THROW ((gilbert_elliott_channel{ { .bad_error = 2 }, 1 }),
+                channel_exception);
+}
+
+TEST (TestChannel, TestBinaryErasureChannel)
+{
+  binary_erasure_channel channel{ 0.05, 5 };
+  const std::size_t num_bits = 1 << 20;
+  std::vector<std::uint64_t> bits (num_bits / 64, ~std::uint64_t{ 0 });
+  std::vector<std::uint64_t> erasures (num_bits / 64, ~std::uint64_t{ 0 });
+  channel.erase (bits, erasures, num_bits);
+
+  // The erased bits, and only those, are cleared.
+  std::size_t count = 0;
+  for (std::size_t b = 0; b < bits.size (); ++b)
+    {
+      EXPECT_EQ (bits[b], ~erasures[b]);
+      count += std::popcount (erasures[b]);
+    }
+  const double mean = 0.05 * num_bits;
+  EXPECT_NEAR (count, mean, 5 * std::sqrt (mean * 0.95));
+
+  binary_erasure_channel never{ 0, 1 };
+  binary_erasure_channel always{ 1, 1 };
+  const codeword cword{ 0b110101, 6 };
+  const auto kept = never.transmit (cword);
+  EXPECT_EQ (kept.word, cword);
+  EXPECT_EQ (kept.erasures.weight (), 0);
+  const auto lost = always.transmit (cword);
+  EXPECT_EQ (lost.word.weight (), 0);
+  EXPECT_EQ (lost.erasures.weight (), 6);
+
+  EXPECT_THROW ((binary_erasure_channel{ -1, 1 }), channel_exception);
+}
@@ -0,0 +1,207 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/convolutional.h>
+
+using namespace patrick;
+using bit_type = convolutional_code::bit_type;
+
+///
+/// Helpers
+///
+
+static std::vector<bit_type>
+random_bits (std::size_t size, std::mt19937_64 &gen)
+{
+  std::vector<bit_type> result (size);
+  for (auto &b : result)
+    b = gen () & 1;
+  return result;
+}
+
+///
+/// \brief Flips a bit in every \a spacing of them.
+///
+static void
+flip_spaced (std::vector<bit_type> &bits, std::size_t spacing,
+             std::mt19937_64 &gen)
+{
+  for (std::size_t i = 0; i + spacing <= bits.size (); i += spacing)
+    bits[i + gen () % spacing] ^= 1;
+}
+
+TEST (TestConvolutional, TestAddCompareSelect)
+{
+  std::mt19937_64 gen{ 9 };
+  using metric_type = details::trellis::metric_type;
+  using decision_type = details::trellis::decision_type;
+  for (std::size_t k = 2; k <= 9; ++k)
+    for (std::size_t n = 2; n <= 8; n += 3)
+      {
+        std::vector<std::uint32_t> polynomials (n);
+        for (auto &p : polynomials)
+          p = 1 + gen () % ((1u << k) - 1);
+        const details::trellis trellis{ k, polynomials };
+
+        std::vector<metric_type> symbols (n);
+        std::vector<metric_type> metrics (trellis.num_states ());
+        for (std::size_t trial = 0; trial < 20; ++trial)
+          {
+            for (auto &s : symbols)
+              s = static_cast<metric_type> (gen () % 127) - 63;
+            for (auto &m : metrics)
+              m = gen () % 10000;
+            std::vector<metric_type> next (metrics.size ());
+            std::vector<metric_type> scalar_next (metrics.size ());
+            std::vector<decision_type> decisions (trellis.decision_words ());
+            std::vector<decision_type> scalar_decisions (decisions.size ());
+            trellis.add_compare_select (symbols, metrics, next, decisions);
+            trellis.add_compare_select_scalar (symbols, metrics, scalar_next,
+                                               scalar_decisions);
+            EXPECT_EQ (next, scalar_next);
+            EXPECT_EQ (decisions, scalar_decisions);
+          }
+      }
+}
+
+TEST (TestConvolutional, TestEncode)
+{
+  const convolutional_code code{ 3, { 07, 05 } };
+  EXPECT_EQ (code.properties ().num_states, 4);
+  EXPECT_DOUBLE_EQ (code.rate (), 0.5);
+
+  // The impulse response interleaves 111 and 101.
+  const std::vector<bit_type> impulse{ 1 };
+  EXPECT_EQ (code.encode (impulse),
+             (std::vector<bit_type>{ 1, 1, 1, 0, 1, 1 }));
+  EXPECT_EQ (code.encode (impulse, false), (std::vector<bit_type>{ 1, 1 }));
+
+  const std::vector<bit_type> message{ 1, 0, 1, 1 };
+  EXPECT_EQ (code.encode (message),
+             (std::vector<bit_type>{ 1, 1, 1, 0, 0, 0, 0, 1, 0, 1, 1, 1 }));
+
+  EXPECT_THROW ((convolutional_code{ 10, { 01111, 01001 } }),
+                convolutional_code_exception);
+  EXPECT_THROW ((convolutional_code{ 3, { 07 } }),
+                convolutional_code_exception);
+  EXPECT_THROW ((convolutional_code{ 3, { 017, 05 } }),
+                convolutional_code_exception);
+  EXPECT_THROW ((convolutional_code{ 3, { 03, 01 } }),
+                convolutional_code_exception);
+  Eigen::MatrixXi pattern (2, 2);
+  pattern << 1, 0, 1, 0;
+  EXPECT_THROW ((convolutional_code{ 3, { 07, 05 }, pattern }),
+                convolutional_code_exception);
+  EXPECT_THROW ((viterbi_decoder{ code, 2 }), convolutional_code_exception);
+}
+
+TEST (TestConvolutional, TestHardDecode)
+{
+  std::mt19937_64 gen{ 7 };
+  for (const auto &[k, polynomials] :
+       { std::pair{ 3ul, std::vector<std::uint32_t>{ 07, 05 } },
+         std::pair{ 7ul, std::vector<std::uint32_t>{ 0171, 0133 } },
+         std::pair{ 9ul, std::vector<std::uint32_t>{ 0753, 0561 } },
+         std::pair{ 7ul, std::vector<std::uint32_t>{ 0171, 0133, 0165 } } })
+    {
+      const convolutional_code code{ k, polynomials };
+      const auto message = random_bits (1000, gen);
+      auto received = code.encode (message);
+      EXPECT_EQ (received.size (), (1000 + k - 1) * polynomials.size ());
+      EXPECT_EQ (code.decode (received), message);
+
+      // Errors far apart are within the free distance.
+      flip_spaced (received, 12 * k, gen);
+      EXPECT_EQ (code.decode (received), message);
+    }
+}
+
+TEST (TestConvolutional, TestSoftDecode)
+{
+  const convolutional_code code{ 7, { 0171, 0133 } };
+  std::mt19937_64 gen{ 71 };
+  const auto message = random_bits (5000, gen);
+  const auto transmitted = code.encode (message);
+
+  // BPSK over an AWGN channel at Eb/N0 = 4 dB.
+  const float sigma = std::sqrt (1.0f / (2 * 0.5f * std::pow (10.0f, 0.4f)));
+  std::normal_distribution<float> noise{ 0.0f, sigma };
+  std::vector<float> llrs;
+  std::vector<bit_type> hard;
+  for (const bit_type b : transmitted)
+    {
+      const float y = (b ? -1.0f : 1.0f) + noise (gen);
+      llrs.push_back (2 * y / (sigma * sigma));
+      hard.push_back (y < 0);
+    }
+
+  const auto soft_decoded = code.decode_soft (llrs);
+  const auto hard_decoded = code.decode (hard);
+  std::size_t soft_errors = 0;
+  std::size_t hard_errors = 0;
+  for (std::size_t i = 0; i < message.size (); ++i)
+    {
+      soft_errors += soft_decoded[i] != message[i];
+      hard_errors += hard_decoded[i] != message[i];
+    }
+  EXPECT_EQ (soft_errors, 0);
+  EXPECT_GT (hard_errors, soft_errors);
+}
+
+TEST (TestConvolutional, TestPuncturing)
+{
+  // Rate 3/4 from the rate 1/2 code, as in 802.11.
+  Eigen::MatrixXi pattern (2, 3);
+  pattern << 1, 1, 0, 1, 0, 1;
+  const convolutional_code code{ 7, { 0133, 0171 }, pattern };
+  EXPECT_DOUBLE_EQ (code.rate (), 0.75);
+
+  std::mt19937_64 gen{ 34 };
+  for (const std::size_t size : { 600ul, 601ul, 602ul })
+    {
+      const auto message = random_bits (size, gen);
+      auto received = code.encode (message);
+      EXPECT_EQ (received.size (), (4 * (size + 6) + 2) / 3);
+      EXPECT_EQ (code.decode (received), message);
+
+      flip_spaced (received, 100, gen);
+      EXPECT_EQ (code.decode (received), message);
+    }
+}
+
+TEST (TestConvolutional, TestStream)
+{
+  Eigen::MatrixXi pattern (2, 2);
+  pattern << 1, 1, 1, 0;
+  std::mt19937_64 gen{ 17 };
+  for (const auto &code : { convolutional_code{ 7, { 0171, 0133 } },
+                            convolutional_code{ 7, { 0171, 0133 }, pattern } })
+    {
+      const auto message = random_bits (20000, gen);
+      auto received = code.encode (message, false);
+      flip_spaced (received, 150, gen);
+
+      // Pushed in pieces of any size, bits come out as they become final.
+      viterbi_decoder decoder{ code };
+      std::vector<bit_type> decoded;
+      for (std::size_t i = 0; i < received.size ();)
+        {
+          const std::size_t size
+              = std::min (gen () % 300, received.size () - i);
+          decoder.push_hard (std::span{ received }.subspan (i, size),
+                             decoded);
+          i += size;
+          EXPECT_GE (decoded.size () + 2 * decoder.traceback_depth (),
+                     i * code.rate ());
+        }
+      decoder.finish (false, decoded);
+      EXPECT_EQ (decoded, message);
+
+      // The decoder is ready for another stream.
+      decoded.clear ();
+      decoder.push_hard (code.encode (message), decoded);
+      decoder.finish (true, decoded);
+      EXPECT_EQ (decoded, message);
+    }
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <memory_resource>
+
 #include <Eigen/Dense>
 #include <fmt/os.h>
 #include <fmt/ostream.h>
@@ -154,23 +156,58 @@ TEST_F (Hamming84Test, TestProperties)
   EXPECT_EQ (props.max_errors_correct, 1);
 }
 
-// TEST_F (Hamming74Test, TestDual)
-//{
-//   auto dual = linearcode::from_dual(code);
+TEST_F (Hamming74Test, TestDual)
+{
+  const auto dual = linearcode::from_dual (code);
+  const auto &props = dual.properties ();
+  EXPECT_EQ (props.basis_size, 3);
+  EXPECT_EQ (props.word_size, 7);
+  EXPECT_EQ (props.min_distance, 4);
+
+  // Every codeword of the dual is orthogonal to every codeword of the code.
+  for (const auto &c : *code.codewords ())
+    for (const auto &d : *dual.codewords ())
+      EXPECT_EQ ((c.vec.dot (d.vec)) % 2, 0);
+
+  const auto dual_of_dual = linearcode::from_dual (dual);
+  EXPECT_EQ (dual_of_dual.properties ().basis_size, 4);
+  for (const auto &c : *code.codewords ())
+    EXPECT_TRUE (dual_of_dual.contains (c));
+}
+
+TEST_F (Hamming74Test, TestFromParityEquations)
+{
+  const auto from_h = linearcode::from_parity_equations (H);
+  EXPECT_EQ (from_h.properties ().basis_size, 4);
+  EXPECT_EQ (from_h.properties ().min_distance, 3);
+  for (const auto &c : *code.codewords ())
+    EXPECT_TRUE (from_h.contains (c));
+
+  // Redundant equations do not change the code.
+  Eigen::MatrixXi H_{ 4, 7 };
+  H_ << H, H.row (0) + H.row (2);
+  const auto from_h_ = linearcode::from_parity_equations (H_);
+  EXPECT_EQ (from_h_.properties ().basis_size, 4);
+  for (const auto &c : *code.codewords ())
+    EXPECT_TRUE (from_h_.contains (c));
+}
 
-//  auto out = fmt::output_file ("codewords_of_hamming74_dual.txt");
-//  int i = 0;
-//  for (const auto &c : *dual.codewords ())
-//    out.print ("{}:\t{}\n", i++, c);
+TEST_F (Hamming73Test, TestFromParityEquations)
+{
+  // A code with more information positions than redundancy positions on its
+  // dual side.
+  const auto from_h = linearcode::from_parity_equations (H);
+  EXPECT_EQ (from_h.properties ().basis_size, 3);
+  EXPECT_EQ (from_h.properties ().min_distance, 4);
+  for (const auto &c : *code.codewords ())
+    EXPECT_TRUE (from_h.contains (c));
 
-//  const std::size_t word_size = 7;
-//  const std::size_t num_limit = (1 << (word_size + 1)) - 1;
-//  for (std::size_t i = 0; i < num_limit; ++i)
-//    {
-//      codeword c{ i, word_size };
-//      EXPECT_NE (code.contains (c), dual.contains (c));
-//    }
-//}
+  using enum linearcode::decoding_strategy;
+  const infoword i1{ "110" };
+  const codeword c1 = from_h.encode (i1) + codeword{ "0000100" };
+  auto from_h_ = from_h;
+  EXPECT_EQ (from_h_.decode<Syndromes> (c1).iword, i1);
+}
 
 TEST_F (Hamming74Test, TestParityMatrix)
 {
@@ -301,3 +338,151 @@ TEST_F (Hamming73Test, TestSyndromesAndContains)
   auto s3 = code.syndrome_of (c3);
   EXPECT_TRUE (code.contains (c3));
 }
+
+struct NonStandardHamming74Test : public ::testing::Test
+{
+  // A generator of the [7, 4] Hamming code whose rows have been mixed and
+  // whose columns have been shuffled, so that it is not in standard form.
+  static inline const Eigen::MatrixXi G = [] () {
+    Eigen::MatrixXi G_{ 4, 7 };
+    // clang-format off
+        G_ << 1, 1, 0, 0, 1, 1, 0,
+              0, 0, 1, 1, 1, 1, 0,
+              0, 1, 0, 1, 1, 0, 1,
+              0, 0, 0, 0, 1, 1, 1;
+    // clang-format on
+    return G_;
+  }();
+
+  linearcode code = linearcode::from_generator (G);
+};
+
+TEST_F (NonStandardHamming74Test, TestStandardForm)
+{
+  const auto &props = code.properties ();
+  EXPECT_EQ (props.basis_size, 4);
+  EXPECT_EQ (props.word_size, 7);
+  EXPECT_EQ (props.min_distance, 3);
+
+  const auto &perm = code.permutation ();
+  ASSERT_EQ (perm.size (), 7);
+  const Eigen::MatrixXi &R = code.generator_matrix ();
+  for (std::size_t i = 0; i < 4; ++i)
+    for (std::size_t j = 0; j < 4; ++j)
+      EXPECT_EQ (R (i, perm[j]), i == j);
+
+  // Every row of the original generator is a codeword.
+  for (long r = 0; r < G.rows (); ++r)
+    EXPECT_TRUE (code.contains (codeword{ Eigen::RowVectorXi{ G.row (r) } }));
+
+  const Eigen::MatrixXi product = (R * code.parity_matrix ().transpose ())
+                                      .unaryExpr ([] (int x) { return x % 2; });
+  EXPECT_TRUE (product.isZero ());
+}
+
+TEST_F (NonStandardHamming74Test, TestDecoding)
+{
+  using enum linearcode::decoding_strategy;
+
+  for (unsigned long long i = 0; i < 16; ++i)
+    {
+      const infoword iword{ i, 4 };
+      const codeword cword = code.encode (iword);
+      EXPECT_TRUE (code.contains (cword));
+
+      for (std::size_t e = 0; e < 7; ++e)
+        {
+          const codeword received = cword + codeword{ 1ull << e, 7 };
+          const auto d1 = code.decode<Syndromes> (received);
+          EXPECT_EQ (d1.iword, iword);
+          EXPECT_EQ (d1.error.weight (), 1);
+          const auto d2 = code.decode<SlepyanTable> (received);
+          EXPECT_EQ (d2.iword, iword);
+        }
+    }
+}
+
+TEST (LinearcodeTest, TestDependentRows)
+{
+  Eigen::MatrixXi G{ 3, 5 };
+  // clang-format off
+  G << 1, 0, 1, 1, 0,
+       0, 1, 1, 0, 1,
+       1, 1, 0, 1, 1;
+  // clang-format on
+  EXPECT_THROW ((void)linearcode::from_generator (G), linearcode_exception);
+  EXPECT_THROW ((void)linearcode::from_generator (Eigen::MatrixXi::Zero (2, 4)),
+                linearcode_exception);
+}
+
+TEST (LinearcodeTest, TestCacheBytes)
+{
+  const auto code = linearcode::hamming (3);
+  const std::size_t bare = code.cache_bytes ();
+
+  // Every table adds at least the ints of its words.
+  (void)code.syndrome_table ();
+  const std::size_t with_syndromes = code.cache_bytes ();
+  EXPECT_GE (with_syndromes - bare, 8 * (3 + 7) * sizeof (int));
+  (void)code.slepian_table ();
+  EXPECT_GE (code.cache_bytes () - with_syndromes, 8 * 16 * 7 * sizeof (int));
+
+  // A copy holds the same tables.
+  const auto copy = code;
+  EXPECT_EQ (copy.cache_bytes (), code.cache_bytes ());
+}
+
+///
+/// \brief Counts the bytes which are allocated from it.
+///
+class counting_resource final : public std::pmr::memory_resource
+{
+public:
+  std::size_t allocated{ 0 };
+
+private:
+  void *
+  do_allocate (std::size_t bytes, std::size_t alignment) override
+  {
+    allocated += bytes;
+    return std::pmr::new_delete_resource ()->allocate (bytes, alignment);
+  }
+
+  void
+  do_deallocate (void *p, std::size_t bytes, std::size_t alignment) override
+  {
+    std::pmr::new_delete_resource ()->deallocate (p, bytes, alignment);
+  }
+
+  bool
+  do_is_equal (const memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+};
+
+TEST (LinearcodeTest, TestTableResource)
+{
+  counting_resource resource;
+  auto code = linearcode::from_generator (
+      linearcode::hamming (3).generator_matrix ());
+  EXPECT_EQ (code.table_resource (), std::pmr::get_default_resource ());
+  code.set_table_resource (&resource);
+
+  EXPECT_EQ (code.codewords ()->get_allocator ().resource (), &resource);
+  EXPECT_EQ (code.syndrome_table ()->get_allocator ().resource (), &resource);
+  const auto &slepian = *code.slepian_table ();
+  EXPECT_EQ (slepian.get_allocator ().resource (), &resource);
+  EXPECT_EQ (slepian.back ().columns.get_allocator ().resource (), &resource);
+  const std::size_t built = resource.allocated;
+  EXPECT_GT (built, 0);
+
+  // Copies and derived codes allocate from it as well.
+  const auto copy = code;
+  EXPECT_EQ (copy.table_resource (), &resource);
+  EXPECT_GT (resource.allocated, built);
+  const auto &columns = copy.slepian_table ()->back ().columns;
+  EXPECT_EQ (columns.get_allocator ().resource (), &resource);
+  const std::size_t positions[]{ 0 };
+  EXPECT_EQ (code.shorten (positions).table_resource (), &resource);
+}
@@ -0,0 +1,146 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/core.h>
+#include <patrick/cyclic.h>
+
+using namespace patrick;
+using digit_type = cyclic_code::digit_type;
+
+///
+/// Helpers
+///
+
+static std::vector<digit_type>
+random_digits (std::size_t size, std::mt19937_64 &gen)
+{
+  std::vector<digit_type> result (size);
+  for (auto &d : result)
+    d = gen ();
+  return result;
+}
+
+///
+/// \brief Bit by bit long division.
+///
+static std::vector<digit_type>
+naive_remainder (std::vector<digit_type> dividend,
+                 const std::vector<digit_type> &divisor, std::size_t degree)
+{
+  auto bit = [] (const std::vector<digit_type> &p, std::size_t i) {
+    return (p[i / 64] >> (i % 64)) & 1u;
+  };
+  for (std::size_t b = dividend.size () * 64; b-- > degree;)
+    if (bit (dividend, b))
+      for (std::size_t j = 0; j <= degree; ++j)
+        if (bit (divisor, j))
+          dividend[(b - degree + j) / 64] ^= digit_type{ 1 }
+                                              << ((b - degree + j) % 64);
+  dividend.resize ((degree + 63) / 64);
+  return dividend;
+}
+
+TEST (TestCyclic, TestRemainder)
+{
+  std::mt19937_64 gen{ 32 };
+  for (const std::size_t degree : { 1ul, 3ul, 32ul, 63ul, 64ul, 65ul, 160ul })
+    {
+      auto divisor = random_digits (degree / 64 + 1, gen);
+      divisor.back () &= (digit_type{ 2 } << (degree % 64)) - 1;
+      divisor.back () |= digit_type{ 1 } << (degree % 64);
+      divisor[0] |= 1;
+      const details::polynomial_divisor reducer{ divisor };
+      ASSERT_EQ (reducer.degree (), degree);
+
+      // Short ones are not folded, long ones are, with and without a tail.
+      for (const std::size_t size : { 1ul, 5ul, 16ul, 37ul, 200ul })
+        {
+          const auto dividend = random_digits (size, gen);
+          const auto expected = naive_remainder (dividend, divisor, degree);
+          std::vector<digit_type> remainder (reducer.remainder_digits ());
+          reducer.remainder (dividend, remainder);
+          EXPECT_EQ (remainder, expected);
+          reducer.remainder_portable (dividend, remainder);
+          EXPECT_EQ (remainder, expected);
+        }
+    }
+}
+
+TEST (TestCyclic, TestHamming)
+{
+  const auto code = cyclic_code::hamming (3);
+  EXPECT_EQ (code.properties ().word_size, 7);
+  EXPECT_EQ (code.properties ().basis_size, 4);
+  EXPECT_TRUE (code.is_cyclic ());
+
+  // 1 + x + x^3 generates 1101000, and its cyclic shifts are codewords.
+  EXPECT_TRUE (code.contains (codeword{ "1101000" }));
+  EXPECT_TRUE (code.contains (codeword{ "0110100" }));
+  EXPECT_TRUE (code.contains (codeword{ "1000110" }));
+  EXPECT_FALSE (code.contains (codeword{ "1100000" }));
+
+  // Systematic: the message is in the high positions.
+  const infoword iword{ "1011" };
+  const codeword cword = code.encode (iword);
+  EXPECT_TRUE (code.contains (cword));
+  EXPECT_EQ (cword.vec.tail (4), iword.vec);
+
+  // Every single error has a different syndrome.
+  std::vector<syndrome> syndromes;
+  for (std::size_t e = 0; e < 7; ++e)
+    {
+      codeword received = cword;
+      received.vec (e) ^= 1;
+      const syndrome s = code.syndrome_of (received);
+      EXPECT_EQ (std::count (syndromes.begin (), syndromes.end (), s), 0);
+      syndromes.push_back (s);
+    }
+}
+
+TEST (TestCyclic, TestBCH)
+{
+  // The same code as the one with a generator matrix.
+  const auto cyclic = cyclic_code::bch (8, 4);
+  const auto linear = linearcode::bch (8, 4);
+  EXPECT_TRUE (cyclic.is_cyclic ());
+  EXPECT_EQ (cyclic.properties ().basis_size,
+             linear.properties ().basis_size);
+
+  std::mt19937_64 gen{ 8 };
+  for (std::size_t trial = 0; trial < 10; ++trial)
+    {
+      Eigen::RowVectorXi vec (cyclic.properties ().basis_size);
+      for (auto &b : vec)
+        b = gen () & 1;
+      EXPECT_TRUE (linear.contains (cyclic.encode (infoword{ vec })));
+    }
+}
+
+TEST (TestCyclic, TestLongBlocks)
+{
+  // CRC-32 as a shortened cyclic code over a 1 MiB block.
+  const digit_type crc32 = 0x104C11DB7;
+  const std::size_t k = 8 * (1 << 20);
+  const cyclic_code code{ k + 32, std::span{ &crc32, 1 } };
+  EXPECT_FALSE (code.is_cyclic ());
+
+  std::mt19937_64 gen{ 32 };
+  const auto message = random_digits (k / 64, gen);
+  std::vector<digit_type> cword (k / 64 + 1);
+  code.encode (message, cword);
+  EXPECT_EQ (cword[0] >> 32, message[0] & 0xffffffff);
+
+  std::vector<digit_type> syndrome (1);
+  code.syndrome_of (cword, syndrome);
+  EXPECT_EQ (syndrome[0], 0);
+  cword[cword.size () / 2] ^= 1u << 7;
+  code.syndrome_of (cword, syndrome);
+  EXPECT_NE (syndrome[0], 0);
+
+  const digit_type constant = 1;
+  EXPECT_THROW ((cyclic_code{ 10, std::span{ &constant, 1 } }),
+                cyclic_code_exception);
+  EXPECT_THROW ((cyclic_code{ 32, std::span{ &crc32, 1 } }),
+                cyclic_code_exception);
+}
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+
+#include <patrick/core.h>
+
+using namespace patrick;
+
+///
+/// Helpers
+///
+
+///
+/// \brief Finds the lightest word of every coset by going through all words.
+///
+static std::unordered_map<syndrome, std::size_t>
+coset_leader_weights (const linearcode &code)
+{
+  const std::size_t n = code.properties ().word_size;
+  std::unordered_map<syndrome, std::size_t> weights;
+  for (unsigned long long i = 0; i < (1ull << n); ++i)
+    {
+      const codeword word{ i, n };
+      const auto [it, inserted]
+          = weights.try_emplace (code.syndrome_of (word), word.weight ());
+      if (!inserted)
+        it->second = std::min (it->second, word.weight ());
+    }
+  return weights;
+}
+
+static codeword
+without (const codeword &cword, const std::vector<std::size_t> &positions)
+{
+  Eigen::RowVectorXi vec (cword.vec.cols () - positions.size ());
+  for (long i = 0, j = 0; i < cword.vec.cols (); ++i)
+    if (std::ranges::find (positions, i) == positions.cend ())
+      vec (j++) = cword.vec (i);
+  return codeword{ std::move (vec) };
+}
+
+static void
+expect_optimal_leaders (const linearcode &code)
+{
+  const auto weights = coset_leader_weights (code);
+  const auto &table = *code.syndrome_table ();
+  EXPECT_EQ (table.size (), weights.size ());
+  for (const auto &[s, leader] : table)
+    {
+      EXPECT_EQ (code.syndrome_of (leader), s);
+      EXPECT_EQ (leader.weight (), weights.at (s));
+    }
+}
+
+TEST (TestDerived, TestShorten)
+{
+  auto mother = linearcode::hamming (4);
+  (void)mother.codewords ();
+  (void)mother.syndrome_table ();
+  const auto &perm = mother.permutation ();
+  const std::vector<std::size_t> positions{ perm[0], perm[4], perm[10] };
+
+  const auto code = mother.shorten (positions);
+  EXPECT_EQ (code.properties ().word_size, 12);
+  EXPECT_EQ (code.properties ().basis_size, 8);
+  EXPECT_EQ (code.properties ().min_distance, 3);
+  EXPECT_EQ (code.properties ().special_name, "Shortened Hamming");
+  EXPECT_EQ (code.family ().kind, linearcode::code_family::Hamming);
+
+  // Its codewords are those of the mother code which are zero at the
+  // positions.
+  std::size_t count = 0;
+  for (const auto &cword : *mother.codewords ())
+    if (std::ranges::none_of (positions, [&] (const std::size_t p) {
+          return cword.vec (p) != 0;
+        }))
+      {
+        EXPECT_TRUE (code.contains (without (cword, positions)));
+        ++count;
+      }
+  EXPECT_EQ (count, 256);
+  EXPECT_EQ (code.codewords ()->size (), 256);
+  for (const auto &cword : *code.codewords ())
+    EXPECT_TRUE (code.contains (cword));
+  expect_optimal_leaders (code);
+
+  // Without tables to reuse, the result is the same code.
+  const auto fresh = linearcode::hamming (4).shorten (positions);
+  EXPECT_EQ (fresh.generator_matrix (), code.generator_matrix ());
+  EXPECT_EQ (fresh.parity_matrix (), code.parity_matrix ());
+  expect_optimal_leaders (fresh);
+
+  // At a redundancy position, the code is built from its parity equations.
+  const std::vector<std::size_t> redundancy{ perm[0], perm[14] };
+  const auto other = mother.shorten (redundancy);
+  EXPECT_EQ (other.properties ().word_size, 13);
+  EXPECT_EQ (other.properties ().basis_size, 9);
+  for (const auto &cword : *other.codewords ())
+    {
+      Eigen::RowVectorXi vec = Eigen::RowVectorXi::Zero (15);
+      for (long i = 0, j = 0; i < 15; ++i)
+        if (i != long (perm[0]) && i != long (perm[14]))
+          vec (i) = cword.vec (j++);
+      EXPECT_TRUE (mother.contains (codeword{ std::move (vec) }));
+    }
+}
+
+TEST (TestDerived, TestShortenKeepsDecoder)
+{
+  using enum linearcode::decoding_strategy;
+  const auto mother = linearcode::bch (5, 2);
+  const auto &perm = mother.permutation ();
+  // At information and redundancy positions, and then once more.
+  const std::vector<std::size_t> positions{ perm[0], perm[3], perm[25] };
+  const auto once = mother.shorten (positions);
+  const std::vector<std::size_t> again{ 0, 7 };
+  for (auto code : { once, once.shorten (again) })
+    {
+      ASSERT_EQ (code.family ().kind, linearcode::code_family::BCH);
+      const std::size_t n = code.properties ().word_size;
+      const std::size_t k = code.properties ().basis_size;
+      Eigen::RowVectorXi bits (k);
+      for (std::size_t i = 0; i < k; ++i)
+        bits (i) = (i * 7 + 3) % 5 < 2;
+      const infoword iword{ std::move (bits) };
+      const auto cword = code.encode (iword);
+      for (std::size_t i = 0; i < n; ++i)
+        {
+          auto received = cword;
+          received.vec (i) ^= 1;
+          received.vec ((i * 11 + 5) % n) ^= 1;
+          for (const auto &result :
+               { code.decode (received), code.decode<ChienSearch> (received) })
+            {
+              EXPECT_EQ (result.iword, iword);
+              EXPECT_EQ (received + result.error, cword);
+            }
+        }
+    }
+
+  // The Hamming decoder fails if it corrects one of the positions, which
+  // is where the syndrome of two errors points at.
+  const auto hamming = linearcode::hamming (4);
+  const std::vector<std::size_t> removed{ 4 };
+  auto code = hamming.shorten (removed);
+  auto received = code.encode (infoword{ Eigen::RowVectorXi::Zero (10) });
+  // The columns of the mother code at positions 0 and 3 add up to the one
+  // at position 4.
+  received.vec (0) = 1;
+  received.vec (3) = 1;
+  EXPECT_THROW ((void)code.decode (received), linearcode_exception);
+  received.vec (3) = 0;
+  EXPECT_EQ (code.decode (received).error.weight (), 1);
+}
+
+TEST (TestDerived, TestPuncture)
+{
+  auto mother = linearcode::bch (4, 2);
+  (void)mother.codewords ();
+  (void)mother.syndrome_table ();
+  const auto &perm = mother.permutation ();
+  const std::vector<std::size_t> positions{ perm[7], perm[12] };
+
+  auto code = mother.puncture (positions);
+  EXPECT_EQ (code.properties ().word_size, 13);
+  EXPECT_EQ (code.properties ().basis_size, 7);
+  EXPECT_EQ (code.properties ().min_distance, 3);
+  EXPECT_EQ (code.properties ().special_name, "Punctured BCH");
+
+  for (const auto &cword : *mother.codewords ())
+    EXPECT_TRUE (code.contains (without (cword, positions)));
+  const auto &codewords = *code.codewords ();
+  EXPECT_EQ (codewords.size (), 128);
+  EXPECT_TRUE (std::ranges::is_sorted (codewords, {}, &codeword::weight));
+  expect_optimal_leaders (code);
+
+  // It still corrects a single error.
+  const auto cword = codewords[77];
+  for (std::size_t i = 0; i < 13; ++i)
+    {
+      auto received = cword;
+      received.vec (i) ^= 1;
+      const auto result
+          = code.decode<linearcode::decoding_strategy::Syndromes> (received);
+      EXPECT_EQ (received + result.error, cword);
+    }
+
+  const auto fresh = linearcode::bch (4, 2).puncture (positions);
+  EXPECT_EQ (fresh.generator_matrix (), code.generator_matrix ());
+  EXPECT_EQ (fresh.parity_matrix (), code.parity_matrix ());
+  expect_optimal_leaders (fresh);
+
+  // At an information position, the code is built from its generator.
+  const std::vector<std::size_t> information{ perm[0] };
+  const auto other = mother.puncture (information);
+  EXPECT_EQ (other.properties ().word_size, 14);
+  EXPECT_EQ (other.properties ().basis_size, 7);
+  for (const auto &cword : *mother.codewords ())
+    EXPECT_TRUE (other.contains (without (cword, information)));
+}
+
+TEST (TestDerived, TestErrors)
+{
+  const auto code = linearcode::hamming (3);
+  const auto &perm = code.permutation ();
+  EXPECT_THROW ((void)code.shorten (std::vector<std::size_t>{ 7 }),
+                linearcode_exception);
+  EXPECT_THROW ((void)code.puncture (std::vector<std::size_t>{ 1, 1 }),
+                linearcode_exception);
+  EXPECT_THROW ((void)code.shorten (std::vector<std::size_t>{
+                    perm[0], perm[1], perm[2], perm[3] }),
+                linearcode_exception);
+
+  const auto repetition = linearcode::from_generator (
+      Eigen::MatrixXi{ { 1, 1, 0 }, { 0, 0, 1 } });
+  EXPECT_THROW ((void)repetition.puncture (std::vector<std::size_t>{ 2 }),
+                linearcode_exception);
+}
@@ -0,0 +1,66 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/channel.h>
+#include <patrick/core.h>
+
+using namespace patrick;
+
+TEST (TestErasures, TestRecoversUpToDistance)
+{
+  // Every pattern of up to 2 erasures of every codeword of Hamming (3).
+  auto code = linearcode::hamming (3);
+  for (unsigned long long i = 0; i < 16; ++i)
+    {
+      const infoword iword{ i, 4 };
+      const auto cword = code.encode (iword);
+      for (unsigned long long pattern = 0; pattern < 128; ++pattern)
+        {
+          const codeword erasures{ pattern, 7 };
+          if (erasures.weight () > 2)
+            continue;
+          // The erased bits are received as their complements.
+          const auto result
+              = code.decode_erasures (cword + erasures, erasures);
+          EXPECT_EQ (result.iword, iword);
+          EXPECT_EQ (result.error, erasures);
+        }
+    }
+  // Every pattern is solved once.
+  EXPECT_EQ (code.erasure_solutions ().size (), 29);
+
+  auto golay = linearcode::golay24 ();
+  binary_erasure_channel channel{ 0.2, 43 };
+  std::mt19937_64 gen{ 43 };
+  for (std::size_t trial = 0; trial < 200; ++trial)
+    {
+      const infoword iword{ gen () & 0xfff, 12 };
+      const auto [word, erasures] = channel.transmit (golay.encode (iword));
+      if (erasures.weight () >= 8)
+        continue;
+      EXPECT_EQ (golay.decode_erasures (word, erasures).iword, iword);
+    }
+}
+
+TEST (TestErasures, TestFailures)
+{
+  auto code = linearcode::hamming (3);
+  const auto cword = code.encode (infoword{ 0b1010, 4 });
+
+  // A flipped bit which is not erased.
+  auto flipped = cword;
+  flipped.vec (0) ^= 1;
+  EXPECT_THROW ((void)code.decode_erasures (flipped, codeword{ 0b1, 7 }),
+                linearcode_exception);
+
+  // Erasing the support of a codeword of minimum weight is ambiguous.
+  codeword erasures{ 0, 7 };
+  for (unsigned long long i = 1; erasures.weight () != 3; ++i)
+    erasures = code.encode (infoword{ i, 4 });
+  EXPECT_THROW ((void)code.decode_erasures (cword, erasures),
+                linearcode_exception);
+
+  EXPECT_THROW ((void)code.decode_erasures (cword, codeword{ 0, 8 }),
+                linearcode_exception);
+}
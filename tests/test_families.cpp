@@ -0,0 +1,155 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/core.h>
+#include <patrick/gf2m.h>
+
+#include "helpers.h"
+
+using namespace patrick;
+using namespace patrick::test;
+
+TEST (TestGaloisField, TestArithmetics)
+{
+  const details::galois_field field{ 4 };
+  EXPECT_EQ (field.order (), 15);
+  for (std::size_t i = 0; i < 15; ++i)
+    EXPECT_EQ (field.log (field.exp (i)), i);
+  // alpha^4 = alpha + 1 for x^4 + x + 1.
+  EXPECT_EQ (field.exp (4), 0b0011);
+  EXPECT_EQ (field.mul (field.exp (7), field.exp (10)), field.exp (2));
+  EXPECT_EQ (field.minimal_polynomial (1), 0x13);
+  // x^4 + x^3 + x^2 + x + 1
+  EXPECT_EQ (field.minimal_polynomial (3), 0x1F);
+  EXPECT_EQ (field.minimal_polynomial (5), 0x7);
+
+  EXPECT_THROW (details::galois_field (4, 0x1F),
+                details::galois_field_exception);
+}
+
+TEST (TestFamilies, TestHamming)
+{
+  using enum linearcode::decoding_strategy;
+
+  for (std::size_t r = 2; r <= 6; ++r)
+    {
+      auto code = linearcode::hamming (r);
+      const auto &props = code.properties ();
+      const std::size_t n = (1 << r) - 1;
+      EXPECT_EQ (props.word_size, n);
+      EXPECT_EQ (props.basis_size, n - r);
+      EXPECT_EQ (props.min_distance, 3);
+      EXPECT_EQ (code.family ().kind, linearcode::code_family::Hamming);
+
+      std::mt19937_64 gen{ r };
+      const infoword iword = random_infoword (n - r, gen);
+      const codeword cword = code.encode (iword);
+      EXPECT_TRUE (code.contains (cword));
+      EXPECT_EQ (code.decode (cword).iword, iword);
+      for (std::size_t e = 0; e < n; ++e)
+        {
+          codeword received = cword;
+          received.vec (e) ^= 1;
+          const auto result = code.decode<Auto> (received);
+          EXPECT_EQ (result.iword, iword);
+          EXPECT_EQ (result.error.weight (), 1);
+          EXPECT_EQ (result.error.vec (e), 1);
+        }
+    }
+
+  // The generator of a longer one is too large to hold.
+  EXPECT_THROW ((void)linearcode::hamming (15), linearcode_exception);
+  EXPECT_THROW ((void)linearcode::hamming (16), linearcode_exception);
+
+  // The smallest one is the same code as the one from the presets.
+  auto h3 = linearcode::hamming (3);
+  auto h3_ = h3;
+  codeword c{ "1100110" };
+  EXPECT_EQ (h3.decode<Auto> (c).error, h3_.decode<Syndromes> (c).error);
+}
+
+TEST (TestFamilies, TestGolay)
+{
+  auto code = linearcode::golay24 ();
+  const auto &props = code.properties ();
+  EXPECT_EQ (props.word_size, 24);
+  EXPECT_EQ (props.basis_size, 12);
+  EXPECT_EQ (props.min_distance, 8);
+  EXPECT_EQ (props.max_errors_correct, 3);
+
+  std::mt19937_64 gen{ 24 };
+  for (std::size_t trial = 0; trial < 200; ++trial)
+    {
+      const infoword iword = random_infoword (12, gen);
+      const codeword cword = code.encode (iword);
+      const codeword error = random_error (24, trial % 4, gen);
+      const auto result = code.decode (cword + error);
+      EXPECT_EQ (result.iword, iword);
+      EXPECT_EQ (result.error, error);
+    }
+
+  const codeword cword = code.encode (random_infoword (12, gen));
+  EXPECT_THROW ((void)code.decode (cword + random_error (24, 4, gen)),
+                linearcode_exception);
+}
+
+TEST (TestFamilies, TestBCH)
+{
+  using enum linearcode::decoding_strategy;
+
+  // The [15, 7, 5] and [15, 5, 7] codes.
+  auto bch2 = linearcode::bch (4, 2);
+  EXPECT_EQ (bch2.properties ().basis_size, 7);
+  EXPECT_EQ (bch2.properties ().min_distance, 5);
+  auto bch3 = linearcode::bch (4, 3);
+  EXPECT_EQ (bch3.properties ().basis_size, 5);
+  EXPECT_EQ (bch3.properties ().min_distance, 7);
+
+  // The designed distance matches the actual one for these.
+  for (const auto *code : { &bch2, &bch3 })
+    {
+      const auto &codewords = *code->codewords ();
+      EXPECT_EQ (codewords[1].weight (), code->properties ().min_distance);
+    }
+
+  std::mt19937_64 gen{ 15 };
+  const infoword iword = random_infoword (7, gen);
+  const codeword cword = bch2.encode (iword);
+  const auto result
+      = bch2.decode<Syndromes> (cword + random_error (15, 2, gen));
+  EXPECT_EQ (result.iword, iword);
+
+  // Large parameters are built without enumerating any codewords.
+  const auto bch_long = linearcode::bch (10, 8);
+  EXPECT_EQ (bch_long.properties ().word_size, 1023);
+  EXPECT_EQ (bch_long.properties ().basis_size, 943);
+  const infoword long_iword = random_infoword (943, gen);
+  EXPECT_TRUE (bch_long.contains (bch_long.encode (long_iword)));
+
+  EXPECT_THROW ((void)linearcode::bch (16, 2), linearcode_exception);
+}
+
+TEST (TestFamilies, TestReedMuller)
+{
+  // RM(1, 3) is the extended Hamming [8, 4, 4] code.
+  auto rm13 = linearcode::reed_muller (1, 3);
+  EXPECT_EQ (rm13.properties ().word_size, 8);
+  EXPECT_EQ (rm13.properties ().basis_size, 4);
+  EXPECT_EQ (rm13.properties ().min_distance, 4);
+  EXPECT_EQ ((*rm13.codewords ())[1].weight (), 4);
+
+  auto rm24 = linearcode::reed_muller (2, 4);
+  EXPECT_EQ (rm24.properties ().word_size, 16);
+  EXPECT_EQ (rm24.properties ().basis_size, 11);
+  EXPECT_EQ (rm24.properties ().min_distance, 4);
+
+  const auto rm38 = linearcode::reed_muller (3, 8);
+  EXPECT_EQ (rm38.properties ().basis_size, 93);
+  EXPECT_EQ (rm38.properties ().min_distance, 32);
+  EXPECT_EQ (rm38.family ().r, 3);
+  EXPECT_EQ (rm38.family ().m, 8);
+
+  EXPECT_THROW ((void)linearcode::reed_muller (4, 3), linearcode_exception);
+  EXPECT_THROW ((void)linearcode::reed_muller (5, 16), linearcode_exception);
+}
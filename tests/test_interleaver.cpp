@@ -0,0 +1,137 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/core.h>
+#include <patrick/interleaver.h>
+
+using namespace patrick;
+
+///
+/// Helpers
+///
+
+static codeword
+random_codeword (std::size_t size, std::mt19937_64 &gen)
+{
+  Eigen::RowVectorXi vec (size);
+  for (auto &b : vec)
+    b = gen () & 1;
+  return codeword{ std::move (vec) };
+}
+
+TEST (TestInterleaver, TestTranspose64)
+{
+  std::mt19937_64 gen{ 36 };
+  for (std::size_t trial = 0; trial < 10; ++trial)
+    {
+      std::array<std::uint64_t, 64> tile;
+      for (auto &row : tile)
+        row = gen ();
+      auto vectorized = tile;
+      auto portable = tile;
+      details::transpose64 (vectorized.data ());
+      details::transpose64_scalar (portable.data ());
+      EXPECT_EQ (vectorized, portable);
+      for (std::size_t i = 0; i < 64; ++i)
+        for (std::size_t j = 0; j < 64; ++j)
+          EXPECT_EQ ((portable[i] >> j) & 1, (tile[j] >> i) & 1);
+    }
+}
+
+TEST (TestInterleaver, TestBlockInterleaver)
+{
+  std::mt19937_64 gen{ 37 };
+  for (const auto &[rows, cols] :
+       { std::pair{ 1ul, 70ul }, std::pair{ 3ul, 5ul },
+         std::pair{ 64ul, 64ul }, std::pair{ 100ul, 130ul } })
+    {
+      const block_interleaver interleaver{ rows, cols };
+      std::vector<codeword> cwords;
+      for (std::size_t r = 0; r < rows; ++r)
+        cwords.push_back (random_codeword (cols, gen));
+
+      // Bit c of word r is sent at position c * rows + r.
+      const auto stream = interleaver.interleave (cwords);
+      for (std::size_t r = 0; r < rows; ++r)
+        for (std::size_t c = 0; c < cols; ++c)
+          EXPECT_EQ (stream.vec (c * rows + r), cwords[r].vec (c));
+      EXPECT_EQ (interleaver.deinterleave (stream), cwords);
+    }
+
+  const block_interleaver interleaver{ 2, 3 };
+  EXPECT_THROW ((block_interleaver{ 0, 3 }), interleaver_exception);
+  EXPECT_THROW ((void)interleaver.interleave (std::vector<codeword>{
+                    random_codeword (5, gen) }),
+                interleaver_exception);
+  EXPECT_THROW ((void)interleaver.deinterleave (random_codeword (7, gen)),
+                interleaver_exception);
+}
+
+TEST (TestInterleaver, TestBurstSpreading)
+{
+  // A burst as long as the depth hits every codeword once.
+  auto code = linearcode::hamming (4);
+  const block_interleaver interleaver{ 16, 15 };
+  std::mt19937_64 gen{ 38 };
+  std::vector<codeword> cwords;
+  for (std::size_t r = 0; r < 16; ++r)
+    cwords.push_back (code.encode (infoword{ random_codeword (11, gen).vec }));
+
+  auto stream = interleaver.interleave (cwords);
+  for (std::size_t i = 100; i < 116; ++i)
+    stream.vec (i) ^= 1;
+  const auto received = interleaver.deinterleave (stream);
+  for (std::size_t r = 0; r < 16; ++r)
+    {
+      const auto result = code.decode (received[r]);
+      EXPECT_EQ (received[r] + result.error, cwords[r]);
+      EXPECT_EQ (result.error.weight (), 1);
+    }
+}
+
+TEST (TestInterleaver, TestConvolutionalInterleaver)
+{
+  using direction_type = convolutional_interleaver::direction_type;
+  std::mt19937_64 gen{ 39 };
+  for (const auto &[branches, delay] :
+       { std::pair{ 1ul, 3ul }, std::pair{ 4ul, 1ul },
+         std::pair{ 12ul, 17ul }, std::pair{ 70ul, 2ul } })
+    {
+      convolutional_interleaver interleaver{ branches, delay };
+      convolutional_interleaver deinterleaver{ branches, delay,
+                                               direction_type::Deinterleave };
+      const std::size_t latency = interleaver.latency ();
+      const std::size_t size = branches * (delay * branches + 37);
+      const auto input = random_codeword (size, gen);
+
+      // Bit t of branch i leaves i * delay of its bits later.
+      const auto sent = interleaver.push (input);
+      for (std::size_t t = 0; t < size; ++t)
+        {
+          const std::size_t lag = (t % branches) * delay * branches;
+          EXPECT_EQ (sent.vec (t), t < lag ? 0 : input.vec (t - lag));
+        }
+
+      // In pieces, the pair gives the input back after the latency.
+      Eigen::RowVectorXi output (size);
+      for (std::size_t start = 0; start < size;)
+        {
+          const std::size_t length
+              = std::min (size - start, branches * (gen () % 5));
+          const auto piece = codeword{ sent.vec.segment (start, length) };
+          output.segment (start, length) = deinterleaver.push (piece).vec;
+          start += length;
+        }
+      for (std::size_t t = latency; t < size; ++t)
+        EXPECT_EQ (output (t), input.vec (t - latency));
+
+      interleaver.reset ();
+      EXPECT_EQ (interleaver.push (input), sent);
+    }
+
+  convolutional_interleaver interleaver{ 3, 2 };
+  EXPECT_THROW ((convolutional_interleaver{ 0, 2 }), interleaver_exception);
+  EXPECT_THROW ((void)interleaver.push (random_codeword (4, gen)),
+                interleaver_exception);
+}
@@ -0,0 +1,144 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/polar.h>
+
+#include "helpers.h"
+
+using namespace patrick;
+using namespace patrick::test;
+using construction_type = polar_code::construction_type;
+
+TEST (TestPolar, TestTransform)
+{
+  // Row i of F^{(x)m} is the transform of the unit vector at i.
+  for (const std::size_t m : { 3ul, 7ul })
+    {
+      const std::size_t n = 1ul << m;
+      for (std::size_t i = 0; i < n; ++i)
+        {
+          std::vector<std::uint64_t> bits ((n + 63) / 64, 0);
+          bits[i / 64] = std::uint64_t{ 1 } << (i % 64);
+          details::polar_transform (bits, m);
+          for (std::size_t j = 0; j < n; ++j)
+            EXPECT_EQ ((bits[j / 64] >> (j % 64)) & 1u, (i & j) == j);
+        }
+    }
+}
+
+TEST (TestPolar, TestConstruction)
+{
+  // The classic [8, 4] code.
+  for (const auto construction :
+       { construction_type::Bhattacharyya,
+         construction_type::GaussianApproximation })
+    {
+      const polar_code code{ 3, 4, construction };
+      EXPECT_EQ (code.information_set (),
+                 (std::vector<std::size_t>{ 3, 5, 6, 7 }));
+    }
+
+  const polar_code code{ 10, 512, construction_type::GaussianApproximation,
+                         1.0 };
+  EXPECT_EQ (code.information_set ().size (), 512);
+  EXPECT_FALSE (code.frozen ().back ());
+  EXPECT_TRUE (code.frozen ().front ());
+
+  EXPECT_THROW ((polar_code{ 0, 1 }), polar_code_exception);
+  EXPECT_THROW ((polar_code{ 3, 0 }), polar_code_exception);
+  EXPECT_THROW ((polar_code{ 3, 7, construction_type::Bhattacharyya, 0.0,
+                             0x7 }),
+                polar_code_exception);
+}
+
+TEST (TestPolar, TestEncode)
+{
+  const polar_code code{ 5, 16 };
+  std::mt19937_64 gen{ 5 };
+  const auto iword = random_infoword (16, gen);
+  const auto cword = code.encode (iword);
+
+  // The transform gives u back, which is zero at the frozen positions.
+  std::vector<std::uint64_t> u (1);
+  details::pack (cword, u.data ());
+  details::polar_transform (u, 5);
+  for (std::size_t i = 0; i < 32; ++i)
+    EXPECT_FALSE (code.frozen ()[i] && ((u[0] >> i) & 1u));
+
+  EXPECT_THROW ((void)code.encode (random_infoword (15, gen)),
+                polar_code_exception);
+}
+
+TEST (TestPolar, TestDecodeNoiseless)
+{
+  std::mt19937_64 gen{ 12 };
+  for (const auto &[m, k] : { std::pair{ 1ul, 1ul }, std::pair{ 4ul, 7ul },
+                              std::pair{ 8ul, 128ul },
+                              std::pair{ 11ul, 1000ul } })
+    {
+      const polar_code code{ m, k };
+      const auto iword = random_infoword (k, gen);
+      const auto cword = code.encode (iword);
+      for (const std::size_t list_size : { 1ul, 2ul, 8ul })
+        {
+          const auto result = code.decode (cword, list_size);
+          EXPECT_EQ (result.iword, iword);
+          EXPECT_TRUE (result.error.vec.isZero ());
+        }
+    }
+}
+
+TEST (TestPolar, TestListDecoding)
+{
+  // Designed for the channel, with and without the CRC-11 of 5G NR.
+  const polar_code plain{ 8, 128, construction_type::GaussianApproximation,
+                          -1.0 };
+  const polar_code aided{ 8, 128, construction_type::GaussianApproximation,
+                          -1.0, 0xe21 };
+  EXPECT_EQ (aided.properties ().crc_size, 11);
+  EXPECT_EQ (aided.information_set ().size (), 139);
+
+  std::mt19937_64 gen{ 256 };
+  std::size_t fast_errors = 0;
+  std::size_t list_errors = 0;
+  std::size_t aided_errors = 0;
+  for (std::size_t trial = 0; trial < 300; ++trial)
+    {
+      const auto iword = random_infoword (128, gen);
+      const auto llrs = transmit (plain.encode (iword), -1.0, gen);
+      fast_errors += plain.decode_soft (llrs).iword != iword;
+      list_errors += plain.decode_soft (llrs, 8).iword != iword;
+
+      const auto aided_llrs = transmit (aided.encode (iword), -1.0, gen);
+      try
+        {
+          const auto result = aided.decode_soft (aided_llrs, 32);
+          aided_errors += result.iword != iword;
+        }
+      catch (const polar_code_exception &)
+        {
+          ++aided_errors;
+        }
+    }
+  EXPECT_LT (list_errors, fast_errors);
+  EXPECT_LT (aided_errors, list_errors);
+}
+
+TEST (TestPolar, TestErrors)
+{
+  const polar_code code{ 6, 32, construction_type::Bhattacharyya, 3.0 };
+  std::mt19937_64 gen{ 64 };
+  const auto iword = random_infoword (32, gen);
+  auto received = code.encode (iword);
+  received.vec (10) ^= 1;
+  received.vec (40) ^= 1;
+  const auto result = code.decode (received, 4);
+  EXPECT_EQ (result.iword, iword);
+  EXPECT_EQ (result.error.vec.sum (), 2);
+  EXPECT_EQ (result.error.vec (10), 1);
+
+  EXPECT_THROW ((void)code.decode_soft (std::vector<float> (63)),
+                polar_code_exception);
+  EXPECT_THROW ((void)code.decode (received, 0), polar_code_exception);
+}
@@ -0,0 +1,191 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/product.h>
+
+#include "helpers.h"
+
+using namespace patrick;
+using namespace patrick::test;
+
+///
+/// Helpers
+///
+
+static codeword
+hard_decisions (const std::vector<float> &llrs)
+{
+  Eigen::RowVectorXi vec (llrs.size ());
+  for (std::size_t i = 0; i < llrs.size (); ++i)
+    vec (i) = llrs[i] < 0;
+  return codeword{ std::move (vec) };
+}
+
+TEST (TestProduct, TestEncode)
+{
+  const product_code code{ linearcode::hamming (3), linearcode::hamming (3) };
+  EXPECT_EQ (code.properties ().word_size, 49);
+  EXPECT_EQ (code.properties ().basis_size, 16);
+  EXPECT_EQ (code.properties ().min_distance, 9);
+
+  std::mt19937_64 gen{ 35 };
+  for (std::size_t trial = 0; trial < 20; ++trial)
+    {
+      const auto cword = code.encode (random_infoword (16, gen));
+      EXPECT_TRUE (code.contains (cword));
+      auto corrupted = cword;
+      corrupted.vec (gen () % 49) ^= 1;
+      EXPECT_FALSE (code.contains (corrupted));
+    }
+
+  EXPECT_THROW ((void)code.encode (random_infoword (15, gen)),
+                product_code_exception);
+}
+
+TEST (TestProduct, TestDecode)
+{
+  product_code code{ linearcode::hamming (3), linearcode::bch (4, 2) };
+  const std::size_t n1 = 7;
+  const std::size_t n2 = 15;
+  std::mt19937_64 gen{ 36 };
+  for (std::size_t trial = 0; trial < 50; ++trial)
+    {
+      const auto iword = random_infoword (code.properties ().basis_size, gen);
+      const auto cword = code.encode (iword);
+
+      // Four errors in distinct rows and columns.
+      auto received = cword;
+      for (std::size_t e = 0; e < 4; ++e)
+        received.vec (e * 3 * n1 + (e + trial) % n1) ^= 1;
+      auto result = code.decode (received);
+      EXPECT_EQ (result.iword, iword);
+      EXPECT_EQ (result.error.vec.sum (), 4);
+
+      // A burst over two whole rows is within the column code's reach.
+      received = cword;
+      const std::size_t row = trial % (n2 - 1);
+      for (std::size_t i = row * n1; i < (row + 2) * n1; ++i)
+        received.vec (i) ^= 1;
+      result = code.decode (received);
+      EXPECT_EQ (result.iword, iword);
+      EXPECT_EQ (result.error.vec.sum (), 2 * n1);
+    }
+
+  EXPECT_THROW ((void)code.decode (codeword{ Eigen::RowVectorXi::Zero (7) }),
+                product_code_exception);
+}
+
+TEST (TestProduct, TestThreads)
+{
+  product_code serial{ linearcode::hamming (4), linearcode::hamming (4), 1 };
+  product_code parallel{ linearcode::hamming (4), linearcode::hamming (4),
+                         4 };
+  std::mt19937_64 gen{ 37 };
+  for (std::size_t trial = 0; trial < 30; ++trial)
+    {
+      auto received = serial.encode (random_infoword (121, gen));
+      for (std::size_t e = 0; e < 12; ++e)
+        received.vec (gen () % 225) ^= 1;
+
+      std::optional<codeword> serial_error;
+      std::optional<codeword> parallel_error;
+      try
+        {
+          serial_error = serial.decode (received).error;
+        }
+      catch (const product_code_exception &)
+        {
+        }
+      try
+        {
+          parallel_error = parallel.decode (received).error;
+        }
+      catch (const product_code_exception &)
+        {
+        }
+      EXPECT_EQ (serial_error, parallel_error);
+    }
+}
+
+TEST (TestProduct, TestDecodeSoft)
+{
+  product_code code{ linearcode::hamming (4), linearcode::hamming (4) };
+  std::mt19937_64 gen{ 38 };
+  std::size_t hard_errors = 0;
+  std::size_t soft_errors = 0;
+  for (std::size_t trial = 0; trial < 200; ++trial)
+    {
+      const auto iword = random_infoword (121, gen);
+      const auto llrs = transmit (code.encode (iword), 1.0, gen);
+      try
+        {
+          hard_errors += code.decode (hard_decisions (llrs)).iword != iword;
+        }
+      catch (const product_code_exception &)
+        {
+          ++hard_errors;
+        }
+      try
+        {
+          soft_errors += code.decode_soft (llrs).iword != iword;
+        }
+      catch (const product_code_exception &)
+        {
+          ++soft_errors;
+        }
+    }
+  EXPECT_LT (soft_errors, hard_errors);
+
+  EXPECT_THROW ((void)code.decode_soft (std::vector<float> (224)),
+                product_code_exception);
+}
+
+TEST (TestProduct, TestDecodeSoftTerminates)
+{
+  // Hard passes over the decisions of this code may oscillate forever.
+  product_code code{ linearcode::hamming (3), linearcode::hamming (3), 1 };
+  std::mt19937_64 gen{ 27 };
+  for (std::size_t trial = 0; trial < 200; ++trial)
+    {
+      const auto iword = random_infoword (16, gen);
+      const double snr = -6.0 + double (trial % 8);
+      const auto llrs = transmit (code.encode (iword), snr, gen);
+      const std::size_t iterations = trial % 4;
+      try
+        {
+          const auto result = code.decode_soft (llrs, iterations, 3);
+          EXPECT_TRUE (code.contains (hard_decisions (llrs) + result.error));
+          if (iterations == 0)
+            {
+              EXPECT_EQ (result.iword,
+                         code.decode (hard_decisions (llrs)).iword);
+            }
+        }
+      catch (const product_code_exception &)
+        {
+        }
+    }
+}
+
+TEST (TestProduct, TestWorkerExceptions)
+{
+  failing_resource resource;
+  auto component = linearcode::from_generator (
+      linearcode::hamming (3).generator_matrix ());
+  component.set_table_resource (&resource);
+  product_code code{ component, component, 4 };
+
+  std::mt19937_64 gen{ 135 };
+  const auto sent = code.encode (random_infoword (16, gen));
+  auto received = sent;
+  received.vec (3) ^= 1;
+
+  // Evicted tables are built again by the threads, which cannot allocate.
+  set_cache_budget (1);
+  set_cache_budget (0);
+  resource.fail = true;
+  EXPECT_THROW ((void)code.decode (received), std::bad_alloc);
+  resource.fail = false;
+  EXPECT_EQ (received + code.decode (received).error, sent);
+}
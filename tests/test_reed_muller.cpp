@@ -0,0 +1,153 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/core.h>
+#include <patrick/reed_muller.h>
+
+#include "helpers.h"
+
+using namespace patrick;
+using namespace patrick::test;
+
+///
+/// Helpers
+///
+
+template <typename T>
+static std::vector<T>
+naive_hadamard_transform (const std::vector<T> &values)
+{
+  std::vector<T> result (values.size (), 0);
+  for (std::size_t a = 0; a < values.size (); ++a)
+    for (std::size_t p = 0; p < values.size (); ++p)
+      result[a] += (std::popcount (a & p) & 1) ? -values[p] : values[p];
+  return result;
+}
+
+TEST (TestReedMuller, TestHadamardTransform)
+{
+  std::mt19937_64 gen{ 30 };
+  for (const std::size_t n : { 1ul, 2ul, 8ul, 64ul, 256ul })
+    {
+      std::vector<std::int16_t> ints (n);
+      std::vector<float> floats (n);
+      for (std::size_t p = 0; p < n; ++p)
+        {
+          ints[p] = std::int16_t (gen () % 7) - 3;
+          floats[p] = float (gen () % 1000) / 100.0f - 5.0f;
+        }
+
+      const auto expected_ints = naive_hadamard_transform (ints);
+      auto scalar_ints = ints;
+      details::fast_hadamard_transform<std::int16_t> (ints);
+      details::fast_hadamard_transform_scalar<std::int16_t> (scalar_ints);
+      EXPECT_EQ (ints, expected_ints);
+      EXPECT_EQ (scalar_ints, expected_ints);
+
+      const auto expected_floats = naive_hadamard_transform (floats);
+      details::fast_hadamard_transform<float> (floats);
+      for (std::size_t a = 0; a < n; ++a)
+        EXPECT_NEAR (floats[a], expected_floats[a], 1e-3);
+    }
+}
+
+TEST (TestReedMuller, TestFirstOrder)
+{
+  using enum linearcode::decoding_strategy;
+
+  std::mt19937_64 gen{ 1 };
+  for (std::size_t m = 2; m <= 10; ++m)
+    {
+      auto code = linearcode::reed_muller (1, m);
+      const std::size_t n = code.properties ().word_size;
+      const std::size_t max_errors = n / 4 - 1;
+      for (std::size_t trial = 0; trial < 10; ++trial)
+        {
+          const infoword iword = random_infoword (m + 1, gen);
+          const codeword error
+              = random_error (n, trial * max_errors / 9, gen);
+          const auto result
+              = code.decode<FastHadamard> (code.encode (iword) + error);
+          EXPECT_EQ (result.iword, iword);
+          EXPECT_EQ (result.error, error);
+        }
+    }
+
+  // Long enough for the correlations to overflow 16 bits.
+  auto rm16 = linearcode::reed_muller (1, 16);
+  const infoword iword = random_infoword (17, gen);
+  const codeword error = random_error (1 << 16, 5000, gen);
+  EXPECT_EQ (rm16.decode<Auto> (rm16.encode (iword) + error).error, error);
+}
+
+TEST (TestReedMuller, TestSoftInput)
+{
+  auto code = linearcode::reed_muller (1, 6);
+  std::mt19937_64 gen{ 6 };
+  const infoword iword = random_infoword (7, gen);
+  const codeword cword = code.encode (iword);
+
+  // 20 of the bits are received wrong, which is more than the hard decoder
+  // can correct, but with little confidence.
+  const codeword flipped = random_error (64, 20, gen);
+  std::vector<float> llrs (64);
+  for (std::size_t p = 0; p < 64; ++p)
+    {
+      const float sign = cword.vec (p) ? -1.0f : 1.0f;
+      llrs[p] = flipped.vec (p) ? -0.1f * sign : 2.0f * sign;
+    }
+
+  const auto result = code.decode_soft (llrs);
+  EXPECT_EQ (result.iword, iword);
+  EXPECT_EQ (result.error, flipped);
+
+  // Other codes decode the hard decisions.
+  auto hamming = linearcode::hamming (3);
+  const std::vector<float> hamming_llrs{ 1, 1, 1, 1, 1, 1, -0.5f };
+  EXPECT_EQ (hamming.decode_soft (hamming_llrs).error,
+             codeword{ "0000001" });
+}
+
+TEST (TestReedMuller, TestMajorityLogic)
+{
+  using enum linearcode::decoding_strategy;
+
+  std::mt19937_64 gen{ 2 };
+  for (const auto &[r, m] :
+       { std::pair{ 0ul, 4ul }, std::pair{ 1ul, 5ul }, std::pair{ 2ul, 5ul },
+         std::pair{ 3ul, 8ul }, std::pair{ 4ul, 4ul } })
+    {
+      auto code = linearcode::reed_muller (r, m);
+      const std::size_t n = code.properties ().word_size;
+      const std::size_t k = code.properties ().basis_size;
+      const std::size_t max_errors = (n >> (r + 1)) - (r < m);
+      for (std::size_t trial = 0; trial < 10; ++trial)
+        {
+          const infoword iword = random_infoword (k, gen);
+          const codeword error
+              = random_error (n, trial % (max_errors + 1), gen);
+          const auto result
+              = code.decode<MajorityLogic> (code.encode (iword) + error);
+          EXPECT_EQ (result.iword, iword);
+          EXPECT_EQ (result.error, error);
+        }
+    }
+
+  // Auto decodes higher orders by majority logic.
+  auto rm24 = linearcode::reed_muller (2, 4);
+  codeword received{ Eigen::RowVectorXi::Zero (16) };
+  received.vec (5) = 1;
+  EXPECT_EQ (rm24.decode (received).error, received);
+
+  // The 2 errors of a word exactly between two codewords tie the votes.
+  received.vec (6) = 1;
+  EXPECT_THROW ((void)rm24.decode<MajorityLogic> (received),
+                linearcode_exception);
+
+  EXPECT_THROW ((void)rm24.decode<FastHadamard> (received),
+                linearcode_exception);
+  auto hamming = linearcode::hamming (3);
+  EXPECT_THROW ((void)hamming.decode<MajorityLogic> (codeword{ "1100110" }),
+                linearcode_exception);
+}
@@ -0,0 +1,170 @@
+#include <numeric>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/reed_solomon.h>
+
+using namespace patrick;
+using symbol_type = reed_solomon::symbol_type;
+
+///
+/// Helpers
+///
+
+static std::vector<symbol_type>
+random_symbols (std::size_t size, std::mt19937_64 &gen)
+{
+  std::vector<symbol_type> result (size);
+  for (auto &s : result)
+    s = gen () & 0xff;
+  return result;
+}
+
+///
+/// \return \a count distinct positions less than \a n.
+///
+static std::vector<std::size_t>
+random_positions (std::size_t n, std::size_t count, std::mt19937_64 &gen)
+{
+  std::vector<std::size_t> positions (n);
+  std::iota (positions.begin (), positions.end (), 0);
+  std::shuffle (positions.begin (), positions.end (), gen);
+  positions.resize (count);
+  return positions;
+}
+
+TEST (TestReedSolomon, TestRegionMultiplier)
+{
+  const details::galois_field field{ 8 };
+  std::mt19937_64 gen{ 8 };
+  const auto src = random_symbols (1000, gen);
+  for (std::size_t c = 0; c < 256; ++c)
+    {
+      const details::region_multiplier multiplier{ field, symbol_type (c) };
+      for (const std::size_t size : { 1ul, 15ul, 16ul, 33ul, 1000ul })
+        {
+          std::vector<symbol_type> dst (size, 0x5a);
+          std::vector<symbol_type> scalar_dst = dst;
+          multiplier.multiply_add (std::span{ src }.first (size), dst);
+          multiplier.multiply_add_scalar (std::span{ src }.first (size),
+                                          scalar_dst);
+          EXPECT_EQ (dst, scalar_dst);
+          EXPECT_EQ (dst[size - 1], 0x5a ^ field.mul (c, src[size - 1]));
+        }
+    }
+}
+
+TEST (TestReedSolomon, TestEncode)
+{
+  const reed_solomon code{ 255, 223 };
+  EXPECT_EQ (code.properties ().min_distance, 33);
+  EXPECT_EQ (code.properties ().max_errors_correct, 16);
+  EXPECT_EQ (code.generator_polynomial ().size (), 33);
+
+  std::mt19937_64 gen{ 255 };
+  const auto message = random_symbols (223, gen);
+  const auto cword = code.encode (message);
+  EXPECT_TRUE (std::equal (message.begin (), message.end (), cword.begin ()));
+  for (const symbol_type s : code.syndrome_of (cword))
+    EXPECT_EQ (s, 0);
+
+  EXPECT_THROW ((void)code.encode (random_symbols (222, gen)),
+                reed_solomon_exception);
+  EXPECT_THROW ((reed_solomon{ 256, 200 }), reed_solomon_exception);
+  EXPECT_THROW ((reed_solomon{ 10, 10 }), reed_solomon_exception);
+}
+
+TEST (TestReedSolomon, TestDecode)
+{
+  std::mt19937_64 gen{ 31 };
+  for (const auto &[n, k] : { std::pair{ 255ul, 223ul },
+                              std::pair{ 20ul, 12ul }, std::pair{ 7ul, 3ul } })
+    {
+      const reed_solomon code{ n, k };
+      const std::size_t redundancy = n - k;
+      for (std::size_t trial = 0; trial < 50; ++trial)
+        {
+          const auto message = random_symbols (k, gen);
+          auto received = code.encode (message);
+
+          // Any split of the redundancy between errors and erasures.
+          const std::size_t num_erasures = trial % (redundancy + 1);
+          const std::size_t num_errors = (redundancy - num_erasures) / 2;
+          const auto positions
+              = random_positions (n, num_erasures + num_errors, gen);
+          std::vector<symbol_type> error (n, 0);
+          for (const std::size_t p : positions)
+            error[p] = 1 + gen () % 255;
+          // Erased symbols may happen to be right.
+          for (std::size_t i = 0; i < num_erasures; i += 3)
+            error[positions[i]] = 0;
+          for (std::size_t p = 0; p < n; ++p)
+            received[p] ^= error[p];
+
+          const std::span<const std::size_t> erasures{ positions.data (),
+                                                       num_erasures };
+          const auto result = code.decode (received, erasures);
+          EXPECT_EQ (result.message, message);
+          EXPECT_EQ (result.error, error);
+        }
+    }
+}
+
+TEST (TestReedSolomon, TestDecodeFailures)
+{
+  const reed_solomon code{ 255, 223 };
+  std::mt19937_64 gen{ 17 };
+  auto received = code.encode (random_symbols (223, gen));
+  for (const std::size_t p : random_positions (255, 17, gen))
+    received[p] ^= 1 + gen () % 255;
+  EXPECT_THROW ((void)code.decode (received), reed_solomon_exception);
+
+  const std::vector<std::size_t> repeated{ 3, 3 };
+  EXPECT_THROW ((void)code.decode (received, repeated),
+                reed_solomon_exception);
+}
+
+TEST (TestReedSolomon, TestShards)
+{
+  const reed_solomon code{ 14, 10 };
+  std::mt19937_64 gen{ 14 };
+
+  // Not a multiple of any vector width, and more than one block.
+  const std::size_t size = 10000 + 7;
+  std::vector<std::vector<symbol_type> > storage;
+  for (std::size_t i = 0; i < 14; ++i)
+    storage.push_back (random_symbols (size, gen));
+
+  std::vector<std::span<const symbol_type> > data (storage.begin (),
+                                                   storage.begin () + 10);
+  std::vector<std::span<symbol_type> > parity (storage.begin () + 10,
+                                               storage.end ());
+  code.encode_shards (data, parity);
+
+  // Every byte column is a codeword.
+  for (std::size_t b = 0; b < size; b += 997)
+    {
+      std::vector<symbol_type> column;
+      for (const auto &shard : storage)
+        column.push_back (shard[b]);
+      for (const symbol_type s : code.syndrome_of (column))
+        EXPECT_EQ (s, 0);
+    }
+
+  const auto original = storage;
+  std::vector<std::span<symbol_type> > shards (storage.begin (),
+                                               storage.end ());
+  for (std::size_t trial = 0; trial < 10; ++trial)
+    {
+      const auto missing = random_positions (14, trial % 5, gen);
+      for (const std::size_t m : missing)
+        std::fill (storage[m].begin (), storage[m].end (), 0);
+      code.reconstruct_shards (shards, missing);
+      EXPECT_EQ (storage, original);
+    }
+
+  const std::vector<std::size_t> too_many{ 0, 1, 2, 3, 4 };
+  EXPECT_THROW (code.reconstruct_shards (shards, too_many),
+                reed_solomon_exception);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <patrick/simulation.h>
+
+#include "helpers.h"
+
+using namespace patrick;
+using namespace patrick::test;
+
+TEST (TestSimulation, TestIndependentOfThreads)
+{
+  const simulation_options serial_options{ .max_frames = 5000,
+                                           .target_frame_errors = 150,
+                                           .batch_size = 64,
+                                           .num_threads = 1,
+                                           .seed = 40 };
+  auto parallel_options = serial_options;
+  parallel_options.num_threads = 4;
+
+  simulation serial{ linearcode::hamming (4), serial_options };
+  simulation parallel{ linearcode::hamming (4), parallel_options };
+  for (const double p : { 0.001, 0.01, 0.05 })
+    EXPECT_EQ (serial.run (p), parallel.run (p));
+
+  // Another seed gives another estimate.
+  auto other_options = parallel_options;
+  other_options.seed = 41;
+  simulation other{ linearcode::hamming (4), other_options };
+  EXPECT_NE (other.run (0.05), parallel.run (0.05));
+}
+
+TEST (TestSimulation, TestStoppingRules)
+{
+  simulation sim{ linearcode::bch (5, 2),
+                  { .max_frames = 100'000,
+                    .target_frame_errors = 50,
+                    .batch_size = 32,
+                    .num_threads = 4 } };
+
+  // The rate is high, so the errors are reached long before the frames,
+  // within the batch which reaches them.
+  const auto point = sim.run (0.1);
+  EXPECT_GE (point.frame_errors, 50);
+  EXPECT_LT (point.frame_errors, 50 + 32);
+  EXPECT_EQ (point.frames % 32, 0);
+  EXPECT_LT (point.frames, 100'000);
+  EXPECT_EQ (point.bits, point.frames * 21);
+
+  // Without errors, every frame is sent.
+  EXPECT_EQ (sim.run (0).frames, 100'000);
+  EXPECT_EQ (sim.run (0).frame_errors, 0);
+
+  simulation precise{ linearcode::hamming (3),
+                      { .target_frame_errors = 0,
+                        .relative_precision = 0.1,
+                        .num_threads = 2 } };
+  const auto estimate = precise.run (0.05);
+  const auto [low, high] = estimate.frame_error_interval ();
+  EXPECT_LE (high - low, 0.2 * estimate.frame_error_rate ());
+  EXPECT_LT (estimate.frames, 1'000'000);
+
+  // Hamming (3) corrects a single error, so a frame survives with
+  // probability (1 - p)^7 + 7 p (1 - p)^6.
+  const double expected
+      = 1 - std::pow (0.95, 7) - 7 * 0.05 * std::pow (0.95, 6);
+  EXPECT_GE (expected, low);
+  EXPECT_LE (expected, high);
+
+  EXPECT_THROW ((void)sim.run (-0.1), simulation_exception);
+  EXPECT_THROW ((void)sim.run (1.1), simulation_exception);
+  EXPECT_THROW ((simulation{ linearcode::hamming (3), { .batch_size = 0 } }),
+                simulation_exception);
+}
+
+TEST (TestSimulation, TestCurve)
+{
+  simulation sim{ linearcode::golay24 (),
+                  { .max_frames = 2000, .target_frame_errors = 100 } };
+  const std::vector<double> ps{ 0.01, 0.05, 0.1, 0.2 };
+  const auto points = sim.curve (ps);
+  ASSERT_EQ (points.size (), ps.size ());
+  for (std::size_t i = 0; i < points.size (); ++i)
+    {
+      EXPECT_EQ (points[i].crossover_probability, ps[i]);
+      EXPECT_LE (points[i].bit_error_rate (), 1.0);
+      if (i > 0)
+        {
+          EXPECT_GE (points[i].frame_error_rate (),
+                     points[i - 1].frame_error_rate ());
+          EXPECT_GE (points[i].bit_error_rate (),
+                     points[i - 1].bit_error_rate ());
+        }
+    }
+  // A point is simulated like on its own.
+  EXPECT_EQ (points[2], sim.run (0.1, 2));
+}
+
+TEST (TestSimulation, TestWorkerExceptions)
+{
+  failing_resource resource;
+  auto code = linearcode::from_generator (
+      linearcode::hamming (4).generator_matrix ());
+  code.set_table_resource (&resource);
+  simulation sim{ std::move (code),
+                  { .max_frames = 4096, .batch_size = 64, .num_threads = 4 } };
+
+  // Evicted tables are built again by the workers, which cannot allocate.
+  set_cache_budget (1);
+  set_cache_budget (0);
+  resource.fail = true;
+  EXPECT_THROW ((void)sim.run (0.05), std::bad_alloc);
+
+  resource.fail = false;
+  EXPECT_EQ (sim.run (0).frames, 4096);
+}
@@ -0,0 +1,90 @@
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <patrick/static_code.h>
+
+using namespace patrick;
+
+///
+/// Codes
+///
+
+using hamming7 = static_linear_code<static_generator<4, 7>{
+    "1101000", "0110100", "0011010", "0001101" }>;
+
+// The extended Golay code with generator (I|B).
+using golay24 = static_linear_code<static_generator<12, 24>{
+    "100000000000110111000101", "010000000000101110001011",
+    "001000000000011100010111", "000100000000111000101101",
+    "000010000000110001011011", "000001000000100010110111",
+    "000000100000000101101111", "000000010000001011011101",
+    "000000001000010110111001", "000000000100101101110001",
+    "000000000010011011100011", "000000000001111111111110" }>;
+
+// Everything is known at compile time.
+static_assert (hamming7::properties.min_distance == 3);
+static_assert (golay24::properties.min_distance == 8);
+static_assert (golay24::properties.max_errors_correct == 3);
+static_assert (hamming7::contains (hamming7::encode (0b1011)));
+static_assert (hamming7::decode (hamming7::encode (0b1011) ^ 0b100).iword
+               == 0b1011);
+
+TEST (TestStaticCode, TestMatchesLinearCode)
+{
+  auto code = linearcode::from_generator (Eigen::MatrixXi{
+      { 1, 1, 0, 1, 0, 0, 0 },
+      { 0, 1, 1, 0, 1, 0, 0 },
+      { 0, 0, 1, 1, 0, 1, 0 },
+      { 0, 0, 0, 1, 1, 0, 1 } });
+  EXPECT_EQ (std::vector<std::size_t> (
+                 hamming7::systematic_form.permutation.cbegin (),
+                 hamming7::systematic_form.permutation.cend ()),
+             code.permutation ());
+  EXPECT_EQ (hamming7::properties.min_distance,
+             code.properties ().min_distance);
+
+  for (unsigned long long i = 0; i < 16; ++i)
+    {
+      const infoword iword{ i, 4 };
+      EXPECT_EQ (hamming7::encode (iword), code.encode (iword));
+    }
+
+  // The code is perfect, so every coset has a single leader.
+  for (unsigned long long i = 0; i < 128; ++i)
+    {
+      const codeword word{ i, 7 };
+      const auto expected
+          = code.decode<linearcode::decoding_strategy::Syndromes> (word);
+      const auto result = hamming7::decode (word);
+      EXPECT_EQ (result.iword, expected.iword);
+      EXPECT_EQ (result.error, expected.error);
+    }
+}
+
+TEST (TestStaticCode, TestDecode)
+{
+  std::mt19937_64 gen{ 38 };
+  for (std::size_t trial = 0; trial < 1000; ++trial)
+    {
+      const std::uint64_t iword = gen () & 0xfff;
+      const std::uint64_t cword = golay24::encode (iword);
+      EXPECT_TRUE (golay24::contains (cword));
+
+      std::uint64_t error = 0;
+      while (std::popcount (error) < int (trial % 4))
+        error |= std::uint64_t{ 1 } << (gen () % 24);
+      const auto result = golay24::decode (cword ^ error);
+      EXPECT_EQ (result.iword, iword);
+      EXPECT_EQ (result.error, error);
+    }
+
+  // Every coset leader is at most as heavy as the covering radius.
+  for (const auto leader : golay24::coset_leaders)
+    EXPECT_LE (std::popcount (leader), 4);
+
+  EXPECT_THROW ((void)golay24::decode (codeword{ 0, 23 }),
+                static_linear_code_exception);
+  EXPECT_THROW ((void)hamming7::encode (infoword{ 0, 5 }),
+                static_linear_code_exception);
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <type_traits>
+
+#include <patrick/core.h>
+
+using namespace patrick;
+
+TEST (TestStats, TestCompiledOut)
+{
+  if constexpr (details::stats_enabled)
+    GTEST_SKIP () << "The stats are enabled.";
+
+  // The counters take no space and count nothing.
+  EXPECT_TRUE (std::is_empty_v<details::stats_counters>);
+  auto code = linearcode::hamming (3);
+  (void)code.decode (code.encode (infoword{ 0b1011, 4 }));
+  EXPECT_EQ (code.stats (), linearcode_stats{});
+}
+
+TEST (TestStats, TestEncodesAndDecodes)
+{
+  if constexpr (!details::stats_enabled)
+    GTEST_SKIP () << "The stats are compiled out.";
+
+  using enum linearcode::decoding_strategy;
+  auto code = linearcode::hamming (3);
+  const auto cword = code.encode (infoword{ 0b1011, 4 });
+  codeword received = cword;
+  received.vec (2) ^= 1;
+  (void)code.decode<Syndromes> (received);
+  (void)code.decode<Syndromes> (cword);
+  (void)code.decode (received);
+  EXPECT_THROW ((void)code.decode (codeword{ 0, 5 }), linearcode_exception);
+
+  auto stats = code.stats ();
+  EXPECT_EQ (stats.encodes, 1);
+  EXPECT_EQ (stats.decodes[std::size_t (Syndromes)], 2);
+  EXPECT_EQ (stats.decodes[std::size_t (Auto)], 2);
+  EXPECT_EQ (stats.decodes[std::size_t (SlepyanTable)], 0);
+  EXPECT_EQ (stats.corrected_weights[0], 1);
+  EXPECT_EQ (stats.corrected_weights[1], 2);
+  EXPECT_EQ (stats.uncorrectable, 1);
+
+  // Building the tables does not count as encoding.
+  EXPECT_EQ (stats.build (lazy_table::SyndromeTable).builds, 1);
+  EXPECT_GT (stats.build (lazy_table::SyndromeTable).bytes, 0);
+  EXPECT_EQ (stats.build (lazy_table::SlepianTable).builds, 0);
+  (void)code.decode<SlepyanTable> (received);
+  stats = code.stats ();
+  EXPECT_EQ (stats.build (lazy_table::Codewords).builds, 1);
+  EXPECT_EQ (stats.build (lazy_table::SlepianTable).builds, 1);
+  EXPECT_EQ (stats.encodes, 1);
+
+  // A copy starts from the counts of the original.
+  const auto copy = code;
+  EXPECT_EQ (copy.stats (), stats);
+  code.reset_stats ();
+  EXPECT_EQ (code.stats (), linearcode_stats{});
+  EXPECT_EQ (copy.stats (), stats);
+}
+
+TEST (TestStats, TestBatchesAndErasures)
+{
+  if constexpr (!details::stats_enabled)
+    GTEST_SKIP () << "The stats are compiled out.";
+
+  using enum linearcode::decoding_strategy;
+  auto code = linearcode::from_generator (
+      linearcode::hamming (3).generator_matrix ());
+  std::vector<std::uint64_t> iwords{ 0b1011, 0b0110, 0b1111 };
+  std::vector<std::uint64_t> cwords (3);
+  code.encode_batch (iwords, cwords, 3);
+  cwords[0] ^= 0b100;
+  std::vector<std::uint64_t> decoded (3);
+  EXPECT_EQ (code.decode_batch (cwords, decoded, 3), 0);
+
+  const auto stats = code.stats ();
+  EXPECT_EQ (stats.encodes, 3);
+  EXPECT_EQ (stats.decodes[std::size_t (Syndromes)], 3);
+  EXPECT_EQ (stats.corrected_weights[0], 2);
+  EXPECT_EQ (stats.corrected_weights[1], 1);
+  EXPECT_EQ (stats.build (lazy_table::PackedSyndromeTable).builds, 1);
+
+  const auto cword = details::unpack<details::codeword_tag> (&cwords[1], 7);
+  (void)code.decode_erasures (cword, codeword{ 0b11, 7 });
+  (void)code.decode_erasures (cword, codeword{ 0b11, 7 });
+  EXPECT_EQ (code.stats ().erasure_decodes, 2);
+  EXPECT_EQ (code.stats ().build (lazy_table::ErasureSolution).builds, 1);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include <patrick/core.h>
+#include <patrick/simulation.h>
+#include <patrick/trace.h>
+
+using namespace patrick;
+
+namespace
+{
+
+///
+/// \brief Keeps the names of the spans it receives.
+///
+class recording_sink final : public trace_sink
+{
+public:
+  void
+  write (const trace_event &event) override
+  {
+    std::scoped_lock lock{ m_mutex };
+    names.emplace_back (event.name);
+    if (event.name == "syndrome_table")
+      {
+        ASSERT_EQ (event.args.size (), 2);
+        EXPECT_EQ (event.args[0].key, "n");
+        EXPECT_EQ (event.args[0].value, 7);
+      }
+  }
+
+  std::vector<std::string> names;
+
+private:
+  std::mutex m_mutex;
+};
+
+bool
+contains (const std::vector<std::string> &names, std::string_view name)
+{
+  return std::find (names.cbegin (), names.cend (), name) != names.cend ();
+}
+
+} // namespace
+
+TEST (TestTrace, TestOffByDefault)
+{
+  EXPECT_EQ (current_trace_sink (), nullptr);
+
+  // Building the tables writes no files.
+  const auto files = [] {
+    using std::filesystem::directory_iterator;
+    return std::distance (directory_iterator{ "." }, directory_iterator{});
+  };
+  const auto before = files ();
+  (void)linearcode::hamming (3).syndrome_table ();
+  EXPECT_EQ (files (), before);
+}
+
+TEST (TestTrace, TestSpans)
+{
+  auto sink = std::make_shared<recording_sink> ();
+  set_trace_sink (sink);
+  {
+    auto code = linearcode::from_generator (
+        linearcode::hamming (3).generator_matrix ());
+    std::vector<std::uint64_t> words (4);
+    std::vector<std::uint64_t> iwords (4);
+    code.encode_batch (iwords, words, 4);
+    (void)code.decode_batch (words, iwords, 4);
+
+    simulation sim{ code, { .max_frames = 64, .num_threads = 2 } };
+    (void)sim.run (0.1);
+  }
+  set_trace_sink (nullptr);
+  EXPECT_EQ (current_trace_sink (), nullptr);
+
+  for (const auto name :
+       { "parity_matrix", "syndrome_table", "packed_syndrome_table",
+         "encode_batch", "decode_batch", "simulation", "simulation_batch" })
+    EXPECT_TRUE (contains (sink->names, name)) << name;
+
+  // Nothing is sent once tracing is off.
+  const auto count = sink->names.size ();
+  (void)linearcode::hamming (4).syndrome_table ();
+  EXPECT_EQ (sink->names.size (), count);
+}
+
+TEST (TestTrace, TestChromeTraceSink)
+{
+  std::ostringstream out;
+  {
+    chrome_trace_sink sink{ out };
+    const trace_arg args[]{ { "count", 3 } };
+    sink.write ({ .name = "a\"b",
+                  .category = "batch",
+                  .start_ns = 1500,
+                  .duration_ns = 2000,
+                  .thread = 1,
+                  .args = args });
+    sink.write ({ .name = "c", .category = "table", .thread = 2 });
+  }
+  EXPECT_EQ (out.str (),
+             "[\n"
+             "{\"name\":\"a\\\"b\",\"cat\":\"batch\",\"ph\":\"X\","
+             "\"ts\":1.500,\"dur\":2.000,\"pid\":1,\"tid\":1,"
+             "\"args\":{\"count\":3}},\n"
+             "{\"name\":\"c\",\"cat\":\"table\",\"ph\":\"X\",\"ts\":0.000,"
+             "\"dur\":0.000,\"pid\":1,\"tid\":2}\n"
+             "]\n");
+
+  EXPECT_THROW ((chrome_trace_sink{ "/nonexistent/dir/trace.json" }),
+                trace_exception);
+}